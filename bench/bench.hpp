@@ -0,0 +1,41 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <string>
+
+namespace bench {
+
+template <typename T>
+inline void do_not_optimize(const T& value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobber_memory() { asm volatile("" : : : "memory"); }
+
+// Runs fn `repetitions` times and returns the fastest run in nanoseconds.
+template <typename Fn>
+double measure_ns(Fn&& fn, std::size_t repetitions = 5) {
+  double best = std::numeric_limits<double>::max();
+  for (std::size_t i = 0; i < repetitions; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto stop = std::chrono::steady_clock::now();
+    best = std::min(
+        best, std::chrono::duration<double, std::nano>(stop - start).count());
+  }
+  return best;
+}
+
+inline void report(const std::string& name, std::size_t size, double ns,
+                   std::size_t ops) {
+  std::printf("%-40s %12zu %12.3f ns/op\n", name.c_str(), size,
+              ns / static_cast<double>(ops));
+}
+
+}  // namespace bench
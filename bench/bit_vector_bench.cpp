@@ -0,0 +1,106 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Three random filter masks of SIZE (default 100M) flags, about 30% set,
+// stored byte-per-flag in utils::Vector<uint8_t> and as utils::BitVector:
+//   - combine: result = a & b & ~c,
+//   - count: number of set flags in the result,
+//   - combine+count: a.count_and(b) without building a result,
+//   - indices: the positions of the set flags, as uint32_t.
+// BitVector rows are repeated on every supported instruction set. Each row
+// is the best of five runs, reported per flag.
+//
+//   bit_vector_bench [SIZE]
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include <bench/bench.hpp>
+#include <lib/bit_vector/bit_vector.hpp>
+#include <lib/vector/vector.hpp>
+#include <lib/vector_algorithms/vector_algorithms.hpp>
+
+namespace {
+
+utils::Vector<std::uint8_t> random_flags(std::size_t size, unsigned seed) {
+  std::mt19937 rng(seed);
+  utils::Vector<std::uint8_t> flags(size, 0);
+  for (auto& flag : flags) flag = rng() % 100 < 30;
+  return flags;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  namespace algo = utils::algorithms;
+  std::size_t size = 100'000'000;
+  if (argc > 1) size = std::strtoull(argv[1], nullptr, 10);
+
+  const auto fa = random_flags(size, 1);
+  const auto fb = random_flags(size, 2);
+  const auto fc = random_flags(size, 3);
+  const auto a = utils::BitVector::from_flags(fa);
+  const auto b = utils::BitVector::from_flags(fb);
+  const auto c = utils::BitVector::from_flags(fc);
+
+  std::printf("memory: %zu bytes byte-per-flag, %zu bytes BitVector\n", fa.capacity(),
+              a.words().size() * sizeof(std::uint64_t));
+
+  utils::Vector<std::uint8_t> bytes_result(size, 0);
+  bench::report("bytes combine", size, bench::measure_ns([&] {
+    for (std::size_t i = 0; i < size; ++i) bytes_result[i] = fa[i] & fb[i] & !fc[i];
+    bench::clobber_memory();
+  }), size);
+  std::size_t bytes_count = 0;
+  bench::report("bytes count", size, bench::measure_ns([&] {
+    bytes_count = 0;
+    for (std::size_t i = 0; i < size; ++i) bytes_count += bytes_result[i];
+    bench::do_not_optimize(bytes_count);
+  }), size);
+  bench::report("bytes combine+count (a & b)", size, bench::measure_ns([&] {
+    std::size_t n = 0;
+    for (std::size_t i = 0; i < size; ++i) n += fa[i] & fb[i];
+    bench::do_not_optimize(n);
+  }), size);
+  utils::Vector<std::uint32_t> indices;
+  bench::report("bytes indices", size, bench::measure_ns([&] {
+    indices.clear();
+    for (std::size_t i = 0; i < size; ++i) {
+      if (bytes_result[i]) indices.push_back(static_cast<std::uint32_t>(i));
+    }
+    bench::do_not_optimize(indices.data());
+  }), size);
+
+  for (int isa = 0; isa <= static_cast<int>(algo::detected_isa()); ++isa) {
+    algo::set_active_isa(static_cast<algo::Isa>(isa));
+    const std::string suffix = std::string(" (") + algo::isa_name(algo::active_isa()) + ")";
+    utils::BitVector result = a;
+    bench::report("BitVector combine" + suffix, size, bench::measure_ns([&] {
+      result = a;
+      result &= b;
+      result.and_not(c);
+      bench::clobber_memory();
+    }), size);
+    std::size_t count = 0;
+    bench::report("BitVector count" + suffix, size, bench::measure_ns([&] {
+      count = result.count();
+      bench::do_not_optimize(count);
+    }), size);
+    if (count != bytes_count) {
+      std::printf("count mismatch: %zu vs %zu\n", count, bytes_count);
+      return 1;
+    }
+    bench::report("BitVector count_and" + suffix, size, bench::measure_ns([&] {
+      bench::do_not_optimize(a.count_and(b));
+    }), size);
+    bench::report("BitVector indices" + suffix, size, bench::measure_ns([&] {
+      indices.clear();
+      result.append_indices(indices);
+      bench::do_not_optimize(indices.data());
+    }), size);
+  }
+  return 0;
+}
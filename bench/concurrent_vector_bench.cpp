@@ -0,0 +1,80 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Append throughput of utils::ConcurrentVector against a utils::Vector
+// guarded by a std::mutex, with 1, 2, 4, ... up to MAX_THREADS (default:
+// hardware threads) threads pushing TOTAL uint64 values between them.
+//
+//   concurrent_vector_bench [TOTAL [MAX_THREADS]]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <bench/bench.hpp>
+#include <lib/concurrent_vector/concurrent_vector.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace {
+
+// Best of three runs in milliseconds; each run starts from an empty
+// container built by make().
+template <typename Make, typename Push>
+double time_ms(std::size_t threads, std::size_t total, Make&& make, Push&& push) {
+  double best = 1e300;
+  for (int run = 0; run < 3; ++run) {
+    auto container = make();
+    std::vector<std::thread> workers;
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t] {
+        const std::size_t first = total * t / threads;
+        const std::size_t last = total * (t + 1) / threads;
+        for (std::size_t i = first; i < last; ++i) push(*container, i);
+      });
+    }
+    for (std::thread& worker : workers) worker.join();
+    auto stop = std::chrono::steady_clock::now();
+    bench::do_not_optimize(container);
+    best = std::min(best, std::chrono::duration<double, std::milli>(stop - start).count());
+  }
+  return best;
+}
+
+struct LockedVector {
+  std::mutex mutex;
+  utils::Vector<std::uint64_t> values;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t total = std::size_t{1} << 24;
+  std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+  if (argc > 1) total = std::strtoull(argv[1], nullptr, 10);
+  if (argc > 2) max_threads = std::strtoull(argv[2], nullptr, 10);
+
+  std::printf("%zu appends, up to %zu threads\n", total, max_threads);
+  for (std::size_t threads = 1;; threads = std::min(threads * 2, max_threads)) {
+    const double locked = time_ms(
+        threads, total, [] { return std::make_unique<LockedVector>(); },
+        [](LockedVector& v, std::size_t i) {
+          std::lock_guard lock(v.mutex);
+          v.values.push_back(i);
+        });
+    const double concurrent = time_ms(
+        threads, total, [] { return std::make_unique<utils::ConcurrentVector<std::uint64_t>>(); },
+        [](utils::ConcurrentVector<std::uint64_t>& v, std::size_t i) { v.push_back(i); });
+    std::printf("%3zu threads  mutex+Vector %8.1f Mops/s  ConcurrentVector %8.1f Mops/s\n",
+                threads, static_cast<double>(total) / locked / 1e3,
+                static_cast<double>(total) / concurrent / 1e3);
+    std::fflush(stdout);
+    if (threads == max_threads) break;
+  }
+  return 0;
+}
@@ -0,0 +1,102 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Removes every tenth element (10%) of a SIZE-element vector (default:
+// 10M uint64 values, and 10M / 8 std::strings):
+//   - erase(position) once per element. This is O(K * N), so it is timed on
+//     LIMIT (default 200) of the removals and scaled up,
+//   - std::erase_if on std::vector,
+//   - utils::erase_if, utils::Vector::erase_indices and unordered_erase.
+// Each row is the best of three runs on a fresh copy.
+//
+//   erase_bench [SIZE [LIMIT]]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+#include <bench/bench.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace {
+
+// Element i is removed when i % 10 == 0; the strings are decimal numbers.
+bool doomed_value(std::uint64_t value) { return value % 10 == 0; }
+bool doomed_value(const std::string& value) { return value.back() == '0'; }
+
+// Best of three runs of erase(copy) in nanoseconds, not counting the copy.
+template <typename Container, typename Erase>
+double time_erase(const Container& original, Erase&& erase) {
+  double best = 1e300;
+  for (int run = 0; run < 3; ++run) {
+    Container copy(original);
+    auto start = std::chrono::steady_clock::now();
+    erase(copy);
+    auto stop = std::chrono::steady_clock::now();
+    bench::do_not_optimize(copy.data());
+    best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+  }
+  return best;
+}
+
+template <typename T, typename Make>
+void run(const char* type, std::size_t size, std::size_t limit, Make&& make) {
+  utils::Vector<T> values;
+  std::vector<T> std_values;
+  values.reserve(size);
+  std_values.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    values.push_back(make(i));
+    std_values.push_back(make(i));
+  }
+  std::vector<std::size_t> doomed;
+  for (std::size_t i = 0; i < size; i += 10) doomed.push_back(i);
+  const std::size_t removed = doomed.size();
+  const auto is_doomed = [](const T& value) { return doomed_value(value); };
+
+  std::printf("%s: %zu elements, %zu removed\n", type, size, removed);
+  const std::size_t sample = std::min(limit, removed);
+  const double one_by_one = time_erase(values, [&](utils::Vector<T>& v) {
+    // Spread over the whole vector, back to front, so the tails average N / 2.
+    const std::size_t stride = removed / sample;
+    for (std::size_t k = sample; k-- > 0;) v.erase(v.begin() + doomed[k * stride]);
+  });
+  bench::report("  Vector::erase(position) loop (scaled)", size,
+                one_by_one * static_cast<double>(removed) / static_cast<double>(sample),
+                removed);
+  bench::report("  std::erase_if(std::vector)", size,
+                time_erase(std_values, [&](std::vector<T>& v) { std::erase_if(v, is_doomed); }),
+                removed);
+  bench::report("  utils::erase_if", size,
+                time_erase(values, [&](utils::Vector<T>& v) { utils::erase_if(v, is_doomed); }),
+                removed);
+  bench::report("  Vector::erase_indices", size,
+                time_erase(values, [&](utils::Vector<T>& v) { v.erase_indices(doomed); }),
+                removed);
+  bench::report("  Vector::unordered_erase loop", size,
+                time_erase(values,
+                           [&](utils::Vector<T>& v) {
+                             for (std::size_t k = removed; k-- > 0;) {
+                               v.unordered_erase(v.begin() + doomed[k]);
+                             }
+                           }),
+                removed);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t size = 10'000'000;
+  std::size_t limit = 200;
+  if (argc > 1) size = std::strtoull(argv[1], nullptr, 10);
+  if (argc > 2) limit = std::max<std::size_t>(1, std::strtoull(argv[2], nullptr, 10));
+
+  run<std::uint64_t>("uint64_t", size, limit, [](std::size_t i) { return std::uint64_t{i}; });
+  run<std::string>("std::string", size / 8, limit,
+                   [](std::size_t i) { return std::to_string(i); });
+  return 0;
+}
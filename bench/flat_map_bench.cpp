@@ -0,0 +1,127 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// uint64 -> uint64 maps with 1K, 100K and 10M random keys (the largest size
+// can be lowered with MAX_SIZE), compared across std::map,
+// std::unordered_map, utils::FlatMap, and std::lower_bound over the same
+// sorted keys as the branchy baseline for FlatMap's branchless search:
+//   - build: from SIZE unsorted entries (FlatMap: one sort + dedup),
+//   - find hit: 1M lookups of keys that are present, in random order,
+//   - find miss: 1M lookups of keys that are absent,
+//   - iterate: sum of all values in key order (unordered_map: bucket order).
+// Each row is the best of five runs, reported per operation.
+//
+//   flat_map_bench [MAX_SIZE]
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <bench/bench.hpp>
+#include <lib/flat_map/flat_map.hpp>
+
+namespace {
+
+constexpr std::size_t kLookups = 1'000'000;
+
+using Entries = std::vector<std::pair<std::uint64_t, std::uint64_t>>;
+
+// Odd keys are present and even keys absent, so misses are easy to draw.
+Entries random_entries(std::size_t size, std::mt19937_64& rng) {
+  Entries entries(size);
+  for (auto& [key, value] : entries) {
+    key = rng() | 1;
+    value = rng();
+  }
+  return entries;
+}
+
+std::vector<std::uint64_t> queries(const Entries& entries, bool hit, std::mt19937_64& rng) {
+  std::vector<std::uint64_t> keys(kLookups);
+  for (auto& key : keys) {
+    key = hit ? entries[rng() % entries.size()].first : rng() & ~std::uint64_t{1};
+  }
+  return keys;
+}
+
+template <typename Find>
+void bench_find(const std::string& name, std::size_t size, const std::vector<std::uint64_t>& keys,
+                Find find) {
+  bench::report(name, size, bench::measure_ns([&] {
+    std::uint64_t sum = 0;
+    for (std::uint64_t key : keys) sum += find(key);
+    bench::do_not_optimize(sum);
+  }), keys.size());
+}
+
+void run(std::size_t size, std::mt19937_64& rng) {
+  const Entries entries = random_entries(size, rng);
+  const auto hits = queries(entries, true, rng);
+  const auto misses = queries(entries, false, rng);
+
+  std::map<std::uint64_t, std::uint64_t> tree;
+  bench::report("std::map build", size, bench::measure_ns([&] {
+    tree = std::map<std::uint64_t, std::uint64_t>(entries.begin(), entries.end());
+  }, 1), size);
+  std::unordered_map<std::uint64_t, std::uint64_t> hash;
+  bench::report("std::unordered_map build", size, bench::measure_ns([&] {
+    hash = std::unordered_map<std::uint64_t, std::uint64_t>(entries.begin(), entries.end());
+  }, 1), size);
+  utils::FlatMap<std::uint64_t, std::uint64_t> flat;
+  bench::report("FlatMap build", size, bench::measure_ns([&] {
+    flat = utils::FlatMap<std::uint64_t, std::uint64_t>(entries);
+  }, 1), size);
+
+  const std::uint64_t* first = flat.keys().data();
+  const std::uint64_t* last = first + flat.size();
+  for (const bool hit : {true, false}) {
+    const auto& keys = hit ? hits : misses;
+    const std::string kind = hit ? " find hit" : " find miss";
+    bench_find("std::map" + kind, size, keys, [&](std::uint64_t key) {
+      const auto it = tree.find(key);
+      return it == tree.end() ? 0 : it->second;
+    });
+    bench_find("std::unordered_map" + kind, size, keys, [&](std::uint64_t key) {
+      const auto it = hash.find(key);
+      return it == hash.end() ? 0 : it->second;
+    });
+    bench_find("std::lower_bound" + kind, size, keys, [&](std::uint64_t key) {
+      const auto* it = std::lower_bound(first, last, key);
+      return it == last || *it != key ? 0 : flat.values()[static_cast<std::size_t>(it - first)];
+    });
+    bench_find("FlatMap" + kind, size, keys, [&](std::uint64_t key) {
+      const auto it = flat.find(key);
+      return it == flat.end() ? 0 : it->second;
+    });
+  }
+
+  const auto iterate = [&](const std::string& name, const auto& map) {
+    bench::report(name + " iterate", size, bench::measure_ns([&] {
+      std::uint64_t sum = 0;
+      for (const auto& [key, value] : map) sum += value;
+      bench::do_not_optimize(sum);
+    }), size);
+  };
+  iterate("std::map", tree);
+  iterate("std::unordered_map", hash);
+  iterate("FlatMap", flat);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t max_size = 10'000'000;
+  if (argc > 1) max_size = std::strtoull(argv[1], nullptr, 10);
+
+  std::mt19937_64 rng(1);
+  for (std::size_t size : {std::size_t{1'000}, std::size_t{100'000}, std::size_t{10'000'000}}) {
+    if (size <= max_size) run(size, rng);
+  }
+  return 0;
+}
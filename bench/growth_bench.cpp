@@ -0,0 +1,43 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Append throughput of the growth policies against std::vector.
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <bench/bench.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace {
+
+template <typename Container>
+void run(const std::string& name, std::size_t size) {
+  double ns = bench::measure_ns([size] {
+    Container c;
+    for (std::size_t i = 0; i < size; ++i) {
+      c.push_back(static_cast<int>(i));
+    }
+    bench::do_not_optimize(c.data());
+    bench::clobber_memory();
+  });
+  bench::report(name, size, ns, size);
+}
+
+template <typename Growth>
+using IntVector = utils::Vector<int, std::allocator<int>, Growth>;
+
+}  // namespace
+
+int main() {
+  for (std::size_t size : {1'000, 100'000, 1'000'000, 10'000'000}) {
+    run<std::vector<int>>("std::vector", size);
+    run<IntVector<utils::GeometricGrowth<2.0>>>("utils::Vector geometric x2", size);
+    run<IntVector<utils::GeometricGrowth<1.5>>>("utils::Vector geometric x1.5", size);
+    if (size <= 100'000) {
+      run<IntVector<utils::LinearGrowth<1>>>("utils::Vector linear +1", size);
+    }
+  }
+  return 0;
+}
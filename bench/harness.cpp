@@ -0,0 +1,136 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include "harness.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+
+namespace {
+
+// Plain counters: the benchmarks are single-threaded.
+std::size_t allocation_count = 0;
+std::size_t current_bytes = 0;
+std::size_t peak_bytes = 0;
+
+// Every block carries its size in a header so delete can account for it
+// without relying on sized deallocation.
+std::size_t header_size(std::size_t alignment) noexcept {
+  return std::max(alignment, alignof(std::max_align_t));
+}
+
+void* counted_allocate(std::size_t size, std::size_t alignment) {
+  const std::size_t header = header_size(alignment);
+  const std::size_t total = (header + size + alignment - 1) / alignment * alignment;
+  void* raw = alignment > alignof(std::max_align_t) ? std::aligned_alloc(alignment, total)
+                                                     : std::malloc(total);
+  if (raw == nullptr) {
+    throw std::bad_alloc();
+  }
+  char* user = static_cast<char*>(raw) + header;
+  *reinterpret_cast<std::size_t*>(user - sizeof(std::size_t)) = size;
+  ++allocation_count;
+  current_bytes += size;
+  peak_bytes = std::max(peak_bytes, current_bytes);
+  return user;
+}
+
+void counted_deallocate(void* p, std::size_t alignment) noexcept {
+  if (p == nullptr) {
+    return;
+  }
+  char* user = static_cast<char*>(p);
+  current_bytes -= *reinterpret_cast<std::size_t*>(user - sizeof(std::size_t));
+  std::free(user - header_size(alignment));
+}
+
+void write_escaped(std::FILE* out, const std::string& text) {
+  std::fputc('"', out);
+  for (char c : text) {
+    if (c == '"' || c == '\\') {
+      std::fputc('\\', out);
+    }
+    std::fputc(c, out);
+  }
+  std::fputc('"', out);
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  return counted_allocate(size, alignof(std::max_align_t));
+}
+void* operator new[](std::size_t size) {
+  return counted_allocate(size, alignof(std::max_align_t));
+}
+void* operator new(std::size_t size, std::align_val_t alignment) {
+  return counted_allocate(size, static_cast<std::size_t>(alignment));
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+  return counted_allocate(size, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* p) noexcept {
+  counted_deallocate(p, alignof(std::max_align_t));
+}
+void operator delete[](void* p) noexcept {
+  counted_deallocate(p, alignof(std::max_align_t));
+}
+void operator delete(void* p, std::size_t) noexcept {
+  counted_deallocate(p, alignof(std::max_align_t));
+}
+void operator delete[](void* p, std::size_t) noexcept {
+  counted_deallocate(p, alignof(std::max_align_t));
+}
+void operator delete(void* p, std::align_val_t alignment) noexcept {
+  counted_deallocate(p, static_cast<std::size_t>(alignment));
+}
+void operator delete[](void* p, std::align_val_t alignment) noexcept {
+  counted_deallocate(p, static_cast<std::size_t>(alignment));
+}
+void operator delete(void* p, std::size_t, std::align_val_t alignment) noexcept {
+  counted_deallocate(p, static_cast<std::size_t>(alignment));
+}
+void operator delete[](void* p, std::size_t, std::align_val_t alignment) noexcept {
+  counted_deallocate(p, static_cast<std::size_t>(alignment));
+}
+
+namespace bench {
+
+HeapCounters heap_counters() noexcept {
+  return {allocation_count, current_bytes, peak_bytes};
+}
+
+void reset_heap_peak() noexcept { peak_bytes = current_bytes; }
+
+bool JsonReport::write(const std::string& path) const {
+  std::FILE* out = path.empty() ? stdout : std::fopen(path.c_str(), "w");
+  if (out == nullptr) {
+    return false;
+  }
+  std::fprintf(out, "{\n  \"suite\": ");
+  write_escaped(out, this->suite_);
+  std::fprintf(out, ",\n  \"results\": [");
+  for (std::size_t i = 0; i < this->results_.size(); ++i) {
+    const Result& r = this->results_[i];
+    std::fprintf(out, "%s\n    {\"name\": ", i == 0 ? "" : ",");
+    write_escaped(out, r.name);
+    std::fprintf(out, ", \"container\": ");
+    write_escaped(out, r.container);
+    std::fprintf(out, ", \"type\": ");
+    write_escaped(out, r.type);
+    std::fprintf(out,
+                 ", \"size\": %zu, \"ns_per_op\": %.4f, \"allocations_per_op\": %.6f, "
+                 "\"peak_bytes\": %zu}",
+                 r.size, r.ns_per_op, r.allocations_per_op, r.peak_bytes);
+  }
+  std::fprintf(out, "\n  ]\n}\n");
+  if (out != stdout) {
+    std::fclose(out);
+  }
+  return true;
+}
+
+}  // namespace bench
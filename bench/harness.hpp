@@ -0,0 +1,118 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Offline benchmark harness: wall time, heap allocations and peak heap
+// bytes per case, written out as JSON. Link harness.cpp into exactly one
+// benchmark executable; it replaces the global operator new/delete to
+// count allocations.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <bench/bench.hpp>
+
+namespace bench {
+
+// Heap usage seen by the replaced operator new/delete.
+struct HeapCounters {
+  std::size_t allocations;
+  std::size_t current_bytes;
+  std::size_t peak_bytes;
+};
+
+HeapCounters heap_counters() noexcept;
+// Makes the current live byte count the new peak.
+void reset_heap_peak() noexcept;
+
+struct Result {
+  std::string name;
+  std::string container;
+  std::string type;
+  std::size_t size;
+  double ns_per_op;
+  double allocations_per_op;
+  std::size_t peak_bytes;
+};
+
+// Collects results and prints them as a single JSON document.
+class JsonReport {
+ public:
+  explicit JsonReport(std::string suite) : suite_(std::move(suite)) {}
+
+  void add(Result result) { results_.push_back(std::move(result)); }
+  // Writes to path, or to stdout when path is empty. Returns false if the
+  // file cannot be opened.
+  bool write(const std::string& path = "") const;
+
+ private:
+  std::string suite_;
+  std::vector<Result> results_;
+};
+
+struct Sample {
+  double ns_per_op;
+  double allocations_per_op;
+  std::size_t peak_bytes;
+};
+
+// Ops per timed batch; small cases are repeated until a batch reaches it so
+// the clock resolution does not dominate.
+constexpr std::size_t kBatchOps = std::size_t{1} << 16;
+constexpr std::size_t kRepetitions = 5;
+// Upper bound on the heap held by the prepared states of one batch.
+constexpr std::size_t kMaxBatchBytes = std::size_t{64} << 20;
+
+// Times body(state) for states made by setup(), which runs outside the
+// clock. ops is the number of operations one body call performs. The time
+// is the best of kRepetitions batches; peak_bytes is the heap growth over
+// a single body call.
+template <typename Setup, typename Body>
+Sample measure(std::size_t ops, Setup&& setup, Body&& body) {
+  using State = decltype(setup());
+  std::size_t iterations = std::max<std::size_t>(1, kBatchOps / std::max<std::size_t>(ops, 1));
+  {
+    const std::size_t before = heap_counters().current_bytes;
+    // Only built to measure its heap footprint, so it must stay alive
+    // until state_bytes is read.
+    [[maybe_unused]] State probe = setup();
+    const std::size_t state_bytes = heap_counters().current_bytes - before;
+    iterations = std::min(iterations,
+                          std::max<std::size_t>(1, kMaxBatchBytes / std::max<std::size_t>(state_bytes, 1)));
+  }
+  double best = std::numeric_limits<double>::max();
+  std::size_t allocations = 0;
+  for (std::size_t r = 0; r < kRepetitions; ++r) {
+    std::vector<State> states;
+    states.reserve(iterations);
+    for (std::size_t i = 0; i < iterations; ++i) {
+      states.push_back(setup());
+    }
+    const std::size_t before = heap_counters().allocations;
+    auto start = std::chrono::steady_clock::now();
+    for (State& state : states) {
+      body(state);
+    }
+    auto stop = std::chrono::steady_clock::now();
+    clobber_memory();
+    allocations = heap_counters().allocations - before;
+    best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+  }
+
+  State state = setup();
+  reset_heap_peak();
+  const std::size_t baseline = heap_counters().current_bytes;
+  body(state);
+  const std::size_t peak = heap_counters().peak_bytes - baseline;
+
+  const double total_ops = static_cast<double>(iterations * std::max<std::size_t>(ops, 1));
+  return {best / total_ops, static_cast<double>(allocations) / total_ops, peak};
+}
+
+}  // namespace bench
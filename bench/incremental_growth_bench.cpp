@@ -0,0 +1,80 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Worst-case append latency of utils::Vector against utils::IncrementalVector.
+// Every push_back is timed on its own and the latencies are printed as a
+// power-of-two histogram with p50, p99, p99.9 and the maximum. Vector's
+// tail is the reallocations that move the whole buffer; IncrementalVector
+// spreads those moves over the following appends.
+//
+//   incremental_growth_bench [COUNT]
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include <bench/bench.hpp>
+#include <lib/incremental_vector/incremental_vector.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace {
+
+struct Pod64 {
+  std::uint64_t words[8];
+};
+
+constexpr std::size_t kBuckets = 40;
+
+template <typename Container, typename T>
+void run(const char* name, std::size_t count) {
+  // Samples are preallocated so that recording them never allocates.
+  std::vector<std::uint32_t> samples(count);
+  Container c;
+  T value{};
+  for (std::size_t i = 0; i < count; ++i) {
+    auto start = std::chrono::steady_clock::now();
+    c.push_back(value);
+    auto stop = std::chrono::steady_clock::now();
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+    samples[i] = static_cast<std::uint32_t>(std::min<long long>(ns, UINT32_MAX));
+  }
+  bench::do_not_optimize(c.size());
+
+  std::array<std::size_t, kBuckets> histogram{};
+  for (std::uint32_t ns : samples) {
+    std::size_t bucket = 0;
+    while (bucket + 1 < kBuckets && (std::uint64_t{1} << (bucket + 1)) <= ns) ++bucket;
+    ++histogram[bucket];
+  }
+  std::sort(samples.begin(), samples.end());
+  auto percentile = [&](double p) {
+    return samples[std::min(count - 1, static_cast<std::size_t>(p * static_cast<double>(count)))];
+  };
+  std::printf("%s: %zu appends  p50 %u ns  p99 %u ns  p99.9 %u ns  max %u ns\n", name, count,
+              percentile(0.5), percentile(0.99), percentile(0.999), samples.back());
+  for (std::size_t b = 0; b < kBuckets; ++b) {
+    if (histogram[b] != 0) {
+      std::printf("  [%10llu, %10llu) ns %12zu\n", 1ULL << b, 1ULL << (b + 1), histogram[b]);
+    }
+  }
+  std::fflush(stdout);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t count = std::size_t{1} << 24;
+  if (argc > 1) count = std::strtoull(argv[1], nullptr, 10);
+  if (count == 0) return 0;
+
+  run<utils::Vector<std::uint64_t>, std::uint64_t>("Vector<uint64_t>", count);
+  run<utils::IncrementalVector<std::uint64_t>, std::uint64_t>("IncrementalVector<uint64_t>",
+                                                              count);
+  run<utils::Vector<Pod64>, Pod64>("Vector<Pod64>", count / 4);
+  run<utils::IncrementalVector<Pod64>, Pod64>("IncrementalVector<Pod64>", count / 4);
+  return 0;
+}
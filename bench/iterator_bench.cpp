@@ -0,0 +1,116 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Measures std::copy and std::ranges::sort over a SIZE-element vector
+// (default: 10M uint32 values) through three iterator types:
+//   - LegacyIterator: the old Vector::Iterator, random-access only, with no
+//     iterator_concept, so the standard library cannot see it as contiguous,
+//   - utils::Vector::Iterator / ConstIterator (contiguous),
+//   - std::vector iterators as the reference.
+// Each row is the best of three runs on a fresh copy.
+//
+//   iterator_bench [SIZE]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iterator>
+#include <random>
+#include <ranges>
+#include <vector>
+
+#include <bench/bench.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace {
+
+// The pre-contiguous Vector::Iterator surface: random_access_iterator_tag
+// only, so std::copy and std::ranges algorithms take their generic loops.
+template <typename T>
+class LegacyIterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = T*;
+  using reference = T&;
+
+  LegacyIterator() = default;
+  explicit LegacyIterator(pointer obj) : current_(obj) {}
+  LegacyIterator& operator++() { ++current_; return *this; }
+  LegacyIterator operator++(int) { return LegacyIterator(current_++); }
+  LegacyIterator& operator--() { --current_; return *this; }
+  LegacyIterator operator--(int) { return LegacyIterator(current_--); }
+  LegacyIterator& operator+=(difference_type n) { current_ += n; return *this; }
+  LegacyIterator& operator-=(difference_type n) { current_ -= n; return *this; }
+  LegacyIterator operator+(difference_type n) const { return LegacyIterator(current_ + n); }
+  friend LegacyIterator operator+(difference_type n, const LegacyIterator& it) { return it + n; }
+  LegacyIterator operator-(difference_type n) const { return LegacyIterator(current_ - n); }
+  difference_type operator-(const LegacyIterator& other) const { return current_ - other.current_; }
+  reference operator*() const { return *current_; }
+  reference operator[](difference_type n) const { return current_[n]; }
+  bool operator==(const LegacyIterator& other) const = default;
+  auto operator<=>(const LegacyIterator& other) const = default;
+
+ private:
+  pointer current_ = nullptr;
+};
+
+// Best of three runs of fn(copy) in nanoseconds, not counting the copy.
+template <typename Container, typename Fn>
+double time_on_copy(const Container& original, Fn&& fn) {
+  double best = 1e300;
+  for (int run = 0; run < 3; ++run) {
+    Container copy(original);
+    auto start = std::chrono::steady_clock::now();
+    fn(copy);
+    auto stop = std::chrono::steady_clock::now();
+    bench::do_not_optimize(copy.data());
+    best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+  }
+  return best;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t size = 10'000'000;
+  if (argc > 1) size = std::strtoull(argv[1], nullptr, 10);
+
+  using Legacy = LegacyIterator<std::uint32_t>;
+  std::mt19937 rng(42);
+  utils::Vector<std::uint32_t> values(size, 0);
+  for (auto& value : values) value = static_cast<std::uint32_t>(rng());
+  const std::vector<std::uint32_t> std_values(values.begin(), values.end());
+  utils::Vector<std::uint32_t> out(size, 0);
+  std::vector<std::uint32_t> std_out(size);
+
+  std::printf("std::copy, uint32_t\n");
+  bench::report("  LegacyIterator", size, time_on_copy(out, [&](auto& dst) {
+    auto* src = const_cast<std::uint32_t*>(values.data());
+    std::copy(Legacy(src), Legacy(src + size), Legacy(dst.data()));
+  }), size);
+  bench::report("  Vector::ConstIterator", size, time_on_copy(out, [&](auto& dst) {
+    std::copy(values.cbegin(), values.cend(), dst.begin());
+  }), size);
+  bench::report("  std::ranges::copy(Vector)", size, time_on_copy(out, [&](auto& dst) {
+    std::ranges::copy(values, dst.begin());
+  }), size);
+  bench::report("  std::vector", size, time_on_copy(std_out, [&](auto& dst) {
+    std::copy(std_values.cbegin(), std_values.cend(), dst.begin());
+  }), size);
+
+  std::printf("std::ranges::sort, uint32_t\n");
+  bench::report("  LegacyIterator", size, time_on_copy(values, [&](auto& v) {
+    std::ranges::sort(Legacy(v.data()), Legacy(v.data() + v.size()));
+  }), size);
+  bench::report("  Vector", size, time_on_copy(values, [&](auto& v) {
+    std::ranges::sort(v);
+  }), size);
+  bench::report("  std::vector", size, time_on_copy(std_values, [&](auto& v) {
+    std::ranges::sort(v);
+  }), size);
+  return 0;
+}
@@ -0,0 +1,86 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Request-scoped workload: every request builds a batch of short vectors
+// and drops them all at the end. Compares std::allocator against the
+// arena, pool and polymorphic allocators from lib/memory.
+
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <string>
+
+#include <bench/bench.hpp>
+#include <lib/memory/memory.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace {
+
+constexpr std::size_t kRequests = 2'000;
+constexpr std::size_t kVectorsPerRequest = 32;
+
+template <typename Allocator>
+std::size_t handle_request(std::size_t seed, const Allocator& alloc) {
+  using Inner = utils::Vector<int, Allocator>;
+  using OuterAllocator =
+      typename std::allocator_traits<Allocator>::template rebind_alloc<Inner>;
+  utils::Vector<Inner, OuterAllocator> batch{OuterAllocator(alloc)};
+  std::size_t checksum = 0;
+  for (std::size_t v = 0; v < kVectorsPerRequest; ++v) {
+    Inner& values = batch.emplace_back(alloc);
+    const std::size_t count = 8 + (seed * 31 + v * 17) % 248;
+    for (std::size_t i = 0; i < count; ++i) {
+      values.push_back(static_cast<int>(i ^ seed));
+    }
+    checksum += values.size();
+  }
+  return checksum;
+}
+
+template <typename Setup>
+void run(const std::string& name, Setup&& setup) {
+  double ns = bench::measure_ns([&] {
+    std::size_t checksum = 0;
+    for (std::size_t r = 0; r < kRequests; ++r) {
+      checksum += setup(r);
+    }
+    bench::do_not_optimize(checksum);
+  });
+  bench::report(name, kRequests, ns, kRequests);
+}
+
+}  // namespace
+
+int main() {
+  run("std::allocator", [](std::size_t r) {
+    return handle_request(r, std::allocator<int>());
+  });
+
+  utils::memory::MonotonicArena arena;
+  run("memory::ArenaAllocator", [&arena](std::size_t r) {
+    std::size_t result = handle_request(r, utils::memory::ArenaAllocator<int>(arena));
+    arena.reset();
+    return result;
+  });
+
+  utils::memory::PoolResource pool;
+  run("memory::PoolAllocator", [&pool](std::size_t r) {
+    return handle_request(r, utils::memory::PoolAllocator<int>(pool));
+  });
+
+  utils::memory::MonotonicArena pmr_arena;
+  utils::memory::MemoryResourceAdapter adapter(pmr_arena);
+  run("pmr::Vector over MonotonicArena", [&](std::size_t r) {
+    std::size_t result = handle_request(r, std::pmr::polymorphic_allocator<int>(&adapter));
+    pmr_arena.reset();
+    return result;
+  });
+
+  std::pmr::monotonic_buffer_resource std_monotonic;
+  run("pmr::Vector over std::pmr monotonic", [&](std::size_t r) {
+    std::size_t result =
+        handle_request(r, std::pmr::polymorphic_allocator<int>(&std_monotonic));
+    std_monotonic.release();
+    return result;
+  });
+  return 0;
+}
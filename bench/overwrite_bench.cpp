@@ -0,0 +1,104 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Loads a MIB-sized file (default 1024 MiB) into a fresh char vector with
+// read(2), sized up front in four ways:
+//   - std::vector<char>(n): zero-fills n bytes, then read() overwrites them,
+//   - utils::Vector resize(n): the same zero fill,
+//   - utils::Vector(n, utils::default_init): no fill, read() writes first,
+//   - resize_and_overwrite(n, op): no fill, and the vector keeps only the
+//     byte count op reports.
+// The file is written once and normally stays in the page cache, so the
+// rows show the cost of the extra pass over memory rather than disk speed.
+// Each row is the best of three runs, including the allocation and page
+// faults of a fresh vector.
+//
+//   overwrite_bench [MIB [PATH]]
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include <bench/bench.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace {
+
+constexpr std::size_t kMiB = std::size_t{1} << 20;
+
+// Reads up to size bytes from the start of path and returns how many were
+// read.
+std::size_t read_file(const std::string& path, char* data, std::size_t size) {
+  const int fd = ::open(path.c_str(), O_RDONLY);
+  if (fd < 0) {
+    std::perror("open");
+    std::exit(1);
+  }
+  std::size_t done = 0;
+  while (done < size) {
+    const ssize_t got = ::read(fd, data + done, size - done);
+    if (got <= 0) break;
+    done += static_cast<std::size_t>(got);
+  }
+  ::close(fd);
+  return done;
+}
+
+template <typename Fn>
+void run(const char* name, std::size_t bytes, Fn&& fn) {
+  const double ns = bench::measure_ns(fn, 3);
+  std::printf("%-36s %8zu MiB %10.1f ms %8.2f GB/s\n", name, bytes / kMiB, ns / 1e6,
+              static_cast<double>(bytes) / ns);
+  std::fflush(stdout);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t mib = 1024;
+  std::string path = (std::filesystem::temp_directory_path() / "overwrite_bench.bin").string();
+  if (argc > 1) mib = std::strtoull(argv[1], nullptr, 10);
+  if (argc > 2) path = argv[2];
+  const std::size_t n = mib * kMiB;
+
+  {
+    std::FILE* out = std::fopen(path.c_str(), "wb");
+    std::vector<char> chunk(kMiB);
+    for (std::size_t i = 0; i < chunk.size(); ++i) chunk[i] = static_cast<char>(i * 131);
+    for (std::size_t i = 0; i < mib; ++i) std::fwrite(chunk.data(), 1, chunk.size(), out);
+    std::fclose(out);
+  }
+
+  run("std::vector(n) + read", n, [&] {
+    std::vector<char> data(n);
+    bench::do_not_optimize(read_file(path, data.data(), n));
+    bench::do_not_optimize(data.data());
+  });
+  run("Vector resize(n) + read", n, [&] {
+    utils::Vector<char> data;
+    data.resize(n);
+    bench::do_not_optimize(read_file(path, data.data(), n));
+    bench::do_not_optimize(data.data());
+  });
+  run("Vector(n, default_init) + read", n, [&] {
+    utils::Vector<char> data(n, utils::default_init);
+    bench::do_not_optimize(read_file(path, data.data(), n));
+    bench::do_not_optimize(data.data());
+  });
+  run("Vector resize_and_overwrite(read)", n, [&] {
+    utils::Vector<char> data;
+    data.resize_and_overwrite(n, [&](char* buffer, std::size_t size) {
+      return read_file(path, buffer, size);
+    });
+    bench::do_not_optimize(data.data());
+  });
+
+  std::filesystem::remove(path);
+  return 0;
+}
@@ -0,0 +1,117 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Memory footprint and scan throughput of SIZE (default 50M) IDs below
+// 2^BITS (default 20):
+//   - utils::Vector<uint32_t> and utils::Vector<uint64_t>, summed directly,
+//   - utils::PackedVector<BITS>, summed through operator[] and through
+//     decode() in 4096-element chunks on every supported instruction set,
+//   - utils::DeltaPackedVector over the same IDs sorted, decoded whole.
+// Each scan row is the best of five runs, reported per element.
+//
+//   packed_vector_bench [SIZE [BITS]]
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <string>
+
+#include <bench/bench.hpp>
+#include <lib/packed_vector/packed_vector.hpp>
+#include <lib/vector/vector.hpp>
+#include <lib/vector_algorithms/vector_algorithms.hpp>
+
+namespace {
+
+constexpr std::size_t kChunk = 4096;
+
+void report_memory(const char* name, std::size_t size, std::size_t bytes) {
+  std::printf("%-40s %12zu %12.3f bytes/element\n", name, size,
+              static_cast<double>(bytes) / static_cast<double>(size));
+}
+
+template <typename Container>
+std::uint64_t sum_direct(const Container& values) {
+  std::uint64_t total = 0;
+  for (std::size_t i = 0; i < values.size(); ++i) total += values[i];
+  return total;
+}
+
+template <typename Out>
+std::uint64_t sum_decoded(const utils::PackedVector<>& packed) {
+  Out buffer[kChunk];
+  std::uint64_t total = 0;
+  for (std::size_t first = 0; first < packed.size(); first += kChunk) {
+    const std::size_t count = std::min(kChunk, packed.size() - first);
+    packed.decode(first, count, buffer);
+    for (std::size_t i = 0; i < count; ++i) total += buffer[i];
+  }
+  return total;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  namespace algo = utils::algorithms;
+  std::size_t size = 50'000'000;
+  unsigned bits = 20;
+  if (argc > 1) size = std::strtoull(argv[1], nullptr, 10);
+  if (argc > 2) bits = static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10));
+  const std::uint64_t mask = bits >= 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << bits) - 1;
+
+  std::mt19937_64 rng(42);
+  utils::Vector<std::uint64_t> wide;
+  wide.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) wide.push_back(rng() & mask);
+  utils::Vector<std::uint32_t> narrow;
+  if (bits <= 32) {
+    narrow.reserve(size);
+    for (std::size_t i = 0; i < size; ++i) narrow.push_back(static_cast<std::uint32_t>(wide[i]));
+  }
+  utils::PackedVector<> packed(bits);
+  packed.append_range(wide);
+  packed.shrink_to_fit();
+
+  std::printf("%u-bit values\n", bits);
+  if (bits <= 32) report_memory("  Vector<uint32_t>", size, narrow.capacity() * 4);
+  report_memory("  Vector<uint64_t>", size, wide.capacity() * 8);
+  report_memory("  PackedVector", size, packed.memory_bytes());
+
+  std::uint64_t expected = sum_direct(wide);
+  auto scan = [&](const std::string& name, auto&& sum) {
+    std::uint64_t total = 0;
+    const double ns = bench::measure_ns([&] { total = sum(); });
+    bench::do_not_optimize(total);
+    if (total != expected) {
+      std::printf("  %s: wrong sum\n", name.c_str());
+      std::exit(1);
+    }
+    bench::report("  " + name, size, ns, size);
+  };
+  std::printf("sum scan\n");
+  if (bits <= 32) scan("Vector<uint32_t>", [&] { return sum_direct(narrow); });
+  scan("Vector<uint64_t>", [&] { return sum_direct(wide); });
+  scan("PackedVector operator[]", [&] { return sum_direct(packed); });
+  for (int isa = 0; isa <= static_cast<int>(algo::detected_isa()); ++isa) {
+    algo::set_active_isa(static_cast<algo::Isa>(isa));
+    const std::string suffix = std::string(" (") + algo::isa_name(algo::active_isa()) + ")";
+    if (bits <= 32) {
+      scan("PackedVector decode u32" + suffix, [&] { return sum_decoded<std::uint32_t>(packed); });
+    }
+    scan("PackedVector decode u64" + suffix, [&] { return sum_decoded<std::uint64_t>(packed); });
+  }
+  algo::set_active_isa(algo::detected_isa());
+
+  std::sort(wide.begin(), wide.end());
+  const auto sorted = utils::DeltaPackedVector::encode(wide);
+  std::printf("sorted %u-bit values\n", bits);
+  report_memory("  DeltaPackedVector", size, sorted.memory_bytes());
+  utils::Vector<std::uint64_t> decoded;
+  scan("DeltaPackedVector decode + sum", [&] {
+    sorted.decode(decoded);
+    return sum_direct(decoded);
+  });
+  return 0;
+}
@@ -0,0 +1,106 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Peak RSS and time to grow a vector of uint64_t by push_back from START to
+// END MiB (default 1024 to 8192), with std::allocator against
+// memory::PageAllocator, which grows through mremap. Each case runs in its
+// own process so the peak RSS readings do not mix.
+//
+//   page_allocator_bench [START_MIB END_MIB]
+
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include <bench/bench.hpp>
+#include <lib/memory/memory.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace {
+
+constexpr std::size_t kMiB = std::size_t{1} << 20;
+
+// Reads a "Name:   123 kB" line from /proc/self/status, in MiB.
+double status_mib(const std::string& field) {
+  std::ifstream status("/proc/self/status");
+  std::string line;
+  while (std::getline(status, line)) {
+    if (line.rfind(field + ":", 0) == 0) {
+      return std::strtod(line.c_str() + field.size() + 1, nullptr) / 1024.0;
+    }
+  }
+  return 0.0;
+}
+
+// Makes VmHWM restart from the current RSS (Linux 4.0+).
+void reset_peak_rss() {
+  std::ofstream clear_refs("/proc/self/clear_refs");
+  clear_refs << "5";
+}
+
+template <typename Allocator>
+void grow(const char* name, std::size_t start_mib, std::size_t end_mib) {
+  using Vector = utils::Vector<std::uint64_t, Allocator, utils::DefaultGrowth,
+                               utils::VectorStats<std::uint64_t>>;
+  const std::size_t start = start_mib * kMiB / sizeof(std::uint64_t);
+  const std::size_t end = end_mib * kMiB / sizeof(std::uint64_t);
+
+  Vector v;
+  for (std::size_t i = 0; i < start; ++i) {
+    v.push_back(i);
+  }
+  reset_peak_rss();
+  const double start_rss = status_mib("VmRSS");
+  const utils::VectorCounters before = v.stats().counters();
+
+  auto begin = std::chrono::steady_clock::now();
+  for (std::size_t i = start; i < end; ++i) {
+    v.push_back(i);
+  }
+  auto stop = std::chrono::steady_clock::now();
+  bench::do_not_optimize(v.data());
+
+  const double ms = std::chrono::duration<double, std::milli>(stop - begin).count();
+  std::printf("%-28s %6zu -> %6zu MiB  %10.1f ms  rss %8.0f -> %8.0f MiB  peak %8.0f MiB"
+              "  reallocs %3zu  copied %8zu MiB\n",
+              name, start_mib, end_mib, ms, start_rss, status_mib("VmRSS"),
+              status_mib("VmHWM"), v.stats().counters().reallocations - before.reallocations,
+              (v.stats().counters().bytes_moved - before.bytes_moved) / kMiB);
+  std::fflush(stdout);
+}
+
+template <typename Allocator>
+void run_isolated(const char* name, std::size_t start_mib, std::size_t end_mib) {
+  pid_t pid = ::fork();
+  if (pid == 0) {
+    grow<Allocator>(name, start_mib, end_mib);
+    std::_Exit(0);
+  }
+  int status = 0;
+  ::waitpid(pid, &status, 0);
+  if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+    std::printf("%-28s failed (out of memory?)\n", name);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t start_mib = 1024;
+  std::size_t end_mib = 8192;
+  if (argc == 3) {
+    start_mib = std::strtoull(argv[1], nullptr, 10);
+    end_mib = std::strtoull(argv[2], nullptr, 10);
+  }
+  run_isolated<std::allocator<std::uint64_t>>("std::allocator", start_mib, end_mib);
+  run_isolated<utils::memory::PageAllocator<std::uint64_t>>("memory::PageAllocator",
+                                                            start_mib, end_mib);
+  return 0;
+}
@@ -0,0 +1,136 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Scaling of the utils::parallel algorithms over a utils::Vector<uint64_t>
+// from one thread to MAX_THREADS (default: hardware threads), next to the
+// serial std algorithm. Sort inputs are reshuffled before every run.
+//
+//   parallel_bench [SIZE [MAX_THREADS]]
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <bench/bench.hpp>
+#include <lib/parallel/parallel.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace parallel = utils::parallel;
+
+namespace {
+
+using Values = utils::Vector<std::uint64_t>;
+
+struct Input {
+  explicit Input(std::size_t size) {
+    std::mt19937_64 rng(42);
+    for (std::size_t i = 0; i < size; ++i) {
+      shuffled.push_back(rng());
+    }
+    work = shuffled;
+    out = shuffled;
+  }
+
+  Values shuffled;
+  Values work;
+  Values out;
+};
+
+// Best of three runs in milliseconds; prepare() runs untimed before each.
+template <typename Prepare, typename Fn>
+double time_ms(Prepare&& prepare, Fn&& fn) {
+  double best = 1e300;
+  for (int i = 0; i < 3; ++i) {
+    prepare();
+    auto start = std::chrono::steady_clock::now();
+    fn();
+    auto stop = std::chrono::steady_clock::now();
+    best = std::min(best, std::chrono::duration<double, std::milli>(stop - start).count());
+  }
+  return best;
+}
+
+void report(const char* name, const std::string& threads, double ms, double serial_ms) {
+  std::printf("%-16s %8s threads %10.2f ms  speedup %5.2fx\n", name, threads.c_str(), ms,
+              serial_ms / ms);
+}
+
+struct Case {
+  const char* name;
+  std::function<void(Input&)> serial;
+  std::function<void(Input&, const parallel::Options&)> parallel;
+  bool reshuffle;
+};
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t size = std::size_t{1} << 24;
+  std::size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+  if (argc > 1) size = std::strtoull(argv[1], nullptr, 10);
+  if (argc > 2) max_threads = std::strtoull(argv[2], nullptr, 10);
+
+  auto square = [](std::uint64_t x) { return x * x; };
+  const Case cases[] = {
+      {"sort", [](Input& in) { std::sort(in.work.data(), in.work.data() + in.work.size()); },
+       [](Input& in, const parallel::Options& o) { parallel::sort(in.work, std::less<>{}, o); },
+       true},
+      {"reduce",
+       [](Input& in) {
+         bench::do_not_optimize(std::accumulate(in.work.data(), in.work.data() + in.work.size(), std::uint64_t{0}));
+       },
+       [](Input& in, const parallel::Options& o) {
+         bench::do_not_optimize(parallel::reduce(in.work, std::uint64_t{0}, std::plus<>{}, o));
+       },
+       false},
+      {"transform",
+       [square](Input& in) {
+         std::transform(in.work.data(), in.work.data() + in.work.size(), in.out.data(), square);
+       },
+       [square](Input& in, const parallel::Options& o) {
+         parallel::transform(in.work, in.out, square, o);
+       },
+       false},
+      {"inclusive_scan",
+       [](Input& in) { std::inclusive_scan(in.work.data(), in.work.data() + in.work.size(), in.out.data()); },
+       [](Input& in, const parallel::Options& o) {
+         parallel::inclusive_scan(in.work, in.out, std::plus<>{}, o);
+       },
+       false},
+      {"for_each",
+       [](Input& in) {
+         std::for_each(in.work.data(), in.work.data() + in.work.size(), [](std::uint64_t& x) { x ^= x >> 7; });
+       },
+       [](Input& in, const parallel::Options& o) {
+         parallel::for_each(in.work, [](std::uint64_t& x) { x ^= x >> 7; }, o);
+       },
+       false},
+  };
+
+  std::printf("%zu elements, up to %zu threads\n", size, max_threads);
+  Input input(size);
+  for (const Case& c : cases) {
+    auto prepare = [&] {
+      if (c.reshuffle) std::copy(input.shuffled.data(), input.shuffled.data() + size, input.work.data());
+    };
+    const double serial_ms = time_ms(prepare, [&] { c.serial(input); });
+    report(c.name, "std", serial_ms, serial_ms);
+    for (std::size_t threads = 1;; threads = std::min(threads * 2, max_threads)) {
+      parallel::ThreadPool pool(threads);
+      parallel::Options options;
+      options.pool = &pool;
+      report(c.name, std::to_string(threads),
+             time_ms(prepare, [&] { c.parallel(input, options); }), serial_ms);
+      if (threads == max_threads) break;
+    }
+  }
+  return 0;
+}
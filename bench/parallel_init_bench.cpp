@@ -0,0 +1,78 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Time to initialize a large utils::Vector<uint64_t> (default 4096 MiB)
+// serially and with utils::parallel::par: fill construction, resize and
+// copy construction. The page faults of the fresh buffer are part of the
+// measurement, since first touch is what decides page placement. Copies
+// use half the size so that source and copy fit together.
+//
+//   parallel_init_bench [MIB]
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+
+#include <bench/bench.hpp>
+#include <lib/parallel/parallel.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace parallel = utils::parallel;
+
+namespace {
+
+using Values = utils::Vector<std::uint64_t>;
+
+constexpr std::size_t kMiB = std::size_t{1} << 20;
+
+template <typename Fn>
+void run(const char* name, std::size_t bytes, Fn&& fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto stop = std::chrono::steady_clock::now();
+  const double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+  std::printf("%-24s %8zu MiB %10.1f ms %8.2f GB/s\n", name, bytes / kMiB, ms,
+              static_cast<double>(bytes) / ms / 1e6);
+  std::fflush(stdout);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t mib = 4096;
+  if (argc > 1) mib = std::strtoull(argv[1], nullptr, 10);
+  const std::size_t n = mib * kMiB / sizeof(std::uint64_t);
+  std::printf("%u hardware threads\n", std::thread::hardware_concurrency());
+
+  run("fill serial", n * 8, [n] {
+    Values v(n, 1);
+    bench::do_not_optimize(v.data());
+  });
+  run("fill par", n * 8, [n] {
+    Values v(parallel::par, n, 1);
+    bench::do_not_optimize(v.data());
+  });
+  run("resize serial", n * 8, [n] {
+    Values v;
+    v.resize(n, 2);
+    bench::do_not_optimize(v.data());
+  });
+  run("resize par", n * 8, [n] {
+    Values v;
+    v.resize(parallel::par, n, 2);
+    bench::do_not_optimize(v.data());
+  });
+
+  const Values source(parallel::par, n / 2, 3);
+  run("copy serial", n / 2 * 8, [&source] {
+    Values v(source);
+    bench::do_not_optimize(v.data());
+  });
+  run("copy par", n / 2 * 8, [&source] {
+    Values v(parallel::par, source);
+    bench::do_not_optimize(v.data());
+  });
+  return 0;
+}
@@ -0,0 +1,88 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Growth and middle-insert cost by element type, showing the bytewise
+// relocation path against element-wise moves.
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <bench/bench.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace {
+
+struct Pod64 {
+  Pod64(std::size_t v = 0) { data[0] = v; }
+  std::size_t data[8]{};
+};
+
+struct Handle {
+  Handle(std::size_t v = 0) : value(std::make_unique<std::size_t>(v)) {}
+  std::unique_ptr<std::size_t> value;
+};
+
+}  // namespace
+
+template <>
+struct utils::is_trivially_relocatable<Handle> : std::true_type {};
+
+namespace {
+
+template <typename T>
+T make(std::size_t i) {
+  if constexpr (std::is_same_v<T, std::string>) {
+    return std::string(32, static_cast<char>('a' + i % 26));
+  } else {
+    return T(i);
+  }
+}
+
+template <typename Container>
+void growth(const std::string& name, std::size_t size) {
+  double ns = bench::measure_ns([size] {
+    Container c;
+    for (std::size_t i = 0; i < size; ++i) {
+      c.push_back(make<typename Container::value_type>(i));
+    }
+    bench::do_not_optimize(c.data());
+  });
+  bench::report(name + " growth", size, ns, size);
+}
+
+template <typename Container>
+void middle_insert(const std::string& name, std::size_t size) {
+  constexpr std::size_t kInserts = 64;
+  Container c;
+  for (std::size_t i = 0; i < size; ++i) {
+    c.push_back(make<typename Container::value_type>(i));
+  }
+  double ns = bench::measure_ns([&c] {
+    for (std::size_t i = 0; i < kInserts; ++i) {
+      c.insert(c.begin() + c.size() / 2, make<typename Container::value_type>(i));
+    }
+    bench::do_not_optimize(c.data());
+  }, 3);
+  bench::report(name + " middle insert", size, ns, kInserts);
+}
+
+template <typename T>
+void run_type(const std::string& type_name, std::size_t size) {
+  growth<std::vector<T>>("std::vector<" + type_name + ">", size);
+  growth<utils::Vector<T>>("utils::Vector<" + type_name + ">", size);
+  middle_insert<std::vector<T>>("std::vector<" + type_name + ">", size);
+  middle_insert<utils::Vector<T>>("utils::Vector<" + type_name + ">", size);
+}
+
+}  // namespace
+
+int main() {
+  for (std::size_t size : {10'000, 1'000'000}) {
+    run_type<int>("int", size);
+    run_type<Pod64>("Pod64", size);
+    run_type<std::string>("string", size);
+    run_type<Handle>("Handle", size);
+  }
+  return 0;
+}
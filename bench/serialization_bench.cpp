@@ -0,0 +1,88 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Save and load throughput of utils::save/utils::load for a vector of
+// uint64_t (default 1024 MiB), next to the element-at-a-time std::ofstream /
+// std::ifstream code they replace, plus utils::VectorReader with a 16 MiB
+// window. The file normally stays in the page cache, so these numbers show
+// the per-byte CPU cost rather than disk speed.
+//
+//   serialization_bench [MIB [PATH]]
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+
+#include <bench/bench.hpp>
+#include <lib/serialization/serialization.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace {
+
+using Values = utils::Vector<std::uint64_t>;
+
+constexpr std::size_t kMiB = std::size_t{1} << 20;
+
+template <typename Fn>
+void run(const char* name, std::size_t bytes, Fn&& fn) {
+  auto start = std::chrono::steady_clock::now();
+  fn();
+  auto stop = std::chrono::steady_clock::now();
+  const double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+  std::printf("%-26s %8zu MiB %10.1f ms %8.2f GB/s\n", name, bytes / kMiB, ms,
+              static_cast<double>(bytes) / ms / 1e6);
+  std::fflush(stdout);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t mib = 1024;
+  std::string path = (std::filesystem::temp_directory_path() / "serialization_bench.bin").string();
+  if (argc > 1) mib = std::strtoull(argv[1], nullptr, 10);
+  if (argc > 2) path = argv[2];
+  const std::size_t n = mib * kMiB / sizeof(std::uint64_t);
+  const std::size_t bytes = n * sizeof(std::uint64_t);
+
+  Values values(n, 0);
+  for (std::size_t i = 0; i < n; ++i) values[i] = i * 0x9E3779B97F4A7C15ULL;
+
+  run("ofstream per element", bytes, [&] {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    for (std::size_t i = 0; i < n; ++i) {
+      out.write(reinterpret_cast<const char*>(&values[i]), sizeof(std::uint64_t));
+    }
+  });
+  run("ifstream per element", bytes, [&] {
+    std::ifstream in(path, std::ios::binary);
+    Values loaded;
+    std::uint64_t value;
+    while (in.read(reinterpret_cast<char*>(&value), sizeof(value))) loaded.push_back(value);
+    bench::do_not_optimize(loaded.data());
+  });
+
+  run("utils::save", bytes, [&] { utils::save(path, values); });
+  run("utils::load", bytes, [&] {
+    Values loaded;
+    utils::load(path, loaded);
+    bench::do_not_optimize(loaded.data());
+  });
+  run("utils::load into reserved", bytes, [&] {
+    utils::load(path, values);
+    bench::do_not_optimize(values.data());
+  });
+  run("VectorReader 16 MiB", bytes, [&] {
+    utils::VectorReader<std::uint64_t> reader(path);
+    Values window;
+    std::uint64_t sum = 0;
+    while (reader.next(window, 16 * kMiB / sizeof(std::uint64_t))) sum += window[0];
+    bench::do_not_optimize(sum);
+  });
+
+  std::filesystem::remove(path);
+  return 0;
+}
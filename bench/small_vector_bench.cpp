@@ -0,0 +1,65 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Heap allocations and time for short-lived, mostly small vectors.
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string>
+#include <vector>
+
+#include <bench/bench.hpp>
+#include <lib/small_vector/small_vector.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace {
+
+std::size_t allocation_count = 0;
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  ++allocation_count;
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+constexpr std::size_t kRequests = 100'000;
+
+template <typename Container>
+void run(const std::string& name, std::size_t elements) {
+  std::size_t allocations = 0;
+  double ns = bench::measure_ns([&] {
+    const std::size_t before = allocation_count;
+    for (std::size_t r = 0; r < kRequests; ++r) {
+      Container c;
+      for (std::size_t i = 0; i < elements; ++i) {
+        c.push_back(static_cast<int>(i + r));
+      }
+      bench::do_not_optimize(c.data());
+    }
+    allocations = allocation_count - before;
+  });
+  bench::report(name, elements, ns, kRequests);
+  std::printf("%-40s %12zu %12.3f allocs/op\n", "", elements,
+              static_cast<double>(allocations) / kRequests);
+}
+
+}  // namespace
+
+int main() {
+  for (std::size_t elements : {4, 8, 16, 32}) {
+    run<std::vector<int>>("std::vector", elements);
+    run<utils::Vector<int>>("utils::Vector", elements);
+    run<utils::SmallVector<int, 16>>("utils::SmallVector<16>", elements);
+  }
+  return 0;
+}
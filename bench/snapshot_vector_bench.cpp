@@ -0,0 +1,159 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Lookup throughput of READERS threads (default: hardware threads) reading
+// random elements of a 1M-element table for MILLIS milliseconds (default:
+// 500) while one writer changes four elements and publishes them every
+// 100 us. Compares
+//   - a utils::Vector behind a std::shared_mutex (shared lock per lookup,
+//     writer copies the table and swaps it in under the exclusive lock),
+//   - utils::SnapshotVector with snapshot() per lookup, and
+//   - utils::SnapshotVector with one Reader per thread.
+//
+//   snapshot_vector_bench [READERS [MILLIS]]
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+#include <vector>
+
+#include <bench/bench.hpp>
+#include <lib/snapshot_vector/snapshot_vector.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace {
+
+constexpr std::size_t kSize = std::size_t{1} << 20;
+constexpr std::size_t kTouched = 4;
+
+std::uint64_t next_random(std::uint64_t& state) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+struct Result {
+  double lookups_per_second;
+  double commits_per_second;
+};
+
+// Runs `readers` threads summing read(thread, state) in a loop and one
+// thread calling write(state) every 100 us, for `millis` milliseconds.
+template <typename Read, typename Write>
+Result run(std::size_t readers, std::size_t millis, Read&& read, Write&& write) {
+  std::atomic<bool> stop{false};
+  std::vector<std::uint64_t> lookups(readers);
+  std::uint64_t commits = 0;
+
+  std::vector<std::thread> threads;
+  for (std::size_t t = 0; t < readers; ++t) {
+    threads.emplace_back([&, t] {
+      std::uint64_t state = 0x9E3779B97F4A7C15ull + t;
+      std::uint64_t count = 0;
+      std::uint64_t sum = 0;
+      while (!stop.load(std::memory_order_relaxed)) {
+        for (int i = 0; i < 256; ++i) sum += read(t, state);
+        count += 256;
+      }
+      bench::do_not_optimize(sum);
+      lookups[t] = count;
+    });
+  }
+  threads.emplace_back([&] {
+    std::uint64_t state = 0xD1B54A32D192ED03ull;
+    while (!stop.load(std::memory_order_relaxed)) {
+      write(state);
+      ++commits;
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+  });
+
+  auto start = std::chrono::steady_clock::now();
+  std::this_thread::sleep_for(std::chrono::milliseconds(millis));
+  stop.store(true);
+  for (std::thread& thread : threads) thread.join();
+  const double seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  std::uint64_t total = 0;
+  for (std::uint64_t count : lookups) total += count;
+  return {static_cast<double>(total) / seconds, static_cast<double>(commits) / seconds};
+}
+
+void print(const char* name, const Result& result) {
+  std::printf("  %-28s %10.1f Mlookups/s %10.0f commits/s\n", name,
+              result.lookups_per_second / 1e6, result.commits_per_second);
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t readers = std::max(1u, std::thread::hardware_concurrency());
+  std::size_t millis = 500;
+  if (argc > 1) readers = std::strtoull(argv[1], nullptr, 10);
+  if (argc > 2) millis = std::strtoull(argv[2], nullptr, 10);
+
+  utils::Vector<std::uint64_t> initial;
+  initial.reserve(kSize);
+  for (std::size_t i = 0; i < kSize; ++i) initial.push_back(i);
+
+  std::printf("%zu elements, %zu readers, %zu elements per commit, %zu ms\n", kSize, readers,
+              kTouched, millis);
+
+  {
+    std::shared_mutex mutex;
+    utils::Vector<std::uint64_t> table(initial);
+    print("shared_mutex+Vector",
+          run(
+              readers, millis,
+              [&](std::size_t, std::uint64_t& state) {
+                std::shared_lock lock(mutex);
+                return table[next_random(state) & (kSize - 1)];
+              },
+              [&](std::uint64_t& state) {
+                utils::Vector<std::uint64_t> next;
+                {
+                  std::shared_lock lock(mutex);
+                  next = table;
+                }
+                for (std::size_t k = 0; k < kTouched; ++k) ++next[next_random(state) & (kSize - 1)];
+                std::unique_lock lock(mutex);
+                table.swap(next);
+              }));
+  }
+
+  utils::SnapshotVector<std::uint64_t> snapshots(initial);
+  const auto write = [&](std::uint64_t& state) {
+    snapshots.update([&](auto& editor) {
+      for (std::size_t k = 0; k < kTouched; ++k) ++editor[next_random(state) & (kSize - 1)];
+    });
+  };
+  {
+    print("SnapshotVector::snapshot()",
+          run(
+              readers, millis,
+              [&](std::size_t, std::uint64_t& state) {
+                return snapshots.snapshot()[next_random(state) & (kSize - 1)];
+              },
+              write));
+  }
+  {
+    std::vector<utils::SnapshotVector<std::uint64_t>::Reader> handles;
+    for (std::size_t t = 0; t < readers; ++t) handles.emplace_back(snapshots);
+    print("SnapshotVector::Reader",
+          run(
+              readers, millis,
+              [&](std::size_t t, std::uint64_t& state) {
+                return handles[t].current()[next_random(state) & (kSize - 1)];
+              },
+              write));
+  }
+  return 0;
+}
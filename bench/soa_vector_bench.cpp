@@ -0,0 +1,111 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Passes that read one or two fields of a 64-byte, 8-field record, over an
+// array of structs (utils::Vector<Record>) and over utils::SoAVector with
+// the same fields, plain loops and utils::algorithms kernels on the field
+// spans. Default size: 2^23 records, 512 MiB per layout.
+//
+//   soa_vector_bench [SIZE]
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <span>
+
+#include <bench/bench.hpp>
+#include <lib/soa_vector/soa_vector.hpp>
+#include <lib/vector/vector.hpp>
+#include <lib/vector_algorithms/vector_algorithms.hpp>
+
+namespace algo = utils::algorithms;
+
+namespace {
+
+struct Record {
+  std::int64_t id;
+  double price;
+  double quantity;
+  double fee;
+  std::int64_t account;
+  std::int64_t timestamp;
+  double bid;
+  double ask;
+};
+static_assert(sizeof(Record) == 64);
+
+using Records = utils::SoAVector<std::int64_t, double, double, double, std::int64_t,
+                                 std::int64_t, double, double>;
+
+enum Field : std::size_t { kId, kPrice, kQuantity, kFee, kAccount, kTimestamp, kBid, kAsk };
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::size_t size = std::size_t{1} << 23;
+  if (argc > 1) size = std::strtoull(argv[1], nullptr, 10);
+
+  utils::Vector<Record> aos;
+  Records soa;
+  aos.reserve(size);
+  soa.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    const auto n = static_cast<std::int64_t>(i);
+    const Record r{n, 100.0 + static_cast<double>(i % 1000) * 0.01,
+                   static_cast<double>(i % 17), 0.5, n % 1024, n * 1000, 99.5, 100.5};
+    aos.push_back(r);
+    soa.push_back(r);
+  }
+  const std::span<const double> prices = soa.get<kPrice>();
+  const std::span<const double> quantities = soa.get<kQuantity>();
+  const std::span<const std::int64_t> accounts = soa.get<kAccount>();
+
+  std::printf("%zu records of %zu bytes\n", size, sizeof(Record));
+  bench::report("sum(price) AoS loop", size, bench::measure_ns([&] {
+                  double total = 0;
+                  for (std::size_t i = 0; i < size; ++i) total += aos[i].price;
+                  bench::do_not_optimize(total);
+                }),
+                size);
+  bench::report("sum(price) SoA loop", size, bench::measure_ns([&] {
+                  double total = 0;
+                  for (double price : prices) total += price;
+                  bench::do_not_optimize(total);
+                }),
+                size);
+  bench::report("sum(price) SoA algorithms::sum", size,
+                bench::measure_ns([&] { bench::do_not_optimize(algo::sum(prices)); }), size);
+
+  bench::report("price*quantity AoS loop", size, bench::measure_ns([&] {
+                  double total = 0;
+                  for (std::size_t i = 0; i < size; ++i) total += aos[i].price * aos[i].quantity;
+                  bench::do_not_optimize(total);
+                }),
+                size);
+  bench::report("price*quantity SoA loop", size, bench::measure_ns([&] {
+                  double total = 0;
+                  for (std::size_t i = 0; i < size; ++i) total += prices[i] * quantities[i];
+                  bench::do_not_optimize(total);
+                }),
+                size);
+  bench::report("price*quantity SoA algorithms::dot", size,
+                bench::measure_ns([&] { bench::do_not_optimize(algo::dot(prices, quantities)); }),
+                size);
+
+  bench::report("count(account == 7) AoS loop", size, bench::measure_ns([&] {
+                  std::size_t hits = 0;
+                  for (std::size_t i = 0; i < size; ++i) hits += aos[i].account == 7;
+                  bench::do_not_optimize(hits);
+                }),
+                size);
+  bench::report("count(account == 7) SoA loop", size, bench::measure_ns([&] {
+                  std::size_t hits = 0;
+                  for (std::int64_t account : accounts) hits += account == 7;
+                  bench::do_not_optimize(hits);
+                }),
+                size);
+  bench::report("count(account == 7) SoA algorithms", size,
+                bench::measure_ns([&] { bench::do_not_optimize(algo::count(accounts, 7)); }),
+                size);
+  return 0;
+}
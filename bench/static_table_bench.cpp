@@ -0,0 +1,106 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Startup cost of lookup tables: a CRC-32 table and the primes below 2^16,
+// filled at run time into utils::Vector as a program would do during
+// initialisation, against the same tables built during constant
+// evaluation into utils::StaticVector, which cost nothing at run time. The
+// prime sieve runs on a transient utils::Vector<bool> in both cases.
+//
+//   static_table_bench
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+#include <bench/bench.hpp>
+#include <lib/static_vector/static_vector.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace {
+
+constexpr std::uint32_t kPrimeLimit = 1 << 16;
+constexpr std::size_t kPrimeCount = 6542;
+
+template <typename Table>
+constexpr void fill_crc32(Table& table) {
+  for (std::uint32_t i = 0; i < 256; ++i) {
+    std::uint32_t crc = i;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc >> 1) ^ (0xEDB88320u & (0u - (crc & 1u)));
+    }
+    table.push_back(crc);
+  }
+}
+
+template <typename Table>
+constexpr void fill_primes(Table& table) {
+  utils::Vector<bool> composite(kPrimeLimit, false);
+  for (std::uint32_t n = 2; n < kPrimeLimit; ++n) {
+    if (composite[n]) continue;
+    table.push_back(n);
+    for (std::uint32_t multiple = n * n; multiple < kPrimeLimit; multiple += n) {
+      composite[multiple] = true;
+    }
+  }
+}
+
+constexpr auto kCrc32 = [] {
+  utils::StaticVector<std::uint32_t, 256> table;
+  fill_crc32(table);
+  return table;
+}();
+
+constexpr auto kPrimes = [] {
+  utils::StaticVector<std::uint32_t, kPrimeCount> table;
+  fill_primes(table);
+  return table;
+}();
+static_assert(kPrimes.full() && kPrimes.back() == 65521);
+static_assert(kCrc32[1] == 0x77073096u && kCrc32[255] == 0x2D02EF8Du);
+
+template <typename A, typename B>
+bool same(const A& a, const B& b) {
+  if (a.size() != b.size()) return false;
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    if (a[i] != b[i]) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
+int main() {
+  utils::Vector<std::uint32_t> crc32;
+  utils::Vector<std::uint32_t> primes;
+  fill_crc32(crc32);
+  fill_primes(primes);
+  if (!same(crc32, kCrc32) || !same(primes, kPrimes)) {
+    std::printf("tables differ\n");
+    return 1;
+  }
+
+  const double crc_ns = bench::measure_ns([] {
+    utils::Vector<std::uint32_t> table;
+    fill_crc32(table);
+    bench::do_not_optimize(table.data());
+  });
+  bench::report("crc32 runtime utils::Vector", 256, crc_ns, 1);
+  const double primes_ns = bench::measure_ns([] {
+    utils::Vector<std::uint32_t> table;
+    fill_primes(table);
+    bench::do_not_optimize(table.data());
+  });
+  bench::report("primes runtime utils::Vector", kPrimeCount, primes_ns, 1);
+
+  // The constexpr tables are part of the binary's read-only data; reading
+  // them once stands in for their startup cost.
+  const double static_ns = bench::measure_ns([] {
+    std::uint32_t sum = 0;
+    for (std::uint32_t x : kCrc32) sum += x;
+    for (std::uint32_t x : kPrimes) sum += x;
+    bench::do_not_optimize(sum);
+  });
+  bench::report("crc32 + primes constexpr StaticVector", 256 + kPrimeCount, static_ns, 1);
+  std::printf("startup saved: %.1f us\n", (crc_ns + primes_ns - static_ns) / 1000.0);
+  return 0;
+}
@@ -0,0 +1,116 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Throughput of the utils::algorithms kernels on utils::Vector, per element
+// type and instruction set, against the std algorithm doing the same work.
+// Sizes are chosen to sit in L1, L2 and main memory.
+//
+//   vector_algorithms_bench [SIZE...]
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <string>
+#include <vector>
+
+#include <bench/bench.hpp>
+#include <lib/vector/vector.hpp>
+#include <lib/vector_algorithms/vector_algorithms.hpp>
+
+namespace algo = utils::algorithms;
+
+namespace {
+
+template <typename T>
+const char* type_name() {
+  if constexpr (std::is_same_v<T, float>) {
+    return "float";
+  } else if constexpr (std::is_same_v<T, double>) {
+    return "double";
+  } else if constexpr (std::is_same_v<T, std::int32_t>) {
+    return "int32";
+  } else {
+    return "int64";
+  }
+}
+
+// Runs fn enough times to touch about 1 GiB and prints GB/s read.
+template <typename Fn>
+void run(const std::string& name, const char* impl, std::size_t bytes, Fn&& fn) {
+  const std::size_t rounds = std::max<std::size_t>(1, (std::size_t{1} << 30) / bytes);
+  double ns = bench::measure_ns([&] {
+    for (std::size_t r = 0; r < rounds; ++r) {
+      fn();
+      bench::clobber_memory();
+    }
+  });
+  std::printf("%-22s %-8s %12zu bytes %8.2f GB/s\n", name.c_str(), impl, bytes,
+              static_cast<double>(bytes * rounds) / ns);
+}
+
+template <typename T>
+void bench_type(std::size_t size) {
+  utils::Vector<T> a;
+  utils::Vector<T> b;
+  for (std::size_t i = 0; i < size; ++i) {
+    a.push_back(static_cast<T>(i % 1000));
+    b.push_back(static_cast<T>((i * 7) % 1000));
+  }
+  const T missing = static_cast<T>(-1);
+  const std::size_t bytes = size * sizeof(T);
+  const std::string type = type_name<T>();
+
+  run(type + " find", "std", bytes, [&] {
+    bench::do_not_optimize(std::find(a.begin(), a.end(), missing));
+  });
+  run(type + " count", "std", bytes, [&] {
+    bench::do_not_optimize(std::count(a.begin(), a.end(), missing));
+  });
+  run(type + " min", "std", bytes, [&] {
+    bench::do_not_optimize(std::min_element(a.begin(), a.end()));
+  });
+  run(type + " sum", "std", bytes, [&] {
+    bench::do_not_optimize(std::accumulate(a.begin(), a.end(), algo::accumulator_t<T>{}));
+  });
+  run(type + " dot", "std", 2 * bytes, [&] {
+    bench::do_not_optimize(
+        std::inner_product(a.begin(), a.end(), b.begin(), algo::accumulator_t<T>{}));
+  });
+  run(type + " clamp", "std", bytes, [&] {
+    std::transform(a.begin(), a.end(), a.begin(),
+                   [](T x) { return std::clamp(x, T{100}, T{900}); });
+  });
+
+  for (int i = 0; i <= static_cast<int>(algo::detected_isa()); ++i) {
+    const auto isa = static_cast<algo::Isa>(i);
+    algo::set_active_isa(isa);
+    const char* impl = algo::isa_name(isa);
+    run(type + " find", impl, bytes, [&] { bench::do_not_optimize(algo::find(a, missing)); });
+    run(type + " count", impl, bytes, [&] { bench::do_not_optimize(algo::count(a, missing)); });
+    run(type + " min", impl, bytes, [&] { bench::do_not_optimize(algo::min(a)); });
+    run(type + " sum", impl, bytes, [&] { bench::do_not_optimize(algo::sum(a)); });
+    run(type + " dot", impl, 2 * bytes, [&] { bench::do_not_optimize(algo::dot(a, b)); });
+    run(type + " clamp", impl, bytes, [&] { algo::clamp(a, T{100}, T{900}); });
+  }
+  algo::set_active_isa(algo::detected_isa());
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  std::vector<std::size_t> sizes = {4096, 65536, std::size_t{1} << 24};
+  if (argc > 1) {
+    sizes.clear();
+    for (int i = 1; i < argc; ++i) sizes.push_back(std::strtoull(argv[i], nullptr, 10));
+  }
+  std::printf("detected instruction set: %s\n", algo::isa_name(algo::detected_isa()));
+  for (std::size_t size : sizes) {
+    bench_type<float>(size);
+    bench_type<double>(size);
+    bench_type<std::int32_t>(size);
+    bench_type<std::int64_t>(size);
+  }
+  return 0;
+}
@@ -0,0 +1,199 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// utils::Vector against std::vector across the common operations, element
+// types and sizes. Prints JSON (ns/op, allocations/op, peak heap bytes) to
+// stdout, or to the file named by the first argument.
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <bench/bench.hpp>
+#include <bench/harness.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace {
+
+struct Pod64 {
+  std::array<std::uint64_t, 8> words;
+};
+static_assert(sizeof(Pod64) == 64);
+
+using MoveOnly = std::unique_ptr<std::uint64_t>;
+
+template <typename T>
+T make_value(std::size_t i) {
+  if constexpr (std::is_same_v<T, int>) {
+    return static_cast<int>(i);
+  } else if constexpr (std::is_same_v<T, Pod64>) {
+    Pod64 pod{};
+    pod.words[0] = i;
+    return pod;
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    // Longer than the small-string buffer, so every element owns heap memory.
+    return std::string(32, static_cast<char>('a' + i % 26));
+  } else {
+    return std::make_unique<std::uint64_t>(i);
+  }
+}
+
+template <typename T>
+std::uint64_t weigh(const T& value) {
+  if constexpr (std::is_same_v<T, int>) {
+    return static_cast<std::uint64_t>(value);
+  } else if constexpr (std::is_same_v<T, Pod64>) {
+    return value.words[0];
+  } else if constexpr (std::is_same_v<T, std::string>) {
+    return value.size();
+  } else {
+    return *value;
+  }
+}
+
+template <typename Container>
+Container make_filled(std::size_t size) {
+  using T = typename Container::value_type;
+  Container c;
+  c.reserve(size);
+  for (std::size_t i = 0; i < size; ++i) {
+    c.push_back(make_value<T>(i));
+  }
+  return c;
+}
+
+struct Empty {};
+
+class Suite {
+ public:
+  explicit Suite(bench::JsonReport& report) : report_(report) {}
+
+  template <typename Container>
+  void run(const std::string& container, const std::string& type, std::size_t size);
+
+ private:
+  void add(const std::string& name, const std::string& container,
+           const std::string& type, std::size_t size, const bench::Sample& sample) {
+    this->report_.add({name, container, type, size, sample.ns_per_op,
+                       sample.allocations_per_op, sample.peak_bytes});
+  }
+
+  bench::JsonReport& report_;
+};
+
+template <typename Container>
+void Suite::run(const std::string& container, const std::string& type,
+                std::size_t size) {
+  using T = typename Container::value_type;
+  auto empty = [] { return Empty{}; };
+  auto filled = [size] { return make_filled<Container>(size); };
+
+  this->add("push_back", container, type, size,
+            bench::measure(size, empty, [size](Empty&) {
+              Container c;
+              for (std::size_t i = 0; i < size; ++i) {
+                c.push_back(make_value<T>(i));
+              }
+              bench::do_not_optimize(c.data());
+            }));
+
+  this->add("emplace_back", container, type, size,
+            bench::measure(size, empty, [size](Empty&) {
+              Container c;
+              for (std::size_t i = 0; i < size; ++i) {
+                c.emplace_back(make_value<T>(i));
+              }
+              bench::do_not_optimize(c.data());
+            }));
+
+  this->add("reserve_fill", container, type, size,
+            bench::measure(size, empty, [size](Empty&) {
+              Container c;
+              c.reserve(size);
+              for (std::size_t i = 0; i < size; ++i) {
+                c.push_back(make_value<T>(i));
+              }
+              bench::do_not_optimize(c.data());
+            }));
+
+  if constexpr (std::copy_constructible<T>) {
+    this->add("copy_construct", container, type, size,
+              bench::measure(size, filled, [](Container& source) {
+                Container copy(source);
+                bench::do_not_optimize(copy.data());
+              }));
+  }
+
+  this->add("move_construct", container, type, size,
+            bench::measure(1, filled, [](Container& source) {
+              Container moved(std::move(source));
+              bench::do_not_optimize(moved.data());
+            }));
+
+  // Inserts and then erases the same number of elements in the middle so
+  // the container is back to its original size for the next round.
+  const std::size_t edits = std::min<std::size_t>(size, 64);
+  this->add("insert_erase_middle", container, type, size,
+            bench::measure(2 * edits, filled, [edits](Container& c) {
+              for (std::size_t i = 0; i < edits; ++i) {
+                c.insert(c.begin() + static_cast<std::ptrdiff_t>(c.size() / 2),
+                         make_value<T>(i));
+              }
+              for (std::size_t i = 0; i < edits; ++i) {
+                c.erase(c.begin() + static_cast<std::ptrdiff_t>(c.size() / 2));
+              }
+              bench::do_not_optimize(c.data());
+            }));
+
+  this->add("iterate", container, type, size,
+            bench::measure(size, filled, [](Container& c) {
+              std::uint64_t sum = 0;
+              for (const T& value : c) {
+                sum += weigh(value);
+              }
+              bench::do_not_optimize(sum);
+            }));
+
+  this->add("shrink_to_fit", container, type, size,
+            bench::measure(size,
+                           [size] {
+                             Container c = make_filled<Container>(size);
+                             c.reserve(2 * size);
+                             return c;
+                           },
+                           [](Container& c) {
+                             c.shrink_to_fit();
+                             bench::do_not_optimize(c.data());
+                           }));
+}
+
+template <typename T>
+void run_type(Suite& suite, const std::string& type) {
+  for (std::size_t size : {16, 1024, 65536}) {
+    suite.run<std::vector<T>>("std::vector", type, size);
+    suite.run<utils::Vector<T>>("utils::Vector", type, size);
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  bench::JsonReport report("vector_bench");
+  Suite suite(report);
+  run_type<int>(suite, "int");
+  run_type<Pod64>(suite, "pod64");
+  run_type<std::string>(suite, "string");
+  run_type<MoveOnly>(suite, "move_only");
+  const std::string path = argc > 1 ? argv[1] : "";
+  if (!report.write(path)) {
+    std::fprintf(stderr, "cannot write %s\n", path.c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,244 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Word kernels are written once, with GCC/Clang vector extensions for the
+// bitwise ones, and get thin per-target entry points as in
+// lib/vector_algorithms. The AVX2 and AVX-512 entry points also enable
+// popcnt, which every CPU with those instruction sets has; the scalar ones
+// fall back to the compiler's portable popcount.
+
+#include "bit_vector.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include <lib/vector_algorithms/vector_algorithms.hpp>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define UTILS_BITS_X86 1
+#else
+#define UTILS_BITS_X86 0
+#endif
+
+namespace utils {
+
+namespace bits {
+
+namespace {
+
+template <std::size_t Bytes>
+struct WordsOf {
+  typedef std::uint64_t type __attribute__((vector_size(Bytes)));
+};
+
+enum class Op { kAnd, kOr, kXor, kAndNot };
+
+// Updates a in place and takes b by reference: a vector passed or returned
+// by value has a different ABI with and without AVX/AVX-512, and this
+// helper is shared by every target.
+template <Op op, typename W>
+[[gnu::always_inline]] inline void apply(W& a, const W& b) {
+  if constexpr (op == Op::kAnd) {
+    a &= b;
+  } else if constexpr (op == Op::kOr) {
+    a |= b;
+  } else if constexpr (op == Op::kXor) {
+    a ^= b;
+  } else {
+    a &= ~b;
+  }
+}
+
+// Kernels. Bytes is the vector width, 0 for scalar code.
+
+template <Op op, std::size_t Bytes>
+[[gnu::always_inline]] inline void combine_kernel(std::uint64_t* dst, const std::uint64_t* src,
+                                                  std::size_t n) {
+  std::size_t i = 0;
+  if constexpr (Bytes != 0) {
+    using V = typename WordsOf<Bytes>::type;
+    constexpr std::size_t kLanes = Bytes / 8;
+    for (; i + kLanes <= n; i += kLanes) {
+      V a;
+      V b;
+      std::memcpy(&a, dst + i, sizeof(V));
+      std::memcpy(&b, src + i, sizeof(V));
+      apply<op>(a, b);
+      std::memcpy(dst + i, &a, sizeof(V));
+    }
+  }
+  for (; i < n; ++i) {
+    apply<op>(dst[i], src[i]);
+  }
+}
+
+template <std::size_t Bytes>
+[[gnu::always_inline]] inline void not_kernel(std::uint64_t* dst, std::size_t n) {
+  std::size_t i = 0;
+  if constexpr (Bytes != 0) {
+    using V = typename WordsOf<Bytes>::type;
+    constexpr std::size_t kLanes = Bytes / 8;
+    for (; i + kLanes <= n; i += kLanes) {
+      V a;
+      std::memcpy(&a, dst + i, sizeof(V));
+      a = ~a;
+      std::memcpy(dst + i, &a, sizeof(V));
+    }
+  }
+  for (; i < n; ++i) {
+    dst[i] = ~dst[i];
+  }
+}
+
+// Four independent sums keep several popcounts in flight.
+template <bool And>
+[[gnu::always_inline]] inline std::size_t popcount_kernel(const std::uint64_t* a,
+                                                          const std::uint64_t* b, std::size_t n) {
+  auto word = [&](std::size_t i) { return And ? a[i] & b[i] : a[i]; };
+  std::size_t sums[4] = {};
+  std::size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    for (std::size_t k = 0; k < 4; ++k) {
+      sums[k] += static_cast<std::size_t>(std::popcount(word(i + k)));
+    }
+  }
+  for (; i < n; ++i) {
+    sums[0] += static_cast<std::size_t>(std::popcount(word(i)));
+  }
+  return sums[0] + sums[1] + sums[2] + sums[3];
+}
+
+#define UTILS_BITS_ENTRY_POINTS(NAME, BYTES, ATTRIBUTES)                                     \
+  namespace NAME {                                                                          \
+  ATTRIBUTES std::size_t popcount(const std::uint64_t* a, std::size_t n) {                  \
+    return popcount_kernel<false>(a, a, n);                                                 \
+  }                                                                                         \
+  ATTRIBUTES std::size_t popcount_and(const std::uint64_t* a, const std::uint64_t* b,       \
+                                      std::size_t n) {                                      \
+    return popcount_kernel<true>(a, b, n);                                                  \
+  }                                                                                         \
+  template <Op op>                                                                          \
+  ATTRIBUTES void combine(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) {    \
+    combine_kernel<op, BYTES>(dst, src, n);                                                 \
+  }                                                                                         \
+  ATTRIBUTES void bit_not(std::uint64_t* dst, std::size_t n) { not_kernel<BYTES>(dst, n); } \
+  }
+
+UTILS_BITS_ENTRY_POINTS(scalar, 0, )
+#if UTILS_BITS_X86
+UTILS_BITS_ENTRY_POINTS(avx2, 32, __attribute__((target("avx2,popcnt"), flatten)))
+UTILS_BITS_ENTRY_POINTS(avx512, 64,
+                        __attribute__((target("avx512f,avx512dq,avx512bw,avx512vl,popcnt"),
+                                       flatten)))
+#endif
+
+#undef UTILS_BITS_ENTRY_POINTS
+
+}  // namespace
+
+#if UTILS_BITS_X86
+#define UTILS_BITS_DISPATCH(CALL)              \
+  switch (algorithms::active_isa()) {          \
+    case algorithms::Isa::kAvx512:             \
+      return avx512::CALL;                     \
+    case algorithms::Isa::kAvx2:               \
+      return avx2::CALL;                       \
+    case algorithms::Isa::kSse2:               \
+    case algorithms::Isa::kScalar:             \
+      break;                                   \
+  }                                            \
+  return scalar::CALL
+#else
+#define UTILS_BITS_DISPATCH(CALL) return scalar::CALL
+#endif
+
+namespace detail {
+
+std::size_t popcount(const std::uint64_t* words, std::size_t n) noexcept {
+  UTILS_BITS_DISPATCH(popcount(words, n));
+}
+
+std::size_t popcount_and(const std::uint64_t* a, const std::uint64_t* b, std::size_t n) noexcept {
+  UTILS_BITS_DISPATCH(popcount_and(a, b, n));
+}
+
+void bit_and(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noexcept {
+  UTILS_BITS_DISPATCH(combine<Op::kAnd>(dst, src, n));
+}
+
+void bit_or(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noexcept {
+  UTILS_BITS_DISPATCH(combine<Op::kOr>(dst, src, n));
+}
+
+void bit_xor(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noexcept {
+  UTILS_BITS_DISPATCH(combine<Op::kXor>(dst, src, n));
+}
+
+void bit_and_not(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noexcept {
+  UTILS_BITS_DISPATCH(combine<Op::kAndNot>(dst, src, n));
+}
+
+void bit_not(std::uint64_t* dst, std::size_t n) noexcept {
+  UTILS_BITS_DISPATCH(bit_not(dst, n));
+}
+
+}  // namespace detail
+
+#undef UTILS_BITS_DISPATCH
+
+}  // namespace bits
+
+// RankSelect:
+RankSelect::RankSelect(std::span<const std::uint64_t> words, std::size_t size)
+    : words_(words), size_(size) {
+  const std::size_t blocks = (words.size() + kBlockWords - 1) / kBlockWords;
+  blocks_.reserve(blocks + 1);
+  std::size_t total = 0;
+  for (std::size_t b = 0; b < blocks; ++b) {
+    blocks_.push_back(total);
+    const std::size_t first = b * kBlockWords;
+    total += bits::detail::popcount(words.data() + first,
+                                    std::min(kBlockWords, words.size() - first));
+  }
+  blocks_.push_back(total);
+}
+
+std::size_t RankSelect::rank(std::size_t i) const {
+  if (i > size_) {
+    throw std::out_of_range("Index out of range");
+  }
+  const std::size_t word = i / 64;
+  const std::size_t block = word / kBlockWords;
+  std::size_t result = blocks_[block];
+  for (std::size_t w = block * kBlockWords; w < word; ++w) {
+    result += static_cast<std::size_t>(std::popcount(words_[w]));
+  }
+  if (i % 64 != 0) {
+    result += static_cast<std::size_t>(
+        std::popcount(words_[word] & ((std::uint64_t{1} << (i % 64)) - 1)));
+  }
+  return result;
+}
+
+std::size_t RankSelect::select(std::size_t k) const {
+  if (k >= count()) {
+    throw std::out_of_range("Select rank out of range");
+  }
+  // Last block with fewer than k + 1 set bits before it.
+  const auto* block_end = blocks_.data() + blocks_.size() - 1;
+  const std::size_t block =
+      static_cast<std::size_t>(std::upper_bound(blocks_.data(), block_end, k) - blocks_.data()) - 1;
+  k -= blocks_[block];
+  for (std::size_t w = block * kBlockWords;; ++w) {
+    const auto ones = static_cast<std::size_t>(std::popcount(words_[w]));
+    if (k < ones) {
+      return w * 64 + bits::detail::select_in_word(words_[w], k);
+    }
+    k -= ones;
+  }
+}
+
+}  // namespace utils
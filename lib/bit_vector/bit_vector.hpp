@@ -0,0 +1,203 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ranges>
+#include <span>
+
+#include <lib/vector/growth_policy.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace utils {
+
+namespace bits {
+
+namespace detail {
+
+// Word kernels over n 64-bit words. The implementation is picked at run
+// time from utils::algorithms::active_isa(), like the kernels in
+// lib/vector_algorithms.
+std::size_t popcount(const std::uint64_t* words, std::size_t n) noexcept;
+// Popcount of a[i] & b[i], without materializing the intersection.
+std::size_t popcount_and(const std::uint64_t* a, const std::uint64_t* b, std::size_t n) noexcept;
+void bit_and(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noexcept;
+void bit_or(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noexcept;
+void bit_xor(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noexcept;
+void bit_and_not(std::uint64_t* dst, const std::uint64_t* src, std::size_t n) noexcept;
+void bit_not(std::uint64_t* dst, std::size_t n) noexcept;
+
+}  // namespace detail
+
+}  // namespace bits
+
+// Dense vector of bits, 64 to a word, stored in a utils::Vector<uint64_t>
+// so it shares Vector's allocator and growth policy. Bits past size() in
+// the last word are kept zero, so whole-word operations never need a mask.
+//
+// &=, |=, ^= and and_not() combine vectors of the same size a word at a
+// time and throw std::invalid_argument otherwise. count(), rank() and
+// select() use hardware popcount; find_next() skips zero words, so visiting
+// the set bits costs one step per word plus one per set bit. For many
+// rank() or select() queries on an unchanging vector, build a RankSelect.
+template <typename Allocator = std::allocator<std::uint64_t>,
+          typename GrowthPolicy = DefaultGrowth>
+class BasicBitVector {
+ public:
+  using word_type = std::uint64_t;
+  using allocator_type = Allocator;
+  static constexpr std::size_t kWordBits = 64;
+  // Returned by find_first(), find_next() and select() when there is no
+  // such bit.
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+  class Reference {
+   public:
+    Reference& operator=(bool value) noexcept;
+    Reference& operator=(const Reference& other) noexcept { return *this = bool(other); }
+    operator bool() const noexcept { return (*word_ & mask_) != 0; }
+    void flip() noexcept { *word_ ^= mask_; }
+
+   private:
+    friend class BasicBitVector;
+    Reference(word_type* word, word_type mask) noexcept : word_(word), mask_(mask) {}
+
+    word_type* word_;
+    word_type mask_;
+  };
+
+  BasicBitVector(const Allocator& alloc = Allocator());
+  explicit BasicBitVector(std::size_t size, bool value = false,
+                          const Allocator& alloc = Allocator());
+
+  // A vector of size bits with the bits at indices set. Throws
+  // std::out_of_range if an index is not below size.
+  template <std::ranges::input_range Indices>
+    requires std::integral<std::ranges::range_value_t<Indices>>
+  static BasicBitVector from_indices(Indices&& indices, std::size_t size,
+                                     const Allocator& alloc = Allocator());
+  // The byte-per-flag form: bit i is set when flags[i] is non-zero.
+  template <std::ranges::input_range Flags>
+  static BasicBitVector from_flags(Flags&& flags, const Allocator& alloc = Allocator());
+
+  // Capacity:
+  std::size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+  std::size_t capacity() const noexcept { return words_.capacity() * kWordBits; }
+  void reserve(std::size_t bits);
+  void resize(std::size_t size, bool value = false);
+  void shrink_to_fit() { words_.shrink_to_fit(); }
+
+  // Element access:
+  Reference operator[](std::size_t i) noexcept;
+  bool operator[](std::size_t i) const noexcept { return test(i); }
+  bool test(std::size_t i) const noexcept;
+  bool at(std::size_t i) const;
+  bool back() const noexcept { return test(size_ - 1); }
+  std::span<const word_type> words() const noexcept { return {words_.data(), words_.size()}; }
+
+  // Modifiers:
+  void push_back(bool value);
+  void pop_back();
+  void clear() noexcept;
+  void set(std::size_t i, bool value = true) noexcept;
+  void reset(std::size_t i) noexcept { set(i, false); }
+  void flip(std::size_t i) noexcept;
+  // Whole-vector forms.
+  void set() noexcept;
+  void reset() noexcept;
+  void flip() noexcept;
+  void swap(BasicBitVector& other) noexcept;
+
+  // Word-level combination with a vector of the same size.
+  BasicBitVector& operator&=(const BasicBitVector& other);
+  BasicBitVector& operator|=(const BasicBitVector& other);
+  BasicBitVector& operator^=(const BasicBitVector& other);
+  // Clears the bits set in other: *this &= ~other without the temporary.
+  BasicBitVector& and_not(const BasicBitVector& other);
+  BasicBitVector operator~() const;
+
+  // Queries:
+  std::size_t count() const noexcept;
+  // Set bits in both vectors; the size of (*this & other).count().
+  std::size_t count_and(const BasicBitVector& other) const;
+  bool any() const noexcept;
+  bool none() const noexcept { return !any(); }
+  bool all() const noexcept { return count() == size_; }
+  // Set bits in [0, i). Throws std::out_of_range if i > size().
+  std::size_t rank(std::size_t i) const;
+  // Index of the set bit with k set bits before it, or npos.
+  std::size_t select(std::size_t k) const noexcept;
+  std::size_t find_first() const noexcept { return find_next(0); }
+  // First set bit at or after i, or npos.
+  std::size_t find_next(std::size_t i) const noexcept;
+  // Calls fn(index) for every set bit in increasing order.
+  template <typename Fn>
+  void for_each_set(Fn&& fn) const;
+
+  // Bulk conversion: the indices of the set bits, in increasing order.
+  // Index must be wide enough for size() - 1.
+  template <std::unsigned_integral Index = std::uint32_t>
+  Vector<Index> to_indices() const;
+  template <std::unsigned_integral Index, typename A, typename G, typename S>
+  void append_indices(Vector<Index, A, G, S>& out) const;
+
+  bool operator==(const BasicBitVector& other) const noexcept;
+
+ private:
+  static std::size_t words_for(std::size_t bits) noexcept { return (bits + kWordBits - 1) / kWordBits; }
+  void check_same_size(const BasicBitVector& other) const;
+  // Clears the bits past size() in the last word.
+  void clear_unused() noexcept;
+
+  Vector<word_type, Allocator, GrowthPolicy> words_;
+  std::size_t size_ = 0;
+};
+
+template <typename Allocator, typename GrowthPolicy>
+BasicBitVector<Allocator, GrowthPolicy> operator&(BasicBitVector<Allocator, GrowthPolicy> lhs,
+                                                  const BasicBitVector<Allocator, GrowthPolicy>& rhs);
+template <typename Allocator, typename GrowthPolicy>
+BasicBitVector<Allocator, GrowthPolicy> operator|(BasicBitVector<Allocator, GrowthPolicy> lhs,
+                                                  const BasicBitVector<Allocator, GrowthPolicy>& rhs);
+template <typename Allocator, typename GrowthPolicy>
+BasicBitVector<Allocator, GrowthPolicy> operator^(BasicBitVector<Allocator, GrowthPolicy> lhs,
+                                                  const BasicBitVector<Allocator, GrowthPolicy>& rhs);
+
+using BitVector = BasicBitVector<>;
+
+// Constant-time rank and logarithmic select over a bit vector that no
+// longer changes: one cumulative count per 512-bit block, 1/8 of a bit per
+// bit. It keeps a view of the vector's words, so it is invalidated by any
+// change to the vector.
+class RankSelect {
+ public:
+  RankSelect(std::span<const std::uint64_t> words, std::size_t size);
+  template <typename Allocator, typename GrowthPolicy>
+  explicit RankSelect(const BasicBitVector<Allocator, GrowthPolicy>& bits)
+      : RankSelect(bits.words(), bits.size()) {}
+
+  std::size_t size() const noexcept { return size_; }
+  std::size_t count() const noexcept { return blocks_[blocks_.size() - 1]; }
+  // Set bits in [0, i). Throws std::out_of_range if i > size().
+  std::size_t rank(std::size_t i) const;
+  // Index of the set bit with k set bits before it. Throws
+  // std::out_of_range if k >= count().
+  std::size_t select(std::size_t k) const;
+
+ private:
+  static constexpr std::size_t kBlockWords = 8;
+
+  std::span<const std::uint64_t> words_;
+  std::size_t size_;
+  // blocks_[b] is the number of set bits before word b * kBlockWords; the
+  // extra last entry is the total.
+  Vector<std::size_t> blocks_;
+};
+
+}  // namespace utils
+
+#include "bit_vector.tpp"
@@ -0,0 +1,347 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <algorithm>
+#include <bit>
+#include <stdexcept>
+#include <utility>
+
+namespace utils {
+
+namespace bits {
+
+namespace detail {
+
+// Index of the set bit of word with k set bits below it; word must have
+// more than k set bits.
+inline std::size_t select_in_word(std::uint64_t word, std::size_t k) noexcept {
+  for (; k > 0; --k) {
+    word &= word - 1;
+  }
+  return static_cast<std::size_t>(std::countr_zero(word));
+}
+
+}  // namespace detail
+
+}  // namespace bits
+
+template <typename Allocator, typename GrowthPolicy>
+BasicBitVector<Allocator, GrowthPolicy>::Reference&
+BasicBitVector<Allocator, GrowthPolicy>::Reference::operator=(bool value) noexcept {
+  if (value) {
+    *word_ |= mask_;
+  } else {
+    *word_ &= ~mask_;
+  }
+  return *this;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+BasicBitVector<Allocator, GrowthPolicy>::BasicBitVector(const Allocator& alloc) : words_(alloc) {}
+
+template <typename Allocator, typename GrowthPolicy>
+BasicBitVector<Allocator, GrowthPolicy>::BasicBitVector(std::size_t size, bool value,
+                                                        const Allocator& alloc)
+    : words_(words_for(size), value ? ~word_type{0} : word_type{0}, alloc), size_(size) {
+  clear_unused();
+}
+
+template <typename Allocator, typename GrowthPolicy>
+template <std::ranges::input_range Indices>
+  requires std::integral<std::ranges::range_value_t<Indices>>
+BasicBitVector<Allocator, GrowthPolicy> BasicBitVector<Allocator, GrowthPolicy>::from_indices(
+    Indices&& indices, std::size_t size, const Allocator& alloc) {
+  BasicBitVector result(size, false, alloc);
+  for (auto&& index : indices) {
+    if (std::cmp_less(index, 0) || !std::cmp_less(index, size)) {
+      throw std::out_of_range("Bit index out of range");
+    }
+    result.set(static_cast<std::size_t>(index));
+  }
+  return result;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+template <std::ranges::input_range Flags>
+BasicBitVector<Allocator, GrowthPolicy> BasicBitVector<Allocator, GrowthPolicy>::from_flags(
+    Flags&& flags, const Allocator& alloc) {
+  BasicBitVector result(alloc);
+  if constexpr (std::ranges::sized_range<Flags>) {
+    result.reserve(std::ranges::size(flags));
+  }
+  word_type word = 0;
+  std::size_t bit = 0;
+  for (auto&& flag : flags) {
+    word |= word_type{flag != 0} << bit;
+    if (++bit == kWordBits) {
+      result.words_.push_back(word);
+      word = 0;
+      bit = 0;
+    }
+    ++result.size_;
+  }
+  if (bit != 0) {
+    result.words_.push_back(word);
+  }
+  return result;
+}
+
+// Capacity:
+template <typename Allocator, typename GrowthPolicy>
+void BasicBitVector<Allocator, GrowthPolicy>::reserve(std::size_t bits) {
+  words_.reserve(words_for(bits));
+}
+
+template <typename Allocator, typename GrowthPolicy>
+void BasicBitVector<Allocator, GrowthPolicy>::resize(std::size_t size, bool value) {
+  if (size > size_ && value && size_ % kWordBits != 0) {
+    words_[words_.size() - 1] |= ~word_type{0} << (size_ % kWordBits);
+  }
+  words_.resize(words_for(size), value ? ~word_type{0} : word_type{0});
+  size_ = size;
+  clear_unused();
+}
+
+// Element access:
+template <typename Allocator, typename GrowthPolicy>
+BasicBitVector<Allocator, GrowthPolicy>::Reference
+BasicBitVector<Allocator, GrowthPolicy>::operator[](std::size_t i) noexcept {
+  return Reference(&words_[i / kWordBits], word_type{1} << (i % kWordBits));
+}
+
+template <typename Allocator, typename GrowthPolicy>
+bool BasicBitVector<Allocator, GrowthPolicy>::test(std::size_t i) const noexcept {
+  return (words_[i / kWordBits] >> (i % kWordBits)) & 1;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+bool BasicBitVector<Allocator, GrowthPolicy>::at(std::size_t i) const {
+  if (i >= size_) {
+    throw std::out_of_range("Index out of range");
+  }
+  return test(i);
+}
+
+// Modifiers:
+template <typename Allocator, typename GrowthPolicy>
+void BasicBitVector<Allocator, GrowthPolicy>::push_back(bool value) {
+  if (size_ % kWordBits == 0) {
+    words_.push_back(0);
+  }
+  ++size_;
+  set(size_ - 1, value);
+}
+
+template <typename Allocator, typename GrowthPolicy>
+void BasicBitVector<Allocator, GrowthPolicy>::pop_back() {
+  if (size_ == 0) {
+    throw std::out_of_range("Trying to pop from empty BitVector.");
+  }
+  reset(size_ - 1);
+  --size_;
+  if (size_ % kWordBits == 0) {
+    words_.pop_back();
+  }
+}
+
+template <typename Allocator, typename GrowthPolicy>
+void BasicBitVector<Allocator, GrowthPolicy>::clear() noexcept {
+  words_.clear();
+  size_ = 0;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+void BasicBitVector<Allocator, GrowthPolicy>::set(std::size_t i, bool value) noexcept {
+  (*this)[i] = value;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+void BasicBitVector<Allocator, GrowthPolicy>::flip(std::size_t i) noexcept {
+  words_[i / kWordBits] ^= word_type{1} << (i % kWordBits);
+}
+
+template <typename Allocator, typename GrowthPolicy>
+void BasicBitVector<Allocator, GrowthPolicy>::set() noexcept {
+  std::fill(words_.begin(), words_.end(), ~word_type{0});
+  clear_unused();
+}
+
+template <typename Allocator, typename GrowthPolicy>
+void BasicBitVector<Allocator, GrowthPolicy>::reset() noexcept {
+  std::fill(words_.begin(), words_.end(), word_type{0});
+}
+
+template <typename Allocator, typename GrowthPolicy>
+void BasicBitVector<Allocator, GrowthPolicy>::flip() noexcept {
+  bits::detail::bit_not(words_.data(), words_.size());
+  clear_unused();
+}
+
+template <typename Allocator, typename GrowthPolicy>
+void BasicBitVector<Allocator, GrowthPolicy>::swap(BasicBitVector& other) noexcept {
+  words_.swap(other.words_);
+  std::swap(size_, other.size_);
+}
+
+template <typename Allocator, typename GrowthPolicy>
+BasicBitVector<Allocator, GrowthPolicy>& BasicBitVector<Allocator, GrowthPolicy>::operator&=(
+    const BasicBitVector& other) {
+  check_same_size(other);
+  bits::detail::bit_and(words_.data(), other.words_.data(), words_.size());
+  return *this;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+BasicBitVector<Allocator, GrowthPolicy>& BasicBitVector<Allocator, GrowthPolicy>::operator|=(
+    const BasicBitVector& other) {
+  check_same_size(other);
+  bits::detail::bit_or(words_.data(), other.words_.data(), words_.size());
+  return *this;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+BasicBitVector<Allocator, GrowthPolicy>& BasicBitVector<Allocator, GrowthPolicy>::operator^=(
+    const BasicBitVector& other) {
+  check_same_size(other);
+  bits::detail::bit_xor(words_.data(), other.words_.data(), words_.size());
+  return *this;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+BasicBitVector<Allocator, GrowthPolicy>& BasicBitVector<Allocator, GrowthPolicy>::and_not(
+    const BasicBitVector& other) {
+  check_same_size(other);
+  bits::detail::bit_and_not(words_.data(), other.words_.data(), words_.size());
+  return *this;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+BasicBitVector<Allocator, GrowthPolicy> BasicBitVector<Allocator, GrowthPolicy>::operator~() const {
+  BasicBitVector result(*this);
+  result.flip();
+  return result;
+}
+
+// Queries:
+template <typename Allocator, typename GrowthPolicy>
+std::size_t BasicBitVector<Allocator, GrowthPolicy>::count() const noexcept {
+  return bits::detail::popcount(words_.data(), words_.size());
+}
+
+template <typename Allocator, typename GrowthPolicy>
+std::size_t BasicBitVector<Allocator, GrowthPolicy>::count_and(const BasicBitVector& other) const {
+  check_same_size(other);
+  return bits::detail::popcount_and(words_.data(), other.words_.data(), words_.size());
+}
+
+template <typename Allocator, typename GrowthPolicy>
+bool BasicBitVector<Allocator, GrowthPolicy>::any() const noexcept {
+  return std::any_of(words_.begin(), words_.end(), [](word_type word) { return word != 0; });
+}
+
+template <typename Allocator, typename GrowthPolicy>
+std::size_t BasicBitVector<Allocator, GrowthPolicy>::rank(std::size_t i) const {
+  if (i > size_) {
+    throw std::out_of_range("Index out of range");
+  }
+  const std::size_t word = i / kWordBits;
+  std::size_t result = bits::detail::popcount(words_.data(), word);
+  if (i % kWordBits != 0) {
+    result += std::popcount(words_[word] & ((word_type{1} << (i % kWordBits)) - 1));
+  }
+  return result;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+std::size_t BasicBitVector<Allocator, GrowthPolicy>::select(std::size_t k) const noexcept {
+  for (std::size_t word = 0; word < words_.size(); ++word) {
+    const auto ones = static_cast<std::size_t>(std::popcount(words_[word]));
+    if (k < ones) {
+      return word * kWordBits + bits::detail::select_in_word(words_[word], k);
+    }
+    k -= ones;
+  }
+  return npos;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+std::size_t BasicBitVector<Allocator, GrowthPolicy>::find_next(std::size_t i) const noexcept {
+  if (i >= size_) {
+    return npos;
+  }
+  std::size_t word = i / kWordBits;
+  word_type bits = words_[word] & (~word_type{0} << (i % kWordBits));
+  while (bits == 0) {
+    if (++word == words_.size()) {
+      return npos;
+    }
+    bits = words_[word];
+  }
+  return word * kWordBits + static_cast<std::size_t>(std::countr_zero(bits));
+}
+
+template <typename Allocator, typename GrowthPolicy>
+template <typename Fn>
+void BasicBitVector<Allocator, GrowthPolicy>::for_each_set(Fn&& fn) const {
+  for (std::size_t word = 0; word < words_.size(); ++word) {
+    for (word_type bits = words_[word]; bits != 0; bits &= bits - 1) {
+      fn(word * kWordBits + static_cast<std::size_t>(std::countr_zero(bits)));
+    }
+  }
+}
+
+template <typename Allocator, typename GrowthPolicy>
+template <std::unsigned_integral Index>
+Vector<Index> BasicBitVector<Allocator, GrowthPolicy>::to_indices() const {
+  Vector<Index> out;
+  append_indices(out);
+  return out;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+template <std::unsigned_integral Index, typename A, typename G, typename S>
+void BasicBitVector<Allocator, GrowthPolicy>::append_indices(Vector<Index, A, G, S>& out) const {
+  out.reserve(out.size() + count());
+  for_each_set([&out](std::size_t index) { out.push_back(static_cast<Index>(index)); });
+}
+
+template <typename Allocator, typename GrowthPolicy>
+bool BasicBitVector<Allocator, GrowthPolicy>::operator==(const BasicBitVector& other) const noexcept {
+  return size_ == other.size_ && std::equal(words_.begin(), words_.end(), other.words_.begin());
+}
+
+template <typename Allocator, typename GrowthPolicy>
+void BasicBitVector<Allocator, GrowthPolicy>::check_same_size(const BasicBitVector& other) const {
+  if (size_ != other.size_) {
+    throw std::invalid_argument("Bit vector sizes differ");
+  }
+}
+
+template <typename Allocator, typename GrowthPolicy>
+void BasicBitVector<Allocator, GrowthPolicy>::clear_unused() noexcept {
+  if (size_ % kWordBits != 0) {
+    words_[words_.size() - 1] &= (word_type{1} << (size_ % kWordBits)) - 1;
+  }
+}
+
+template <typename Allocator, typename GrowthPolicy>
+BasicBitVector<Allocator, GrowthPolicy> operator&(BasicBitVector<Allocator, GrowthPolicy> lhs,
+                                                  const BasicBitVector<Allocator, GrowthPolicy>& rhs) {
+  lhs &= rhs;
+  return lhs;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+BasicBitVector<Allocator, GrowthPolicy> operator|(BasicBitVector<Allocator, GrowthPolicy> lhs,
+                                                  const BasicBitVector<Allocator, GrowthPolicy>& rhs) {
+  lhs |= rhs;
+  return lhs;
+}
+
+template <typename Allocator, typename GrowthPolicy>
+BasicBitVector<Allocator, GrowthPolicy> operator^(BasicBitVector<Allocator, GrowthPolicy> lhs,
+                                                  const BasicBitVector<Allocator, GrowthPolicy>& rhs) {
+  lhs ^= rhs;
+  return lhs;
+}
+
+}  // namespace utils
@@ -0,0 +1,221 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+#include <lib/vector/vector.hpp>
+
+namespace utils {
+
+// Append-only vector that any number of threads can grow at once. Storage is
+// a fixed table of segments whose sizes double (kFirstSegment, then 2x, 4x,
+// ...), so growth allocates a new segment and never moves an element: a
+// reference obtained from push_back stays valid until clear() or
+// destruction.
+//
+// Appends reserve their indices and install missing segments with
+// compare-exchanges on the size and the segment table; no lock is taken (the
+// allocator itself may take one). An element is published once its
+// constructor has returned. is_published(i) tells readers on other threads
+// whether slot i can be read; size() counts reserved slots, some of which
+// may still be under construction. A slot whose constructor (or segment
+// allocation) threw stays unpublished for good and is skipped by
+// to_vector(); iteration stops at the first such slot.
+//
+// push_back, emplace_back, grow_by, reserve, is_published, operator[], at
+// and to_vector may run concurrently with each other. Copying, assignment,
+// clear, swap and iteration require that no other thread is appending.
+template <typename T, typename Allocator = std::allocator<T>>
+class ConcurrentVector {
+  template <bool Const>
+  class BasicIterator;
+
+ public:
+  using value_type = T;
+  using allocator_type = Allocator;
+  using alloc_traits = std::allocator_traits<Allocator>;
+  using iterator = BasicIterator<false>;
+  using const_iterator = BasicIterator<true>;
+
+  static constexpr std::size_t kFirstSegmentLog =
+      std::bit_width(std::max<std::size_t>(1, 1024 / sizeof(T))) - 1;
+  static constexpr std::size_t kFirstSegment = std::size_t{1} << kFirstSegmentLog;
+  static constexpr std::size_t kSegments =
+      std::numeric_limits<std::size_t>::digits - kFirstSegmentLog;
+
+  // Constructors / Destructor
+  ConcurrentVector(const Allocator& alloc = Allocator());
+  ConcurrentVector(const ConcurrentVector& obj);
+  ConcurrentVector(ConcurrentVector&& other) noexcept;
+  ConcurrentVector& operator=(const ConcurrentVector& obj);
+  ConcurrentVector& operator=(ConcurrentVector&& other) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value ||
+      alloc_traits::is_always_equal::value);
+  ~ConcurrentVector();
+
+  const Allocator& get_allocator() const noexcept { return alloc_; }
+
+  // Iterators:
+  iterator begin() noexcept { return iterator(this, 0); }
+  const_iterator begin() const noexcept { return const_iterator(this, 0); }
+  iterator end() noexcept { return iterator(this, iteration_end()); }
+  const_iterator end() const noexcept { return const_iterator(this, iteration_end()); }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+
+  // Capacity:
+  std::size_t size() const noexcept { return size_.load(std::memory_order_acquire); }
+  std::size_t max_size() const noexcept;
+  // Slots covered by the leading run of allocated segments.
+  std::size_t capacity() const noexcept;
+  bool empty() const noexcept { return size() == 0; }
+  void reserve(std::size_t malloc);
+
+  // Element access:
+  bool is_published(std::size_t i) const noexcept;
+  T& operator[](std::size_t i) noexcept { return *slot(i); }
+  const T& operator[](std::size_t i) const noexcept { return *slot(i); }
+  // Throws std::out_of_range unless slot i is published.
+  T& at(std::size_t i);
+  const T& at(std::size_t i) const;
+  // Published elements in index order, contiguous.
+  Vector<T, Allocator> to_vector() const;
+
+  // Modifiers:
+  T& push_back(const T& obj);
+  T& push_back(T&& obj);
+  template <typename... Args>
+  T& emplace_back(Args&&... args);
+  // Appends n value-initialized (or copied) elements at consecutive indices
+  // and returns the index of the first.
+  std::size_t grow_by(std::size_t n);
+  std::size_t grow_by(std::size_t n, const T& val);
+  void clear() noexcept;
+  void swap(ConcurrentVector& obj) noexcept;
+
+ private:
+  using Flag = std::atomic<bool>;
+
+  static constexpr std::size_t kNone = std::numeric_limits<std::size_t>::max();
+
+  static std::size_t segment_of(std::size_t i) noexcept {
+    return static_cast<std::size_t>(std::bit_width(i + kFirstSegment)) - 1 - kFirstSegmentLog;
+  }
+  static std::size_t segment_base(std::size_t s) noexcept {
+    return (kFirstSegment << s) - kFirstSegment;
+  }
+  static std::size_t segment_size(std::size_t s) noexcept { return kFirstSegment << s; }
+  // Element storage of a segment is followed by one published flag per slot.
+  static std::size_t segment_allocation(std::size_t s) noexcept {
+    return segment_size(s) + (segment_size(s) * sizeof(Flag) + sizeof(T) - 1) / sizeof(T);
+  }
+  static Flag* flags(T* segment, std::size_t s) noexcept {
+    return reinterpret_cast<Flag*>(segment + segment_size(s));
+  }
+
+  T* slot(std::size_t i) const noexcept;
+  Flag& flag(std::size_t i) const noexcept;
+  T* ensure_segment(std::size_t s);
+  // Records that slot i will never be published.
+  void mark_unpublished(std::size_t i) noexcept;
+  std::size_t iteration_end() const noexcept;
+  std::size_t reserve_slots(std::size_t n);
+  template <typename Construct>
+  void construct_range(std::size_t first, std::size_t n, Construct&& construct);
+  // Copies or moves the published elements of obj into this empty vector.
+  template <typename Source>
+  void assign_from(Source&& obj);
+  void destroy_elements() noexcept;
+  void release() noexcept;
+
+  // The contended counter gets its own cache line so that appends do not
+  // invalidate the segment table that every access reads.
+  alignas(64) std::atomic<std::size_t> size_;
+  alignas(64) std::atomic<T*> segments_[kSegments];
+  // Lowest slot that will never be published, or the maximum size_t.
+  std::atomic<std::size_t> first_unpublished_;
+  Allocator alloc_;
+};
+
+template <typename T, typename Allocator>
+template <bool Const>
+class ConcurrentVector<T, Allocator>::BasicIterator {
+  using Owner = std::conditional_t<Const, const ConcurrentVector, ConcurrentVector>;
+
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = std::conditional_t<Const, const T*, T*>;
+  using reference = std::conditional_t<Const, const T&, T&>;
+
+  BasicIterator() noexcept = default;
+  BasicIterator(Owner* owner, std::size_t index) noexcept : owner_(owner), index_(index) {}
+  // iterator converts to const_iterator.
+  template <bool OtherConst>
+    requires(Const && !OtherConst)
+  BasicIterator(const BasicIterator<OtherConst>& other) noexcept
+      : owner_(other.owner_), index_(other.index_) {}
+
+  reference operator*() const noexcept { return (*owner_)[index_]; }
+  pointer operator->() const noexcept { return &(*owner_)[index_]; }
+  reference operator[](difference_type n) const noexcept {
+    return (*owner_)[index_ + static_cast<std::size_t>(n)];
+  }
+
+  BasicIterator& operator++() noexcept {
+    ++index_;
+    return *this;
+  }
+  BasicIterator operator++(int) noexcept { return BasicIterator(owner_, index_++); }
+  BasicIterator& operator--() noexcept {
+    --index_;
+    return *this;
+  }
+  BasicIterator operator--(int) noexcept { return BasicIterator(owner_, index_--); }
+  BasicIterator& operator+=(difference_type n) noexcept {
+    index_ += static_cast<std::size_t>(n);
+    return *this;
+  }
+  BasicIterator& operator-=(difference_type n) noexcept {
+    index_ -= static_cast<std::size_t>(n);
+    return *this;
+  }
+  BasicIterator operator+(difference_type n) const noexcept {
+    return BasicIterator(owner_, index_ + static_cast<std::size_t>(n));
+  }
+  friend BasicIterator operator+(difference_type n, const BasicIterator& it) noexcept {
+    return it + n;
+  }
+  BasicIterator operator-(difference_type n) const noexcept {
+    return BasicIterator(owner_, index_ - static_cast<std::size_t>(n));
+  }
+  difference_type operator-(const BasicIterator& other) const noexcept {
+    return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+  }
+
+  bool operator==(const BasicIterator& other) const noexcept { return index_ == other.index_; }
+  std::strong_ordering operator<=>(const BasicIterator& other) const noexcept {
+    return index_ <=> other.index_;
+  }
+
+ private:
+  template <bool>
+  friend class BasicIterator;
+
+  Owner* owner_ = nullptr;
+  std::size_t index_ = 0;
+};
+
+}  // namespace utils
+
+#include "concurrent_vector.tpp"
@@ -0,0 +1,374 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include "concurrent_vector.hpp"
+
+namespace utils {
+
+// Constructors / Destructor
+
+template <typename T, typename Allocator>
+ConcurrentVector<T, Allocator>::ConcurrentVector(const Allocator& alloc)
+    : size_(0), segments_{}, first_unpublished_(kNone), alloc_(alloc) {}
+
+template <typename T, typename Allocator>
+ConcurrentVector<T, Allocator>::ConcurrentVector(const ConcurrentVector& obj)
+    : ConcurrentVector(alloc_traits::select_on_container_copy_construction(obj.alloc_)) {
+  // The delegated constructor has finished, so the destructor cleans up if a
+  // copy throws.
+  this->assign_from(obj);
+}
+
+template <typename T, typename Allocator>
+ConcurrentVector<T, Allocator>::ConcurrentVector(ConcurrentVector&& other) noexcept
+    : size_(other.size_.exchange(0)),
+      segments_{},
+      first_unpublished_(other.first_unpublished_.exchange(kNone)),
+      alloc_(std::move(other.alloc_)) {
+  for (std::size_t s = 0; s < kSegments; ++s) {
+    this->segments_[s].store(other.segments_[s].exchange(nullptr));
+  }
+}
+
+template <typename T, typename Allocator>
+ConcurrentVector<T, Allocator>& ConcurrentVector<T, Allocator>::operator=(
+    const ConcurrentVector& obj) {
+  if (this != &obj) {
+    this->release();
+    if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+      this->alloc_ = obj.alloc_;
+    }
+    this->assign_from(obj);
+  }
+  return *this;
+}
+
+template <typename T, typename Allocator>
+ConcurrentVector<T, Allocator>& ConcurrentVector<T, Allocator>::operator=(
+    ConcurrentVector&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::
+                                           value ||
+                                       alloc_traits::is_always_equal::value) {
+  if (this == &other) {
+    return *this;
+  }
+  this->release();
+  if (alloc_traits::propagate_on_container_move_assignment::value ||
+      this->alloc_ == other.alloc_) {
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+      this->alloc_ = std::move(other.alloc_);
+    }
+    this->size_.store(other.size_.exchange(0));
+    this->first_unpublished_.store(other.first_unpublished_.exchange(kNone));
+    for (std::size_t s = 0; s < kSegments; ++s) {
+      this->segments_[s].store(other.segments_[s].exchange(nullptr));
+    }
+  } else {
+    this->assign_from(std::move(other));
+    other.clear();
+  }
+  return *this;
+}
+
+template <typename T, typename Allocator>
+ConcurrentVector<T, Allocator>::~ConcurrentVector() {
+  this->release();
+}
+
+// Capacity
+
+template <typename T, typename Allocator>
+std::size_t ConcurrentVector<T, Allocator>::max_size() const noexcept {
+  return std::min(alloc_traits::max_size(this->alloc_),
+                  std::numeric_limits<std::size_t>::max() - kFirstSegment);
+}
+
+template <typename T, typename Allocator>
+std::size_t ConcurrentVector<T, Allocator>::capacity() const noexcept {
+  std::size_t s = 0;
+  while (s < kSegments && this->segments_[s].load(std::memory_order_acquire)) {
+    ++s;
+  }
+  return s == 0 ? 0 : segment_base(s - 1) + segment_size(s - 1);
+}
+
+template <typename T, typename Allocator>
+void ConcurrentVector<T, Allocator>::reserve(std::size_t malloc) {
+  if (malloc == 0) {
+    return;
+  }
+  if (malloc > max_size()) {
+    throw std::length_error("ConcurrentVector size exceeds max_size()");
+  }
+  for (std::size_t s = 0; s <= segment_of(malloc - 1); ++s) {
+    this->ensure_segment(s);
+  }
+}
+
+// Element access
+
+template <typename T, typename Allocator>
+T* ConcurrentVector<T, Allocator>::slot(std::size_t i) const noexcept {
+  const std::size_t s = segment_of(i);
+  return this->segments_[s].load(std::memory_order_acquire) + (i - segment_base(s));
+}
+
+template <typename T, typename Allocator>
+typename ConcurrentVector<T, Allocator>::Flag& ConcurrentVector<T, Allocator>::flag(
+    std::size_t i) const noexcept {
+  const std::size_t s = segment_of(i);
+  return flags(this->segments_[s].load(std::memory_order_acquire), s)[i - segment_base(s)];
+}
+
+template <typename T, typename Allocator>
+bool ConcurrentVector<T, Allocator>::is_published(std::size_t i) const noexcept {
+  if (i >= this->size()) {
+    return false;
+  }
+  // A reserved slot's segment may not be installed yet.
+  const std::size_t s = segment_of(i);
+  T* segment = this->segments_[s].load(std::memory_order_acquire);
+  return segment && flags(segment, s)[i - segment_base(s)].load(std::memory_order_acquire);
+}
+
+template <typename T, typename Allocator>
+T& ConcurrentVector<T, Allocator>::at(std::size_t i) {
+  if (!this->is_published(i)) {
+    throw std::out_of_range("");
+  }
+  return *this->slot(i);
+}
+
+template <typename T, typename Allocator>
+const T& ConcurrentVector<T, Allocator>::at(std::size_t i) const {
+  if (!this->is_published(i)) {
+    throw std::out_of_range("");
+  }
+  return *this->slot(i);
+}
+
+template <typename T, typename Allocator>
+Vector<T, Allocator> ConcurrentVector<T, Allocator>::to_vector() const {
+  const std::size_t count = this->size();
+  Vector<T, Allocator> result(this->alloc_);
+  result.reserve(count);
+  for (std::size_t s = 0; s < kSegments && segment_base(s) < count; ++s) {
+    T* segment = this->segments_[s].load(std::memory_order_acquire);
+    if (!segment) {
+      continue;
+    }
+    // Runs of published slots are appended in one go so that trivially
+    // copyable elements are copied with memcpy.
+    Flag* published = flags(segment, s);
+    const std::size_t length = std::min(segment_size(s), count - segment_base(s));
+    std::size_t i = 0;
+    while (i < length) {
+      if (!published[i].load(std::memory_order_acquire)) {
+        ++i;
+        continue;
+      }
+      std::size_t end = i + 1;
+      while (end < length && published[end].load(std::memory_order_acquire)) {
+        ++end;
+      }
+      result.append_range(std::span<const T>(segment + i, end - i));
+      i = end;
+    }
+  }
+  return result;
+}
+
+// Modifiers
+
+template <typename T, typename Allocator>
+void ConcurrentVector<T, Allocator>::mark_unpublished(std::size_t i) noexcept {
+  std::size_t current = this->first_unpublished_.load(std::memory_order_relaxed);
+  while (i < current && !this->first_unpublished_.compare_exchange_weak(
+                            current, i, std::memory_order_relaxed)) {
+  }
+}
+
+template <typename T, typename Allocator>
+std::size_t ConcurrentVector<T, Allocator>::iteration_end() const noexcept {
+  return std::min(this->size(), this->first_unpublished_.load(std::memory_order_relaxed));
+}
+
+template <typename T, typename Allocator>
+T* ConcurrentVector<T, Allocator>::ensure_segment(std::size_t s) {
+  T* segment = this->segments_[s].load(std::memory_order_acquire);
+  if (segment) {
+    return segment;
+  }
+  // Threads that race here all allocate; one installs its segment and the
+  // others free theirs and use the winner's.
+  T* fresh = alloc_traits::allocate(this->alloc_, segment_allocation(s));
+  std::uninitialized_value_construct_n(flags(fresh, s), segment_size(s));
+  if (this->segments_[s].compare_exchange_strong(segment, fresh, std::memory_order_acq_rel,
+                                                 std::memory_order_acquire)) {
+    return fresh;
+  }
+  alloc_traits::deallocate(this->alloc_, fresh, segment_allocation(s));
+  return segment;
+}
+
+template <typename T, typename Allocator>
+std::size_t ConcurrentVector<T, Allocator>::reserve_slots(std::size_t n) {
+  // The bound is checked before the size moves, so a failed reservation
+  // leaves no phantom slots behind.
+  std::size_t first = this->size_.load(std::memory_order_relaxed);
+  do {
+    if (n > max_size() || first > max_size() - n) {
+      throw std::length_error("ConcurrentVector size exceeds max_size()");
+    }
+  } while (!this->size_.compare_exchange_weak(first, first + n, std::memory_order_acq_rel,
+                                              std::memory_order_relaxed));
+  if (n != 0) {
+    try {
+      for (std::size_t s = segment_of(first); s <= segment_of(first + n - 1); ++s) {
+        this->ensure_segment(s);
+      }
+    } catch (...) {
+      this->mark_unpublished(first);
+      throw;
+    }
+  }
+  return first;
+}
+
+template <typename T, typename Allocator>
+template <typename Construct>
+void ConcurrentVector<T, Allocator>::construct_range(std::size_t first, std::size_t n,
+                                                     Construct&& construct) {
+  for (std::size_t i = first; i < first + n; ++i) {
+    try {
+      construct(this->slot(i));
+    } catch (...) {
+      this->mark_unpublished(i);
+      throw;
+    }
+    this->flag(i).store(true, std::memory_order_release);
+  }
+}
+
+template <typename T, typename Allocator>
+T& ConcurrentVector<T, Allocator>::push_back(const T& obj) {
+  return this->emplace_back(obj);
+}
+
+template <typename T, typename Allocator>
+T& ConcurrentVector<T, Allocator>::push_back(T&& obj) {
+  return this->emplace_back(std::move(obj));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+T& ConcurrentVector<T, Allocator>::emplace_back(Args&&... args) {
+  const std::size_t i = this->reserve_slots(1);
+  T* element = this->slot(i);
+  try {
+    alloc_traits::construct(this->alloc_, element, std::forward<Args>(args)...);
+  } catch (...) {
+    this->mark_unpublished(i);
+    throw;
+  }
+  this->flag(i).store(true, std::memory_order_release);
+  return *element;
+}
+
+template <typename T, typename Allocator>
+std::size_t ConcurrentVector<T, Allocator>::grow_by(std::size_t n) {
+  const std::size_t first = this->reserve_slots(n);
+  this->construct_range(first, n, [this](T* p) { alloc_traits::construct(this->alloc_, p); });
+  return first;
+}
+
+template <typename T, typename Allocator>
+std::size_t ConcurrentVector<T, Allocator>::grow_by(std::size_t n, const T& val) {
+  const std::size_t first = this->reserve_slots(n);
+  this->construct_range(first, n,
+                        [this, &val](T* p) { alloc_traits::construct(this->alloc_, p, val); });
+  return first;
+}
+
+template <typename T, typename Allocator>
+template <typename Source>
+void ConcurrentVector<T, Allocator>::assign_from(Source&& obj) {
+  const std::size_t count = obj.size();
+  this->reserve(count);
+  this->size_.store(count);
+  this->first_unpublished_.store(obj.first_unpublished_.load());
+  for (std::size_t i = 0; i < count; ++i) {
+    if (!obj.is_published(i)) {
+      continue;
+    }
+    try {
+      if constexpr (std::is_rvalue_reference_v<Source&&>) {
+        alloc_traits::construct(this->alloc_, this->slot(i), std::move(obj[i]));
+      } else {
+        alloc_traits::construct(this->alloc_, this->slot(i), obj[i]);
+      }
+    } catch (...) {
+      this->mark_unpublished(i);
+      throw;
+    }
+    this->flag(i).store(true, std::memory_order_release);
+  }
+}
+
+template <typename T, typename Allocator>
+void ConcurrentVector<T, Allocator>::destroy_elements() noexcept {
+  const std::size_t count = this->size_.load();
+  for (std::size_t s = 0; s < kSegments && segment_base(s) < count; ++s) {
+    T* segment = this->segments_[s].load();
+    if (!segment) {
+      continue;
+    }
+    Flag* published = flags(segment, s);
+    const std::size_t length = std::min(segment_size(s), count - segment_base(s));
+    for (std::size_t i = 0; i < length; ++i) {
+      if (published[i].exchange(false)) {
+        alloc_traits::destroy(this->alloc_, segment + i);
+      }
+    }
+  }
+  this->size_.store(0);
+  this->first_unpublished_.store(kNone);
+}
+
+template <typename T, typename Allocator>
+void ConcurrentVector<T, Allocator>::clear() noexcept {
+  this->destroy_elements();
+}
+
+template <typename T, typename Allocator>
+void ConcurrentVector<T, Allocator>::release() noexcept {
+  this->destroy_elements();
+  for (std::size_t s = 0; s < kSegments; ++s) {
+    if (T* segment = this->segments_[s].exchange(nullptr)) {
+      alloc_traits::deallocate(this->alloc_, segment, segment_allocation(s));
+    }
+  }
+}
+
+template <typename T, typename Allocator>
+void ConcurrentVector<T, Allocator>::swap(ConcurrentVector& obj) noexcept {
+  this->size_.store(obj.size_.exchange(this->size_.load()));
+  this->first_unpublished_.store(
+      obj.first_unpublished_.exchange(this->first_unpublished_.load()));
+  for (std::size_t s = 0; s < kSegments; ++s) {
+    this->segments_[s].store(obj.segments_[s].exchange(this->segments_[s].load()));
+  }
+  if constexpr (alloc_traits::propagate_on_container_swap::value) {
+    using std::swap;
+    swap(this->alloc_, obj.alloc_);
+  }
+}
+
+}  // namespace utils
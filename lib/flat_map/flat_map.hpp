@@ -0,0 +1,306 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <algorithm>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include <lib/vector/vector.hpp>
+
+namespace utils {
+
+// Constructor tag: the input is already sorted and free of duplicates.
+struct sorted_unique_t {
+  explicit sorted_unique_t() = default;
+};
+inline constexpr sorted_unique_t sorted_unique{};
+
+namespace detail {
+
+// Index of the first element of [base, base + n) for which pred is false,
+// given that pred is true for a prefix and false after it. The loop has a
+// fixed trip count for a given n and picks each half with a conditional
+// move instead of a branch, so it does not mispredict; both candidate
+// midpoints of the next step are prefetched.
+template <typename T, typename Pred>
+std::size_t branchless_partition_point(const T* base, std::size_t n, Pred pred);
+
+}  // namespace detail
+
+// Sorted set stored in one utils::Vector<K>. Lookups are branchless binary
+// searches over contiguous keys, so a 1M-key set costs about 20 cache
+// misses per lookup at worst instead of a node per level, and iteration is
+// a linear scan.
+//
+// Building from a range sorts and deduplicates once. insert_range sorts the
+// new keys and merges them with the existing ones in one pass; single
+// inserts and erases shift the tail, O(size()). On equal keys the one
+// already present, or the first in the input, is kept. Iterators and
+// references are invalidated by every insert and erase.
+template <typename K, typename Compare = std::less<K>, typename Allocator = std::allocator<K>>
+class FlatSet {
+ public:
+  using key_type = K;
+  using value_type = K;
+  using key_compare = Compare;
+  using container_type = Vector<K, Allocator>;
+  using const_iterator = typename container_type::ConstIterator;
+  using iterator = const_iterator;
+
+  FlatSet(const Compare& comp = Compare(), const Allocator& alloc = Allocator());
+  template <std::ranges::input_range Range>
+    requires(!std::same_as<std::remove_cvref_t<Range>, FlatSet>)
+  explicit FlatSet(Range&& keys, const Compare& comp = Compare(),
+                   const Allocator& alloc = Allocator());
+  FlatSet(std::initializer_list<K> keys, const Compare& comp = Compare(),
+          const Allocator& alloc = Allocator());
+  // Adopts keys as they are; they must be sorted and unique.
+  FlatSet(sorted_unique_t, container_type keys, const Compare& comp = Compare());
+
+  // Iterators:
+  const_iterator begin() const noexcept { return keys_.begin(); }
+  const_iterator end() const noexcept { return keys_.end(); }
+  const_iterator cbegin() const noexcept { return keys_.cbegin(); }
+  const_iterator cend() const noexcept { return keys_.cend(); }
+
+  // Capacity:
+  std::size_t size() const noexcept { return keys_.size(); }
+  bool empty() const noexcept { return keys_.empty(); }
+  std::size_t capacity() const noexcept { return keys_.capacity(); }
+  void reserve(std::size_t count) { keys_.reserve(count); }
+  void shrink_to_fit() { keys_.shrink_to_fit(); }
+
+  // The sorted keys.
+  const container_type& keys() const noexcept { return keys_; }
+  const Compare& key_comp() const noexcept { return comp_; }
+
+  // Lookup:
+  const_iterator lower_bound(const K& key) const;
+  const_iterator upper_bound(const K& key) const;
+  const_iterator find(const K& key) const;
+  bool contains(const K& key) const { return find(key) != end(); }
+  std::size_t count(const K& key) const { return contains(key) ? 1 : 0; }
+
+  // Modifiers:
+  std::pair<const_iterator, bool> insert(const K& key) { return emplace(key); }
+  std::pair<const_iterator, bool> insert(K&& key) { return emplace(std::move(key)); }
+  template <typename... Args>
+  std::pair<const_iterator, bool> emplace(Args&&... args);
+  template <std::ranges::input_range Range>
+  void insert_range(Range&& keys);
+  std::size_t erase(const K& key);
+  const_iterator erase(const_iterator position) { return keys_.erase(position); }
+  void clear() noexcept { keys_.clear(); }
+  void swap(FlatSet& other) noexcept;
+
+  bool operator==(const FlatSet& other) const { return std::ranges::equal(keys_, other.keys_); }
+
+ private:
+  bool equivalent(const K& a, const K& b) const { return !comp_(a, b) && !comp_(b, a); }
+  // Sorts keys_ and drops repeated keys, keeping the first.
+  void sort_unique();
+
+  container_type keys_;
+  [[no_unique_address]] Compare comp_;
+};
+
+// Sorted map with keys and values in two parallel utils::Vectors, so a
+// lookup touches only the keys and a scan of the values streams one array.
+// It searches, builds and merges like FlatSet. Iterators yield
+// std::pair<const K&, V&> proxies; keys() and values() expose the arrays.
+template <typename K, typename V, typename Compare = std::less<K>,
+          typename KeyAllocator = std::allocator<K>, typename ValueAllocator = std::allocator<V>>
+class FlatMap {
+  template <bool Const>
+  class BasicIterator;
+
+ public:
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<K, V>;
+  using key_compare = Compare;
+  using reference = std::pair<const K&, V&>;
+  using const_reference = std::pair<const K&, const V&>;
+  using key_container_type = Vector<K, KeyAllocator>;
+  using mapped_container_type = Vector<V, ValueAllocator>;
+  using iterator = BasicIterator<false>;
+  using const_iterator = BasicIterator<true>;
+
+  FlatMap(const Compare& comp = Compare());
+  // Builds from (key, value) pairs; for repeated keys the first one wins.
+  template <std::ranges::input_range Range>
+    requires(!std::same_as<std::remove_cvref_t<Range>, FlatMap>)
+  explicit FlatMap(Range&& entries, const Compare& comp = Compare());
+  FlatMap(std::initializer_list<value_type> entries, const Compare& comp = Compare());
+  // Adopts the arrays as they are; keys must be sorted and unique and the
+  // sizes must match (std::invalid_argument otherwise).
+  FlatMap(sorted_unique_t, key_container_type keys, mapped_container_type values,
+          const Compare& comp = Compare());
+
+  // Iterators:
+  iterator begin() noexcept { return iterator(keys_.data(), values_.data(), 0); }
+  const_iterator begin() const noexcept { return const_iterator(keys_.data(), values_.data(), 0); }
+  iterator end() noexcept { return iterator(keys_.data(), values_.data(), size()); }
+  const_iterator end() const noexcept {
+    return const_iterator(keys_.data(), values_.data(), size());
+  }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+
+  // Capacity:
+  std::size_t size() const noexcept { return keys_.size(); }
+  bool empty() const noexcept { return keys_.empty(); }
+  void reserve(std::size_t count);
+  void shrink_to_fit();
+
+  const key_container_type& keys() const noexcept { return keys_; }
+  const mapped_container_type& values() const noexcept { return values_; }
+  std::span<V> values() noexcept { return {values_.data(), values_.size()}; }
+  const Compare& key_comp() const noexcept { return comp_; }
+
+  // Lookup:
+  iterator lower_bound(const K& key) { return at_index(lower_index(key)); }
+  const_iterator lower_bound(const K& key) const { return at_index(lower_index(key)); }
+  iterator upper_bound(const K& key) { return at_index(upper_index(key)); }
+  const_iterator upper_bound(const K& key) const { return at_index(upper_index(key)); }
+  iterator find(const K& key) { return at_index(find_index(key)); }
+  const_iterator find(const K& key) const { return at_index(find_index(key)); }
+  bool contains(const K& key) const { return find_index(key) != size(); }
+  std::size_t count(const K& key) const { return contains(key) ? 1 : 0; }
+  // Throws std::out_of_range if key is missing.
+  V& at(const K& key);
+  const V& at(const K& key) const;
+  V& operator[](const K& key) { return try_emplace(key).first->second; }
+  V& operator[](K&& key) { return try_emplace(std::move(key)).first->second; }
+
+  // Modifiers:
+  template <typename KeyArg, typename... Args>
+  std::pair<iterator, bool> try_emplace(KeyArg&& key, Args&&... args);
+  std::pair<iterator, bool> insert(const value_type& entry) {
+    return try_emplace(entry.first, entry.second);
+  }
+  std::pair<iterator, bool> insert(value_type&& entry) {
+    return try_emplace(std::move(entry.first), std::move(entry.second));
+  }
+  template <typename M>
+  std::pair<iterator, bool> insert_or_assign(const K& key, M&& value);
+  // Merges a range of (key, value) pairs: one sort of the new entries and
+  // one merge pass. Keys already present keep their value.
+  template <std::ranges::input_range Range>
+  void insert_range(Range&& entries);
+  std::size_t erase(const K& key);
+  iterator erase(const_iterator position);
+  void clear() noexcept;
+  void swap(FlatMap& other) noexcept;
+
+  bool operator==(const FlatMap& other) const {
+    return std::ranges::equal(keys_, other.keys_) && std::ranges::equal(values_, other.values_);
+  }
+
+ private:
+  std::size_t lower_index(const K& key) const;
+  std::size_t upper_index(const K& key) const;
+  std::size_t find_index(const K& key) const;
+  iterator at_index(std::size_t i) noexcept { return iterator(keys_.data(), values_.data(), i); }
+  const_iterator at_index(std::size_t i) const noexcept {
+    return const_iterator(keys_.data(), values_.data(), i);
+  }
+  // Sorts entries by key, keeping the first of equal keys, and drops the
+  // repeats.
+  void sort_unique(Vector<value_type>& entries) const;
+
+  key_container_type keys_;
+  mapped_container_type values_;
+  [[no_unique_address]] Compare comp_;
+};
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+template <bool Const>
+class FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::BasicIterator {
+  using mapped = std::conditional_t<Const, const V, V>;
+
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::pair<K, V>;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::pair<const K&, mapped&>;
+
+  // Lets it->first and it->second work on the proxy reference.
+  struct pointer {
+    reference ref;
+    const reference* operator->() const noexcept { return &ref; }
+  };
+
+  BasicIterator() noexcept = default;
+  BasicIterator(const K* keys, mapped* values, std::size_t index) noexcept
+      : keys_(keys), values_(values), index_(index) {}
+  // iterator converts to const_iterator.
+  template <bool OtherConst>
+    requires(Const && !OtherConst)
+  BasicIterator(const BasicIterator<OtherConst>& other) noexcept
+      : keys_(other.keys_), values_(other.values_), index_(other.index_) {}
+
+  reference operator*() const noexcept { return reference(keys_[index_], values_[index_]); }
+  pointer operator->() const noexcept { return pointer{**this}; }
+  reference operator[](difference_type n) const noexcept { return *(*this + n); }
+  // Position in keys() and values().
+  std::size_t index() const noexcept { return index_; }
+
+  BasicIterator& operator++() noexcept {
+    ++index_;
+    return *this;
+  }
+  BasicIterator operator++(int) noexcept { return BasicIterator(keys_, values_, index_++); }
+  BasicIterator& operator--() noexcept {
+    --index_;
+    return *this;
+  }
+  BasicIterator operator--(int) noexcept { return BasicIterator(keys_, values_, index_--); }
+  BasicIterator& operator+=(difference_type n) noexcept {
+    index_ += static_cast<std::size_t>(n);
+    return *this;
+  }
+  BasicIterator& operator-=(difference_type n) noexcept {
+    index_ -= static_cast<std::size_t>(n);
+    return *this;
+  }
+  BasicIterator operator+(difference_type n) const noexcept {
+    return BasicIterator(keys_, values_, index_ + static_cast<std::size_t>(n));
+  }
+  friend BasicIterator operator+(difference_type n, const BasicIterator& it) noexcept {
+    return it + n;
+  }
+  BasicIterator operator-(difference_type n) const noexcept {
+    return BasicIterator(keys_, values_, index_ - static_cast<std::size_t>(n));
+  }
+  difference_type operator-(const BasicIterator& other) const noexcept {
+    return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+  }
+
+  bool operator==(const BasicIterator& other) const noexcept { return index_ == other.index_; }
+  std::strong_ordering operator<=>(const BasicIterator& other) const noexcept {
+    return index_ <=> other.index_;
+  }
+
+ private:
+  template <bool>
+  friend class BasicIterator;
+
+  const K* keys_ = nullptr;
+  mapped* values_ = nullptr;
+  std::size_t index_ = 0;
+};
+
+}  // namespace utils
+
+#include "flat_map.tpp"
@@ -0,0 +1,367 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace utils {
+
+namespace detail {
+
+template <typename T, typename Pred>
+std::size_t branchless_partition_point(const T* base, std::size_t n, Pred pred) {
+  if (n == 0) {
+    return 0;
+  }
+  const T* first = base;
+  while (n > 1) {
+    const std::size_t half = n / 2;
+#if defined(__GNUC__) || defined(__clang__)
+    const std::size_t next_half = (n - half) / 2;
+    __builtin_prefetch(base + next_half);
+    __builtin_prefetch(base + half + next_half);
+#endif
+    base = pred(base[half]) ? base + half : base;
+    n -= half;
+  }
+  return static_cast<std::size_t>(base - first) + (pred(*base) ? 1 : 0);
+}
+
+}  // namespace detail
+
+// FlatSet:
+template <typename K, typename Compare, typename Allocator>
+FlatSet<K, Compare, Allocator>::FlatSet(const Compare& comp, const Allocator& alloc)
+    : keys_(alloc), comp_(comp) {}
+
+template <typename K, typename Compare, typename Allocator>
+template <std::ranges::input_range Range>
+  requires(!std::same_as<std::remove_cvref_t<Range>, FlatSet<K, Compare, Allocator>>)
+FlatSet<K, Compare, Allocator>::FlatSet(Range&& keys, const Compare& comp, const Allocator& alloc)
+    : keys_(alloc), comp_(comp) {
+  keys_.append_range(std::forward<Range>(keys));
+  sort_unique();
+}
+
+template <typename K, typename Compare, typename Allocator>
+FlatSet<K, Compare, Allocator>::FlatSet(std::initializer_list<K> keys, const Compare& comp,
+                                        const Allocator& alloc)
+    : keys_(keys, alloc), comp_(comp) {
+  sort_unique();
+}
+
+template <typename K, typename Compare, typename Allocator>
+FlatSet<K, Compare, Allocator>::FlatSet(sorted_unique_t, container_type keys, const Compare& comp)
+    : keys_(std::move(keys)), comp_(comp) {}
+
+template <typename K, typename Compare, typename Allocator>
+FlatSet<K, Compare, Allocator>::const_iterator FlatSet<K, Compare, Allocator>::lower_bound(
+    const K& key) const {
+  return begin() + static_cast<std::ptrdiff_t>(detail::branchless_partition_point(
+                       keys_.data(), size(), [&](const K& k) { return comp_(k, key); }));
+}
+
+template <typename K, typename Compare, typename Allocator>
+FlatSet<K, Compare, Allocator>::const_iterator FlatSet<K, Compare, Allocator>::upper_bound(
+    const K& key) const {
+  return begin() + static_cast<std::ptrdiff_t>(detail::branchless_partition_point(
+                       keys_.data(), size(), [&](const K& k) { return !comp_(key, k); }));
+}
+
+template <typename K, typename Compare, typename Allocator>
+FlatSet<K, Compare, Allocator>::const_iterator FlatSet<K, Compare, Allocator>::find(
+    const K& key) const {
+  const auto it = lower_bound(key);
+  return it != end() && !comp_(key, *it) ? it : end();
+}
+
+template <typename K, typename Compare, typename Allocator>
+template <typename... Args>
+std::pair<typename FlatSet<K, Compare, Allocator>::const_iterator, bool>
+FlatSet<K, Compare, Allocator>::emplace(Args&&... args) {
+  K key(std::forward<Args>(args)...);
+  const auto it = lower_bound(key);
+  if (it != end() && !comp_(key, *it)) {
+    return {it, false};
+  }
+  return {keys_.insert(it, std::move(key)), true};
+}
+
+template <typename K, typename Compare, typename Allocator>
+template <std::ranges::input_range Range>
+void FlatSet<K, Compare, Allocator>::insert_range(Range&& keys) {
+  // Filled directly rather than through the range constructor, which does
+  // not take a FlatSet.
+  FlatSet incoming(comp_, keys_.get_allocator());
+  incoming.keys_.append_range(std::forward<Range>(keys));
+  incoming.sort_unique();
+  if (incoming.empty()) {
+    return;
+  }
+  // Every move below is into reserved storage; with nothrow moves nothing
+  // after the reserve can throw, so a failure leaves the set unchanged.
+  if (empty() || comp_(keys_.back(), incoming.keys_.front())) {
+    keys_.reserve(size() + incoming.size());
+    for (auto& key : incoming.keys_) {
+      keys_.push_back(std::move_if_noexcept(key));
+    }
+    return;
+  }
+  container_type merged(keys_.get_allocator());
+  merged.reserve(size() + incoming.size());
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < size() || j < incoming.size()) {
+    if (j == incoming.size() || (i < size() && !comp_(incoming.keys_[j], keys_[i]))) {
+      if (j < incoming.size() && !comp_(keys_[i], incoming.keys_[j])) {
+        ++j;
+      }
+      merged.push_back(std::move_if_noexcept(keys_[i++]));
+    } else {
+      merged.push_back(std::move_if_noexcept(incoming.keys_[j++]));
+    }
+  }
+  keys_.swap(merged);
+}
+
+template <typename K, typename Compare, typename Allocator>
+std::size_t FlatSet<K, Compare, Allocator>::erase(const K& key) {
+  const auto it = find(key);
+  if (it == end()) {
+    return 0;
+  }
+  keys_.erase(it);
+  return 1;
+}
+
+template <typename K, typename Compare, typename Allocator>
+void FlatSet<K, Compare, Allocator>::swap(FlatSet& other) noexcept {
+  keys_.swap(other.keys_);
+  std::swap(comp_, other.comp_);
+}
+
+template <typename K, typename Compare, typename Allocator>
+void FlatSet<K, Compare, Allocator>::sort_unique() {
+  std::stable_sort(keys_.begin(), keys_.end(), comp_);
+  const auto last = std::unique(keys_.begin(), keys_.end(),
+                                [&](const K& a, const K& b) { return equivalent(a, b); });
+  keys_.erase(last, keys_.end());
+}
+
+// FlatMap:
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::FlatMap(const Compare& comp) : comp_(comp) {}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+template <std::ranges::input_range Range>
+  requires(!std::same_as<std::remove_cvref_t<Range>, FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>>)
+FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::FlatMap(Range&& entries, const Compare& comp)
+    : comp_(comp) {
+  Vector<value_type> sorted;
+  sorted.append_range(std::forward<Range>(entries));
+  sort_unique(sorted);
+  keys_.reserve(sorted.size());
+  values_.reserve(sorted.size());
+  for (auto& entry : sorted) {
+    keys_.push_back(std::move(entry.first));
+    values_.push_back(std::move(entry.second));
+  }
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::FlatMap(
+    std::initializer_list<value_type> entries, const Compare& comp)
+    : FlatMap(std::views::all(entries), comp) {}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::FlatMap(sorted_unique_t,
+                                                              key_container_type keys,
+                                                              mapped_container_type values,
+                                                              const Compare& comp)
+    : keys_(std::move(keys)), values_(std::move(values)), comp_(comp) {
+  if (keys_.size() != values_.size()) {
+    throw std::invalid_argument("FlatMap keys and values differ in size");
+  }
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+void FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::reserve(std::size_t count) {
+  keys_.reserve(count);
+  values_.reserve(count);
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+void FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::shrink_to_fit() {
+  keys_.shrink_to_fit();
+  values_.shrink_to_fit();
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+V& FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::at(const K& key) {
+  const std::size_t i = find_index(key);
+  if (i == size()) {
+    throw std::out_of_range("Key not found");
+  }
+  return values_[i];
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+const V& FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::at(const K& key) const {
+  const std::size_t i = find_index(key);
+  if (i == size()) {
+    throw std::out_of_range("Key not found");
+  }
+  return values_[i];
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+template <typename KeyArg, typename... Args>
+std::pair<typename FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::iterator, bool>
+FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::try_emplace(KeyArg&& key, Args&&... args) {
+  const std::size_t i = lower_index(key);
+  if (i != size() && !comp_(key, keys_[i])) {
+    return {at_index(i), false};
+  }
+  const auto position = static_cast<std::ptrdiff_t>(i);
+  keys_.insert(keys_.cbegin() + position, std::forward<KeyArg>(key));
+  try {
+    values_.emplace(values_.cbegin() + position, std::forward<Args>(args)...);
+  } catch (...) {
+    keys_.erase(keys_.cbegin() + position);
+    throw;
+  }
+  return {at_index(i), true};
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+template <typename M>
+std::pair<typename FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::iterator, bool>
+FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::insert_or_assign(const K& key, M&& value) {
+  auto result = try_emplace(key, std::forward<M>(value));
+  if (!result.second) {
+    values_[result.first.index()] = std::forward<M>(value);
+  }
+  return result;
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+template <std::ranges::input_range Range>
+void FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::insert_range(Range&& entries) {
+  Vector<value_type> incoming;
+  incoming.append_range(std::forward<Range>(entries));
+  if (incoming.empty()) {
+    return;
+  }
+  sort_unique(incoming);
+  // As in FlatSet::insert_range, nothing after the reserves throws when the
+  // moves do not.
+  if (empty() || comp_(keys_.back(), incoming.front().first)) {
+    reserve(size() + incoming.size());
+    const std::size_t old_size = size();
+    try {
+      for (auto& entry : incoming) {
+        values_.push_back(std::move_if_noexcept(entry.second));
+        keys_.push_back(std::move_if_noexcept(entry.first));
+      }
+    } catch (...) {
+      // A copy threw: drop what was appended, including a value whose key
+      // did not follow, so keys_ and values_ stay the same length.
+      while (values_.size() > old_size) {
+        values_.pop_back();
+      }
+      while (keys_.size() > old_size) {
+        keys_.pop_back();
+      }
+      throw;
+    }
+    return;
+  }
+  key_container_type merged_keys(keys_.get_allocator());
+  mapped_container_type merged_values(values_.get_allocator());
+  merged_keys.reserve(size() + incoming.size());
+  merged_values.reserve(size() + incoming.size());
+  std::size_t i = 0;
+  std::size_t j = 0;
+  while (i < size() || j < incoming.size()) {
+    if (j == incoming.size() || (i < size() && !comp_(incoming[j].first, keys_[i]))) {
+      if (j < incoming.size() && !comp_(keys_[i], incoming[j].first)) {
+        ++j;
+      }
+      merged_keys.push_back(std::move_if_noexcept(keys_[i]));
+      merged_values.push_back(std::move_if_noexcept(values_[i]));
+      ++i;
+    } else {
+      merged_keys.push_back(std::move_if_noexcept(incoming[j].first));
+      merged_values.push_back(std::move_if_noexcept(incoming[j].second));
+      ++j;
+    }
+  }
+  keys_.swap(merged_keys);
+  values_.swap(merged_values);
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+std::size_t FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::erase(const K& key) {
+  const std::size_t i = find_index(key);
+  if (i == size()) {
+    return 0;
+  }
+  erase(at_index(i));
+  return 1;
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::iterator
+FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::erase(const_iterator position) {
+  const auto i = static_cast<std::ptrdiff_t>(position.index());
+  keys_.erase(keys_.cbegin() + i);
+  values_.erase(values_.cbegin() + i);
+  return at_index(position.index());
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+void FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::clear() noexcept {
+  keys_.clear();
+  values_.clear();
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+void FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::swap(FlatMap& other) noexcept {
+  keys_.swap(other.keys_);
+  values_.swap(other.values_);
+  std::swap(comp_, other.comp_);
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+std::size_t FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::lower_index(const K& key) const {
+  return detail::branchless_partition_point(keys_.data(), size(),
+                                            [&](const K& k) { return comp_(k, key); });
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+std::size_t FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::upper_index(const K& key) const {
+  return detail::branchless_partition_point(keys_.data(), size(),
+                                            [&](const K& k) { return !comp_(key, k); });
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+std::size_t FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::find_index(const K& key) const {
+  const std::size_t i = lower_index(key);
+  return i != size() && !comp_(key, keys_[i]) ? i : size();
+}
+
+template <typename K, typename V, typename Compare, typename KeyAllocator, typename ValueAllocator>
+void FlatMap<K, V, Compare, KeyAllocator, ValueAllocator>::sort_unique(
+    Vector<value_type>& entries) const {
+  const auto by_key = [&](const value_type& a, const value_type& b) {
+    return comp_(a.first, b.first);
+  };
+  std::stable_sort(entries.begin(), entries.end(), by_key);
+  const auto last = std::unique(entries.begin(), entries.end(),
+                                [&](const value_type& a, const value_type& b) {
+                                  return !by_key(a, b) && !by_key(b, a);
+                                });
+  entries.erase(last, entries.end());
+}
+
+}  // namespace utils
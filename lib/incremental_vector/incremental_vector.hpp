@@ -0,0 +1,202 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+#include <lib/vector/growth_policy.hpp>
+#include <lib/vector/relocate.hpp>
+
+namespace utils {
+
+// Vector whose growth never moves the whole buffer in one call. When an
+// append finds the buffer full, a larger one is allocated and only the new
+// element is placed in it; the old elements follow a few at a time on the
+// next appends (at least MigrateStep each, and enough to finish before the
+// new buffer fills up). No append does more than one allocation plus
+// step() element moves.
+//
+// While a migration is pending, element i lives in the old buffer if it has
+// not moved yet and in the new one otherwise, so indexing and iteration cost
+// one extra comparison. data() finishes the migration first and returns
+// contiguous memory, and so does every operation that changes capacity
+// explicitly (reserve, shrink_to_fit). Appends may move elements while a
+// migration is pending, invalidating references to them; iterators hold an
+// index and stay valid.
+//
+// Migration cannot report failures, so elements must be nothrow move
+// constructible or trivially relocatable.
+template <typename T, typename Allocator = std::allocator<T>,
+          typename GrowthPolicy = DefaultGrowth, std::size_t MigrateStep = 4>
+class IncrementalVector {
+  static_assert(std::is_nothrow_move_constructible_v<T> ||
+                    detail::is_memcpy_relocatable_v<T, Allocator>,
+                "IncrementalVector elements must be relocatable without throwing");
+  static_assert(growth_policy_for<GrowthPolicy, T>,
+                "GrowthPolicy must provide next_capacity<T>(capacity, required, max_size)");
+  static_assert(MigrateStep > 0, "MigrateStep must be positive");
+
+  template <bool Const>
+  class BasicIterator;
+
+ public:
+  using value_type = T;
+  using allocator_type = Allocator;
+  using alloc_traits = std::allocator_traits<Allocator>;
+  using growth_policy = GrowthPolicy;
+  using iterator = BasicIterator<false>;
+  using const_iterator = BasicIterator<true>;
+
+  // Constructors / Destructor
+  IncrementalVector(const Allocator& alloc = Allocator());
+  IncrementalVector(const IncrementalVector& obj);
+  IncrementalVector(IncrementalVector&& other) noexcept;
+  IncrementalVector& operator=(const IncrementalVector& obj);
+  IncrementalVector& operator=(IncrementalVector&& other) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value ||
+      alloc_traits::is_always_equal::value);
+  ~IncrementalVector();
+
+  const Allocator& get_allocator() const noexcept { return alloc_; }
+
+  // Iterators:
+  iterator begin() noexcept { return iterator(this, 0); }
+  const_iterator begin() const noexcept { return const_iterator(this, 0); }
+  iterator end() noexcept { return iterator(this, size_); }
+  const_iterator end() const noexcept { return const_iterator(this, size_); }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+
+  // Capacity:
+  std::size_t size() const noexcept { return size_; }
+  std::size_t max_size() const noexcept;
+  std::size_t capacity() const noexcept { return capacity_; }
+  bool empty() const noexcept { return size_ == 0; }
+  void reserve(std::size_t malloc);
+  void shrink_to_fit();
+
+  // Migration:
+  // True while some elements still live in the previous buffer.
+  bool migrating() const noexcept { return old_ != nullptr; }
+  // Elements moved per append during the current migration.
+  std::size_t step() const noexcept { return step_; }
+  void finish_migration() noexcept;
+
+  // Element access:
+  T& operator[](std::size_t i) noexcept { return *slot(i); }
+  const T& operator[](std::size_t i) const noexcept { return *slot(i); }
+  T& at(std::size_t i);
+  const T& at(std::size_t i) const;
+  T& front() noexcept { return *slot(0); }
+  const T& front() const noexcept { return *slot(0); }
+  T& back() noexcept { return *slot(size_ - 1); }
+  const T& back() const noexcept { return *slot(size_ - 1); }
+  // Finishes a pending migration; not const for that reason.
+  T* data() noexcept;
+
+  // Modifiers:
+  void push_back(const T& obj);
+  void push_back(T&& obj);
+  template <typename... Args>
+  T& emplace_back(Args&&... args);
+  void pop_back();
+  void clear() noexcept;
+  void swap(IncrementalVector& obj) noexcept;
+
+ private:
+  T* slot(std::size_t i) const noexcept;
+  void grow();
+  void migrate(std::size_t count) noexcept;
+  void reallocate(std::size_t new_cap);
+
+  // Elements [migrated_, old_size_) still live in old_; all the others are
+  // in data_.
+  std::size_t size_;
+  T* data_;
+  std::size_t capacity_;
+  T* old_;
+  std::size_t old_capacity_;
+  std::size_t old_size_;
+  std::size_t migrated_;
+  std::size_t step_;
+  Allocator alloc_;
+};
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+template <bool Const>
+class IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::BasicIterator {
+  using Owner = std::conditional_t<Const, const IncrementalVector, IncrementalVector>;
+
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using pointer = std::conditional_t<Const, const T*, T*>;
+  using reference = std::conditional_t<Const, const T&, T&>;
+
+  BasicIterator() noexcept = default;
+  BasicIterator(Owner* owner, std::size_t index) noexcept : owner_(owner), index_(index) {}
+  // iterator converts to const_iterator.
+  template <bool OtherConst>
+    requires(Const && !OtherConst)
+  BasicIterator(const BasicIterator<OtherConst>& other) noexcept
+      : owner_(other.owner_), index_(other.index_) {}
+
+  reference operator*() const noexcept { return (*owner_)[index_]; }
+  pointer operator->() const noexcept { return &(*owner_)[index_]; }
+  reference operator[](difference_type n) const noexcept {
+    return (*owner_)[index_ + static_cast<std::size_t>(n)];
+  }
+
+  BasicIterator& operator++() noexcept {
+    ++index_;
+    return *this;
+  }
+  BasicIterator operator++(int) noexcept { return BasicIterator(owner_, index_++); }
+  BasicIterator& operator--() noexcept {
+    --index_;
+    return *this;
+  }
+  BasicIterator operator--(int) noexcept { return BasicIterator(owner_, index_--); }
+  BasicIterator& operator+=(difference_type n) noexcept {
+    index_ += static_cast<std::size_t>(n);
+    return *this;
+  }
+  BasicIterator& operator-=(difference_type n) noexcept {
+    index_ -= static_cast<std::size_t>(n);
+    return *this;
+  }
+  BasicIterator operator+(difference_type n) const noexcept {
+    return BasicIterator(owner_, index_ + static_cast<std::size_t>(n));
+  }
+  friend BasicIterator operator+(difference_type n, const BasicIterator& it) noexcept {
+    return it + n;
+  }
+  BasicIterator operator-(difference_type n) const noexcept {
+    return BasicIterator(owner_, index_ - static_cast<std::size_t>(n));
+  }
+  difference_type operator-(const BasicIterator& other) const noexcept {
+    return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+  }
+
+  bool operator==(const BasicIterator& other) const noexcept { return index_ == other.index_; }
+  std::strong_ordering operator<=>(const BasicIterator& other) const noexcept {
+    return index_ <=> other.index_;
+  }
+
+ private:
+  template <bool>
+  friend class BasicIterator;
+
+  Owner* owner_ = nullptr;
+  std::size_t index_ = 0;
+};
+
+}  // namespace utils
+
+#include "incremental_vector.tpp"
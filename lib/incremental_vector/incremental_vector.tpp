@@ -0,0 +1,345 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "incremental_vector.hpp"
+
+namespace utils {
+
+// Constructors / Destructor
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::IncrementalVector(
+    const Allocator& alloc)
+    : size_(0),
+      data_(nullptr),
+      capacity_(0),
+      old_(nullptr),
+      old_capacity_(0),
+      old_size_(0),
+      migrated_(0),
+      step_(0),
+      alloc_(alloc) {}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::IncrementalVector(
+    const IncrementalVector& obj)
+    : IncrementalVector(alloc_traits::select_on_container_copy_construction(obj.alloc_)) {
+  if (obj.size_ == 0) {
+    return;
+  }
+  this->data_ = alloc_traits::allocate(this->alloc_, obj.size_);
+  this->capacity_ = obj.size_;
+  std::size_t i = 0;
+  try {
+    for (; i < obj.size_; ++i) {
+      alloc_traits::construct(this->alloc_, this->data_ + i, obj[i]);
+    }
+  } catch (...) {
+    detail::destroy_n(this->alloc_, this->data_, i);
+    alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
+    throw;
+  }
+  this->size_ = obj.size_;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::IncrementalVector(
+    IncrementalVector&& other) noexcept
+    : size_(std::exchange(other.size_, 0)),
+      data_(std::exchange(other.data_, nullptr)),
+      capacity_(std::exchange(other.capacity_, 0)),
+      old_(std::exchange(other.old_, nullptr)),
+      old_capacity_(std::exchange(other.old_capacity_, 0)),
+      old_size_(std::exchange(other.old_size_, 0)),
+      migrated_(std::exchange(other.migrated_, 0)),
+      step_(std::exchange(other.step_, 0)),
+      alloc_(std::move(other.alloc_)) {}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>&
+IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::operator=(
+    const IncrementalVector& obj) {
+  if (this != &obj) {
+    IncrementalVector tmp(obj);
+    if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+      this->clear();
+      if (this->data_) {
+        alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
+        this->data_ = nullptr;
+        this->capacity_ = 0;
+      }
+      this->alloc_ = obj.alloc_;
+    }
+    if (this->alloc_ == tmp.alloc_) {
+      this->swap(tmp);
+    } else {
+      this->clear();
+      this->reserve(tmp.size_);
+      for (std::size_t i = 0; i < tmp.size_; ++i) {
+        this->push_back(std::move(tmp[i]));
+      }
+    }
+  }
+  return *this;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>&
+IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::operator=(
+    IncrementalVector&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::
+                                            value ||
+                                        alloc_traits::is_always_equal::value) {
+  if (this == &other) {
+    return *this;
+  }
+  if (alloc_traits::propagate_on_container_move_assignment::value ||
+      this->alloc_ == other.alloc_) {
+    this->clear();
+    if (this->data_) {
+      alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
+    }
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+      this->alloc_ = std::move(other.alloc_);
+    }
+    this->size_ = std::exchange(other.size_, 0);
+    this->data_ = std::exchange(other.data_, nullptr);
+    this->capacity_ = std::exchange(other.capacity_, 0);
+    this->old_ = std::exchange(other.old_, nullptr);
+    this->old_capacity_ = std::exchange(other.old_capacity_, 0);
+    this->old_size_ = std::exchange(other.old_size_, 0);
+    this->migrated_ = std::exchange(other.migrated_, 0);
+    this->step_ = std::exchange(other.step_, 0);
+  } else {
+    this->clear();
+    this->reserve(other.size_);
+    for (std::size_t i = 0; i < other.size_; ++i) {
+      this->push_back(std::move(other[i]));
+    }
+    other.clear();
+  }
+  return *this;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::~IncrementalVector() {
+  this->clear();
+  if (this->data_) {
+    alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
+  }
+}
+
+// Capacity
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+std::size_t IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::max_size() const noexcept {
+  return alloc_traits::max_size(this->alloc_);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::reserve(std::size_t malloc) {
+  if (malloc <= this->capacity_) {
+    return;
+  }
+  if (malloc > max_size()) {
+    throw std::length_error("IncrementalVector size exceeds max_size()");
+  }
+  this->finish_migration();
+  this->reallocate(malloc);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::shrink_to_fit() {
+  this->finish_migration();
+  if (this->size_ == this->capacity_) {
+    return;
+  }
+  if (this->size_ == 0) {
+    alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
+    this->data_ = nullptr;
+    this->capacity_ = 0;
+    return;
+  }
+  this->reallocate(this->size_);
+}
+
+// Migration
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::finish_migration() noexcept {
+  if (this->old_) {
+    this->migrate(this->old_size_ - this->migrated_);
+  }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::migrate(
+    std::size_t count) noexcept {
+  count = std::min(count, this->old_size_ - this->migrated_);
+  detail::relocate(this->alloc_, this->old_ + this->migrated_, count,
+                   this->data_ + this->migrated_);
+  this->migrated_ += count;
+  if (this->migrated_ == this->old_size_) {
+    alloc_traits::deallocate(this->alloc_, this->old_, this->old_capacity_);
+    this->old_ = nullptr;
+    this->old_capacity_ = 0;
+    this->old_size_ = 0;
+    this->migrated_ = 0;
+    this->step_ = 0;
+  }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+T* IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::slot(
+    std::size_t i) const noexcept {
+  // Unsigned wrap-around folds both bounds into one comparison; with no
+  // migration pending the range is empty.
+  if (i - this->migrated_ < this->old_size_ - this->migrated_) {
+    return this->old_ + i;
+  }
+  return this->data_ + i;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::grow() {
+  if (this->size_ >= max_size()) {
+    throw std::length_error("IncrementalVector size exceeds max_size()");
+  }
+  // Only reachable mid-migration if the growth policy left fewer free slots
+  // than MigrateStep can cover; the remaining elements move now.
+  this->finish_migration();
+  const std::size_t new_cap = GrowthPolicy::template next_capacity<T>(
+      this->capacity_, this->size_ + 1, max_size());
+  auto [new_data, allocated] = detail::allocate_at_least(this->alloc_, new_cap);
+  if (this->size_ == 0) {
+    if (this->data_) {
+      alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
+    }
+  } else {
+    this->old_ = this->data_;
+    this->old_capacity_ = this->capacity_;
+    this->old_size_ = this->size_;
+    this->migrated_ = 0;
+    // Every append until the new buffer is full moves step_ elements, which
+    // is enough to empty the old buffer by then.
+    const std::size_t appends = allocated - this->size_;
+    this->step_ = std::max(MigrateStep, (this->size_ + appends - 1) / appends);
+  }
+  this->data_ = new_data;
+  this->capacity_ = allocated;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::reallocate(
+    std::size_t new_cap) {
+  T* new_data = alloc_traits::allocate(this->alloc_, new_cap);
+  detail::relocate(this->alloc_, this->data_, this->size_, new_data);
+  if (this->data_) {
+    alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
+  }
+  this->data_ = new_data;
+  this->capacity_ = new_cap;
+}
+
+// Element access
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+T& IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::at(std::size_t i) {
+  if (i >= this->size_) {
+    throw std::out_of_range("");
+  }
+  return *this->slot(i);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+const T& IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::at(std::size_t i) const {
+  if (i >= this->size_) {
+    throw std::out_of_range("");
+  }
+  return *this->slot(i);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+T* IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::data() noexcept {
+  this->finish_migration();
+  return this->data_;
+}
+
+// Modifiers
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::push_back(const T& obj) {
+  this->emplace_back(obj);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::push_back(T&& obj) {
+  this->emplace_back(std::move(obj));
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+template <typename... Args>
+T& IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::emplace_back(Args&&... args) {
+  if (this->size_ == this->capacity_) {
+    this->grow();
+  }
+  // The new element is built before migrating so that arguments referring
+  // to elements of this vector are still in place.
+  T* element = this->data_ + this->size_;
+  alloc_traits::construct(this->alloc_, element, std::forward<Args>(args)...);
+  ++this->size_;
+  if (this->old_) {
+    this->migrate(this->step_);
+  }
+  return *element;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::pop_back() {
+  if (this->size_ == 0) {
+    throw std::out_of_range("Trying to pop from empty IncrementalVector.");
+  }
+  --this->size_;
+  alloc_traits::destroy(this->alloc_, this->slot(this->size_));
+  if (this->size_ < this->old_size_) {
+    // The last element was still waiting in the old buffer.
+    this->old_size_ = this->size_;
+    this->migrate(0);
+  }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::clear() noexcept {
+  detail::destroy_n(this->alloc_, this->data_, this->migrated_);
+  detail::destroy_n(this->alloc_, this->old_ + this->migrated_, this->old_size_ - this->migrated_);
+  detail::destroy_n(this->alloc_, this->data_ + this->old_size_, this->size_ - this->old_size_);
+  this->size_ = 0;
+  if (this->old_) {
+    this->old_size_ = 0;
+    this->migrated_ = 0;
+    this->migrate(0);
+  }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, std::size_t MigrateStep>
+void IncrementalVector<T, Allocator, GrowthPolicy, MigrateStep>::swap(
+    IncrementalVector& obj) noexcept {
+  using std::swap;
+  swap(this->size_, obj.size_);
+  swap(this->data_, obj.data_);
+  swap(this->capacity_, obj.capacity_);
+  swap(this->old_, obj.old_);
+  swap(this->old_capacity_, obj.old_capacity_);
+  swap(this->old_size_, obj.old_size_);
+  swap(this->migrated_, obj.migrated_);
+  swap(this->step_, obj.step_);
+  if constexpr (alloc_traits::propagate_on_container_swap::value) {
+    swap(this->alloc_, obj.alloc_);
+  }
+}
+
+}  // namespace utils
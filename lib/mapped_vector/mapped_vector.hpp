@@ -0,0 +1,104 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <type_traits>
+
+#include <lib/vector/growth_policy.hpp>
+
+namespace utils {
+
+// Vector whose elements live in a memory-mapped file. The file is a plain
+// array of T with no header, so existing record files can be opened as-is
+// and opening costs the same for any file size: pages are read in by the
+// kernel on first access.
+//
+// While open for writing the file is extended to the capacity; close() (or
+// the destructor) truncates it back to size() elements. Only trivially
+// copyable T can be stored, since elements are reinterpreted from raw file
+// bytes. Errors from the system calls are thrown as std::system_error.
+template <typename T, typename GrowthPolicy = DefaultGrowth>
+class MappedVector {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "MappedVector stores raw bytes and needs a trivially copyable T");
+  static_assert(growth_policy_for<GrowthPolicy, T>,
+                "GrowthPolicy must provide next_capacity<T>(capacity, required, max_size)");
+
+ public:
+  using value_type = T;
+  using growth_policy = GrowthPolicy;
+
+  enum class Mode {
+    kReadOnly,   // PROT_READ mapping. Mutating calls throw std::logic_error
+                 // and stores through element references fault.
+    kReadWrite,  // Existing file, shared writable mapping.
+    kCreate,     // Creates the file, or truncates an existing one.
+  };
+
+  MappedVector() noexcept;
+  explicit MappedVector(const std::string& path, Mode mode = Mode::kReadOnly);
+  MappedVector(const MappedVector&) = delete;
+  MappedVector(MappedVector&& other) noexcept;
+  MappedVector& operator=(const MappedVector&) = delete;
+  MappedVector& operator=(MappedVector&& other) noexcept;
+  ~MappedVector();
+
+  bool is_open() const noexcept { return fd_ != -1; }
+  bool writable() const noexcept { return writable_; }
+
+  // Iterators:
+  T* begin() noexcept { return data_; }
+  const T* begin() const noexcept { return data_; }
+  T* end() noexcept { return data_ + size_; }
+  const T* end() const noexcept { return data_ + size_; }
+  // Capacity:
+  std::size_t size() const noexcept { return size_; }
+  std::size_t capacity() const noexcept { return capacity_; }
+  std::size_t max_size() const noexcept;
+  bool empty() const noexcept { return size_ == 0; }
+  void reserve(std::size_t capacity);
+  // New elements are zero-filled, as a freshly extended file is.
+  void resize(std::size_t size);
+  void shrink_to_fit();
+  // Element access:
+  T& operator[](std::size_t i) { return data_[i]; }
+  const T& operator[](std::size_t i) const { return data_[i]; }
+  T& at(std::size_t i);
+  const T& at(std::size_t i) const;
+  T& front() { return data_[0]; }
+  const T& front() const { return data_[0]; }
+  T& back() { return data_[size_ - 1]; }
+  const T& back() const { return data_[size_ - 1]; }
+  T* data() noexcept { return data_; }
+  const T* data() const noexcept { return data_; }
+  // Modifiers:
+  void push_back(const T& value);
+  void append(const T* values, std::size_t count);
+  void pop_back();
+  void clear();
+
+  // Writes dirty pages back to the file. With wait == false the write-back
+  // is only scheduled (MS_ASYNC).
+  void flush(bool wait = true);
+  // Flushes, unmaps and trims the file to size() elements.
+  void close();
+
+ private:
+  static std::size_t bytes(std::size_t count) noexcept { return count * sizeof(T); }
+  void check_writable() const;
+  void map(std::size_t capacity);
+  void remap(std::size_t capacity);
+  void unmap() noexcept;
+
+  int fd_;
+  T* data_;
+  std::size_t size_;
+  std::size_t capacity_;
+  bool writable_;
+};
+
+}  // namespace utils
+
+#include "mapped_vector.tpp"
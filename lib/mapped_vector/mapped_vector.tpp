@@ -0,0 +1,312 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "mapped_vector.hpp"
+
+namespace utils {
+
+namespace detail {
+
+[[noreturn]] inline void throw_errno(const std::string& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+}  // namespace detail
+
+// Constructors / Destructor
+
+template <typename T, typename GrowthPolicy>
+MappedVector<T, GrowthPolicy>::MappedVector() noexcept
+    : fd_(-1), data_(nullptr), size_(0), capacity_(0), writable_(false) {}
+
+template <typename T, typename GrowthPolicy>
+MappedVector<T, GrowthPolicy>::MappedVector(const std::string& path, Mode mode)
+    : MappedVector() {
+  int flags = O_RDWR;
+  if (mode == Mode::kReadOnly) {
+    flags = O_RDONLY;
+  } else if (mode == Mode::kCreate) {
+    flags |= O_CREAT | O_TRUNC;
+  }
+  this->fd_ = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+  if (this->fd_ == -1) {
+    detail::throw_errno("MappedVector: cannot open " + path);
+  }
+  this->writable_ = mode != Mode::kReadOnly;
+
+  try {
+    struct stat info;
+    if (::fstat(this->fd_, &info) != 0) {
+      detail::throw_errno("MappedVector: cannot stat " + path);
+    }
+    const auto file_bytes = static_cast<std::size_t>(info.st_size);
+    if (file_bytes % sizeof(T) != 0) {
+      throw std::runtime_error("MappedVector: size of " + path +
+                               " is not a multiple of the element size");
+    }
+    if (file_bytes != 0) {
+      map(file_bytes / sizeof(T));
+    }
+    this->size_ = this->capacity_;
+  } catch (...) {
+    ::close(this->fd_);
+    this->fd_ = -1;
+    throw;
+  }
+}
+
+template <typename T, typename GrowthPolicy>
+MappedVector<T, GrowthPolicy>::MappedVector(MappedVector&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1)),
+      data_(std::exchange(other.data_, nullptr)),
+      size_(std::exchange(other.size_, 0)),
+      capacity_(std::exchange(other.capacity_, 0)),
+      writable_(std::exchange(other.writable_, false)) {}
+
+template <typename T, typename GrowthPolicy>
+MappedVector<T, GrowthPolicy>& MappedVector<T, GrowthPolicy>::operator=(
+    MappedVector&& other) noexcept {
+  if (this != &other) {
+    try {
+      close();
+    } catch (...) {
+      // close() leaves the object closed even when write-back fails.
+    }
+    this->fd_ = std::exchange(other.fd_, -1);
+    this->data_ = std::exchange(other.data_, nullptr);
+    this->size_ = std::exchange(other.size_, 0);
+    this->capacity_ = std::exchange(other.capacity_, 0);
+    this->writable_ = std::exchange(other.writable_, false);
+  }
+  return *this;
+}
+
+template <typename T, typename GrowthPolicy>
+MappedVector<T, GrowthPolicy>::~MappedVector() {
+  try {
+    close();
+  } catch (...) {
+    // Destructors cannot report; call close() explicitly to see errors.
+  }
+}
+
+// Private helper methods
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::check_writable() const {
+  if (!this->writable_) {
+    throw std::logic_error("MappedVector is not open for writing");
+  }
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::map(std::size_t capacity) {
+  const int protection = this->writable_ ? PROT_READ | PROT_WRITE : PROT_READ;
+  void* addr = ::mmap(nullptr, bytes(capacity), protection, MAP_SHARED, this->fd_, 0);
+  if (addr == MAP_FAILED) {
+    detail::throw_errno("MappedVector: mmap failed");
+  }
+  this->data_ = static_cast<T*>(addr);
+  this->capacity_ = capacity;
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::unmap() noexcept {
+  if (this->data_ != nullptr) {
+    ::munmap(this->data_, bytes(this->capacity_));
+    this->data_ = nullptr;
+  }
+  this->capacity_ = 0;
+}
+
+// Resizes the file and the mapping to hold capacity elements. The file is
+// extended before the mapping so no page ever lies past end of file; on
+// Linux mremap moves the pages instead of copying them.
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::remap(std::size_t capacity) {
+  const std::size_t old_capacity = this->capacity_;
+  if (capacity > old_capacity &&
+      ::ftruncate(this->fd_, static_cast<off_t>(bytes(capacity))) != 0) {
+    detail::throw_errno("MappedVector: ftruncate failed");
+  }
+  try {
+    if (capacity == 0) {
+      unmap();
+    } else if (this->data_ == nullptr) {
+      map(capacity);
+    } else {
+#if defined(__linux__)
+      void* addr = ::mremap(this->data_, bytes(old_capacity), bytes(capacity), MREMAP_MAYMOVE);
+      if (addr == MAP_FAILED) {
+        detail::throw_errno("MappedVector: mremap failed");
+      }
+      this->data_ = static_cast<T*>(addr);
+      this->capacity_ = capacity;
+#else
+      unmap();
+      map(capacity);
+#endif
+    }
+  } catch (...) {
+    if (capacity > old_capacity) {
+      ::ftruncate(this->fd_, static_cast<off_t>(bytes(old_capacity)));
+    }
+    throw;
+  }
+  if (capacity < old_capacity &&
+      ::ftruncate(this->fd_, static_cast<off_t>(bytes(capacity))) != 0) {
+    detail::throw_errno("MappedVector: ftruncate failed");
+  }
+}
+
+// Capacity:
+
+template <typename T, typename GrowthPolicy>
+std::size_t MappedVector<T, GrowthPolicy>::max_size() const noexcept {
+  return static_cast<std::size_t>(std::numeric_limits<off_t>::max()) / sizeof(T);
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::reserve(std::size_t capacity) {
+  check_writable();
+  if (capacity <= this->capacity_) {
+    return;
+  }
+  if (capacity > max_size()) {
+    throw std::length_error("MappedVector size exceeds max_size()");
+  }
+  remap(capacity);
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::resize(std::size_t size) {
+  check_writable();
+  reserve(size);
+  if (size > this->size_) {
+    std::memset(static_cast<void*>(this->data_ + this->size_), 0, bytes(size - this->size_));
+  }
+  this->size_ = size;
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::shrink_to_fit() {
+  check_writable();
+  if (this->size_ != this->capacity_) {
+    remap(this->size_);
+  }
+}
+
+// Element access:
+
+template <typename T, typename GrowthPolicy>
+T& MappedVector<T, GrowthPolicy>::at(std::size_t i) {
+  if (i >= this->size_) {
+    throw std::out_of_range("");
+  }
+  return this->data_[i];
+}
+
+template <typename T, typename GrowthPolicy>
+const T& MappedVector<T, GrowthPolicy>::at(std::size_t i) const {
+  if (i >= this->size_) {
+    throw std::out_of_range("");
+  }
+  return this->data_[i];
+}
+
+// Modifiers:
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::push_back(const T& value) {
+  append(&value, 1);
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::append(const T* values, std::size_t count) {
+  check_writable();
+  if (count > max_size() - this->size_) {
+    throw std::length_error("MappedVector size exceeds max_size()");
+  }
+  if (count > this->capacity_ - this->size_) {
+    // values may point into the mapping, which can move.
+    const bool aliased = values >= this->data_ && values < this->data_ + this->size_;
+    const std::size_t offset = aliased ? static_cast<std::size_t>(values - this->data_) : 0;
+    remap(GrowthPolicy::template next_capacity<T>(this->capacity_, this->size_ + count,
+                                                  max_size()));
+    if (aliased) {
+      values = this->data_ + offset;
+    }
+  }
+  if (count != 0) {
+    std::memmove(static_cast<void*>(this->data_ + this->size_),
+                 static_cast<const void*>(values), bytes(count));
+  }
+  this->size_ += count;
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::pop_back() {
+  check_writable();
+  if (this->size_ == 0) {
+    throw std::out_of_range("Trying to pop from empty MappedVector.");
+  }
+  --this->size_;
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::clear() {
+  check_writable();
+  this->size_ = 0;
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::flush(bool wait) {
+  if (!this->writable_ || this->size_ == 0) {
+    return;
+  }
+  if (::msync(this->data_, bytes(this->size_), wait ? MS_SYNC : MS_ASYNC) != 0) {
+    detail::throw_errno("MappedVector: msync failed");
+  }
+}
+
+template <typename T, typename GrowthPolicy>
+void MappedVector<T, GrowthPolicy>::close() {
+  if (!is_open()) {
+    return;
+  }
+  int error = 0;
+  if (this->writable_ && this->size_ != 0 &&
+      ::msync(this->data_, bytes(this->size_), MS_SYNC) != 0) {
+    error = errno;
+  }
+  unmap();
+  if (this->writable_ &&
+      ::ftruncate(this->fd_, static_cast<off_t>(bytes(this->size_))) != 0 && error == 0) {
+    error = errno;
+  }
+  if (::close(this->fd_) != 0 && error == 0) {
+    error = errno;
+  }
+  this->fd_ = -1;
+  this->size_ = 0;
+  this->writable_ = false;
+  if (error != 0) {
+    throw std::system_error(error, std::generic_category(), "MappedVector: close failed");
+  }
+}
+
+}  // namespace utils
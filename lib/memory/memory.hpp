@@ -0,0 +1,228 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+
+#include <lib/vector/growth_policy.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace utils {
+
+namespace memory {
+
+constexpr std::size_t kDefaultChunkSize = 64 * 1024;
+
+// Bump-pointer arena. deallocate() is a no-op; everything handed out is
+// returned at once by release() or the destructor, so a request-scoped
+// batch of containers is freed in O(number of chunks). Not thread-safe.
+class MonotonicArena {
+ public:
+  explicit MonotonicArena(
+      std::size_t initial_chunk = kDefaultChunkSize,
+      std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+  MonotonicArena(void* buffer, std::size_t size,
+                 std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+  MonotonicArena(const MonotonicArena&) = delete;
+  MonotonicArena& operator=(const MonotonicArena&) = delete;
+  ~MonotonicArena();
+
+  void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+  void deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept;
+  // Returns every chunk upstream.
+  void release() noexcept;
+  // Rewinds to empty but keeps the newest (largest) chunk for reuse, so a
+  // steady request loop stops calling upstream at all.
+  void reset() noexcept;
+
+  // Bytes handed out since construction or the last release() / reset().
+  std::size_t bytes_used() const noexcept { return bytes_used_; }
+  std::pmr::memory_resource* upstream() const noexcept { return upstream_; }
+
+ private:
+  struct Chunk {
+    Chunk* next;
+    std::size_t size;
+  };
+
+  void add_chunk(std::size_t min_bytes, std::size_t alignment);
+
+  Chunk* chunks_;
+  char* current_;
+  char* end_;
+  char* initial_buffer_;
+  std::size_t initial_size_;
+  std::size_t initial_chunk_size_;
+  std::size_t next_chunk_size_;
+  std::size_t bytes_used_;
+  std::pmr::memory_resource* upstream_;
+};
+
+// Segregated free lists for power-of-two size classes from kMinBlock to
+// kMaxBlock bytes; larger or over-aligned requests go straight upstream.
+// Freed blocks are reused by later requests of the same class. Not
+// thread-safe.
+class PoolResource {
+ public:
+  static constexpr std::size_t kMinBlock = 8;
+  static constexpr std::size_t kMaxBlock = 4096;
+  static constexpr std::size_t kClasses = 10;  // 8, 16, ..., 4096
+
+  explicit PoolResource(
+      std::size_t chunk_size = kDefaultChunkSize,
+      std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+  PoolResource(const PoolResource&) = delete;
+  PoolResource& operator=(const PoolResource&) = delete;
+  ~PoolResource();
+
+  void* allocate(std::size_t bytes, std::size_t alignment = alignof(std::max_align_t));
+  void deallocate(void* p, std::size_t bytes, std::size_t alignment) noexcept;
+  void release() noexcept;
+
+  std::pmr::memory_resource* upstream() const noexcept { return upstream_; }
+
+ private:
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+  struct Chunk {
+    Chunk* next;
+    std::size_t size;
+  };
+
+  static std::size_t size_class(std::size_t bytes) noexcept;
+  void refill(std::size_t index);
+
+  std::array<FreeBlock*, kClasses> free_lists_{};
+  Chunk* chunks_;
+  std::size_t chunk_size_;
+  std::pmr::memory_resource* upstream_;
+};
+
+// Standard allocator that draws from a MonotonicArena or PoolResource held
+// by reference. Two allocators compare equal when they share a resource.
+template <typename T, typename Resource>
+class ResourceAllocator {
+ public:
+  using value_type = T;
+  using resource_type = Resource;
+
+  ResourceAllocator(Resource& resource) noexcept : resource_(&resource) {}
+  template <typename U>
+  ResourceAllocator(const ResourceAllocator<U, Resource>& other) noexcept
+      : resource_(other.resource()) {}
+
+  T* allocate(std::size_t n);
+  void deallocate(T* p, std::size_t n) noexcept;
+
+  Resource* resource() const noexcept { return resource_; }
+
+  template <typename U>
+  bool operator==(const ResourceAllocator<U, Resource>& other) const noexcept {
+    return resource_ == other.resource();
+  }
+
+ private:
+  Resource* resource_;
+};
+
+template <typename T>
+using ArenaAllocator = ResourceAllocator<T, MonotonicArena>;
+
+template <typename T>
+using PoolAllocator = ResourceAllocator<T, PoolResource>;
+
+constexpr std::size_t kHugePageSize = std::size_t{2} << 20;
+
+// Allocator for large arrays of trivially relocatable data. Every block is
+// aligned to Alignment (at most the 4 KiB page size). Blocks of at least
+// MapThreshold bytes come straight from mmap; those of HugePageThreshold
+// bytes or more are placed on a 2 MiB boundary and marked MADV_HUGEPAGE.
+//
+// reallocate() lets Vector grow mapped blocks with mremap on Linux: the
+// kernel moves page table entries, so nothing is copied and peak RSS stays
+// at the new size instead of old + new.
+template <typename T, std::size_t Alignment = 64,
+          std::size_t HugePageThreshold = kHugePageSize,
+          std::size_t MapThreshold = std::size_t{64} << 10>
+class PageAllocator {
+  static_assert(std::has_single_bit(Alignment) && Alignment <= 4096,
+                "Alignment must be a power of two no larger than a page");
+  static_assert(Alignment >= alignof(T), "Alignment must satisfy alignof(T)");
+
+ public:
+  using value_type = T;
+  using is_always_equal = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+
+  template <typename U>
+  struct rebind {
+    using other = PageAllocator<U, std::max(Alignment, alignof(U)), HugePageThreshold,
+                                MapThreshold>;
+  };
+
+  static constexpr std::size_t alignment = Alignment;
+
+  PageAllocator() noexcept = default;
+  template <typename U, std::size_t A>
+  PageAllocator(const PageAllocator<U, A, HugePageThreshold, MapThreshold>&) noexcept {}
+
+  T* allocate(std::size_t n);
+  // Reports the page-rounded size of mapped blocks as usable capacity.
+  detail::allocation_result<T*> allocate_at_least(std::size_t n);
+  void deallocate(T* p, std::size_t n) noexcept;
+  // Resizes the block at p from old_n to new_n elements, keeping the first
+  // min(old_n, new_n) elements bytewise. Throws std::bad_alloc and leaves p
+  // untouched on failure.
+  T* reallocate(T* p, std::size_t old_n, std::size_t new_n);
+
+  template <typename U, std::size_t A>
+  bool operator==(const PageAllocator<U, A, HugePageThreshold, MapThreshold>&) const noexcept {
+    return true;
+  }
+
+ private:
+  static std::size_t page_size() noexcept;
+  static std::size_t byte_size(std::size_t n);
+  static bool is_mapped(std::size_t bytes) noexcept { return bytes >= MapThreshold; }
+  static std::size_t mapped_size(std::size_t bytes) noexcept;
+  static void* map(std::size_t bytes);
+  static void advise(void* p, std::size_t bytes) noexcept;
+};
+
+// Exposes a MonotonicArena or PoolResource as a std::pmr::memory_resource
+// so it can back std::pmr::polymorphic_allocator and utils::pmr::Vector.
+template <typename Resource>
+class MemoryResourceAdapter final : public std::pmr::memory_resource {
+ public:
+  explicit MemoryResourceAdapter(Resource& resource) noexcept
+      : resource_(&resource) {}
+
+  Resource& resource() const noexcept { return *resource_; }
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override;
+  bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+  Resource* resource_;
+};
+
+}  // namespace memory
+
+namespace pmr {
+
+template <typename T, typename GrowthPolicy = DefaultGrowth>
+using Vector = utils::Vector<T, std::pmr::polymorphic_allocator<T>, GrowthPolicy>;
+
+}  // namespace pmr
+
+}  // namespace utils
+
+#include "memory.tpp"
@@ -0,0 +1,370 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <memory_resource>
+#include <new>
+
+#include "memory.hpp"
+
+namespace utils {
+
+namespace memory {
+
+// MonotonicArena
+
+inline MonotonicArena::MonotonicArena(std::size_t initial_chunk,
+                                      std::pmr::memory_resource* upstream)
+    : chunks_(nullptr),
+      current_(nullptr),
+      end_(nullptr),
+      initial_buffer_(nullptr),
+      initial_size_(0),
+      initial_chunk_size_(std::max<std::size_t>(initial_chunk, sizeof(Chunk) * 2)),
+      next_chunk_size_(initial_chunk_size_),
+      bytes_used_(0),
+      upstream_(upstream) {}
+
+inline MonotonicArena::MonotonicArena(void* buffer, std::size_t size,
+                                      std::pmr::memory_resource* upstream)
+    : chunks_(nullptr),
+      current_(static_cast<char*>(buffer)),
+      end_(static_cast<char*>(buffer) + size),
+      initial_buffer_(static_cast<char*>(buffer)),
+      initial_size_(size),
+      initial_chunk_size_(std::max<std::size_t>(size * 2, kDefaultChunkSize)),
+      next_chunk_size_(initial_chunk_size_),
+      bytes_used_(0),
+      upstream_(upstream) {}
+
+inline MonotonicArena::~MonotonicArena() {
+  release();
+}
+
+inline void* MonotonicArena::allocate(std::size_t bytes, std::size_t alignment) {
+  if (bytes == 0) {
+    bytes = 1;
+  }
+  void* p = current_;
+  std::size_t space = static_cast<std::size_t>(end_ - current_);
+  if (current_ == nullptr || std::align(alignment, bytes, p, space) == nullptr) {
+    add_chunk(bytes, alignment);
+    p = current_;
+    space = static_cast<std::size_t>(end_ - current_);
+    std::align(alignment, bytes, p, space);
+  }
+  current_ = static_cast<char*>(p) + bytes;
+  bytes_used_ += bytes;
+  return p;
+}
+
+inline void MonotonicArena::deallocate(void*, std::size_t, std::size_t) noexcept {}
+
+inline void MonotonicArena::release() noexcept {
+  while (chunks_ != nullptr) {
+    Chunk* next = chunks_->next;
+    upstream_->deallocate(chunks_, chunks_->size, alignof(std::max_align_t));
+    chunks_ = next;
+  }
+  current_ = initial_buffer_;
+  end_ = initial_buffer_ == nullptr ? nullptr : initial_buffer_ + initial_size_;
+  next_chunk_size_ = initial_chunk_size_;
+  bytes_used_ = 0;
+}
+
+inline void MonotonicArena::reset() noexcept {
+  if (chunks_ == nullptr) {
+    release();
+    return;
+  }
+  Chunk* kept = chunks_;
+  chunks_ = kept->next;
+  const std::size_t next_size = next_chunk_size_;
+  release();
+  kept->next = nullptr;
+  chunks_ = kept;
+  current_ = reinterpret_cast<char*>(kept + 1);
+  end_ = reinterpret_cast<char*>(kept) + kept->size;
+  // Keep growing: if one round still spills, the next chunk is larger and
+  // becomes the one that is kept.
+  next_chunk_size_ = next_size;
+}
+
+inline void MonotonicArena::add_chunk(std::size_t min_bytes, std::size_t alignment) {
+  if (min_bytes > std::numeric_limits<std::size_t>::max() / 2 - alignment) {
+    throw std::bad_alloc();
+  }
+  const std::size_t needed = sizeof(Chunk) + min_bytes + alignment;
+  const std::size_t size = std::max(next_chunk_size_, needed);
+  auto* chunk = static_cast<Chunk*>(upstream_->allocate(size, alignof(std::max_align_t)));
+  chunk->next = chunks_;
+  chunk->size = size;
+  chunks_ = chunk;
+  current_ = reinterpret_cast<char*>(chunk + 1);
+  end_ = reinterpret_cast<char*>(chunk) + size;
+  next_chunk_size_ = size * 2;
+}
+
+// PoolResource
+
+inline PoolResource::PoolResource(std::size_t chunk_size,
+                                  std::pmr::memory_resource* upstream)
+    : chunks_(nullptr),
+      chunk_size_(std::max(chunk_size, sizeof(Chunk) + kMaxBlock)),
+      upstream_(upstream) {}
+
+inline PoolResource::~PoolResource() {
+  release();
+}
+
+inline std::size_t PoolResource::size_class(std::size_t bytes) noexcept {
+  const std::size_t block = std::bit_ceil(std::max(bytes, kMinBlock));
+  return static_cast<std::size_t>(std::countr_zero(block) -
+                                  std::countr_zero(kMinBlock));
+}
+
+inline void* PoolResource::allocate(std::size_t bytes, std::size_t alignment) {
+  if (bytes > kMaxBlock || alignment > alignof(std::max_align_t)) {
+    return upstream_->allocate(bytes, alignment);
+  }
+  // Blocks of a class are aligned to their size (up to max_align_t), so a
+  // small request with a larger alignment takes the class of its alignment.
+  const std::size_t index = size_class(std::max(bytes, alignment));
+  if (free_lists_[index] == nullptr) {
+    refill(index);
+  }
+  FreeBlock* block = free_lists_[index];
+  free_lists_[index] = block->next;
+  return block;
+}
+
+inline void PoolResource::deallocate(void* p, std::size_t bytes,
+                                     std::size_t alignment) noexcept {
+  if (p == nullptr) {
+    return;
+  }
+  if (bytes > kMaxBlock || alignment > alignof(std::max_align_t)) {
+    upstream_->deallocate(p, bytes, alignment);
+    return;
+  }
+  const std::size_t index = size_class(std::max(bytes, alignment));
+  auto* block = static_cast<FreeBlock*>(p);
+  block->next = free_lists_[index];
+  free_lists_[index] = block;
+}
+
+inline void PoolResource::release() noexcept {
+  while (chunks_ != nullptr) {
+    Chunk* next = chunks_->next;
+    upstream_->deallocate(chunks_, chunks_->size, alignof(std::max_align_t));
+    chunks_ = next;
+  }
+  free_lists_.fill(nullptr);
+}
+
+// Carves a fresh chunk into blocks of one size class. The chunk header is
+// padded to max_align_t so every block keeps that alignment.
+inline void PoolResource::refill(std::size_t index) {
+  const std::size_t block_size = kMinBlock << index;
+  constexpr std::size_t kHeader =
+      (sizeof(Chunk) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) *
+      alignof(std::max_align_t);
+  auto* chunk = static_cast<Chunk*>(
+      upstream_->allocate(chunk_size_, alignof(std::max_align_t)));
+  chunk->next = chunks_;
+  chunk->size = chunk_size_;
+  chunks_ = chunk;
+
+  char* first = reinterpret_cast<char*>(chunk) + kHeader;
+  const std::size_t count = (chunk_size_ - kHeader) / block_size;
+  for (std::size_t i = count; i > 0; --i) {
+    auto* block = reinterpret_cast<FreeBlock*>(first + (i - 1) * block_size);
+    block->next = free_lists_[index];
+    free_lists_[index] = block;
+  }
+}
+
+// ResourceAllocator
+
+template <typename T, typename Resource>
+T* ResourceAllocator<T, Resource>::allocate(std::size_t n) {
+  if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+    throw std::bad_array_new_length();
+  }
+  return static_cast<T*>(resource_->allocate(n * sizeof(T), alignof(T)));
+}
+
+template <typename T, typename Resource>
+void ResourceAllocator<T, Resource>::deallocate(T* p, std::size_t n) noexcept {
+  resource_->deallocate(p, n * sizeof(T), alignof(T));
+}
+
+// PageAllocator
+
+template <typename T, std::size_t Alignment, std::size_t HugePageThreshold,
+          std::size_t MapThreshold>
+std::size_t PageAllocator<T, Alignment, HugePageThreshold, MapThreshold>::page_size() noexcept {
+  static const std::size_t size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  return size;
+}
+
+template <typename T, std::size_t Alignment, std::size_t HugePageThreshold,
+          std::size_t MapThreshold>
+std::size_t PageAllocator<T, Alignment, HugePageThreshold, MapThreshold>::byte_size(
+    std::size_t n) {
+  if (n > std::numeric_limits<std::size_t>::max() / 2 / sizeof(T)) {
+    throw std::bad_array_new_length();
+  }
+  return std::max<std::size_t>(n * sizeof(T), 1);
+}
+
+template <typename T, std::size_t Alignment, std::size_t HugePageThreshold,
+          std::size_t MapThreshold>
+std::size_t PageAllocator<T, Alignment, HugePageThreshold, MapThreshold>::mapped_size(
+    std::size_t bytes) noexcept {
+  const std::size_t page = page_size();
+  return (bytes + page - 1) / page * page;
+}
+
+template <typename T, std::size_t Alignment, std::size_t HugePageThreshold,
+          std::size_t MapThreshold>
+void PageAllocator<T, Alignment, HugePageThreshold, MapThreshold>::advise(
+    void* p, std::size_t bytes) noexcept {
+#if defined(MADV_HUGEPAGE)
+  if (bytes >= HugePageThreshold) {
+    ::madvise(p, bytes, MADV_HUGEPAGE);
+  }
+#else
+  (void)p;
+  (void)bytes;
+#endif
+}
+
+// Large blocks are carved out of a slightly bigger mapping so that they
+// start on a huge page boundary, which transparent huge pages need.
+template <typename T, std::size_t Alignment, std::size_t HugePageThreshold,
+          std::size_t MapThreshold>
+void* PageAllocator<T, Alignment, HugePageThreshold, MapThreshold>::map(std::size_t bytes) {
+  const bool huge = bytes >= HugePageThreshold;
+  const std::size_t reserved = huge ? bytes + kHugePageSize : bytes;
+  void* raw = ::mmap(nullptr, reserved, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (raw == MAP_FAILED) {
+    throw std::bad_alloc();
+  }
+  char* start = static_cast<char*>(raw);
+  if (huge) {
+    const auto address = reinterpret_cast<std::uintptr_t>(start);
+    char* aligned = start + ((kHugePageSize - address % kHugePageSize) % kHugePageSize);
+    if (aligned != start) {
+      ::munmap(start, static_cast<std::size_t>(aligned - start));
+    }
+    const std::size_t tail = static_cast<std::size_t>(start + reserved - (aligned + bytes));
+    if (tail != 0) {
+      ::munmap(aligned + bytes, tail);
+    }
+    start = aligned;
+  }
+  advise(start, bytes);
+  return start;
+}
+
+template <typename T, std::size_t Alignment, std::size_t HugePageThreshold,
+          std::size_t MapThreshold>
+T* PageAllocator<T, Alignment, HugePageThreshold, MapThreshold>::allocate(std::size_t n) {
+  const std::size_t bytes = byte_size(n);
+  if (is_mapped(bytes)) {
+    return static_cast<T*>(map(mapped_size(bytes)));
+  }
+  return static_cast<T*>(::operator new(bytes, std::align_val_t{Alignment}));
+}
+
+template <typename T, std::size_t Alignment, std::size_t HugePageThreshold,
+          std::size_t MapThreshold>
+detail::allocation_result<T*>
+PageAllocator<T, Alignment, HugePageThreshold, MapThreshold>::allocate_at_least(std::size_t n) {
+  const std::size_t bytes = byte_size(n);
+  // The rounded count must map back to the same number of pages in
+  // deallocate(), which only holds for elements no larger than a page.
+  if (!is_mapped(bytes) || sizeof(T) > page_size()) {
+    return {allocate(n), n};
+  }
+  const std::size_t size = mapped_size(bytes);
+  return {static_cast<T*>(map(size)), size / sizeof(T)};
+}
+
+template <typename T, std::size_t Alignment, std::size_t HugePageThreshold,
+          std::size_t MapThreshold>
+void PageAllocator<T, Alignment, HugePageThreshold, MapThreshold>::deallocate(
+    T* p, std::size_t n) noexcept {
+  if (p == nullptr) {
+    return;
+  }
+  const std::size_t bytes = std::max<std::size_t>(n * sizeof(T), 1);
+  if (is_mapped(bytes)) {
+    ::munmap(p, mapped_size(bytes));
+  } else {
+    ::operator delete(p, std::align_val_t{Alignment});
+  }
+}
+
+template <typename T, std::size_t Alignment, std::size_t HugePageThreshold,
+          std::size_t MapThreshold>
+T* PageAllocator<T, Alignment, HugePageThreshold, MapThreshold>::reallocate(
+    T* p, std::size_t old_n, std::size_t new_n) {
+  const std::size_t old_bytes = std::max<std::size_t>(old_n * sizeof(T), 1);
+  const std::size_t new_bytes = byte_size(new_n);
+#if defined(__linux__)
+  if (is_mapped(old_bytes) && is_mapped(new_bytes)) {
+    const std::size_t old_size = mapped_size(old_bytes);
+    const std::size_t new_size = mapped_size(new_bytes);
+    if (old_size == new_size) {
+      return p;
+    }
+    void* moved = ::mremap(p, old_size, new_size, MREMAP_MAYMOVE);
+    if (moved == MAP_FAILED) {
+      throw std::bad_alloc();
+    }
+    advise(moved, new_size);
+    return static_cast<T*>(moved);
+  }
+#endif
+  T* fresh = allocate(new_n);
+  std::memcpy(static_cast<void*>(fresh), static_cast<const void*>(p),
+              std::min(old_bytes, new_bytes));
+  deallocate(p, old_n);
+  return fresh;
+}
+
+// MemoryResourceAdapter
+
+template <typename Resource>
+void* MemoryResourceAdapter<Resource>::do_allocate(std::size_t bytes,
+                                                   std::size_t alignment) {
+  return resource_->allocate(bytes, alignment);
+}
+
+template <typename Resource>
+void MemoryResourceAdapter<Resource>::do_deallocate(void* p, std::size_t bytes,
+                                                    std::size_t alignment) {
+  resource_->deallocate(p, bytes, alignment);
+}
+
+template <typename Resource>
+bool MemoryResourceAdapter<Resource>::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+  const auto* adapter = dynamic_cast<const MemoryResourceAdapter*>(&other);
+  return adapter != nullptr && adapter->resource_ == resource_;
+}
+
+}  // namespace memory
+
+}  // namespace utils
@@ -0,0 +1,258 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Unpacking loads each element with one unaligned 8-byte read at the byte
+// holding its first bit, then shifts and masks. That covers every width
+// up to 57 bits (7 bits of shift plus the element), which lets the AVX2
+// and AVX-512 variants gather 4 or 8 elements per instruction; wider
+// elements, and CPUs without gathers, take the scalar two-word path. The
+// padding word PackedVector keeps after its data makes the over-read safe.
+
+#include "packed_vector.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include <lib/vector_algorithms/vector_algorithms.hpp>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define UTILS_PACKED_X86 1
+#include <immintrin.h>
+#else
+#define UTILS_PACKED_X86 0
+#endif
+
+namespace utils {
+
+namespace packed {
+
+namespace {
+
+// Widest element the gather kernels handle.
+constexpr unsigned kMaxGatherBits = 57;
+
+template <typename Out>
+void unpack_scalar(const std::uint64_t* words, unsigned bits, std::size_t first,
+                   std::size_t count, Out* out) {
+  const std::uint64_t mask = detail::mask_for(bits);
+  std::size_t offset = first * bits;
+  for (std::size_t i = 0; i < count; ++i, offset += bits) {
+    const std::size_t word = offset / 64;
+    const unsigned shift = offset % 64;
+    std::uint64_t value = words[word] >> shift;
+    if (shift + bits > 64) {
+      value |= words[word + 1] << (64 - shift);
+    }
+    out[i] = static_cast<Out>(value & mask);
+  }
+}
+
+#if UTILS_PACKED_X86
+
+// Gathers the 4 elements at bit offsets, shifts and masks them.
+__attribute__((target("avx2"))) inline __m256i gather4(const long long* bytes, __m256i offsets,
+                                                      __m256i mask) {
+  const __m256i loaded = _mm256_i64gather_epi64(bytes, _mm256_srli_epi64(offsets, 3), 1);
+  return _mm256_and_si256(
+      _mm256_srlv_epi64(loaded, _mm256_and_si256(offsets, _mm256_set1_epi64x(7))), mask);
+}
+
+template <typename Out>
+__attribute__((target("avx2"))) void unpack_avx2(const std::uint64_t* words, unsigned bits,
+                                                 std::size_t first, std::size_t count, Out* out) {
+  const auto* bytes = reinterpret_cast<const long long*>(words);
+  const long long offset = static_cast<long long>(first * bits);
+  const long long b = bits;
+  const __m256i mask = _mm256_set1_epi64x(static_cast<long long>(detail::mask_for(bits)));
+  const __m256i step = _mm256_set1_epi64x(4 * b);
+  __m256i offsets = _mm256_setr_epi64x(offset, offset + b, offset + 2 * b, offset + 3 * b);
+
+  std::size_t i = 0;
+  if constexpr (sizeof(Out) == 8) {
+    for (; i + 4 <= count; i += 4) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), gather4(bytes, offsets, mask));
+      offsets = _mm256_add_epi64(offsets, step);
+    }
+  } else {
+    // Keep the low half of each 64-bit lane: 8 x 32 bits from two gathers.
+    const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+    for (; i + 8 <= count; i += 8) {
+      const __m256i lo = _mm256_permutevar8x32_epi32(gather4(bytes, offsets, mask), even);
+      offsets = _mm256_add_epi64(offsets, step);
+      const __m256i hi = _mm256_permutevar8x32_epi32(gather4(bytes, offsets, mask), even);
+      offsets = _mm256_add_epi64(offsets, step);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                          _mm256_permute2x128_si256(lo, hi, 0x20));
+    }
+  }
+  unpack_scalar(words, bits, first + i, count - i, out + i);
+}
+
+template <typename Out>
+__attribute__((target("avx512f,avx512dq"))) void unpack_avx512(const std::uint64_t* words,
+                                                                unsigned bits, std::size_t first,
+                                                                std::size_t count, Out* out) {
+  const auto* bytes = reinterpret_cast<const long long*>(words);
+  const long long offset = static_cast<long long>(first * bits);
+  const long long b = bits;
+  const __m512i mask = _mm512_set1_epi64(static_cast<long long>(detail::mask_for(bits)));
+  const __m512i seven = _mm512_set1_epi64(7);
+  const __m512i step = _mm512_set1_epi64(8 * b);
+  __m512i offsets = _mm512_add_epi64(_mm512_set1_epi64(offset),
+                                     _mm512_mullo_epi64(_mm512_setr_epi64(0, 1, 2, 3, 4, 5, 6, 7),
+                                                        _mm512_set1_epi64(b)));
+
+  // The masked forms take an explicit source; the unmasked ones pass GCC's
+  // _mm512_undefined_epi32(), which trips -Wmaybe-uninitialized.
+  const __mmask8 all = 0xFF;
+  std::size_t i = 0;
+  for (; i + 8 <= count; i += 8) {
+    const __m512i loaded = _mm512_mask_i64gather_epi64(
+        _mm512_setzero_si512(), all, _mm512_maskz_srli_epi64(all, offsets, 3), bytes, 1);
+    const __m512i value = _mm512_and_si512(
+        _mm512_maskz_srlv_epi64(all, loaded, _mm512_and_si512(offsets, seven)), mask);
+    offsets = _mm512_add_epi64(offsets, step);
+    if constexpr (sizeof(Out) == 8) {
+      _mm512_storeu_si512(out + i, value);
+    } else {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                          _mm512_maskz_cvtepi64_epi32(all, value));
+    }
+  }
+  unpack_scalar(words, bits, first + i, count - i, out + i);
+}
+
+#endif
+
+}  // namespace
+
+namespace detail {
+
+template <typename Out>
+void unpack(const std::uint64_t* words, unsigned bits, std::size_t first, std::size_t count,
+            Out* out) {
+#if UTILS_PACKED_X86
+  if (bits <= kMaxGatherBits) {
+    switch (algorithms::active_isa()) {
+      case algorithms::Isa::kAvx512:
+        return unpack_avx512(words, bits, first, count, out);
+      case algorithms::Isa::kAvx2:
+        return unpack_avx2(words, bits, first, count, out);
+      case algorithms::Isa::kSse2:
+      case algorithms::Isa::kScalar:
+        break;
+    }
+  }
+#endif
+  unpack_scalar(words, bits, first, count, out);
+}
+
+template void unpack<std::uint32_t>(const std::uint64_t*, unsigned, std::size_t, std::size_t,
+                                    std::uint32_t*);
+template void unpack<std::uint64_t>(const std::uint64_t*, unsigned, std::size_t, std::size_t,
+                                    std::uint64_t*);
+
+}  // namespace detail
+
+}  // namespace packed
+
+// DeltaPackedVector:
+std::size_t DeltaPackedVector::memory_bytes() const noexcept {
+  return blocks_.capacity() * sizeof(Block) + words_.capacity() * sizeof(std::uint64_t) +
+         sizeof(tail_);
+}
+
+DeltaPackedVector::value_type DeltaPackedVector::operator[](std::size_t i) const {
+  const std::size_t block = i / kBlock;
+  const std::size_t index = i % kBlock;
+  if (block == blocks_.size()) {
+    return tail_[index];
+  }
+  const Block& header = blocks_[block];
+  value_type gaps[kBlock];
+  packed::detail::unpack(words_.data() + header.first_word, header.bits, 0, index, gaps);
+  value_type value = header.base;
+  for (std::size_t j = 0; j < index; ++j) {
+    value += gaps[j];
+  }
+  return value;
+}
+
+DeltaPackedVector::value_type DeltaPackedVector::at(std::size_t i) const {
+  if (i >= size()) {
+    throw std::out_of_range("Index out of range");
+  }
+  return (*this)[i];
+}
+
+DeltaPackedVector::value_type DeltaPackedVector::back() const {
+  return (*this)[size() - 1];
+}
+
+void DeltaPackedVector::push_back(value_type value) {
+  if (!empty() && value < back()) {
+    throw std::invalid_argument("DeltaPackedVector values must be non-decreasing");
+  }
+  // A full tail is flushed before the new value goes in, so a flush that
+  // throws leaves the vector as it was.
+  if (tail_size_ == kBlock) {
+    flush_tail();
+  }
+  tail_[tail_size_++] = value;
+}
+
+void DeltaPackedVector::clear() noexcept {
+  blocks_.clear();
+  words_.clear();
+  tail_size_ = 0;
+}
+
+void DeltaPackedVector::decode(Vector<value_type>& out) const {
+  out.clear();
+  out.resize(size());
+  for (std::size_t block = 0; block < blocks_.size(); ++block) {
+    decode_block(block, out.data() + block * kBlock);
+  }
+  std::copy(tail_.begin(), tail_.begin() + tail_size_, out.data() + blocks_.size() * kBlock);
+}
+
+void DeltaPackedVector::flush_tail() {
+  value_type gaps[kBlock - 1];
+  std::uint64_t all = 0;
+  for (std::size_t j = 0; j + 1 < kBlock; ++j) {
+    gaps[j] = tail_[j + 1] - tail_[j];
+    all |= gaps[j];
+  }
+  const unsigned bits = packed::bits_for(all);
+  // The old padding word becomes the block's first word.
+  const std::size_t first_word = words_.empty() ? 0 : words_.size() - 1;
+  const std::size_t needed = first_word + packed::detail::words_for(kBlock - 1, bits) + 1;
+  // Both arrays grow before either changes: words_.size() places the next
+  // block, so a partial append would corrupt the layout.
+  if (words_.capacity() < needed) {
+    words_.reserve(DefaultGrowth::next_capacity<std::uint64_t>(words_.capacity(), needed,
+                                                               words_.max_size()));
+  }
+  if (blocks_.size() == blocks_.capacity()) {
+    blocks_.reserve(DefaultGrowth::next_capacity<Block>(blocks_.capacity(), blocks_.size() + 1,
+                                                        blocks_.max_size()));
+  }
+  while (words_.size() < needed) {
+    words_.push_back(0);
+  }
+  packed::detail::pack(words_.data() + first_word, bits, 0, kBlock - 1, gaps);
+  blocks_.push_back(Block{tail_[0], first_word, bits});
+  tail_size_ = 0;
+}
+
+void DeltaPackedVector::decode_block(std::size_t block, value_type* out) const {
+  const Block& header = blocks_[block];
+  out[0] = header.base;
+  packed::detail::unpack(words_.data() + header.first_word, header.bits, 0, kBlock - 1, out + 1);
+  for (std::size_t j = 1; j < kBlock; ++j) {
+    out[j] += out[j - 1];
+  }
+}
+
+}  // namespace utils
@@ -0,0 +1,204 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <ranges>
+
+#include <lib/vector/vector.hpp>
+
+namespace utils {
+
+// Bit width chosen at run time, passed to the PackedVector constructor.
+inline constexpr unsigned kDynamicBits = 0;
+
+namespace packed {
+
+// Bits needed to store value: 1 for 0, 64 for values at or above 2^63.
+constexpr unsigned bits_for(std::uint64_t value) noexcept;
+
+// Bits needed to store the largest element of range.
+template <std::ranges::input_range Range>
+  requires std::unsigned_integral<std::ranges::range_value_t<Range>>
+constexpr unsigned required_bits(Range&& range);
+
+namespace detail {
+
+constexpr std::size_t words_for(std::size_t size, unsigned bits) noexcept;
+
+// Decodes count elements of width bits, starting at element first, from
+// words into out. words must hold one padding word past the last element.
+// The implementation is picked at run time like the kernels in
+// lib/vector_algorithms; Out is std::uint32_t (bits <= 32) or std::uint64_t.
+template <typename Out>
+void unpack(const std::uint64_t* words, unsigned bits, std::size_t first, std::size_t count,
+            Out* out);
+
+// Encodes count values of width bits into words, starting at element first.
+// Bits above the width must be zero; the destination bits are overwritten.
+template <typename In>
+void pack(std::uint64_t* words, unsigned bits, std::size_t first, std::size_t count,
+          const In* values);
+
+}  // namespace detail
+
+}  // namespace packed
+
+// Vector of unsigned integers stored in Bits bits each, packed back to back
+// into 64-bit words, so a million 20-bit IDs take 2.5 MB instead of 4 or 8.
+// Bits is 1..64, or kDynamicBits to choose the width in the constructor.
+//
+// operator[] returns a proxy that reads and writes one element; scanning
+// element by element costs a shift and a mask per read, so bulk reads
+// should go through decode(), which unpacks with SIMD gathers when the CPU
+// has them. Storing a value that does not fit in bits() throws
+// std::out_of_range and leaves the vector unchanged.
+template <unsigned Bits = kDynamicBits>
+class PackedVector {
+  static_assert(Bits <= 64, "PackedVector elements are at most 64 bits wide");
+
+ public:
+  using value_type = std::uint64_t;
+
+  class Reference {
+   public:
+    Reference& operator=(value_type value);
+    Reference& operator=(const Reference& other) { return *this = value_type(other); }
+    operator value_type() const;
+
+   private:
+    friend class PackedVector;
+    Reference(PackedVector& owner, std::size_t index) : owner_(owner), index_(index) {}
+
+    PackedVector& owner_;
+    std::size_t index_;
+  };
+
+  PackedVector()
+    requires(Bits != kDynamicBits);
+  // Throws std::invalid_argument unless bits is 1..64 and, for a fixed
+  // Bits, equal to it.
+  explicit PackedVector(unsigned bits);
+  PackedVector(std::size_t size, value_type val)
+    requires(Bits != kDynamicBits);
+  PackedVector(unsigned bits, std::size_t size, value_type val);
+
+  // Packs values into a vector as narrow as their largest element (or
+  // Bits, if fixed).
+  template <std::ranges::input_range Range>
+    requires std::unsigned_integral<std::ranges::range_value_t<Range>>
+  static PackedVector encode(Range&& values);
+
+  unsigned bits() const noexcept;
+  value_type max_value() const noexcept;
+
+  // Capacity:
+  std::size_t size() const noexcept { return size_; }
+  bool empty() const noexcept { return size_ == 0; }
+  std::size_t capacity() const noexcept;
+  void reserve(std::size_t count);
+  void resize(std::size_t size, value_type val = 0);
+  void shrink_to_fit();
+  // Bytes of packed storage currently allocated.
+  std::size_t memory_bytes() const noexcept { return words_.capacity() * sizeof(std::uint64_t); }
+
+  // Element access:
+  Reference operator[](std::size_t i) { return Reference(*this, i); }
+  value_type operator[](std::size_t i) const { return get(i); }
+  Reference at(std::size_t i);
+  value_type at(std::size_t i) const;
+  value_type front() const { return get(0); }
+  value_type back() const { return get(size_ - 1); }
+  // The packed words; element i occupies bits [i * bits(), (i + 1) * bits()).
+  const std::uint64_t* words() const noexcept { return words_.data(); }
+
+  // Modifiers:
+  void push_back(value_type value);
+  void pop_back();
+  void clear() noexcept;
+  template <std::ranges::input_range Range>
+    requires std::unsigned_integral<std::ranges::range_value_t<Range>>
+  void append_range(Range&& values);
+  void swap(PackedVector& other) noexcept;
+
+  // Bulk decode: writes count elements starting at first to out, which must
+  // have room for them. Throws std::out_of_range if the range is outside
+  // the vector and std::invalid_argument if Out is too narrow for bits().
+  template <typename Out>
+    requires(std::same_as<Out, std::uint32_t> || std::same_as<Out, std::uint64_t>)
+  void decode(std::size_t first, std::size_t count, Out* out) const;
+  // Replaces the contents of out with every element.
+  template <typename Out>
+    requires(std::same_as<Out, std::uint32_t> || std::same_as<Out, std::uint64_t>)
+  void decode(Vector<Out>& out) const;
+
+ private:
+  value_type get(std::size_t i) const noexcept;
+  void set(std::size_t i, value_type value) noexcept;
+  void check_value(value_type value) const;
+  // Makes words_ large enough for count elements plus the padding word.
+  void grow_words(std::size_t count);
+
+  Vector<std::uint64_t> words_;
+  std::size_t size_ = 0;
+  unsigned bits_ = Bits;
+};
+
+// Frame-of-reference and delta coding for sorted (non-decreasing) data:
+// elements are cut into blocks of kBlock, and each block stores its first
+// value plus the gaps to the following elements, packed as narrow as the
+// block's largest gap. Sorted IDs with small gaps shrink to a few bits
+// each, whatever their magnitude.
+//
+// The last, partial block is kept unpacked until it fills up. Random
+// access decodes the gaps up to the element, O(kBlock); decode() unpacks
+// whole blocks and prefix-sums them. push_back throws std::invalid_argument
+// if the value is smaller than back().
+class DeltaPackedVector {
+ public:
+  using value_type = std::uint64_t;
+  static constexpr std::size_t kBlock = 128;
+
+  DeltaPackedVector() = default;
+
+  template <std::ranges::input_range Range>
+    requires std::unsigned_integral<std::ranges::range_value_t<Range>>
+  static DeltaPackedVector encode(Range&& values);
+
+  std::size_t size() const noexcept { return blocks_.size() * kBlock + tail_size_; }
+  bool empty() const noexcept { return size() == 0; }
+  // Bytes of packed storage, block headers and tail currently allocated.
+  std::size_t memory_bytes() const noexcept;
+
+  value_type operator[](std::size_t i) const;
+  value_type at(std::size_t i) const;
+  value_type back() const;
+
+  void push_back(value_type value);
+  void clear() noexcept;
+
+  // Replaces the contents of out with every element.
+  void decode(Vector<value_type>& out) const;
+
+ private:
+  struct Block {
+    value_type base;
+    std::size_t first_word;
+    unsigned bits;
+  };
+
+  void flush_tail();
+  void decode_block(std::size_t block, value_type* out) const;
+
+  Vector<Block> blocks_;
+  Vector<std::uint64_t> words_;
+  std::array<value_type, kBlock> tail_{};
+  std::size_t tail_size_ = 0;
+};
+
+}  // namespace utils
+
+#include "packed_vector.tpp"
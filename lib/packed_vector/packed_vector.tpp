@@ -0,0 +1,316 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace utils {
+
+namespace packed {
+
+constexpr unsigned bits_for(std::uint64_t value) noexcept {
+  return value == 0 ? 1 : static_cast<unsigned>(std::bit_width(value));
+}
+
+template <std::ranges::input_range Range>
+  requires std::unsigned_integral<std::ranges::range_value_t<Range>>
+constexpr unsigned required_bits(Range&& range) {
+  std::uint64_t all = 0;
+  for (auto&& value : range) {
+    all |= static_cast<std::uint64_t>(value);
+  }
+  return bits_for(all);
+}
+
+namespace detail {
+
+constexpr std::size_t words_for(std::size_t size, unsigned bits) noexcept {
+  return (size * bits + 63) / 64;
+}
+
+constexpr std::uint64_t mask_for(unsigned bits) noexcept {
+  return bits == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << bits) - 1;
+}
+
+template <typename In>
+void pack(std::uint64_t* words, unsigned bits, std::size_t first, std::size_t count,
+          const In* values) {
+  const std::size_t offset = first * bits;
+  std::size_t word = offset / 64;
+  unsigned shift = offset % 64;
+  // Bits below first in the starting word belong to earlier elements.
+  std::uint64_t acc = shift == 0 ? 0 : words[word] & ((std::uint64_t{1} << shift) - 1);
+  for (std::size_t i = 0; i < count; ++i) {
+    const auto value = static_cast<std::uint64_t>(values[i]);
+    acc |= value << shift;
+    if (shift + bits >= 64) {
+      words[word++] = acc;
+      acc = shift == 0 ? 0 : value >> (64 - shift);
+      shift = shift + bits - 64;
+    } else {
+      shift += bits;
+    }
+  }
+  if (shift != 0) {
+    words[word] = acc;
+  }
+}
+
+}  // namespace detail
+
+}  // namespace packed
+
+template <unsigned Bits>
+PackedVector<Bits>::Reference& PackedVector<Bits>::Reference::operator=(value_type value) {
+  owner_.check_value(value);
+  owner_.set(index_, value);
+  return *this;
+}
+
+template <unsigned Bits>
+PackedVector<Bits>::Reference::operator value_type() const {
+  return owner_.get(index_);
+}
+
+template <unsigned Bits>
+PackedVector<Bits>::PackedVector()
+  requires(Bits != kDynamicBits)
+    : PackedVector(Bits) {}
+
+template <unsigned Bits>
+PackedVector<Bits>::PackedVector(unsigned bits) : bits_(bits) {
+  if (bits == 0 || bits > 64 || (Bits != kDynamicBits && bits != Bits)) {
+    throw std::invalid_argument("Invalid PackedVector bit width: " + std::to_string(bits));
+  }
+}
+
+template <unsigned Bits>
+PackedVector<Bits>::PackedVector(std::size_t size, value_type val)
+  requires(Bits != kDynamicBits)
+    : PackedVector(Bits, size, val) {}
+
+template <unsigned Bits>
+PackedVector<Bits>::PackedVector(unsigned bits, std::size_t size, value_type val)
+    : PackedVector(bits) {
+  resize(size, val);
+}
+
+template <unsigned Bits>
+template <std::ranges::input_range Range>
+  requires std::unsigned_integral<std::ranges::range_value_t<Range>>
+PackedVector<Bits> PackedVector<Bits>::encode(Range&& values) {
+  if constexpr (Bits != kDynamicBits) {
+    PackedVector result;
+    result.append_range(std::forward<Range>(values));
+    return result;
+  } else if constexpr (std::ranges::forward_range<Range>) {
+    PackedVector result(packed::required_bits(values));
+    result.append_range(std::forward<Range>(values));
+    return result;
+  } else {
+    // The width is only known after one pass, so keep a copy.
+    Vector<std::uint64_t> copy;
+    for (auto&& value : values) {
+      copy.push_back(static_cast<std::uint64_t>(value));
+    }
+    return encode(copy);
+  }
+}
+
+template <unsigned Bits>
+unsigned PackedVector<Bits>::bits() const noexcept {
+  if constexpr (Bits != kDynamicBits) {
+    return Bits;
+  } else {
+    return bits_;
+  }
+}
+
+template <unsigned Bits>
+PackedVector<Bits>::value_type PackedVector<Bits>::max_value() const noexcept {
+  return packed::detail::mask_for(bits());
+}
+
+// Capacity:
+template <unsigned Bits>
+std::size_t PackedVector<Bits>::capacity() const noexcept {
+  return words_.capacity() == 0 ? 0 : (words_.capacity() - 1) * 64 / bits();
+}
+
+template <unsigned Bits>
+void PackedVector<Bits>::reserve(std::size_t count) {
+  words_.reserve(packed::detail::words_for(count, bits()) + 1);
+}
+
+template <unsigned Bits>
+void PackedVector<Bits>::resize(std::size_t size, value_type val) {
+  if (size > size_) {
+    check_value(val);
+    grow_words(size);
+    for (std::size_t i = size_; i < size; ++i) {
+      set(i, val);
+    }
+  }
+  size_ = size;
+}
+
+template <unsigned Bits>
+void PackedVector<Bits>::shrink_to_fit() {
+  if (size_ == 0) {
+    words_.clear();
+  } else {
+    words_.resize(packed::detail::words_for(size_, bits()) + 1);
+  }
+  words_.shrink_to_fit();
+}
+
+// Element access:
+template <unsigned Bits>
+PackedVector<Bits>::Reference PackedVector<Bits>::at(std::size_t i) {
+  if (i >= size_) {
+    throw std::out_of_range("Index out of range");
+  }
+  return Reference(*this, i);
+}
+
+template <unsigned Bits>
+PackedVector<Bits>::value_type PackedVector<Bits>::at(std::size_t i) const {
+  if (i >= size_) {
+    throw std::out_of_range("Index out of range");
+  }
+  return get(i);
+}
+
+// Modifiers:
+template <unsigned Bits>
+void PackedVector<Bits>::push_back(value_type value) {
+  check_value(value);
+  grow_words(size_ + 1);
+  set(size_, value);
+  ++size_;
+}
+
+template <unsigned Bits>
+void PackedVector<Bits>::pop_back() {
+  if (size_ == 0) {
+    throw std::out_of_range("Trying to pop from empty PackedVector.");
+  }
+  --size_;
+}
+
+template <unsigned Bits>
+void PackedVector<Bits>::clear() noexcept {
+  size_ = 0;
+}
+
+template <unsigned Bits>
+template <std::ranges::input_range Range>
+  requires std::unsigned_integral<std::ranges::range_value_t<Range>>
+void PackedVector<Bits>::append_range(Range&& values) {
+  if constexpr (std::ranges::sized_range<Range> && std::ranges::contiguous_range<Range>) {
+    const std::size_t count = std::ranges::size(values);
+    const auto* data = std::ranges::data(values);
+    for (std::size_t i = 0; i < count; ++i) {
+      check_value(data[i]);
+    }
+    grow_words(size_ + count);
+    packed::detail::pack(words_.data(), bits(), size_, count, data);
+    size_ += count;
+  } else {
+    if constexpr (std::ranges::sized_range<Range>) {
+      reserve(size_ + std::ranges::size(values));
+    }
+    for (auto&& value : values) {
+      push_back(static_cast<value_type>(value));
+    }
+  }
+}
+
+template <unsigned Bits>
+void PackedVector<Bits>::swap(PackedVector& other) noexcept {
+  words_.swap(other.words_);
+  std::swap(size_, other.size_);
+  std::swap(bits_, other.bits_);
+}
+
+template <unsigned Bits>
+template <typename Out>
+  requires(std::same_as<Out, std::uint32_t> || std::same_as<Out, std::uint64_t>)
+void PackedVector<Bits>::decode(std::size_t first, std::size_t count, Out* out) const {
+  if (first > size_ || count > size_ - first) {
+    throw std::out_of_range("Decode range out of range");
+  }
+  if (bits() > sizeof(Out) * 8) {
+    throw std::invalid_argument("Decode target narrower than the packed elements");
+  }
+  packed::detail::unpack(words_.data(), bits(), first, count, out);
+}
+
+template <unsigned Bits>
+template <typename Out>
+  requires(std::same_as<Out, std::uint32_t> || std::same_as<Out, std::uint64_t>)
+void PackedVector<Bits>::decode(Vector<Out>& out) const {
+  if (bits() > sizeof(Out) * 8) {
+    throw std::invalid_argument("Decode target narrower than the packed elements");
+  }
+  out.clear();
+  out.resize(size_);
+  packed::detail::unpack(words_.data(), bits(), 0, size_, out.data());
+}
+
+template <unsigned Bits>
+PackedVector<Bits>::value_type PackedVector<Bits>::get(std::size_t i) const noexcept {
+  const std::size_t offset = i * bits();
+  const std::size_t word = offset / 64;
+  const unsigned shift = offset % 64;
+  // The padding word makes words_[word + 1] readable for the last element.
+  std::uint64_t value = words_[word] >> shift;
+  if (shift + bits() > 64) {
+    value |= words_[word + 1] << (64 - shift);
+  }
+  return value & max_value();
+}
+
+template <unsigned Bits>
+void PackedVector<Bits>::set(std::size_t i, value_type value) noexcept {
+  const std::size_t offset = i * bits();
+  const std::size_t word = offset / 64;
+  const unsigned shift = offset % 64;
+  const std::uint64_t mask = max_value();
+  words_[word] = (words_[word] & ~(mask << shift)) | (value << shift);
+  if (shift + bits() > 64) {
+    const unsigned spill = 64 - shift;
+    words_[word + 1] = (words_[word + 1] & ~(mask >> spill)) | (value >> spill);
+  }
+}
+
+template <unsigned Bits>
+void PackedVector<Bits>::check_value(value_type value) const {
+  if (value > max_value()) {
+    throw std::out_of_range("Value " + std::to_string(value) + " does not fit in " +
+                            std::to_string(bits()) + " bits");
+  }
+}
+
+template <unsigned Bits>
+void PackedVector<Bits>::grow_words(std::size_t count) {
+  const std::size_t needed = packed::detail::words_for(count, bits()) + 1;
+  while (words_.size() < needed) {
+    words_.push_back(0);
+  }
+}
+
+template <std::ranges::input_range Range>
+  requires std::unsigned_integral<std::ranges::range_value_t<Range>>
+DeltaPackedVector DeltaPackedVector::encode(Range&& values) {
+  DeltaPackedVector result;
+  for (auto&& value : values) {
+    result.push_back(static_cast<value_type>(value));
+  }
+  return result;
+}
+
+}  // namespace utils
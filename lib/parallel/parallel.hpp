@@ -0,0 +1,162 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace utils {
+
+namespace parallel {
+
+// Fixed set of worker threads, one task deque each. A worker pops from the
+// back of its own deque and steals from the front of the others when it
+// runs dry. Threads that are not workers submit to a shared deque, and
+// threads waiting on a TaskGroup run queued tasks instead of blocking, so
+// the algorithms below can be nested.
+class ThreadPool {
+ public:
+  // Total parallelism, counting the thread that waits for the results:
+  // ThreadPool(1) starts no workers and runs everything on the caller.
+  explicit ThreadPool(std::size_t threads = std::thread::hardware_concurrency());
+  ThreadPool(const ThreadPool&) = delete;
+  ThreadPool& operator=(const ThreadPool&) = delete;
+  ~ThreadPool();
+
+  std::size_t size() const noexcept;
+
+  void submit(std::function<void()> task);
+  // Runs one queued task on the calling thread, if there is one.
+  bool try_run_one();
+
+  // Shared pool with one thread per hardware thread, started on first use.
+  static ThreadPool& global();
+
+ private:
+  struct alignas(64) Queue {
+    std::mutex mutex;
+    std::deque<std::function<void()>> tasks;
+  };
+
+  void stop() noexcept;
+  bool try_pop(std::size_t self, std::function<void()>& task);
+  void worker_loop(std::size_t index);
+  std::size_t current_queue() const noexcept;
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+  std::atomic<std::size_t> queued_ = 0;
+  std::mutex sleep_mutex_;
+  std::condition_variable wake_;
+  bool stop_ = false;
+
+  static inline thread_local const ThreadPool* current_pool_ = nullptr;
+  static inline thread_local std::size_t current_index_ = 0;
+};
+
+// Fork-join scope over a pool. wait() rethrows the first exception thrown
+// by a task; the destructor waits without rethrowing.
+class TaskGroup {
+ public:
+  explicit TaskGroup(ThreadPool& pool) noexcept;
+  TaskGroup(const TaskGroup&) = delete;
+  TaskGroup& operator=(const TaskGroup&) = delete;
+  ~TaskGroup();
+
+  template <typename Fn>
+  void run(Fn&& fn);
+  void wait();
+
+ private:
+  void join() noexcept;
+
+  ThreadPool& pool_;
+  std::atomic<std::size_t> pending_ = 0;
+  std::mutex error_mutex_;
+  std::exception_ptr error_;
+};
+
+// Ranges are split into chunks of `grain` elements (by default
+// size / kMaxChunks, but at least kMinGrain), and up to `threads` tasks
+// claim chunks in turn. Chunk boundaries depend only on the size and the
+// grain, so reduce and scan give the same result for any thread count.
+// Ranges shorter than `serial_threshold` are processed by the calling
+// thread with the std algorithm.
+struct Options {
+  static constexpr std::size_t kMinGrain = 4096;
+  static constexpr std::size_t kMaxChunks = 256;
+
+  ThreadPool* pool = nullptr;  // ThreadPool::global() if null
+  std::size_t threads = 0;     // all threads of the pool if 0
+  std::size_t grain = 0;
+  std::size_t serial_threshold = std::size_t{1} << 15;
+};
+
+// Calls body(begin, end) for consecutive chunks covering [0, size).
+template <typename Body>
+void for_each_chunk(std::size_t size, Body&& body, const Options& options = {});
+
+// Execution policy for utils::Vector's parallel constructors, resize and
+// assign, which build chunks on the pool so that every page is first
+// touched by the thread that fills it:
+//
+//   utils::Vector<double> v(utils::parallel::par, n, 0.0);
+//   utils::Vector<double> w(utils::parallel::Policy{options}, v);
+struct Policy {
+  template <typename Body>
+  void for_each_chunk(std::size_t size, Body&& body) const;
+
+  Options options;
+};
+
+inline constexpr Policy par{};
+
+// The algorithms take any container with data() and size(), utils::Vector
+// and std::vector alike. Operations must be safe to call concurrently on
+// distinct elements; op in reduce and scan must be associative.
+
+template <typename Container, typename Fn>
+void for_each(Container& c, Fn fn, const Options& options = {});
+
+// out[i] = fn(in[i]). out may be in; throws std::invalid_argument if it is
+// shorter than in.
+template <typename In, typename Out, typename Fn>
+void transform(const In& in, Out& out, Fn fn, const Options& options = {});
+
+template <typename Container, typename T, typename Op = std::plus<>>
+T reduce(const Container& c, T init, Op op = {}, const Options& options = {});
+
+// out[i] = in[0] op ... op in[i]. out may be in; throws
+// std::invalid_argument if it is shorter than in.
+template <typename In, typename Out, typename Op = std::plus<>>
+void inclusive_scan(const In& in, Out& out, Op op = {}, const Options& options = {});
+
+// out[i] = init op in[0] op ... op in[i - 1].
+template <typename In, typename Out, typename T, typename Op = std::plus<>>
+void exclusive_scan(const In& in, Out& out, T init, Op op = {}, const Options& options = {});
+
+// Merge sort: chunks are sorted concurrently, then merged pairwise with
+// every merge split across the pool along its merge path. Needs a
+// temporary buffer of size() elements; elements whose move constructor may
+// throw are sorted serially. If comp throws, the elements are left valid
+// but with unspecified values: some may be moved-from, since their values
+// were in the buffer when the merge stopped.
+template <typename Container, typename Compare = std::less<>>
+void sort(Container& c, Compare comp = {}, const Options& options = {});
+template <typename Container, typename Compare = std::less<>>
+void stable_sort(Container& c, Compare comp = {}, const Options& options = {});
+
+}  // namespace parallel
+
+}  // namespace utils
+
+#include "parallel.tpp"
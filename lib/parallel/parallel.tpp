@@ -0,0 +1,516 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel.hpp"
+
+namespace utils {
+
+namespace parallel {
+
+// ThreadPool
+inline ThreadPool::ThreadPool(std::size_t threads) {
+  threads = std::max<std::size_t>(threads, 1);
+  // One deque per worker plus a shared one for other threads, kept last.
+  for (std::size_t i = 0; i < threads; ++i) {
+    this->queues_.push_back(std::make_unique<Queue>());
+  }
+  try {
+    for (std::size_t i = 0; i + 1 < threads; ++i) {
+      this->workers_.emplace_back([this, i] { this->worker_loop(i); });
+    }
+  } catch (...) {
+    this->stop();
+    throw;
+  }
+}
+
+inline ThreadPool::~ThreadPool() { this->stop(); }
+
+inline void ThreadPool::stop() noexcept {
+  {
+    std::lock_guard<std::mutex> lock(this->sleep_mutex_);
+    this->stop_ = true;
+  }
+  this->wake_.notify_all();
+  for (std::thread& worker : this->workers_) {
+    worker.join();
+  }
+  this->workers_.clear();
+}
+
+inline std::size_t ThreadPool::size() const noexcept { return this->queues_.size(); }
+
+inline void ThreadPool::submit(std::function<void()> task) {
+  Queue& queue = *this->queues_[this->current_queue()];
+  {
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    queue.tasks.push_back(std::move(task));
+  }
+  this->queued_.fetch_add(1, std::memory_order_release);
+  // Taking the lock orders this notification after a worker that saw an
+  // empty pool has started waiting.
+  { std::lock_guard<std::mutex> lock(this->sleep_mutex_); }
+  this->wake_.notify_one();
+}
+
+inline bool ThreadPool::try_run_one() {
+  std::function<void()> task;
+  if (!this->try_pop(this->current_queue(), task)) {
+    return false;
+  }
+  task();
+  return true;
+}
+
+inline ThreadPool& ThreadPool::global() {
+  static ThreadPool pool;
+  return pool;
+}
+
+inline bool ThreadPool::try_pop(std::size_t self, std::function<void()>& task) {
+  if (this->queued_.load(std::memory_order_acquire) == 0) {
+    return false;
+  }
+  {
+    Queue& own = *this->queues_[self];
+    std::lock_guard<std::mutex> lock(own.mutex);
+    if (!own.tasks.empty()) {
+      task = std::move(own.tasks.back());
+      own.tasks.pop_back();
+      this->queued_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  for (std::size_t k = 1; k < this->queues_.size(); ++k) {
+    Queue& victim = *this->queues_[(self + k) % this->queues_.size()];
+    std::lock_guard<std::mutex> lock(victim.mutex);
+    if (!victim.tasks.empty()) {
+      task = std::move(victim.tasks.front());
+      victim.tasks.pop_front();
+      this->queued_.fetch_sub(1, std::memory_order_relaxed);
+      return true;
+    }
+  }
+  return false;
+}
+
+inline void ThreadPool::worker_loop(std::size_t index) {
+  current_pool_ = this;
+  current_index_ = index;
+  std::function<void()> task;
+  while (true) {
+    if (this->try_pop(index, task)) {
+      task();
+      task = nullptr;
+      continue;
+    }
+    std::unique_lock<std::mutex> lock(this->sleep_mutex_);
+    if (this->stop_) {
+      return;
+    }
+    this->wake_.wait(lock, [this] {
+      return this->stop_ || this->queued_.load(std::memory_order_acquire) != 0;
+    });
+  }
+}
+
+inline std::size_t ThreadPool::current_queue() const noexcept {
+  return current_pool_ == this ? current_index_ : this->queues_.size() - 1;
+}
+
+// TaskGroup
+inline TaskGroup::TaskGroup(ThreadPool& pool) noexcept : pool_(pool) {}
+
+inline TaskGroup::~TaskGroup() { this->join(); }
+
+template <typename Fn>
+void TaskGroup::run(Fn&& fn) {
+  this->pending_.fetch_add(1, std::memory_order_relaxed);
+  try {
+    this->pool_.submit([this, fn = std::forward<Fn>(fn)]() mutable {
+      try {
+        fn();
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(this->error_mutex_);
+        if (!this->error_) {
+          this->error_ = std::current_exception();
+        }
+      }
+      this->pending_.fetch_sub(1, std::memory_order_release);
+    });
+  } catch (...) {
+    this->pending_.fetch_sub(1, std::memory_order_relaxed);
+    throw;
+  }
+}
+
+inline void TaskGroup::wait() {
+  this->join();
+  if (this->error_) {
+    std::rethrow_exception(std::exchange(this->error_, nullptr));
+  }
+}
+
+inline void TaskGroup::join() noexcept {
+  while (this->pending_.load(std::memory_order_acquire) != 0) {
+    if (!this->pool_.try_run_one()) {
+      std::this_thread::yield();
+    }
+  }
+}
+
+namespace detail {
+
+struct Chunking {
+  std::size_t grain;
+  std::size_t count;
+};
+
+inline Chunking chunking(std::size_t size, const Options& options) {
+  std::size_t grain = options.grain;
+  if (grain == 0) {
+    grain = std::max(Options::kMinGrain, (size + Options::kMaxChunks - 1) / Options::kMaxChunks);
+  }
+  return {grain, (size + grain - 1) / grain};
+}
+
+// Calls fn(i) for every i in [0, count), spread over the pool. After an
+// exception no further indices are started and the first one is rethrown.
+template <typename Fn>
+void run_tasks(std::size_t count, Fn&& fn, const Options& options) {
+  ThreadPool& pool = options.pool != nullptr ? *options.pool : ThreadPool::global();
+  const std::size_t threads = options.threads != 0 ? options.threads : pool.size();
+  const std::size_t tasks = std::min(count, threads);
+
+  std::atomic<std::size_t> next = 0;
+  auto worker = [&] {
+    try {
+      for (std::size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;) {
+        fn(i);
+      }
+    } catch (...) {
+      next.store(count, std::memory_order_relaxed);
+      throw;
+    }
+  };
+
+  TaskGroup group(pool);
+  for (std::size_t t = 1; t < tasks; ++t) {
+    group.run(worker);
+  }
+  worker();
+  group.wait();
+}
+
+// Number of elements of a that come first in the stable merge of a and b
+// truncated to k elements.
+template <typename T, typename Compare>
+std::size_t co_rank(const T* a, std::size_t a_size, const T* b, std::size_t b_size,
+                    std::size_t k, Compare& comp) {
+  std::size_t lo = k > b_size ? k - b_size : 0;
+  std::size_t hi = std::min(k, a_size);
+  while (lo < hi) {
+    const std::size_t mid = lo + (hi - lo) / 2;
+    if (!comp(b[k - mid - 1], a[mid])) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// Destroys and frees the merge buffer.
+template <typename T>
+struct Buffer {
+  explicit Buffer(std::size_t n) : data(std::allocator<T>().allocate(n)), size(n) {}
+  ~Buffer() {
+    std::destroy_n(this->data, this->constructed);
+    std::allocator<T>().deallocate(this->data, this->size);
+  }
+
+  T* data;
+  std::size_t size;
+  std::size_t constructed = 0;
+};
+
+template <bool Stable, typename T, typename Compare>
+void merge_sort(T* data, std::size_t size, Compare& comp, const Options& options) {
+  if (size < options.serial_threshold || !std::is_nothrow_move_constructible_v<T>) {
+    if constexpr (Stable) {
+      std::stable_sort(data, data + size, comp);
+    } else {
+      std::sort(data, data + size, comp);
+    }
+    return;
+  }
+
+  const Chunking chunks = chunking(size, options);
+  auto chunk_end = [&](std::size_t begin) { return std::min(size, begin + chunks.grain); };
+  run_tasks(
+      chunks.count,
+      [&](std::size_t c) {
+        T* first = data + c * chunks.grain;
+        T* last = data + chunk_end(c * chunks.grain);
+        if constexpr (Stable) {
+          std::stable_sort(first, last, comp);
+        } else {
+          std::sort(first, last, comp);
+        }
+      },
+      options);
+  if (chunks.count == 1) {
+    return;
+  }
+
+  Buffer<T> buffer(size);
+  run_tasks(
+      chunks.count,
+      [&](std::size_t c) {
+        const std::size_t begin = c * chunks.grain;
+        std::uninitialized_move(data + begin, data + chunk_end(begin), buffer.data + begin);
+      },
+      options);
+  buffer.constructed = size;
+
+  // Every round merges pairs of sorted runs from src into dst. The output
+  // of each merge is cut into grain-sized pieces, whose starting points on
+  // the merge path are located first; the pieces are then merged
+  // independently.
+  struct Piece {
+    std::size_t run;
+    std::size_t a_size;
+    std::size_t b_size;
+    std::size_t begin;
+    std::size_t end;
+    std::size_t a_begin;
+  };
+  T* src = buffer.data;
+  T* dst = data;
+  std::vector<Piece> pieces;
+  for (std::size_t width = chunks.grain; width < size; width *= 2) {
+    pieces.clear();
+    for (std::size_t run = 0; run < size; run += 2 * width) {
+      const std::size_t a_size = std::min(width, size - run);
+      const std::size_t b_size = std::min(width, size - run - a_size);
+      for (std::size_t k = 0; k < a_size + b_size; k += chunks.grain) {
+        pieces.push_back({run, a_size, b_size, k, std::min(a_size + b_size, k + chunks.grain), 0});
+      }
+    }
+    run_tasks(
+        pieces.size(),
+        [&](std::size_t p) {
+          Piece& piece = pieces[p];
+          const T* a = src + piece.run;
+          piece.a_begin = co_rank(a, piece.a_size, a + piece.a_size, piece.b_size, piece.begin, comp);
+        },
+        options);
+    run_tasks(
+        pieces.size(),
+        [&](std::size_t p) {
+          const Piece& piece = pieces[p];
+          const bool last = p + 1 == pieces.size() || pieces[p + 1].run != piece.run;
+          const std::size_t a_end = last ? piece.a_size : pieces[p + 1].a_begin;
+          T* a = src + piece.run;
+          T* b = a + piece.a_size;
+          std::merge(std::make_move_iterator(a + piece.a_begin), std::make_move_iterator(a + a_end),
+                     std::make_move_iterator(b + (piece.begin - piece.a_begin)),
+                     std::make_move_iterator(b + (piece.end - a_end)),
+                     dst + piece.run + piece.begin, comp);
+        },
+        options);
+    std::swap(src, dst);
+  }
+
+  if (src != data) {
+    run_tasks(
+        chunks.count,
+        [&](std::size_t c) {
+          const std::size_t begin = c * chunks.grain;
+          std::move(src + begin, src + chunk_end(begin), data + begin);
+        },
+        options);
+  }
+}
+
+}  // namespace detail
+
+template <typename Body>
+void for_each_chunk(std::size_t size, Body&& body, const Options& options) {
+  if (size < options.serial_threshold) {
+    if (size != 0) {
+      body(std::size_t{0}, size);
+    }
+    return;
+  }
+  const detail::Chunking chunks = detail::chunking(size, options);
+  detail::run_tasks(
+      chunks.count,
+      [&](std::size_t c) {
+        const std::size_t begin = c * chunks.grain;
+        body(begin, std::min(size, begin + chunks.grain));
+      },
+      options);
+}
+
+template <typename Body>
+void Policy::for_each_chunk(std::size_t size, Body&& body) const {
+  parallel::for_each_chunk(size, std::forward<Body>(body), this->options);
+}
+
+template <typename Container, typename Fn>
+void for_each(Container& c, Fn fn, const Options& options) {
+  auto* data = c.data();
+  for_each_chunk(
+      static_cast<std::size_t>(c.size()),
+      [&](std::size_t begin, std::size_t end) { std::for_each(data + begin, data + end, fn); },
+      options);
+}
+
+template <typename In, typename Out, typename Fn>
+void transform(const In& in, Out& out, Fn fn, const Options& options) {
+  const std::size_t size = static_cast<std::size_t>(in.size());
+  if (static_cast<std::size_t>(out.size()) < size) {
+    throw std::invalid_argument("transform output is shorter than the input");
+  }
+  const auto* src = in.data();
+  auto* dst = out.data();
+  for_each_chunk(
+      size,
+      [&](std::size_t begin, std::size_t end) {
+        std::transform(src + begin, src + end, dst + begin, fn);
+      },
+      options);
+}
+
+template <typename Container, typename T, typename Op>
+T reduce(const Container& c, T init, Op op, const Options& options) {
+  const std::size_t size = static_cast<std::size_t>(c.size());
+  const auto* data = c.data();
+  const detail::Chunking chunks = detail::chunking(size, options);
+  if (size < options.serial_threshold || chunks.count < 2) {
+    return std::accumulate(data, data + size, std::move(init), op);
+  }
+  // Chunks accumulate in T, as the serial path does, so a wider init keeps
+  // narrow elements from overflowing or losing precision.
+  std::vector<std::optional<T>> partial(chunks.count);
+  detail::run_tasks(
+      chunks.count,
+      [&](std::size_t i) {
+        const std::size_t begin = i * chunks.grain;
+        const std::size_t end = std::min(size, begin + chunks.grain);
+        partial[i].emplace(std::accumulate(data + begin + 1, data + end, T(data[begin]), op));
+      },
+      options);
+  for (std::optional<T>& value : partial) {
+    init = op(std::move(init), std::move(*value));
+  }
+  return init;
+}
+
+template <typename In, typename Out, typename Op>
+void inclusive_scan(const In& in, Out& out, Op op, const Options& options) {
+  const std::size_t size = static_cast<std::size_t>(in.size());
+  if (static_cast<std::size_t>(out.size()) < size) {
+    throw std::invalid_argument("inclusive_scan output is shorter than the input");
+  }
+  const auto* src = in.data();
+  auto* dst = out.data();
+  const detail::Chunking chunks = detail::chunking(size, options);
+  if (size < options.serial_threshold || chunks.count < 2) {
+    std::inclusive_scan(src, src + size, dst, op);
+    return;
+  }
+  using Value = std::remove_cvref_t<decltype(*src)>;
+  // carry[i] combines every chunk before chunk i.
+  std::vector<std::optional<Value>> carry(chunks.count);
+  detail::run_tasks(
+      chunks.count - 1,
+      [&](std::size_t i) {
+        const std::size_t begin = i * chunks.grain;
+        carry[i + 1].emplace(
+            std::accumulate(src + begin + 1, src + begin + chunks.grain, Value(src[begin]), op));
+      },
+      options);
+  for (std::size_t i = 2; i < chunks.count; ++i) {
+    carry[i] = op(*carry[i - 1], std::move(*carry[i]));
+  }
+  detail::run_tasks(
+      chunks.count,
+      [&](std::size_t i) {
+        const std::size_t begin = i * chunks.grain;
+        const std::size_t end = std::min(size, begin + chunks.grain);
+        if (i == 0) {
+          std::inclusive_scan(src + begin, src + end, dst + begin, op);
+        } else {
+          std::inclusive_scan(src + begin, src + end, dst + begin, op, *carry[i]);
+        }
+      },
+      options);
+}
+
+template <typename In, typename Out, typename T, typename Op>
+void exclusive_scan(const In& in, Out& out, T init, Op op, const Options& options) {
+  const std::size_t size = static_cast<std::size_t>(in.size());
+  if (static_cast<std::size_t>(out.size()) < size) {
+    throw std::invalid_argument("exclusive_scan output is shorter than the input");
+  }
+  const auto* src = in.data();
+  auto* dst = out.data();
+  const detail::Chunking chunks = detail::chunking(size, options);
+  if (size < options.serial_threshold || chunks.count < 2) {
+    std::exclusive_scan(src, src + size, dst, std::move(init), op);
+    return;
+  }
+  // carry[i] is init combined with every chunk before chunk i.
+  std::vector<std::optional<T>> carry(chunks.count);
+  detail::run_tasks(
+      chunks.count - 1,
+      [&](std::size_t i) {
+        const std::size_t begin = i * chunks.grain;
+        carry[i + 1].emplace(
+            std::accumulate(src + begin + 1, src + begin + chunks.grain, T(src[begin]), op));
+      },
+      options);
+  carry[0].emplace(std::move(init));
+  for (std::size_t i = 1; i < chunks.count; ++i) {
+    carry[i] = op(*carry[i - 1], std::move(*carry[i]));
+  }
+  detail::run_tasks(
+      chunks.count,
+      [&](std::size_t i) {
+        const std::size_t begin = i * chunks.grain;
+        const std::size_t end = std::min(size, begin + chunks.grain);
+        std::exclusive_scan(src + begin, src + end, dst + begin, *carry[i], op);
+      },
+      options);
+}
+
+template <typename Container, typename Compare>
+void sort(Container& c, Compare comp, const Options& options) {
+  detail::merge_sort<false>(c.data(), static_cast<std::size_t>(c.size()), comp, options);
+}
+
+template <typename Container, typename Compare>
+void stable_sort(Container& c, Compare comp, const Options& options) {
+  detail::merge_sort<true>(c.data(), static_cast<std::size_t>(c.size()), comp, options);
+}
+
+}  // namespace parallel
+
+}  // namespace utils
@@ -0,0 +1,130 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+#include <lib/vector/vector.hpp>
+
+namespace utils {
+
+// Binary format for Vector<T> of trivially copyable T: a 32-byte
+// SerializedHeader followed by count * sizeof(T) bytes of element data,
+// exactly as they sit in memory. save() writes header and data with one
+// writev straight from data(); load() reads the data straight into the
+// vector's buffer without constructing elements. The checksum is XXH64 of
+// the data bytes.
+//
+// Files are not portable across byte orders: loading a file written with
+// the other endianness throws instead of returning swapped values. Format
+// errors (bad magic, version, element size, checksum, truncated data) are
+// thrown as std::runtime_error, failed system calls as std::system_error.
+struct SerializedHeader {
+  static constexpr char kMagic[4] = {'U', 'V', 'E', 'C'};
+  static constexpr std::uint16_t kVersion = 1;
+
+  char magic[4];
+  std::uint16_t version;
+  // 1 if written on a big-endian host. Single byte, so it reads the same in
+  // either byte order.
+  std::uint8_t big_endian;
+  std::uint8_t reserved0;
+  std::uint32_t element_size;
+  std::uint32_t reserved1;
+  std::uint64_t count;
+  std::uint64_t checksum;
+};
+static_assert(sizeof(SerializedHeader) == 32 && std::is_trivially_copyable_v<SerializedHeader>);
+
+namespace detail {
+
+// Streaming XXH64 (seed 0).
+class Checksum {
+ public:
+  void update(const void* data, std::size_t bytes) noexcept;
+  std::uint64_t digest() const noexcept;
+
+ private:
+  static constexpr std::uint64_t kPrime1 = 0x9E3779B185EBCA87ULL;
+  static constexpr std::uint64_t kPrime2 = 0xC2B2AE3D27D4EB4FULL;
+  static constexpr std::uint64_t kPrime3 = 0x165667B19E3779F9ULL;
+  static constexpr std::uint64_t kPrime4 = 0x85EBCA77C2B2AE63ULL;
+  static constexpr std::uint64_t kPrime5 = 0x27D4EB2F165667C5ULL;
+
+  static std::uint64_t round(std::uint64_t acc, std::uint64_t input) noexcept;
+  void consume_stripe(const unsigned char* stripe) noexcept;
+
+  std::uint64_t acc_[4] = {kPrime1 + kPrime2, kPrime2, 0, 0 - kPrime1};
+  unsigned char buffer_[32];
+  std::size_t buffered_ = 0;
+  std::uint64_t total_ = 0;
+};
+
+std::uint64_t checksum(const void* data, std::size_t bytes) noexcept;
+
+}  // namespace detail
+
+// Writes v to fd (a file, pipe or socket) at its current position.
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+void save(int fd, const Vector<T, Allocator, GrowthPolicy, Stats>& v);
+// Creates or truncates path.
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+void save(const std::string& path, const Vector<T, Allocator, GrowthPolicy, Stats>& v);
+
+// Replaces the contents of out with one serialized vector read from fd,
+// reusing out's capacity when it is large enough. On error out is left
+// empty.
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+void load(int fd, Vector<T, Allocator, GrowthPolicy, Stats>& out);
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+void load(const std::string& path, Vector<T, Allocator, GrowthPolicy, Stats>& out);
+
+// Reads a serialized vector in windows of at most a given number of
+// elements, for inputs that do not fit in memory. The checksum is verified
+// when the last window is read.
+//
+//   VectorReader<Record> reader("records.bin");
+//   utils::Vector<Record> window;
+//   while (reader.next(window, 1 << 20)) process(window);
+template <typename T>
+class VectorReader {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "VectorReader reads raw bytes and needs a trivially copyable T");
+
+ public:
+  explicit VectorReader(const std::string& path);
+  // Reads from fd, which stays owned by the caller.
+  explicit VectorReader(int fd);
+  VectorReader(const VectorReader&) = delete;
+  VectorReader(VectorReader&& other) noexcept;
+  VectorReader& operator=(const VectorReader&) = delete;
+  VectorReader& operator=(VectorReader&& other) noexcept;
+  ~VectorReader();
+
+  // Element count recorded in the header.
+  std::size_t size() const noexcept { return size_; }
+  std::size_t remaining() const noexcept { return remaining_; }
+
+  // Replaces the contents of window with the next min(max_count,
+  // remaining()) elements. Returns false, leaving window empty, once every
+  // element has been read.
+  template <typename Allocator, typename GrowthPolicy, typename Stats>
+  bool next(Vector<T, Allocator, GrowthPolicy, Stats>& window, std::size_t max_count);
+
+ private:
+  void close() noexcept;
+
+  int fd_;
+  bool owns_fd_;
+  std::size_t size_;
+  std::size_t remaining_;
+  std::uint64_t expected_checksum_;
+  detail::Checksum checksum_;
+};
+
+}  // namespace utils
+
+#include "serialization.tpp"
@@ -0,0 +1,403 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "serialization.hpp"
+
+namespace utils {
+
+namespace detail {
+
+// Data is read and checksummed in pieces of this size, so each piece is
+// hashed while it is still in cache.
+inline constexpr std::size_t kSerializationChunkBytes = std::size_t{4} << 20;
+
+[[noreturn]] inline void throw_io_error(const std::string& what) {
+  throw std::system_error(errno, std::generic_category(), what);
+}
+
+inline std::uint64_t load_le64(const unsigned char* p) noexcept {
+  std::uint64_t value;
+  std::memcpy(&value, p, sizeof(value));
+  if constexpr (std::endian::native == std::endian::big) {
+    value = std::byteswap(value);
+  }
+  return value;
+}
+
+inline std::uint32_t load_le32(const unsigned char* p) noexcept {
+  std::uint32_t value;
+  std::memcpy(&value, p, sizeof(value));
+  if constexpr (std::endian::native == std::endian::big) {
+    value = std::byteswap(value);
+  }
+  return value;
+}
+
+inline std::uint64_t Checksum::round(std::uint64_t acc, std::uint64_t input) noexcept {
+  acc += input * kPrime2;
+  acc = std::rotl(acc, 31);
+  return acc * kPrime1;
+}
+
+inline void Checksum::consume_stripe(const unsigned char* stripe) noexcept {
+  for (int lane = 0; lane < 4; ++lane) {
+    this->acc_[lane] = round(this->acc_[lane], load_le64(stripe + 8 * lane));
+  }
+}
+
+inline void Checksum::update(const void* data, std::size_t bytes) noexcept {
+  // An empty Vector has no buffer, and memcpy must not see a null pointer.
+  if (bytes == 0) {
+    return;
+  }
+  auto* p = static_cast<const unsigned char*>(data);
+  this->total_ += bytes;
+  if (this->buffered_ + bytes < sizeof(this->buffer_)) {
+    std::memcpy(this->buffer_ + this->buffered_, p, bytes);
+    this->buffered_ += bytes;
+    return;
+  }
+  if (this->buffered_ != 0) {
+    const std::size_t fill = sizeof(this->buffer_) - this->buffered_;
+    std::memcpy(this->buffer_ + this->buffered_, p, fill);
+    this->consume_stripe(this->buffer_);
+    p += fill;
+    bytes -= fill;
+    this->buffered_ = 0;
+  }
+  // The lanes are kept in locals so that the compiler does not reload them
+  // through the byte pointer on every stripe.
+  std::uint64_t a0 = this->acc_[0], a1 = this->acc_[1], a2 = this->acc_[2], a3 = this->acc_[3];
+  for (; bytes >= 32; p += 32, bytes -= 32) {
+    a0 = round(a0, load_le64(p));
+    a1 = round(a1, load_le64(p + 8));
+    a2 = round(a2, load_le64(p + 16));
+    a3 = round(a3, load_le64(p + 24));
+  }
+  this->acc_[0] = a0;
+  this->acc_[1] = a1;
+  this->acc_[2] = a2;
+  this->acc_[3] = a3;
+  std::memcpy(this->buffer_, p, bytes);
+  this->buffered_ = bytes;
+}
+
+inline std::uint64_t Checksum::digest() const noexcept {
+  std::uint64_t hash;
+  if (this->total_ >= 32) {
+    hash = std::rotl(this->acc_[0], 1) + std::rotl(this->acc_[1], 7) +
+           std::rotl(this->acc_[2], 12) + std::rotl(this->acc_[3], 18);
+    for (std::uint64_t acc : this->acc_) {
+      hash ^= round(0, acc);
+      hash = hash * kPrime1 + kPrime4;
+    }
+  } else {
+    hash = kPrime5;
+  }
+  hash += this->total_;
+
+  const unsigned char* p = this->buffer_;
+  std::size_t left = this->buffered_;
+  for (; left >= 8; p += 8, left -= 8) {
+    hash ^= round(0, load_le64(p));
+    hash = std::rotl(hash, 27) * kPrime1 + kPrime4;
+  }
+  if (left >= 4) {
+    hash ^= static_cast<std::uint64_t>(load_le32(p)) * kPrime1;
+    hash = std::rotl(hash, 23) * kPrime2 + kPrime3;
+    p += 4;
+    left -= 4;
+  }
+  for (; left > 0; ++p, --left) {
+    hash ^= *p * kPrime5;
+    hash = std::rotl(hash, 11) * kPrime1;
+  }
+
+  hash ^= hash >> 33;
+  hash *= kPrime2;
+  hash ^= hash >> 29;
+  hash *= kPrime3;
+  hash ^= hash >> 32;
+  return hash;
+}
+
+inline std::uint64_t checksum(const void* data, std::size_t bytes) noexcept {
+  Checksum sum;
+  sum.update(data, bytes);
+  return sum.digest();
+}
+
+// Writes every iovec, resuming after partial writes and EINTR.
+inline void write_all(int fd, iovec* iov, int count) {
+  while (count > 0) {
+    const ssize_t written = ::writev(fd, iov, count);
+    if (written < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw_io_error("save: write failed");
+    }
+    auto left = static_cast<std::size_t>(written);
+    while (count > 0 && left >= iov->iov_len) {
+      left -= iov->iov_len;
+      ++iov;
+      --count;
+    }
+    if (count > 0) {
+      iov->iov_base = static_cast<char*>(iov->iov_base) + left;
+      iov->iov_len -= left;
+    }
+  }
+}
+
+// Reads up to bytes bytes; returns fewer only at end of input.
+inline std::size_t read_all(int fd, void* buffer, std::size_t bytes) {
+  auto* out = static_cast<char*>(buffer);
+  std::size_t done = 0;
+  while (done < bytes) {
+    const ssize_t got = ::read(fd, out + done, bytes - done);
+    if (got < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw_io_error("load: read failed");
+    }
+    if (got == 0) {
+      break;
+    }
+    done += static_cast<std::size_t>(got);
+  }
+  return done;
+}
+
+// Reads bytes bytes into dst in cache-sized pieces, adding each piece to
+// sum as soon as it arrives.
+inline void read_checksummed(int fd, void* dst, std::size_t bytes, Checksum& sum) {
+  auto* out = static_cast<char*>(dst);
+  while (bytes > 0) {
+    const std::size_t piece = std::min(bytes, kSerializationChunkBytes);
+    if (read_all(fd, out, piece) != piece) {
+      throw std::runtime_error("load: truncated element data");
+    }
+    sum.update(out, piece);
+    out += piece;
+    bytes -= piece;
+  }
+}
+
+template <typename T>
+SerializedHeader read_header(int fd, std::size_t max_count) {
+  SerializedHeader header;
+  if (read_all(fd, &header, sizeof(header)) != sizeof(header)) {
+    throw std::runtime_error("load: truncated header");
+  }
+  if (std::memcmp(header.magic, SerializedHeader::kMagic, sizeof(header.magic)) != 0) {
+    throw std::runtime_error("load: not a serialized vector");
+  }
+  if (header.big_endian != (std::endian::native == std::endian::big)) {
+    throw std::runtime_error("load: written with the other byte order");
+  }
+  if (header.version != SerializedHeader::kVersion) {
+    throw std::runtime_error("load: unsupported version " + std::to_string(header.version));
+  }
+  if (header.element_size != sizeof(T)) {
+    throw std::runtime_error("load: element size " + std::to_string(header.element_size) +
+                             " does not match sizeof(T) " + std::to_string(sizeof(T)));
+  }
+  if (header.count > max_count) {
+    throw std::runtime_error("load: element count exceeds max_size()");
+  }
+  // The header is not checksummed, so a corrupt count would otherwise be
+  // allocated before the short read gives it away. Pipes cannot be sized
+  // up front and are only caught by that read.
+  struct stat st;
+  if (::fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+    const off_t offset = ::lseek(fd, 0, SEEK_CUR);
+    if (offset != -1) {
+      const auto left = static_cast<std::uint64_t>(std::max<off_t>(0, st.st_size - offset));
+      if (header.count > left / sizeof(T)) {
+        throw std::runtime_error("load: element count exceeds the file size");
+      }
+    }
+  }
+  return header;
+}
+
+inline int open_or_throw(const std::string& path, int flags) {
+  const int fd = ::open(path.c_str(), flags | O_CLOEXEC, 0644);
+  if (fd == -1) {
+    throw_io_error("cannot open " + path);
+  }
+  return fd;
+}
+
+}  // namespace detail
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+void save(int fd, const Vector<T, Allocator, GrowthPolicy, Stats>& v) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "save writes raw bytes and needs a trivially copyable T");
+  const std::size_t bytes = v.size() * sizeof(T);
+  SerializedHeader header{};
+  std::memcpy(header.magic, SerializedHeader::kMagic, sizeof(header.magic));
+  header.version = SerializedHeader::kVersion;
+  header.big_endian = std::endian::native == std::endian::big;
+  header.element_size = sizeof(T);
+  header.count = v.size();
+  header.checksum = detail::checksum(v.data(), bytes);
+
+  iovec iov[2] = {{&header, sizeof(header)}, {const_cast<T*>(v.data()), bytes}};
+  detail::write_all(fd, iov, 2);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+void save(const std::string& path, const Vector<T, Allocator, GrowthPolicy, Stats>& v) {
+  const int fd = detail::open_or_throw(path, O_WRONLY | O_CREAT | O_TRUNC);
+  try {
+    save(fd, v);
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  // close() reports write-back errors that write() could not.
+  if (::close(fd) != 0) {
+    detail::throw_io_error("save: cannot close " + path);
+  }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+void load(int fd, Vector<T, Allocator, GrowthPolicy, Stats>& out) {
+  static_assert(std::is_trivially_copyable_v<T>,
+                "load reads raw bytes and needs a trivially copyable T");
+  out.clear();
+  const SerializedHeader header = detail::read_header<T>(fd, out.max_size());
+  const auto count = static_cast<std::size_t>(header.count);
+  detail::Checksum sum;
+  // On a read error or checksum mismatch out is left empty.
+  out.resize_and_overwrite(count, [&](T* data, std::size_t size) {
+    detail::read_checksummed(fd, data, size * sizeof(T), sum);
+    if (sum.digest() != header.checksum) {
+      throw std::runtime_error("load: checksum mismatch");
+    }
+    return size;
+  });
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+void load(const std::string& path, Vector<T, Allocator, GrowthPolicy, Stats>& out) {
+  const int fd = detail::open_or_throw(path, O_RDONLY);
+  try {
+    load(fd, out);
+  } catch (...) {
+    ::close(fd);
+    throw;
+  }
+  ::close(fd);
+}
+
+// VectorReader
+
+template <typename T>
+VectorReader<T>::VectorReader(const std::string& path)
+    : fd_(detail::open_or_throw(path, O_RDONLY)),
+      owns_fd_(true),
+      size_(0),
+      remaining_(0),
+      expected_checksum_(0) {
+  try {
+    const SerializedHeader header =
+        detail::read_header<T>(this->fd_, std::numeric_limits<std::size_t>::max() / sizeof(T));
+    this->size_ = this->remaining_ = static_cast<std::size_t>(header.count);
+    this->expected_checksum_ = header.checksum;
+  } catch (...) {
+    this->close();
+    throw;
+  }
+}
+
+template <typename T>
+VectorReader<T>::VectorReader(int fd)
+    : fd_(fd), owns_fd_(false), size_(0), remaining_(0), expected_checksum_(0) {
+  const SerializedHeader header =
+      detail::read_header<T>(this->fd_, std::numeric_limits<std::size_t>::max() / sizeof(T));
+  this->size_ = this->remaining_ = static_cast<std::size_t>(header.count);
+  this->expected_checksum_ = header.checksum;
+}
+
+template <typename T>
+VectorReader<T>::VectorReader(VectorReader&& other) noexcept
+    : fd_(std::exchange(other.fd_, -1)),
+      owns_fd_(std::exchange(other.owns_fd_, false)),
+      size_(std::exchange(other.size_, 0)),
+      remaining_(std::exchange(other.remaining_, 0)),
+      expected_checksum_(other.expected_checksum_),
+      checksum_(other.checksum_) {}
+
+template <typename T>
+VectorReader<T>& VectorReader<T>::operator=(VectorReader&& other) noexcept {
+  if (this != &other) {
+    this->close();
+    this->fd_ = std::exchange(other.fd_, -1);
+    this->owns_fd_ = std::exchange(other.owns_fd_, false);
+    this->size_ = std::exchange(other.size_, 0);
+    this->remaining_ = std::exchange(other.remaining_, 0);
+    this->expected_checksum_ = other.expected_checksum_;
+    this->checksum_ = other.checksum_;
+  }
+  return *this;
+}
+
+template <typename T>
+VectorReader<T>::~VectorReader() {
+  this->close();
+}
+
+template <typename T>
+void VectorReader<T>::close() noexcept {
+  if (this->owns_fd_ && this->fd_ != -1) {
+    ::close(this->fd_);
+  }
+  this->fd_ = -1;
+  this->owns_fd_ = false;
+}
+
+template <typename T>
+template <typename Allocator, typename GrowthPolicy, typename Stats>
+bool VectorReader<T>::next(Vector<T, Allocator, GrowthPolicy, Stats>& window,
+                           std::size_t max_count) {
+  window.clear();
+  if (this->remaining_ == 0) {
+    return false;
+  }
+  if (max_count == 0) {
+    throw std::invalid_argument("VectorReader::next: max_count must be positive");
+  }
+  const std::size_t count = std::min(max_count, this->remaining_);
+  window.resize_and_overwrite(count, [&](T* data, std::size_t size) {
+    detail::read_checksummed(this->fd_, data, size * sizeof(T), this->checksum_);
+    this->remaining_ -= size;
+    if (this->remaining_ == 0 && this->checksum_.digest() != this->expected_checksum_) {
+      throw std::runtime_error("load: checksum mismatch");
+    }
+    return size;
+  });
+  return true;
+}
+
+}  // namespace utils
@@ -0,0 +1,161 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include <lib/vector/growth_policy.hpp>
+#include <lib/vector/relocate.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace utils {
+
+// Vector that keeps up to N elements inside the object and only moves them
+// to the heap once it outgrows that. Growth and relocation are shared with
+// utils::Vector; after spilling, capacity grows from N by GrowthPolicy.
+template <typename T, std::size_t N, typename Allocator = std::allocator<T>,
+          typename GrowthPolicy = DefaultGrowth>
+class SmallVector {
+  static_assert(N > 0, "SmallVector needs room for at least one inline element");
+  static_assert(growth_policy_for<GrowthPolicy, T>,
+                "GrowthPolicy must provide next_capacity<T>(capacity, required, max_size)");
+
+ public:
+  using value_type = T;
+  using allocator_type = Allocator;
+  using alloc_traits = std::allocator_traits<Allocator>;
+  using growth_policy = GrowthPolicy;
+  using Iterator = typename Vector<T, Allocator, GrowthPolicy>::Iterator;
+  using ConstIterator = typename Vector<T, Allocator, GrowthPolicy>::ConstIterator;
+  using ReverseIterator = std::reverse_iterator<Iterator>;
+  using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+  // Standard container names.
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+  using reverse_iterator = ReverseIterator;
+  using const_reverse_iterator = ConstReverseIterator;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+
+  static constexpr std::size_t inline_capacity = N;
+
+  // Constructors / Destructor
+  SmallVector(const Allocator& alloc = Allocator());
+  explicit SmallVector(std::size_t size, const T& val,
+                       const Allocator& alloc = Allocator());
+  SmallVector(const std::initializer_list<T>& list,
+              const Allocator& alloc = Allocator());
+  template <std::input_iterator InputIterator>
+  SmallVector(InputIterator first, InputIterator last,
+              const Allocator& alloc = Allocator());
+  SmallVector(const SmallVector& obj);
+  SmallVector(const SmallVector& obj, const Allocator& alloc);
+  SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+  SmallVector(SmallVector&& other, const Allocator& alloc);
+  SmallVector& operator=(const SmallVector& obj);
+  SmallVector& operator=(SmallVector&& other)
+      noexcept(std::is_nothrow_move_constructible_v<T> &&
+               (alloc_traits::propagate_on_container_move_assignment::value ||
+                alloc_traits::is_always_equal::value));
+  SmallVector& operator=(const std::initializer_list<T>& list);
+  ~SmallVector();
+
+  // Allocator
+  const Allocator& get_allocator() const noexcept { return alloc_; }
+
+  // Iterators:
+  Iterator begin();
+  ConstIterator begin() const;
+  Iterator end();
+  ConstIterator end() const;
+  ConstIterator cbegin() const;
+  ConstIterator cend() const;
+  ReverseIterator rbegin() { return ReverseIterator(end()); }
+  ConstReverseIterator rbegin() const { return ConstReverseIterator(end()); }
+  ReverseIterator rend() { return ReverseIterator(begin()); }
+  ConstReverseIterator rend() const { return ConstReverseIterator(begin()); }
+  ConstReverseIterator crbegin() const { return rbegin(); }
+  ConstReverseIterator crend() const { return rend(); }
+  // Capacity:
+  std::size_t size() const;
+  std::size_t max_size() const;
+  void resize(std::size_t size, const T& val = T());
+  std::size_t capacity() const;
+  bool empty() const;
+  bool is_inline() const noexcept { return data_ == inline_data(); }
+  void reserve(std::size_t malloc);
+  void shrink_to_fit();
+  // Element access:
+  T& operator[](std::size_t i);
+  const T& operator[](std::size_t i) const;
+  T& at(std::size_t n);
+  const T& at(std::size_t n) const;
+  T& front();
+  const T& front() const;
+  T& back();
+  const T& back() const;
+  T* data();
+  const T* data() const;
+  // Modifiers:
+  template <std::input_iterator InputIterator>
+  void assign(InputIterator first, InputIterator last);
+  void assign(std::size_t size, const T& val);
+  void clear() noexcept;
+  void push_back(const T& obj);
+  void push_back(T&& obj);
+  template <typename... Args>
+  T& emplace_back(Args&&... args);
+  void pop_back();
+  Iterator erase(ConstIterator position);
+  Iterator insert(ConstIterator position, const T& val);
+  Iterator insert(ConstIterator position, T&& val);
+  Iterator insert(ConstIterator position, std::size_t count, const T& val);
+  template <std::input_iterator InputIterator>
+  Iterator insert(ConstIterator position, InputIterator first, InputIterator last);
+  Iterator insert(ConstIterator position, std::initializer_list<T> list);
+  template <std::ranges::input_range Range>
+  Iterator insert_range(ConstIterator position, Range&& range);
+  template <std::ranges::input_range Range>
+  void append_range(Range&& range);
+  template <typename... Args>
+  Iterator emplace(ConstIterator position, Args&&... args);
+
+  void swap(SmallVector& obj) noexcept(
+      std::is_nothrow_move_constructible_v<T> &&
+      (alloc_traits::propagate_on_container_swap::value ||
+       alloc_traits::is_always_equal::value));
+
+ private:
+  T* inline_data() noexcept { return reinterpret_cast<T*>(buffer_); }
+  const T* inline_data() const noexcept {
+    return reinterpret_cast<const T*>(buffer_);
+  }
+  void release() noexcept;
+  void take_storage(SmallVector& other);
+  void reallocate(std::size_t new_cap);
+  std::size_t next_capacity(std::size_t required) const;
+  template <typename Build>
+  void realloc_insert(std::size_t pos, std::size_t count, Build&& build);
+  template <std::forward_iterator ForwardIterator>
+  Iterator insert_forward(std::size_t pos, ForwardIterator first, std::size_t count);
+
+  std::size_t size_;
+  T* data_;
+  std::size_t capacity_;
+  Allocator alloc_;
+  alignas(T) unsigned char buffer_[N * sizeof(T)];
+};
+
+}  // namespace utils
+
+#include "small_vector.tpp"
@@ -0,0 +1,487 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+
+#include "small_vector.hpp"
+
+namespace utils {
+
+// Constructors / Destructor
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(const Allocator& alloc)
+    : size_(0), data_(inline_data()), capacity_(N), alloc_(alloc) {}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(std::size_t size, const T& val, const Allocator& alloc)
+    : SmallVector(alloc) {
+  insert(end(), size, val);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(const std::initializer_list<T>& list, const Allocator& alloc)
+    : SmallVector(alloc) {
+  insert_forward(0, list.begin(), list.size());
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+template <std::input_iterator InputIterator>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(InputIterator first, InputIterator last, const Allocator& alloc)
+    : SmallVector(alloc) {
+  insert(end(), first, last);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(const SmallVector& obj)
+    : SmallVector(alloc_traits::select_on_container_copy_construction(obj.alloc_)) {
+  insert_forward(0, obj.data_, obj.size_);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(const SmallVector& obj, const Allocator& alloc)
+    : SmallVector(alloc) {
+  insert_forward(0, obj.data_, obj.size_);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(SmallVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+    : size_(0), data_(inline_data()), capacity_(N), alloc_(std::move(other.alloc_)) {
+  take_storage(other);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::SmallVector(SmallVector&& other, const Allocator& alloc)
+    : SmallVector(alloc) {
+  if (other.is_inline() || this->alloc_ == other.alloc_) {
+    take_storage(other);
+  } else {
+    insert_forward(0, std::make_move_iterator(other.data_), other.size_);
+    other.clear();
+  }
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>& SmallVector<T, N, Allocator, GrowthPolicy>::operator=(const SmallVector& obj) {
+  if (this != &obj) {
+    if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+      if (this->alloc_ != obj.alloc_) {
+        release();
+      }
+      this->alloc_ = obj.alloc_;
+    }
+    assign(obj.data_, obj.data_ + obj.size_);
+  }
+  return *this;
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>& SmallVector<T, N, Allocator, GrowthPolicy>::operator=(SmallVector&& other)
+    noexcept(std::is_nothrow_move_constructible_v<T> &&
+             (alloc_traits::propagate_on_container_move_assignment::value ||
+              alloc_traits::is_always_equal::value)) {
+  if (this != &other) {
+    if (alloc_traits::propagate_on_container_move_assignment::value ||
+        this->alloc_ == other.alloc_ || other.is_inline()) {
+      release();
+      if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+        this->alloc_ = std::move(other.alloc_);
+      }
+      take_storage(other);
+    } else {
+      assign(std::make_move_iterator(other.data_),
+             std::make_move_iterator(other.data_ + other.size_));
+    }
+  }
+  return *this;
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>& SmallVector<T, N, Allocator, GrowthPolicy>::operator=(const std::initializer_list<T>& list) {
+  assign(list.begin(), list.end());
+  return *this;
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::~SmallVector() {
+  release();
+}
+
+// Private helper methods
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::release() noexcept {
+  clear();
+  if (!is_inline()) {
+    alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
+    this->data_ = inline_data();
+    this->capacity_ = N;
+  }
+}
+
+// Moves other's elements into *this, which must be empty and inline. Heap
+// buffers change hands; inline elements are relocated.
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::take_storage(SmallVector& other) {
+  if (other.is_inline()) {
+    detail::relocate(this->alloc_, other.data_, other.size_, inline_data());
+  } else {
+    this->data_ = other.data_;
+    this->capacity_ = other.capacity_;
+    other.data_ = other.inline_data();
+    other.capacity_ = N;
+  }
+  this->size_ = other.size_;
+  other.size_ = 0;
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::reallocate(std::size_t new_cap) {
+  detail::grow_buffer(this->alloc_, this->data_, this->capacity_, this->size_, !is_inline(),
+                      new_cap);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+std::size_t SmallVector<T, N, Allocator, GrowthPolicy>::next_capacity(std::size_t required) const {
+  if (required > max_size()) {
+    throw std::length_error("SmallVector size exceeds max_size()");
+  }
+  return GrowthPolicy::template next_capacity<T>(this->capacity_, required,
+                                                 max_size());
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+template <typename Build>
+void SmallVector<T, N, Allocator, GrowthPolicy>::realloc_insert(std::size_t pos, std::size_t count, Build&& build) {
+  detail::grow_buffer(this->alloc_, this->data_, this->capacity_, this->size_, !is_inline(),
+                      next_capacity(this->size_ + count), pos, count, std::forward<Build>(build));
+  this->size_ += count;
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+template <std::forward_iterator ForwardIterator>
+SmallVector<T, N, Allocator, GrowthPolicy>::Iterator SmallVector<T, N, Allocator, GrowthPolicy>::insert_forward(std::size_t pos, ForwardIterator first, std::size_t count) {
+  if (count > this->capacity_ - this->size_) {
+    realloc_insert(pos, count, [&](T* dest) {
+      detail::uninitialized_copy_n(this->alloc_, first, count, dest);
+    });
+  } else if (count != 0) {
+    detail::insert_in_place(this->alloc_, this->data_, this->size_, pos, first, count);
+  }
+  return Iterator(this->data_ + pos);
+}
+
+// Iterators:
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::Iterator SmallVector<T, N, Allocator, GrowthPolicy>::begin() {
+  return Iterator(this->data_);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::ConstIterator SmallVector<T, N, Allocator, GrowthPolicy>::begin() const {
+  return ConstIterator(this->data_);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::Iterator SmallVector<T, N, Allocator, GrowthPolicy>::end() {
+  return Iterator(this->data_ + this->size_);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::ConstIterator SmallVector<T, N, Allocator, GrowthPolicy>::end() const {
+  return ConstIterator(this->data_ + this->size_);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::ConstIterator SmallVector<T, N, Allocator, GrowthPolicy>::cbegin() const {
+  return begin();
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::ConstIterator SmallVector<T, N, Allocator, GrowthPolicy>::cend() const {
+  return end();
+}
+
+// Capacity:
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+std::size_t SmallVector<T, N, Allocator, GrowthPolicy>::size() const {
+  return this->size_;
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+std::size_t SmallVector<T, N, Allocator, GrowthPolicy>::max_size() const {
+  return std::numeric_limits<std::size_t>::max() / sizeof(T);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::resize(std::size_t size, const T& val) {
+  if (size < this->size_) {
+    detail::destroy_n(this->alloc_, this->data_ + size, this->size_ - size);
+    this->size_ = size;
+  } else if (size > this->size_) {
+    insert(end(), size - this->size_, val);
+  }
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+std::size_t SmallVector<T, N, Allocator, GrowthPolicy>::capacity() const {
+  return this->capacity_;
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+bool SmallVector<T, N, Allocator, GrowthPolicy>::empty() const {
+  return (this->size_ == 0);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::reserve(std::size_t malloc) {
+  if (malloc <= this->capacity_) return;
+  if (malloc > max_size()) {
+    throw std::length_error("SmallVector size exceeds max_size()");
+  }
+  reallocate(malloc);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::shrink_to_fit() {
+  if (is_inline() || this->size_ == this->capacity_) {
+    return;
+  }
+
+  T* new_data = this->size_ <= N ? inline_data()
+                                 : alloc_traits::allocate(this->alloc_, this->size_);
+  try {
+    detail::relocate(this->alloc_, this->data_, this->size_, new_data);
+  } catch (...) {
+    if (new_data != inline_data()) {
+      alloc_traits::deallocate(this->alloc_, new_data, this->size_);
+    }
+    throw;
+  }
+
+  alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
+  this->data_ = new_data;
+  this->capacity_ = is_inline() ? N : this->size_;
+}
+
+// Element access:
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+T& SmallVector<T, N, Allocator, GrowthPolicy>::operator[](std::size_t i) {
+  return this->data_[i];
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+const T& SmallVector<T, N, Allocator, GrowthPolicy>::operator[](std::size_t i) const {
+  return this->data_[i];
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+T& SmallVector<T, N, Allocator, GrowthPolicy>::at(std::size_t i) {
+  if (i >= this->size_) {
+    throw std::out_of_range("");
+  }
+  return this->data_[i];
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+const T& SmallVector<T, N, Allocator, GrowthPolicy>::at(std::size_t i) const {
+  if (i >= this->size_) {
+    throw std::out_of_range("");
+  }
+  return this->data_[i];
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+T& SmallVector<T, N, Allocator, GrowthPolicy>::front() {
+  return this->data_[0];
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+const T& SmallVector<T, N, Allocator, GrowthPolicy>::front() const {
+  return this->data_[0];
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+T& SmallVector<T, N, Allocator, GrowthPolicy>::back() {
+  return this->data_[this->size_ - 1];
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+const T& SmallVector<T, N, Allocator, GrowthPolicy>::back() const {
+  return this->data_[this->size_ - 1];
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+T* SmallVector<T, N, Allocator, GrowthPolicy>::data() {
+  return this->data_;
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+const T* SmallVector<T, N, Allocator, GrowthPolicy>::data() const {
+  return this->data_;
+}
+
+// Modifiers:
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+template <std::input_iterator InputIterator>
+void SmallVector<T, N, Allocator, GrowthPolicy>::assign(InputIterator first, InputIterator last) {
+  SmallVector tmp(first, last, this->alloc_);
+  *this = std::move(tmp);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::assign(std::size_t size, const T& val) {
+  SmallVector tmp(size, val, this->alloc_);
+  *this = std::move(tmp);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::clear() noexcept {
+  detail::destroy_n(this->alloc_, this->data_, this->size_);
+  this->size_ = 0;
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::push_back(const T& obj) {
+  emplace_back(obj);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::push_back(T&& obj) {
+  emplace_back(std::move(obj));
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+T& SmallVector<T, N, Allocator, GrowthPolicy>::emplace_back(Args&&... args) {
+  const std::size_t pos = this->size_;
+  if (this->size_ >= this->capacity_) {
+    realloc_insert(pos, 1, [&](T* dest) {
+      alloc_traits::construct(this->alloc_, dest, std::forward<Args>(args)...);
+    });
+  } else {
+    alloc_traits::construct(this->alloc_, this->data_ + pos, std::forward<Args>(args)...);
+    ++this->size_;
+  }
+  return this->data_[pos];
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::pop_back() {
+  if (this->size_ == 0) {
+    throw std::out_of_range("Trying to pop from empty SmallVector.");
+  }
+  --this->size_;
+  alloc_traits::destroy(this->alloc_, this->data_ + this->size_);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::Iterator SmallVector<T, N, Allocator, GrowthPolicy>::erase(ConstIterator position) {
+  const std::size_t index = position - cbegin();
+  if (index >= this->size_) {
+    throw std::out_of_range("Iterator out of range");
+  }
+  detail::erase_in_place(this->alloc_, this->data_, this->size_, index, 1);
+
+  return Iterator(this->data_ + index);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::Iterator SmallVector<T, N, Allocator, GrowthPolicy>::insert(ConstIterator position, const T& val) {
+  return emplace(position, val);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::Iterator SmallVector<T, N, Allocator, GrowthPolicy>::insert(ConstIterator position, T&& val) {
+  return emplace(position, std::move(val));
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::Iterator SmallVector<T, N, Allocator, GrowthPolicy>::insert(ConstIterator position, std::size_t count, const T& val) {
+  // val may refer to an element that is about to be shifted.
+  const T copy(val);
+  auto values = std::views::iota(std::size_t{0}, count) |
+                std::views::transform([&copy](std::size_t) -> const T& { return copy; });
+  return insert_forward(position - cbegin(), values.begin(), count);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+template <std::input_iterator InputIterator>
+SmallVector<T, N, Allocator, GrowthPolicy>::Iterator SmallVector<T, N, Allocator, GrowthPolicy>::insert(ConstIterator position, InputIterator first, InputIterator last) {
+  return insert_range(position, std::ranges::subrange(first, last));
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+SmallVector<T, N, Allocator, GrowthPolicy>::Iterator SmallVector<T, N, Allocator, GrowthPolicy>::insert(ConstIterator position, std::initializer_list<T> list) {
+  return insert_forward(position - cbegin(), list.begin(), list.size());
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+template <std::ranges::input_range Range>
+SmallVector<T, N, Allocator, GrowthPolicy>::Iterator SmallVector<T, N, Allocator, GrowthPolicy>::insert_range(ConstIterator position, Range&& range) {
+  const std::size_t pos = position - cbegin();
+  if constexpr (std::ranges::forward_range<Range>) {
+    return insert_forward(pos, std::ranges::begin(range),
+                          static_cast<std::size_t>(std::ranges::distance(range)));
+  } else {
+    const std::size_t old_size = this->size_;
+    for (auto it = std::ranges::begin(range); it != std::ranges::end(range); ++it) {
+      emplace_back(*it);
+    }
+    std::rotate(this->data_ + pos, this->data_ + old_size, this->data_ + this->size_);
+    return Iterator(this->data_ + pos);
+  }
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+template <std::ranges::input_range Range>
+void SmallVector<T, N, Allocator, GrowthPolicy>::append_range(Range&& range) {
+  insert_range(end(), std::forward<Range>(range));
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+template <typename... Args>
+SmallVector<T, N, Allocator, GrowthPolicy>::Iterator SmallVector<T, N, Allocator, GrowthPolicy>::emplace(ConstIterator position, Args&&... args) {
+  const std::size_t pos = position - cbegin();
+  if (this->size_ == this->capacity_) {
+    realloc_insert(pos, 1, [&](T* dest) {
+      alloc_traits::construct(this->alloc_, dest, std::forward<Args>(args)...);
+    });
+  } else {
+    detail::emplace_in_place(this->alloc_, this->data_, this->size_, pos,
+                             std::forward<Args>(args)...);
+  }
+  return Iterator(this->data_ + pos);
+}
+
+template <typename T, std::size_t N, typename Allocator, typename GrowthPolicy>
+void SmallVector<T, N, Allocator, GrowthPolicy>::swap(SmallVector& obj) noexcept(
+    std::is_nothrow_move_constructible_v<T> &&
+    (alloc_traits::propagate_on_container_swap::value ||
+     alloc_traits::is_always_equal::value)) {
+  using std::swap;
+  if constexpr (alloc_traits::propagate_on_container_swap::value) {
+    swap(this->alloc_, obj.alloc_);
+  }
+  if (!is_inline() && !obj.is_inline()) {
+    swap(this->data_, obj.data_);
+    swap(this->size_, obj.size_);
+    swap(this->capacity_, obj.capacity_);
+    return;
+  }
+  SmallVector tmp(this->alloc_);
+  tmp.take_storage(*this);
+  take_storage(obj);
+  obj.take_storage(tmp);
+}
+
+}  // namespace utils
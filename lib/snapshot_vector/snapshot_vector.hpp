@@ -0,0 +1,267 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <span>
+
+#include <lib/vector/vector.hpp>
+
+namespace utils {
+
+// Vector for read-mostly data shared by many threads. The contents are kept
+// in chunks of kChunkSize elements behind a table of shared pointers, and
+// every published state is an immutable version of that table.
+//
+// Readers call snapshot(), which atomically loads the current version
+// without waiting on writers, and read from it for as long as they keep it.
+// A Reader caches its snapshot and only reloads it after a commit, so
+// steady-state reads touch no shared cache line that anyone writes.
+//
+// Writers call edit() (or update()) and change an Editor: it starts from a
+// copy of the current chunk table and copies a chunk the first time one of
+// its elements is modified, so an update costs the table plus the chunks it
+// touches. commit() publishes the result atomically. Writers are serialized
+// by a mutex that readers never take.
+//
+// Versions and chunks are reference counted: a version is freed when the
+// last snapshot of it is dropped, and a chunk when no version refers to it.
+//
+//   utils::SnapshotVector<Route> routes(std::move(initial));
+//   routes.update([](auto& e) { e[42].gateway = next_hop; });
+//   auto view = routes.snapshot();  // stays valid and unchanged
+template <typename T, typename Allocator = std::allocator<T>>
+class SnapshotVector {
+ public:
+  using value_type = T;
+  using allocator_type = Allocator;
+  using Chunk = Vector<T, Allocator>;
+
+  static constexpr std::size_t kChunkLog =
+      std::bit_width(std::max<std::size_t>(1, 4096 / sizeof(T))) - 1;
+  static constexpr std::size_t kChunkSize = std::size_t{1} << kChunkLog;
+
+  class Snapshot;
+  class Editor;
+  class Reader;
+
+  // Constructors / Destructor
+  SnapshotVector(const Allocator& alloc = Allocator());
+  explicit SnapshotVector(const Vector<T, Allocator>& values);
+  explicit SnapshotVector(Vector<T, Allocator>&& values);
+  SnapshotVector(std::initializer_list<T> list, const Allocator& alloc = Allocator());
+  SnapshotVector(const SnapshotVector&) = delete;
+  SnapshotVector& operator=(const SnapshotVector&) = delete;
+
+  const Allocator& get_allocator() const noexcept { return alloc_; }
+
+  // Readers:
+  Snapshot snapshot() const noexcept;
+  // Number of commits so far.
+  std::uint64_t version() const noexcept { return version_.load(std::memory_order_acquire); }
+  std::size_t size() const noexcept { return snapshot().size(); }
+  Vector<T, Allocator> to_vector() const { return snapshot().to_vector(); }
+
+  // Writers:
+  // Waits for other writers; the Editor holds the writer lock until it is
+  // destroyed. Nothing is published without commit().
+  Editor edit();
+  // Runs fn(Editor&) and commits.
+  template <typename Fn>
+  void update(Fn&& fn);
+  // Publishes values as the new contents.
+  void assign(const Vector<T, Allocator>& values);
+  void assign(Vector<T, Allocator>&& values);
+
+ private:
+  struct Version {
+    Vector<std::shared_ptr<Chunk>> chunks;
+    std::size_t size = 0;
+  };
+
+  std::shared_ptr<Chunk> make_chunk() const;
+  // Splits values into chunks, moving the elements when Values is an rvalue.
+  template <typename Values>
+  std::shared_ptr<const Version> make_version(Values&& values) const;
+  void publish(std::shared_ptr<const Version> version);
+
+  std::atomic<std::shared_ptr<const Version>> current_;
+  // Bumped after every publish; lets a Reader check for news with one load.
+  alignas(64) std::atomic<std::uint64_t> version_;
+  std::mutex writer_mutex_;
+  Allocator alloc_;
+};
+
+// Immutable view of one published version. Cheap to copy; keeps the
+// version alive, and so do its iterators.
+template <typename T, typename Allocator>
+class SnapshotVector<T, Allocator>::Snapshot {
+ public:
+  class Iterator;
+
+  Snapshot() noexcept = default;
+
+  std::size_t size() const noexcept { return version_ ? version_->size : 0; }
+  bool empty() const noexcept { return size() == 0; }
+  const T& operator[](std::size_t i) const noexcept {
+    return (*version_->chunks[i >> kChunkLog])[i & (kChunkSize - 1)];
+  }
+  const T& at(std::size_t i) const;
+  const T& front() const noexcept { return (*this)[0]; }
+  const T& back() const noexcept { return (*this)[size() - 1]; }
+
+  // The elements as consecutive contiguous runs of kChunkSize (the last one
+  // may be shorter).
+  std::size_t chunk_count() const noexcept { return version_ ? version_->chunks.size() : 0; }
+  std::span<const T> chunk(std::size_t c) const noexcept {
+    const Chunk& elements = *version_->chunks[c];
+    return {elements.data(), elements.size()};
+  }
+
+  Iterator begin() const noexcept { return Iterator(version_, 0); }
+  Iterator end() const noexcept { return Iterator(version_, size()); }
+
+  Vector<T, Allocator> to_vector() const;
+
+ private:
+  friend class SnapshotVector;
+
+  explicit Snapshot(std::shared_ptr<const Version> version) noexcept
+      : version_(std::move(version)) {}
+
+  std::shared_ptr<const Version> version_;
+};
+
+template <typename T, typename Allocator>
+class SnapshotVector<T, Allocator>::Snapshot::Iterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = T;
+  using difference_type = std::ptrdiff_t;
+  using reference = const T&;
+  using pointer = const T*;
+
+  Iterator() noexcept = default;
+
+  reference operator*() const noexcept {
+    return (*version_->chunks[index_ >> kChunkLog])[index_ & (kChunkSize - 1)];
+  }
+  pointer operator->() const noexcept { return &**this; }
+  reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+  Iterator& operator++() noexcept {
+    ++index_;
+    return *this;
+  }
+  Iterator operator++(int) noexcept { return Iterator(version_, index_++); }
+  Iterator& operator--() noexcept {
+    --index_;
+    return *this;
+  }
+  Iterator operator--(int) noexcept { return Iterator(version_, index_--); }
+  Iterator& operator+=(difference_type n) noexcept {
+    index_ += static_cast<std::size_t>(n);
+    return *this;
+  }
+  Iterator& operator-=(difference_type n) noexcept {
+    index_ -= static_cast<std::size_t>(n);
+    return *this;
+  }
+  Iterator operator+(difference_type n) const noexcept {
+    return Iterator(version_, index_ + static_cast<std::size_t>(n));
+  }
+  friend Iterator operator+(difference_type n, const Iterator& it) noexcept { return it + n; }
+  Iterator operator-(difference_type n) const noexcept {
+    return Iterator(version_, index_ - static_cast<std::size_t>(n));
+  }
+  difference_type operator-(const Iterator& other) const noexcept {
+    return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+  }
+
+  bool operator==(const Iterator& other) const noexcept { return index_ == other.index_; }
+  std::strong_ordering operator<=>(const Iterator& other) const noexcept {
+    return index_ <=> other.index_;
+  }
+
+ private:
+  friend class Snapshot;
+
+  Iterator(std::shared_ptr<const Version> version, std::size_t index) noexcept
+      : version_(std::move(version)), index_(index) {}
+
+  // Shared with the Snapshot, so an iterator outlives a temporary one.
+  std::shared_ptr<const Version> version_;
+  std::size_t index_ = 0;
+};
+
+// Draft of the next version, owned by one writer. Reading through a const
+// Editor never copies; the non-const accessors copy the element's chunk on
+// first use.
+template <typename T, typename Allocator>
+class SnapshotVector<T, Allocator>::Editor {
+ public:
+  Editor(Editor&&) noexcept = default;
+  Editor& operator=(Editor&&) noexcept = default;
+
+  std::size_t size() const noexcept { return draft_.size; }
+  bool empty() const noexcept { return draft_.size == 0; }
+  const T& operator[](std::size_t i) const noexcept {
+    return (*draft_.chunks[i >> kChunkLog])[i & (kChunkSize - 1)];
+  }
+  T& operator[](std::size_t i) { return writable(i >> kChunkLog)[i & (kChunkSize - 1)]; }
+  const T& at(std::size_t i) const;
+  T& at(std::size_t i);
+
+  void push_back(const T& obj);
+  void push_back(T&& obj);
+  template <typename... Args>
+  T& emplace_back(Args&&... args);
+  void pop_back();
+  void resize(std::size_t size, const T& val = T());
+  void clear() noexcept;
+
+  // Publishes the draft. The Editor stays usable for further changes.
+  void commit();
+
+ private:
+  friend class SnapshotVector;
+
+  Editor(SnapshotVector& owner);
+
+  // Chunk c, copied first unless this Editor created it.
+  Chunk& writable(std::size_t c);
+
+  SnapshotVector* owner_;
+  std::unique_lock<std::mutex> lock_;
+  Version draft_;
+  // owned_[c]: chunk c is private to the draft and may be changed in place.
+  Vector<bool> owned_;
+};
+
+// Per-thread handle that keeps the latest snapshot and reloads it only when
+// the version number has moved.
+template <typename T, typename Allocator>
+class SnapshotVector<T, Allocator>::Reader {
+ public:
+  explicit Reader(const SnapshotVector& source) noexcept;
+
+  const Snapshot& current() noexcept;
+
+ private:
+  const SnapshotVector* source_;
+  std::uint64_t seen_;
+  Snapshot snapshot_;
+};
+
+}  // namespace utils
+
+#include "snapshot_vector.tpp"
@@ -0,0 +1,282 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+#include "snapshot_vector.hpp"
+
+namespace utils {
+
+// Constructors
+
+template <typename T, typename Allocator>
+SnapshotVector<T, Allocator>::SnapshotVector(const Allocator& alloc)
+    : current_(std::make_shared<const Version>()), version_(0), alloc_(alloc) {}
+
+template <typename T, typename Allocator>
+SnapshotVector<T, Allocator>::SnapshotVector(const Vector<T, Allocator>& values)
+    : version_(0), alloc_(values.get_allocator()) {
+  this->current_.store(this->make_version(values));
+}
+
+template <typename T, typename Allocator>
+SnapshotVector<T, Allocator>::SnapshotVector(Vector<T, Allocator>&& values)
+    : version_(0), alloc_(values.get_allocator()) {
+  this->current_.store(this->make_version(std::move(values)));
+}
+
+template <typename T, typename Allocator>
+SnapshotVector<T, Allocator>::SnapshotVector(std::initializer_list<T> list,
+                                             const Allocator& alloc)
+    : SnapshotVector(Vector<T, Allocator>(list, alloc)) {}
+
+// Private helper methods
+
+template <typename T, typename Allocator>
+std::shared_ptr<typename SnapshotVector<T, Allocator>::Chunk>
+SnapshotVector<T, Allocator>::make_chunk() const {
+  auto chunk = std::make_shared<Chunk>(this->alloc_);
+  chunk->reserve(kChunkSize);
+  return chunk;
+}
+
+template <typename T, typename Allocator>
+template <typename Values>
+std::shared_ptr<const typename SnapshotVector<T, Allocator>::Version>
+SnapshotVector<T, Allocator>::make_version(Values&& values) const {
+  auto version = std::make_shared<Version>();
+  version->size = values.size();
+  version->chunks.reserve((values.size() + kChunkSize - 1) >> kChunkLog);
+  for (std::size_t first = 0; first < values.size(); first += kChunkSize) {
+    const std::size_t count = std::min(kChunkSize, values.size() - first);
+    auto chunk = this->make_chunk();
+    if constexpr (std::is_rvalue_reference_v<Values&&>) {
+      chunk->append_range(std::ranges::subrange(std::make_move_iterator(values.data() + first),
+                                                std::make_move_iterator(values.data() + first + count)));
+    } else {
+      chunk->append_range(std::span<const T>(values.data() + first, count));
+    }
+    version->chunks.push_back(std::move(chunk));
+  }
+  return version;
+}
+
+template <typename T, typename Allocator>
+void SnapshotVector<T, Allocator>::publish(std::shared_ptr<const Version> version) {
+  this->current_.store(std::move(version), std::memory_order_release);
+  this->version_.fetch_add(1, std::memory_order_release);
+}
+
+// Readers
+
+template <typename T, typename Allocator>
+typename SnapshotVector<T, Allocator>::Snapshot SnapshotVector<T, Allocator>::snapshot()
+    const noexcept {
+  return Snapshot(this->current_.load(std::memory_order_acquire));
+}
+
+// Writers
+
+template <typename T, typename Allocator>
+typename SnapshotVector<T, Allocator>::Editor SnapshotVector<T, Allocator>::edit() {
+  return Editor(*this);
+}
+
+template <typename T, typename Allocator>
+template <typename Fn>
+void SnapshotVector<T, Allocator>::update(Fn&& fn) {
+  Editor editor = this->edit();
+  std::forward<Fn>(fn)(editor);
+  editor.commit();
+}
+
+template <typename T, typename Allocator>
+void SnapshotVector<T, Allocator>::assign(const Vector<T, Allocator>& values) {
+  auto version = this->make_version(values);
+  std::lock_guard<std::mutex> lock(this->writer_mutex_);
+  this->publish(std::move(version));
+}
+
+template <typename T, typename Allocator>
+void SnapshotVector<T, Allocator>::assign(Vector<T, Allocator>&& values) {
+  auto version = this->make_version(std::move(values));
+  std::lock_guard<std::mutex> lock(this->writer_mutex_);
+  this->publish(std::move(version));
+}
+
+// Snapshot
+
+template <typename T, typename Allocator>
+const T& SnapshotVector<T, Allocator>::Snapshot::at(std::size_t i) const {
+  if (i >= this->size()) {
+    throw std::out_of_range("");
+  }
+  return (*this)[i];
+}
+
+template <typename T, typename Allocator>
+Vector<T, Allocator> SnapshotVector<T, Allocator>::Snapshot::to_vector() const {
+  Vector<T, Allocator> result(this->version_ && !this->version_->chunks.empty()
+                                  ? this->version_->chunks[0]->get_allocator()
+                                  : Allocator());
+  result.reserve(this->size());
+  for (std::size_t c = 0; c < this->chunk_count(); ++c) {
+    result.append_range(this->chunk(c));
+  }
+  return result;
+}
+
+// Editor
+
+template <typename T, typename Allocator>
+SnapshotVector<T, Allocator>::Editor::Editor(SnapshotVector& owner)
+    : owner_(&owner),
+      lock_(owner.writer_mutex_),
+      draft_(*owner.current_.load(std::memory_order_acquire)),
+      owned_(draft_.chunks.size(), false) {}
+
+template <typename T, typename Allocator>
+typename SnapshotVector<T, Allocator>::Chunk& SnapshotVector<T, Allocator>::Editor::writable(
+    std::size_t c) {
+  if (!this->owned_[c]) {
+    const Chunk& shared = *this->draft_.chunks[c];
+    auto copy = this->owner_->make_chunk();
+    copy->append_range(std::span<const T>(shared.data(), shared.size()));
+    this->draft_.chunks[c] = std::move(copy);
+    this->owned_[c] = true;
+  }
+  return *this->draft_.chunks[c];
+}
+
+template <typename T, typename Allocator>
+const T& SnapshotVector<T, Allocator>::Editor::at(std::size_t i) const {
+  if (i >= this->draft_.size) {
+    throw std::out_of_range("");
+  }
+  return (*this)[i];
+}
+
+template <typename T, typename Allocator>
+T& SnapshotVector<T, Allocator>::Editor::at(std::size_t i) {
+  if (i >= this->draft_.size) {
+    throw std::out_of_range("");
+  }
+  return (*this)[i];
+}
+
+template <typename T, typename Allocator>
+void SnapshotVector<T, Allocator>::Editor::push_back(const T& obj) {
+  this->emplace_back(obj);
+}
+
+template <typename T, typename Allocator>
+void SnapshotVector<T, Allocator>::Editor::push_back(T&& obj) {
+  this->emplace_back(std::move(obj));
+}
+
+template <typename T, typename Allocator>
+template <typename... Args>
+T& SnapshotVector<T, Allocator>::Editor::emplace_back(Args&&... args) {
+  const bool fresh = this->draft_.size == this->draft_.chunks.size() << kChunkLog;
+  if (fresh) {
+    this->draft_.chunks.push_back(this->owner_->make_chunk());
+    try {
+      this->owned_.push_back(true);
+    } catch (...) {
+      this->draft_.chunks.pop_back();
+      throw;
+    }
+  }
+  // Chunks never reallocate and a copied chunk's source stays alive in the
+  // published version, so args may refer to any element.
+  try {
+    T& element = this->writable(this->draft_.chunks.size() - 1)
+                     .emplace_back(std::forward<Args>(args)...);
+    ++this->draft_.size;
+    return element;
+  } catch (...) {
+    // pop_back expects every chunk to hold at least one element.
+    if (fresh) {
+      this->draft_.chunks.pop_back();
+      this->owned_.pop_back();
+    }
+    throw;
+  }
+}
+
+template <typename T, typename Allocator>
+void SnapshotVector<T, Allocator>::Editor::pop_back() {
+  if (this->draft_.size == 0) {
+    throw std::out_of_range("Trying to pop from empty SnapshotVector.");
+  }
+  const std::size_t last = this->draft_.chunks.size() - 1;
+  if (this->draft_.chunks[last]->size() == 1) {
+    this->draft_.chunks.pop_back();
+    this->owned_.pop_back();
+  } else {
+    this->writable(last).pop_back();
+  }
+  --this->draft_.size;
+}
+
+template <typename T, typename Allocator>
+void SnapshotVector<T, Allocator>::Editor::resize(std::size_t size, const T& val) {
+  if (size >= this->draft_.size) {
+    while (this->draft_.size < size) {
+      this->emplace_back(val);
+    }
+    return;
+  }
+  const std::size_t chunks = (size + kChunkSize - 1) >> kChunkLog;
+  while (this->draft_.chunks.size() > chunks) {
+    this->draft_.chunks.pop_back();
+    this->owned_.pop_back();
+  }
+  const std::size_t tail = size - ((chunks == 0 ? 0 : chunks - 1) << kChunkLog);
+  if (chunks != 0 && this->draft_.chunks[chunks - 1]->size() != tail) {
+    this->writable(chunks - 1).resize(tail, val);
+  }
+  this->draft_.size = size;
+}
+
+template <typename T, typename Allocator>
+void SnapshotVector<T, Allocator>::Editor::clear() noexcept {
+  this->draft_.chunks.clear();
+  this->owned_.clear();
+  this->draft_.size = 0;
+}
+
+template <typename T, typename Allocator>
+void SnapshotVector<T, Allocator>::Editor::commit() {
+  this->owner_->publish(std::make_shared<const Version>(this->draft_));
+  // Every chunk is now shared with readers.
+  this->owned_.assign(this->owned_.size(), false);
+}
+
+// Reader
+
+template <typename T, typename Allocator>
+SnapshotVector<T, Allocator>::Reader::Reader(const SnapshotVector& source) noexcept
+    : source_(&source), seen_(source.version()), snapshot_(source.snapshot()) {}
+
+template <typename T, typename Allocator>
+const typename SnapshotVector<T, Allocator>::Snapshot&
+SnapshotVector<T, Allocator>::Reader::current() noexcept {
+  const std::uint64_t latest = this->source_->version();
+  if (latest != this->seen_) {
+    // Loaded after the version number, so it is at least that new.
+    this->snapshot_ = this->source_->snapshot();
+    this->seen_ = latest;
+  }
+  return this->snapshot_;
+}
+
+}  // namespace utils
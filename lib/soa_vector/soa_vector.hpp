@@ -0,0 +1,250 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <compare>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <lib/vector/growth_policy.hpp>
+#include <lib/vector/relocate.hpp>
+
+namespace utils {
+
+namespace detail {
+
+template <typename T>
+concept tuple_like = requires { std::tuple_size<std::remove_cvref_t<T>>::value; };
+
+// Binds the N members of an aggregate to a tuple of references, forwarding
+// them as rvalues when record is an rvalue.
+template <std::size_t N, typename Record>
+auto tie_members(Record&& record);
+
+}  // namespace detail
+
+// Structure-of-arrays vector: field I of every element lives in its own
+// contiguous array, reachable as a span through get<I>(), so a pass that
+// reads two fields of a wide record streams only those two arrays. All the
+// arrays share one size and capacity, grow together through GrowthPolicy
+// (sized for std::tuple<Ts...>) and are allocated from Allocator rebound to
+// each field type.
+//
+// Elements are appended from a std::tuple<Ts...>, any other tuple-like
+// type, an aggregate with sizeof...(Ts) members, or one constructor
+// argument per field (emplace_back). Element access returns proxies,
+// std::tuple<Ts&...>, and iterators zip the arrays.
+//
+// Growth cannot roll back fields that were already moved, so every field
+// must be nothrow move constructible or trivially relocatable.
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+class BasicSoAVector {
+  static_assert(sizeof...(Ts) > 0, "SoAVector needs at least one field");
+  static_assert(((std::is_nothrow_move_constructible_v<Ts> ||
+                  is_trivially_relocatable_v<Ts>) && ...),
+                "SoAVector fields must be relocatable without throwing");
+  static_assert(growth_policy_for<GrowthPolicy, std::tuple<Ts...>>,
+                "GrowthPolicy must provide next_capacity<T>(capacity, required, max_size)");
+
+  template <bool Const>
+  class BasicIterator;
+
+ public:
+  using value_type = std::tuple<Ts...>;
+  using reference = std::tuple<Ts&...>;
+  using const_reference = std::tuple<const Ts&...>;
+  using allocator_type = Allocator;
+  using alloc_traits = std::allocator_traits<Allocator>;
+  using growth_policy = GrowthPolicy;
+  using iterator = BasicIterator<false>;
+  using const_iterator = BasicIterator<true>;
+
+  static constexpr std::size_t kFields = sizeof...(Ts);
+  template <std::size_t I>
+  using field_type = std::tuple_element_t<I, value_type>;
+  template <std::size_t I>
+  using field_allocator = typename alloc_traits::template rebind_alloc<field_type<I>>;
+
+  // Constructors / Destructor
+  BasicSoAVector(const Allocator& alloc = Allocator());
+  BasicSoAVector(const BasicSoAVector& obj);
+  BasicSoAVector(BasicSoAVector&& other) noexcept;
+  BasicSoAVector& operator=(const BasicSoAVector& obj);
+  BasicSoAVector& operator=(BasicSoAVector&& other) noexcept(
+      alloc_traits::propagate_on_container_move_assignment::value ||
+      alloc_traits::is_always_equal::value);
+  ~BasicSoAVector();
+
+  const Allocator& get_allocator() const noexcept { return alloc_; }
+
+  // Iterators:
+  iterator begin() noexcept { return iterator(data_, 0); }
+  const_iterator begin() const noexcept { return const_iterator(data_, 0); }
+  iterator end() noexcept { return iterator(data_, size_); }
+  const_iterator end() const noexcept { return const_iterator(data_, size_); }
+  const_iterator cbegin() const noexcept { return begin(); }
+  const_iterator cend() const noexcept { return end(); }
+
+  // Capacity:
+  std::size_t size() const noexcept { return size_; }
+  std::size_t max_size() const noexcept;
+  std::size_t capacity() const noexcept { return capacity_; }
+  bool empty() const noexcept { return size_ == 0; }
+  void reserve(std::size_t malloc);
+  void shrink_to_fit();
+
+  // Field arrays:
+  template <std::size_t I>
+  std::span<field_type<I>> get() noexcept {
+    return {std::get<I>(data_), size_};
+  }
+  template <std::size_t I>
+  std::span<const field_type<I>> get() const noexcept {
+    return {std::get<I>(data_), size_};
+  }
+  template <std::size_t I>
+  field_type<I>* data() noexcept {
+    return std::get<I>(data_);
+  }
+  template <std::size_t I>
+  const field_type<I>* data() const noexcept {
+    return std::get<I>(data_);
+  }
+
+  // Element access:
+  reference operator[](std::size_t i) noexcept { return row(data_, i); }
+  const_reference operator[](std::size_t i) const noexcept { return row(data_, i); }
+  reference at(std::size_t i);
+  const_reference at(std::size_t i) const;
+  reference front() noexcept { return (*this)[0]; }
+  const_reference front() const noexcept { return (*this)[0]; }
+  reference back() noexcept { return (*this)[size_ - 1]; }
+  const_reference back() const noexcept { return (*this)[size_ - 1]; }
+
+  // Modifiers:
+  // Takes a tuple-like value or an aggregate with kFields members.
+  template <typename Record>
+  void push_back(Record&& record);
+  // One constructor argument per field.
+  template <typename... Args>
+    requires(sizeof...(Args) == sizeof...(Ts))
+  reference emplace_back(Args&&... args);
+  void pop_back();
+  void resize(std::size_t size);
+  void clear() noexcept;
+  void swap(BasicSoAVector& obj) noexcept;
+
+ private:
+  using Pointers = std::tuple<Ts*...>;
+  using Indices = std::index_sequence_for<Ts...>;
+
+  template <typename Tuple, std::size_t... I>
+  static auto row(const Tuple& data, std::size_t i, std::index_sequence<I...>) noexcept {
+    return std::tuple<decltype(*std::get<I>(data))...>(std::get<I>(data)[i]...);
+  }
+  template <typename Tuple>
+  static auto row(const Tuple& data, std::size_t i) noexcept {
+    return row(data, i, Indices{});
+  }
+
+  template <std::size_t I>
+  field_allocator<I> allocator_for() const noexcept {
+    return field_allocator<I>(this->alloc_);
+  }
+  // Allocates every field array or none.
+  Pointers allocate(std::size_t count);
+  void deallocate(const Pointers& data, std::size_t count) noexcept;
+  template <std::size_t I, typename Arg>
+  void construct_field(field_type<I>* p, Arg&& arg);
+  // Builds row `at` of data from one argument per field; all or nothing.
+  template <typename... Args>
+  void construct_row(const Pointers& data, std::size_t at, Args&&... args);
+  void destroy_rows(std::size_t first, std::size_t last) noexcept;
+  void reallocate(std::size_t new_cap);
+  template <typename... Args>
+  void realloc_append(Args&&... args);
+  template <typename Source>
+  void assign_from(Source&& obj);
+
+  std::size_t size_;
+  Pointers data_;
+  std::size_t capacity_;
+  Allocator alloc_;
+};
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+template <bool Const>
+class BasicSoAVector<Allocator, GrowthPolicy, Ts...>::BasicIterator {
+ public:
+  using iterator_category = std::random_access_iterator_tag;
+  using value_type = std::tuple<Ts...>;
+  using difference_type = std::ptrdiff_t;
+  using reference = std::conditional_t<Const, std::tuple<const Ts&...>, std::tuple<Ts&...>>;
+  using pointer = void;
+
+  BasicIterator() noexcept = default;
+  BasicIterator(const Pointers& data, std::size_t index) noexcept : data_(data), index_(index) {}
+  // iterator converts to const_iterator.
+  template <bool OtherConst>
+    requires(Const && !OtherConst)
+  BasicIterator(const BasicIterator<OtherConst>& other) noexcept
+      : data_(other.data_), index_(other.index_) {}
+
+  reference operator*() const noexcept { return reference(BasicSoAVector::row(data_, index_)); }
+  reference operator[](difference_type n) const noexcept { return *(*this + n); }
+
+  BasicIterator& operator++() noexcept {
+    ++index_;
+    return *this;
+  }
+  BasicIterator operator++(int) noexcept { return BasicIterator(data_, index_++); }
+  BasicIterator& operator--() noexcept {
+    --index_;
+    return *this;
+  }
+  BasicIterator operator--(int) noexcept { return BasicIterator(data_, index_--); }
+  BasicIterator& operator+=(difference_type n) noexcept {
+    index_ += static_cast<std::size_t>(n);
+    return *this;
+  }
+  BasicIterator& operator-=(difference_type n) noexcept {
+    index_ -= static_cast<std::size_t>(n);
+    return *this;
+  }
+  BasicIterator operator+(difference_type n) const noexcept {
+    return BasicIterator(data_, index_ + static_cast<std::size_t>(n));
+  }
+  friend BasicIterator operator+(difference_type n, const BasicIterator& it) noexcept {
+    return it + n;
+  }
+  BasicIterator operator-(difference_type n) const noexcept {
+    return BasicIterator(data_, index_ - static_cast<std::size_t>(n));
+  }
+  difference_type operator-(const BasicIterator& other) const noexcept {
+    return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+  }
+
+  bool operator==(const BasicIterator& other) const noexcept { return index_ == other.index_; }
+  std::strong_ordering operator<=>(const BasicIterator& other) const noexcept {
+    return index_ <=> other.index_;
+  }
+
+ private:
+  template <bool>
+  friend class BasicIterator;
+
+  Pointers data_{};
+  std::size_t index_ = 0;
+};
+
+template <typename... Ts>
+using SoAVector = BasicSoAVector<std::allocator<std::tuple<Ts...>>, DefaultGrowth, Ts...>;
+
+}  // namespace utils
+
+#include "soa_vector.tpp"
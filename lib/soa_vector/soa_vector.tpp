@@ -0,0 +1,409 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "soa_vector.hpp"
+
+namespace utils {
+
+namespace detail {
+
+template <std::size_t N, typename Record>
+auto tie_members(Record&& record) {
+  static_assert(std::is_aggregate_v<std::remove_cvref_t<Record>>,
+                "push_back takes a tuple-like value or an aggregate");
+  static_assert(N <= 12, "aggregates with more than 12 members are not supported");
+  // Structured bindings name lvalues; members of an rvalue record are moved.
+  auto pass = [](auto& member) -> decltype(auto) {
+    if constexpr (std::is_lvalue_reference_v<Record>) {
+      return (member);
+    } else {
+      return std::move(member);
+    }
+  };
+  auto&& r = record;
+  if constexpr (N == 1) {
+    auto&& [a] = r;
+    return std::forward_as_tuple(pass(a));
+  } else if constexpr (N == 2) {
+    auto&& [a, b] = r;
+    return std::forward_as_tuple(pass(a), pass(b));
+  } else if constexpr (N == 3) {
+    auto&& [a, b, c] = r;
+    return std::forward_as_tuple(pass(a), pass(b), pass(c));
+  } else if constexpr (N == 4) {
+    auto&& [a, b, c, d] = r;
+    return std::forward_as_tuple(pass(a), pass(b), pass(c), pass(d));
+  } else if constexpr (N == 5) {
+    auto&& [a, b, c, d, e] = r;
+    return std::forward_as_tuple(pass(a), pass(b), pass(c), pass(d), pass(e));
+  } else if constexpr (N == 6) {
+    auto&& [a, b, c, d, e, f] = r;
+    return std::forward_as_tuple(pass(a), pass(b), pass(c), pass(d), pass(e), pass(f));
+  } else if constexpr (N == 7) {
+    auto&& [a, b, c, d, e, f, g] = r;
+    return std::forward_as_tuple(pass(a), pass(b), pass(c), pass(d), pass(e), pass(f),
+                                 pass(g));
+  } else if constexpr (N == 8) {
+    auto&& [a, b, c, d, e, f, g, h] = r;
+    return std::forward_as_tuple(pass(a), pass(b), pass(c), pass(d), pass(e), pass(f),
+                                 pass(g), pass(h));
+  } else if constexpr (N == 9) {
+    auto&& [a, b, c, d, e, f, g, h, i] = r;
+    return std::forward_as_tuple(pass(a), pass(b), pass(c), pass(d), pass(e), pass(f),
+                                 pass(g), pass(h), pass(i));
+  } else if constexpr (N == 10) {
+    auto&& [a, b, c, d, e, f, g, h, i, j] = r;
+    return std::forward_as_tuple(pass(a), pass(b), pass(c), pass(d), pass(e), pass(f),
+                                 pass(g), pass(h), pass(i), pass(j));
+  } else if constexpr (N == 11) {
+    auto&& [a, b, c, d, e, f, g, h, i, j, k] = r;
+    return std::forward_as_tuple(pass(a), pass(b), pass(c), pass(d), pass(e), pass(f),
+                                 pass(g), pass(h), pass(i), pass(j), pass(k));
+  } else {
+    auto&& [a, b, c, d, e, f, g, h, i, j, k, l] = r;
+    return std::forward_as_tuple(pass(a), pass(b), pass(c), pass(d), pass(e), pass(f),
+                                 pass(g), pass(h), pass(i), pass(j), pass(k), pass(l));
+  }
+}
+
+// Calls fn.template operator()<I>() for I = 0 .. N-1, in order.
+template <std::size_t N, typename Fn>
+void for_each_index(Fn&& fn) {
+  [&]<std::size_t... I>(std::index_sequence<I...>) {
+    (fn.template operator()<I>(), ...);
+  }(std::make_index_sequence<N>{});
+}
+
+}  // namespace detail
+
+// Constructors / Destructor
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+BasicSoAVector<Allocator, GrowthPolicy, Ts...>::BasicSoAVector(const Allocator& alloc)
+    : size_(0), data_{}, capacity_(0), alloc_(alloc) {}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+BasicSoAVector<Allocator, GrowthPolicy, Ts...>::BasicSoAVector(const BasicSoAVector& obj)
+    : BasicSoAVector(alloc_traits::select_on_container_copy_construction(obj.alloc_)) {
+  // The delegated constructor has finished, so the destructor cleans up if a
+  // copy throws.
+  this->assign_from(obj);
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+BasicSoAVector<Allocator, GrowthPolicy, Ts...>::BasicSoAVector(BasicSoAVector&& other) noexcept
+    : size_(std::exchange(other.size_, 0)),
+      data_(std::exchange(other.data_, Pointers{})),
+      capacity_(std::exchange(other.capacity_, 0)),
+      alloc_(std::move(other.alloc_)) {}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+BasicSoAVector<Allocator, GrowthPolicy, Ts...>&
+BasicSoAVector<Allocator, GrowthPolicy, Ts...>::operator=(const BasicSoAVector& obj) {
+  if (this != &obj) {
+    this->clear();
+    if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+      if (this->alloc_ != obj.alloc_) {
+        this->deallocate(this->data_, this->capacity_);
+        this->data_ = Pointers{};
+        this->capacity_ = 0;
+      }
+      this->alloc_ = obj.alloc_;
+    }
+    this->assign_from(obj);
+  }
+  return *this;
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+BasicSoAVector<Allocator, GrowthPolicy, Ts...>&
+BasicSoAVector<Allocator, GrowthPolicy, Ts...>::operator=(BasicSoAVector&& other) noexcept(
+    alloc_traits::propagate_on_container_move_assignment::value ||
+    alloc_traits::is_always_equal::value) {
+  if (this == &other) {
+    return *this;
+  }
+  this->clear();
+  if (alloc_traits::propagate_on_container_move_assignment::value ||
+      this->alloc_ == other.alloc_) {
+    this->deallocate(this->data_, this->capacity_);
+    if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
+      this->alloc_ = std::move(other.alloc_);
+    }
+    this->size_ = std::exchange(other.size_, 0);
+    this->data_ = std::exchange(other.data_, Pointers{});
+    this->capacity_ = std::exchange(other.capacity_, 0);
+  } else {
+    this->assign_from(std::move(other));
+    other.clear();
+  }
+  return *this;
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+BasicSoAVector<Allocator, GrowthPolicy, Ts...>::~BasicSoAVector() {
+  this->clear();
+  this->deallocate(this->data_, this->capacity_);
+}
+
+// Capacity
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+std::size_t BasicSoAVector<Allocator, GrowthPolicy, Ts...>::max_size() const noexcept {
+  std::size_t result = std::numeric_limits<std::size_t>::max();
+  detail::for_each_index<kFields>([&]<std::size_t I>() {
+    result = std::min(result, std::allocator_traits<field_allocator<I>>::max_size(
+                                  this->template allocator_for<I>()));
+  });
+  return result;
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+void BasicSoAVector<Allocator, GrowthPolicy, Ts...>::reserve(std::size_t malloc) {
+  if (malloc <= this->capacity_) {
+    return;
+  }
+  if (malloc > max_size()) {
+    throw std::length_error("SoAVector size exceeds max_size()");
+  }
+  this->reallocate(malloc);
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+void BasicSoAVector<Allocator, GrowthPolicy, Ts...>::shrink_to_fit() {
+  if (this->size_ == this->capacity_) {
+    return;
+  }
+  if (this->size_ == 0) {
+    this->deallocate(this->data_, this->capacity_);
+    this->data_ = Pointers{};
+    this->capacity_ = 0;
+    return;
+  }
+  this->reallocate(this->size_);
+}
+
+// Element access
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+typename BasicSoAVector<Allocator, GrowthPolicy, Ts...>::reference
+BasicSoAVector<Allocator, GrowthPolicy, Ts...>::at(std::size_t i) {
+  if (i >= this->size_) {
+    throw std::out_of_range("");
+  }
+  return (*this)[i];
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+typename BasicSoAVector<Allocator, GrowthPolicy, Ts...>::const_reference
+BasicSoAVector<Allocator, GrowthPolicy, Ts...>::at(std::size_t i) const {
+  if (i >= this->size_) {
+    throw std::out_of_range("");
+  }
+  return (*this)[i];
+}
+
+// Storage
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+typename BasicSoAVector<Allocator, GrowthPolicy, Ts...>::Pointers
+BasicSoAVector<Allocator, GrowthPolicy, Ts...>::allocate(std::size_t count) {
+  Pointers result{};
+  try {
+    detail::for_each_index<kFields>([&]<std::size_t I>() {
+      auto alloc = this->template allocator_for<I>();
+      std::get<I>(result) = std::allocator_traits<field_allocator<I>>::allocate(alloc, count);
+    });
+  } catch (...) {
+    this->deallocate(result, count);
+    throw;
+  }
+  return result;
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+void BasicSoAVector<Allocator, GrowthPolicy, Ts...>::deallocate(const Pointers& data,
+                                                                std::size_t count) noexcept {
+  detail::for_each_index<kFields>([&]<std::size_t I>() {
+    if (std::get<I>(data)) {
+      auto alloc = this->template allocator_for<I>();
+      std::allocator_traits<field_allocator<I>>::deallocate(alloc, std::get<I>(data), count);
+    }
+  });
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+template <std::size_t I, typename Arg>
+void BasicSoAVector<Allocator, GrowthPolicy, Ts...>::construct_field(field_type<I>* p,
+                                                                     Arg&& arg) {
+  auto alloc = this->template allocator_for<I>();
+  std::allocator_traits<field_allocator<I>>::construct(alloc, p, std::forward<Arg>(arg));
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+template <typename... Args>
+void BasicSoAVector<Allocator, GrowthPolicy, Ts...>::construct_row(const Pointers& data,
+                                                                   std::size_t at,
+                                                                   Args&&... args) {
+  std::size_t built = 0;
+  try {
+    [&]<std::size_t... I>(std::index_sequence<I...>) {
+      ((this->template construct_field<I>(std::get<I>(data) + at, std::forward<Args>(args)),
+        ++built),
+       ...);
+    }(Indices{});
+  } catch (...) {
+    detail::for_each_index<kFields>([&]<std::size_t I>() {
+      if (I < built) {
+        auto alloc = this->template allocator_for<I>();
+        std::allocator_traits<field_allocator<I>>::destroy(alloc, std::get<I>(data) + at);
+      }
+    });
+    throw;
+  }
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+void BasicSoAVector<Allocator, GrowthPolicy, Ts...>::destroy_rows(std::size_t first,
+                                                                  std::size_t last) noexcept {
+  detail::for_each_index<kFields>([&]<std::size_t I>() {
+    auto alloc = this->template allocator_for<I>();
+    detail::destroy_n(alloc, std::get<I>(this->data_) + first, last - first);
+  });
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+void BasicSoAVector<Allocator, GrowthPolicy, Ts...>::reallocate(std::size_t new_cap) {
+  Pointers fresh = this->allocate(new_cap);
+  // Cannot throw: fields are nothrow movable or copied bytewise.
+  detail::for_each_index<kFields>([&]<std::size_t I>() {
+    auto alloc = this->template allocator_for<I>();
+    detail::relocate(alloc, std::get<I>(this->data_), this->size_, std::get<I>(fresh));
+  });
+  this->deallocate(this->data_, this->capacity_);
+  this->data_ = fresh;
+  this->capacity_ = new_cap;
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+template <typename... Args>
+void BasicSoAVector<Allocator, GrowthPolicy, Ts...>::realloc_append(Args&&... args) {
+  if (this->size_ == max_size()) {
+    throw std::length_error("SoAVector size exceeds max_size()");
+  }
+  const std::size_t new_cap = GrowthPolicy::template next_capacity<value_type>(
+      this->capacity_, this->size_ + 1, max_size());
+  Pointers fresh = this->allocate(new_cap);
+  // The new row is built before the old ones move, since args may refer to
+  // them.
+  try {
+    this->construct_row(fresh, this->size_, std::forward<Args>(args)...);
+  } catch (...) {
+    this->deallocate(fresh, new_cap);
+    throw;
+  }
+  detail::for_each_index<kFields>([&]<std::size_t I>() {
+    auto alloc = this->template allocator_for<I>();
+    detail::relocate(alloc, std::get<I>(this->data_), this->size_, std::get<I>(fresh));
+  });
+  this->deallocate(this->data_, this->capacity_);
+  this->data_ = fresh;
+  this->capacity_ = new_cap;
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+template <typename Source>
+void BasicSoAVector<Allocator, GrowthPolicy, Ts...>::assign_from(Source&& obj) {
+  this->reserve(obj.size_);
+  for (std::size_t i = 0; i < obj.size_; ++i) {
+    std::apply(
+        [&](auto&... fields) {
+          if constexpr (std::is_rvalue_reference_v<Source&&>) {
+            this->construct_row(this->data_, i, std::move(fields)...);
+          } else {
+            this->construct_row(this->data_, i, fields...);
+          }
+        },
+        row(obj.data_, i));
+    ++this->size_;
+  }
+}
+
+// Modifiers
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+template <typename Record>
+void BasicSoAVector<Allocator, GrowthPolicy, Ts...>::push_back(Record&& record) {
+  auto emplace = [this](auto&&... fields) {
+    this->emplace_back(std::forward<decltype(fields)>(fields)...);
+  };
+  if constexpr (detail::tuple_like<Record>) {
+    std::apply(emplace, std::forward<Record>(record));
+  } else {
+    std::apply(emplace, detail::tie_members<kFields>(std::forward<Record>(record)));
+  }
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+template <typename... Args>
+  requires(sizeof...(Args) == sizeof...(Ts))
+typename BasicSoAVector<Allocator, GrowthPolicy, Ts...>::reference
+BasicSoAVector<Allocator, GrowthPolicy, Ts...>::emplace_back(Args&&... args) {
+  if (this->size_ == this->capacity_) {
+    this->realloc_append(std::forward<Args>(args)...);
+  } else {
+    this->construct_row(this->data_, this->size_, std::forward<Args>(args)...);
+  }
+  ++this->size_;
+  return (*this)[this->size_ - 1];
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+void BasicSoAVector<Allocator, GrowthPolicy, Ts...>::pop_back() {
+  if (this->size_ == 0) {
+    throw std::out_of_range("Trying to pop from empty SoAVector.");
+  }
+  this->destroy_rows(this->size_ - 1, this->size_);
+  --this->size_;
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+void BasicSoAVector<Allocator, GrowthPolicy, Ts...>::resize(std::size_t size) {
+  if (size <= this->size_) {
+    this->destroy_rows(size, this->size_);
+    this->size_ = size;
+    return;
+  }
+  this->reserve(size);
+  while (this->size_ < size) {
+    this->construct_row(this->data_, this->size_, Ts()...);
+    ++this->size_;
+  }
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+void BasicSoAVector<Allocator, GrowthPolicy, Ts...>::clear() noexcept {
+  this->destroy_rows(0, this->size_);
+  this->size_ = 0;
+}
+
+template <typename Allocator, typename GrowthPolicy, typename... Ts>
+void BasicSoAVector<Allocator, GrowthPolicy, Ts...>::swap(BasicSoAVector& obj) noexcept {
+  using std::swap;
+  swap(this->size_, obj.size_);
+  swap(this->data_, obj.data_);
+  swap(this->capacity_, obj.capacity_);
+  if constexpr (alloc_traits::propagate_on_container_swap::value) {
+    swap(this->alloc_, obj.alloc_);
+  }
+}
+
+}  // namespace utils
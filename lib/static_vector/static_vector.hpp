@@ -0,0 +1,179 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+#include <lib/vector/relocate.hpp>
+#include <lib/vector/vector.hpp>
+
+namespace utils {
+
+namespace detail {
+
+// Element storage for StaticVector. Trivial element types live in a plain
+// array, which is what lets a filled StaticVector leave constant evaluation
+// as a constexpr table; the slots past size() are zeroed only when built at
+// compile time. Other types get a union so that each slot's lifetime starts
+// and ends with the element in it.
+template <typename T, std::size_t N,
+          bool = std::is_trivially_default_constructible_v<T> &&
+                 std::is_trivially_destructible_v<T>>
+struct StaticStorage {
+  constexpr StaticStorage() noexcept {
+    if consteval {
+      for (T& slot : data) {
+        std::construct_at(std::addressof(slot));
+      }
+    }
+  }
+
+  T data[N];
+};
+
+template <typename T, std::size_t N>
+struct StaticStorage<T, N, false> {
+  constexpr StaticStorage() noexcept {}
+  constexpr ~StaticStorage() {}
+
+  union {
+    T data[N];
+  };
+};
+
+}  // namespace detail
+
+// Vector with a fixed capacity of N elements stored inside the object. It
+// never allocates, so it can be filled during constant evaluation and kept
+// as a constexpr or static table:
+//
+//   constexpr auto kSquares = [] {
+//     utils::StaticVector<int, 16> v;
+//     for (int i = 0; i < 16; ++i) v.push_back(i * i);
+//     return v;
+//   }();
+//
+// The interface follows Vector, and elements are shifted by the same
+// relocate.hpp helpers, driven through a local std::allocator<T>. Growing
+// past N throws std::length_error and leaves the vector unchanged; reserve()
+// and shrink_to_fit() only check the capacity.
+template <typename T, std::size_t N>
+class StaticVector {
+  static_assert(N > 0, "StaticVector needs room for at least one element");
+
+ public:
+  using value_type = T;
+  using Iterator = typename Vector<T>::Iterator;
+  using ConstIterator = typename Vector<T>::ConstIterator;
+  using ReverseIterator = std::reverse_iterator<Iterator>;
+  using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+  // Standard container names.
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+  using reverse_iterator = ReverseIterator;
+  using const_reverse_iterator = ConstReverseIterator;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+
+  static constexpr std::size_t static_capacity = N;
+
+  // Constructors / Destructor
+  constexpr StaticVector() noexcept;
+  constexpr explicit StaticVector(std::size_t size, const T& val);
+  constexpr StaticVector(const std::initializer_list<T>& list);
+  template <std::input_iterator InputIterator>
+  constexpr StaticVector(InputIterator first, InputIterator last);
+  constexpr StaticVector(const StaticVector& obj);
+  constexpr StaticVector(StaticVector&& other) noexcept(std::is_nothrow_move_constructible_v<T>);
+  constexpr StaticVector& operator=(const StaticVector& obj);
+  constexpr StaticVector& operator=(StaticVector&& other)
+      noexcept(std::is_nothrow_move_constructible_v<T>);
+  constexpr StaticVector& operator=(const std::initializer_list<T>& list);
+  constexpr ~StaticVector()
+    requires std::is_trivially_destructible_v<T>
+  = default;
+  constexpr ~StaticVector();
+
+  // Iterators:
+  constexpr Iterator begin();
+  constexpr ConstIterator begin() const;
+  constexpr Iterator end();
+  constexpr ConstIterator end() const;
+  constexpr ConstIterator cbegin() const;
+  constexpr ConstIterator cend() const;
+  constexpr ReverseIterator rbegin() { return ReverseIterator(end()); }
+  constexpr ConstReverseIterator rbegin() const { return ConstReverseIterator(end()); }
+  constexpr ReverseIterator rend() { return ReverseIterator(begin()); }
+  constexpr ConstReverseIterator rend() const { return ConstReverseIterator(begin()); }
+  constexpr ConstReverseIterator crbegin() const { return rbegin(); }
+  constexpr ConstReverseIterator crend() const { return rend(); }
+  // Capacity:
+  constexpr std::size_t size() const;
+  constexpr std::size_t max_size() const;
+  constexpr void resize(std::size_t size, const T& val = T());
+  constexpr std::size_t capacity() const;
+  constexpr bool empty() const;
+  constexpr bool full() const noexcept { return size_ == N; }
+  constexpr void reserve(std::size_t malloc);
+  constexpr void shrink_to_fit() noexcept {}
+  // Element access:
+  constexpr T& operator[](std::size_t i);
+  constexpr const T& operator[](std::size_t i) const;
+  constexpr T& at(std::size_t n);
+  constexpr const T& at(std::size_t n) const;
+  constexpr T& front();
+  constexpr const T& front() const;
+  constexpr T& back();
+  constexpr const T& back() const;
+  constexpr T* data();
+  constexpr const T* data() const;
+  // Modifiers:
+  template <std::input_iterator InputIterator>
+  constexpr void assign(InputIterator first, InputIterator last);
+  constexpr void assign(std::size_t size, const T& val);
+  constexpr void clear() noexcept;
+  constexpr void push_back(const T& obj);
+  constexpr void push_back(T&& obj);
+  template <typename... Args>
+  constexpr T& emplace_back(Args&&... args);
+  constexpr void pop_back();
+  constexpr Iterator erase(ConstIterator position);
+  constexpr Iterator insert(ConstIterator position, const T& val);
+  constexpr Iterator insert(ConstIterator position, T&& val);
+  constexpr Iterator insert(ConstIterator position, std::size_t count, const T& val);
+  template <std::input_iterator InputIterator>
+  constexpr Iterator insert(ConstIterator position, InputIterator first, InputIterator last);
+  constexpr Iterator insert(ConstIterator position, std::initializer_list<T> list);
+  template <std::ranges::input_range Range>
+  constexpr Iterator insert_range(ConstIterator position, Range&& range);
+  template <std::ranges::input_range Range>
+  constexpr void append_range(Range&& range);
+  template <typename... Args>
+  constexpr Iterator emplace(ConstIterator position, Args&&... args);
+
+  constexpr void swap(StaticVector& obj) noexcept(std::is_nothrow_move_constructible_v<T> &&
+                                                  std::is_nothrow_swappable_v<T>);
+
+ private:
+  // Throws unless count more elements fit.
+  constexpr void check_room(std::size_t count) const;
+  template <std::forward_iterator ForwardIterator>
+  constexpr Iterator insert_forward(std::size_t pos, ForwardIterator first, std::size_t count);
+
+  std::size_t size_;
+  detail::StaticStorage<T, N> storage_;
+};
+
+}  // namespace utils
+
+#include "static_vector.tpp"
@@ -0,0 +1,384 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <ranges>
+#include <stdexcept>
+#include <utility>
+
+#include "static_vector.hpp"
+
+namespace utils {
+
+// Constructors / Destructor
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::StaticVector() noexcept : size_(0) {}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::StaticVector(std::size_t size, const T& val) : StaticVector() {
+  insert(end(), size, val);
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::StaticVector(const std::initializer_list<T>& list)
+    : StaticVector() {
+  insert_forward(0, list.begin(), list.size());
+}
+
+template <typename T, std::size_t N>
+template <std::input_iterator InputIterator>
+constexpr StaticVector<T, N>::StaticVector(InputIterator first, InputIterator last)
+    : StaticVector() {
+  insert(end(), first, last);
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::StaticVector(const StaticVector& obj) : StaticVector() {
+  insert_forward(0, obj.data(), obj.size_);
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::StaticVector(StaticVector&& other) noexcept(
+    std::is_nothrow_move_constructible_v<T>)
+    : StaticVector() {
+  std::allocator<T> alloc;
+  detail::relocate(alloc, other.data(), other.size_, data());
+  this->size_ = other.size_;
+  other.size_ = 0;
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>& StaticVector<T, N>::operator=(const StaticVector& obj) {
+  if (this != &obj) {
+    assign(obj.data(), obj.data() + obj.size_);
+  }
+  return *this;
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>& StaticVector<T, N>::operator=(StaticVector&& other) noexcept(
+    std::is_nothrow_move_constructible_v<T>) {
+  if (this != &other) {
+    clear();
+    std::allocator<T> alloc;
+    detail::relocate(alloc, other.data(), other.size_, data());
+    this->size_ = other.size_;
+    other.size_ = 0;
+  }
+  return *this;
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>& StaticVector<T, N>::operator=(const std::initializer_list<T>& list) {
+  assign(list.begin(), list.end());
+  return *this;
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::~StaticVector() {
+  clear();
+}
+
+// Private helper methods
+
+template <typename T, std::size_t N>
+constexpr void StaticVector<T, N>::check_room(std::size_t count) const {
+  if (count > N - this->size_) {
+    throw std::length_error("StaticVector capacity exceeded");
+  }
+}
+
+template <typename T, std::size_t N>
+template <std::forward_iterator ForwardIterator>
+constexpr StaticVector<T, N>::Iterator StaticVector<T, N>::insert_forward(std::size_t pos, ForwardIterator first, std::size_t count) {
+  check_room(count);
+  if (count != 0) {
+    std::allocator<T> alloc;
+    detail::insert_in_place(alloc, data(), this->size_, pos, first, count);
+  }
+  return Iterator(data() + pos);
+}
+
+// Iterators:
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::Iterator StaticVector<T, N>::begin() {
+  return Iterator(data());
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::ConstIterator StaticVector<T, N>::begin() const {
+  return ConstIterator(data());
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::Iterator StaticVector<T, N>::end() {
+  return Iterator(data() + this->size_);
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::ConstIterator StaticVector<T, N>::end() const {
+  return ConstIterator(data() + this->size_);
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::ConstIterator StaticVector<T, N>::cbegin() const {
+  return begin();
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::ConstIterator StaticVector<T, N>::cend() const {
+  return end();
+}
+
+// Capacity:
+
+template <typename T, std::size_t N>
+constexpr std::size_t StaticVector<T, N>::size() const {
+  return this->size_;
+}
+
+template <typename T, std::size_t N>
+constexpr std::size_t StaticVector<T, N>::max_size() const {
+  return N;
+}
+
+template <typename T, std::size_t N>
+constexpr void StaticVector<T, N>::resize(std::size_t size, const T& val) {
+  if (size < this->size_) {
+    std::allocator<T> alloc;
+    detail::destroy_n(alloc, data() + size, this->size_ - size);
+    this->size_ = size;
+  } else if (size > this->size_) {
+    insert(end(), size - this->size_, val);
+  }
+}
+
+template <typename T, std::size_t N>
+constexpr std::size_t StaticVector<T, N>::capacity() const {
+  return N;
+}
+
+template <typename T, std::size_t N>
+constexpr bool StaticVector<T, N>::empty() const {
+  return (this->size_ == 0);
+}
+
+template <typename T, std::size_t N>
+constexpr void StaticVector<T, N>::reserve(std::size_t malloc) {
+  if (malloc > N) {
+    throw std::length_error("StaticVector capacity exceeded");
+  }
+}
+
+// Element access:
+
+template <typename T, std::size_t N>
+constexpr T& StaticVector<T, N>::operator[](std::size_t i) {
+  return data()[i];
+}
+
+template <typename T, std::size_t N>
+constexpr const T& StaticVector<T, N>::operator[](std::size_t i) const {
+  return data()[i];
+}
+
+template <typename T, std::size_t N>
+constexpr T& StaticVector<T, N>::at(std::size_t i) {
+  if (i >= this->size_) {
+    throw std::out_of_range("");
+  }
+  return data()[i];
+}
+
+template <typename T, std::size_t N>
+constexpr const T& StaticVector<T, N>::at(std::size_t i) const {
+  if (i >= this->size_) {
+    throw std::out_of_range("");
+  }
+  return data()[i];
+}
+
+template <typename T, std::size_t N>
+constexpr T& StaticVector<T, N>::front() {
+  return data()[0];
+}
+
+template <typename T, std::size_t N>
+constexpr const T& StaticVector<T, N>::front() const {
+  return data()[0];
+}
+
+template <typename T, std::size_t N>
+constexpr T& StaticVector<T, N>::back() {
+  return data()[this->size_ - 1];
+}
+
+template <typename T, std::size_t N>
+constexpr const T& StaticVector<T, N>::back() const {
+  return data()[this->size_ - 1];
+}
+
+template <typename T, std::size_t N>
+constexpr T* StaticVector<T, N>::data() {
+  return this->storage_.data;
+}
+
+template <typename T, std::size_t N>
+constexpr const T* StaticVector<T, N>::data() const {
+  return this->storage_.data;
+}
+
+// Modifiers:
+
+template <typename T, std::size_t N>
+template <std::input_iterator InputIterator>
+constexpr void StaticVector<T, N>::assign(InputIterator first, InputIterator last) {
+  StaticVector tmp(first, last);
+  *this = std::move(tmp);
+}
+
+template <typename T, std::size_t N>
+constexpr void StaticVector<T, N>::assign(std::size_t size, const T& val) {
+  StaticVector tmp(size, val);
+  *this = std::move(tmp);
+}
+
+template <typename T, std::size_t N>
+constexpr void StaticVector<T, N>::clear() noexcept {
+  std::allocator<T> alloc;
+  detail::destroy_n(alloc, data(), this->size_);
+  this->size_ = 0;
+}
+
+template <typename T, std::size_t N>
+constexpr void StaticVector<T, N>::push_back(const T& obj) {
+  emplace_back(obj);
+}
+
+template <typename T, std::size_t N>
+constexpr void StaticVector<T, N>::push_back(T&& obj) {
+  emplace_back(std::move(obj));
+}
+
+template <typename T, std::size_t N>
+template <typename... Args>
+constexpr T& StaticVector<T, N>::emplace_back(Args&&... args) {
+  check_room(1);
+  T* slot = data() + this->size_;
+  std::construct_at(slot, std::forward<Args>(args)...);
+  ++this->size_;
+  return *slot;
+}
+
+template <typename T, std::size_t N>
+constexpr void StaticVector<T, N>::pop_back() {
+  if (this->size_ == 0) {
+    throw std::out_of_range("Trying to pop from empty StaticVector.");
+  }
+  --this->size_;
+  std::destroy_at(data() + this->size_);
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::Iterator StaticVector<T, N>::erase(ConstIterator position) {
+  const std::size_t index = position - cbegin();
+  if (index >= this->size_) {
+    throw std::out_of_range("Iterator out of range");
+  }
+  std::allocator<T> alloc;
+  detail::erase_in_place(alloc, data(), this->size_, index, 1);
+
+  return Iterator(data() + index);
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::Iterator StaticVector<T, N>::insert(ConstIterator position, const T& val) {
+  return emplace(position, val);
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::Iterator StaticVector<T, N>::insert(ConstIterator position, T&& val) {
+  return emplace(position, std::move(val));
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::Iterator StaticVector<T, N>::insert(ConstIterator position, std::size_t count, const T& val) {
+  // val may refer to an element that is about to be shifted.
+  const T copy(val);
+  auto values = std::views::iota(std::size_t{0}, count) |
+                std::views::transform([&copy](std::size_t) -> const T& { return copy; });
+  return insert_forward(position - cbegin(), values.begin(), count);
+}
+
+template <typename T, std::size_t N>
+template <std::input_iterator InputIterator>
+constexpr StaticVector<T, N>::Iterator StaticVector<T, N>::insert(ConstIterator position, InputIterator first, InputIterator last) {
+  return insert_range(position, std::ranges::subrange(first, last));
+}
+
+template <typename T, std::size_t N>
+constexpr StaticVector<T, N>::Iterator StaticVector<T, N>::insert(ConstIterator position, std::initializer_list<T> list) {
+  return insert_forward(position - cbegin(), list.begin(), list.size());
+}
+
+template <typename T, std::size_t N>
+template <std::ranges::input_range Range>
+constexpr StaticVector<T, N>::Iterator StaticVector<T, N>::insert_range(ConstIterator position, Range&& range) {
+  const std::size_t pos = position - cbegin();
+  if constexpr (std::ranges::forward_range<Range>) {
+    return insert_forward(pos, std::ranges::begin(range),
+                          static_cast<std::size_t>(std::ranges::distance(range)));
+  } else {
+    // The count is unknown up front: on overflow the elements read so far
+    // are dropped again before the exception leaves.
+    const std::size_t old_size = this->size_;
+    try {
+      for (auto it = std::ranges::begin(range); it != std::ranges::end(range); ++it) {
+        emplace_back(*it);
+      }
+    } catch (...) {
+      resize(old_size);
+      throw;
+    }
+    std::rotate(data() + pos, data() + old_size, data() + this->size_);
+    return Iterator(data() + pos);
+  }
+}
+
+template <typename T, std::size_t N>
+template <std::ranges::input_range Range>
+constexpr void StaticVector<T, N>::append_range(Range&& range) {
+  insert_range(end(), std::forward<Range>(range));
+}
+
+template <typename T, std::size_t N>
+template <typename... Args>
+constexpr StaticVector<T, N>::Iterator StaticVector<T, N>::emplace(ConstIterator position, Args&&... args) {
+  const std::size_t pos = position - cbegin();
+  check_room(1);
+  std::allocator<T> alloc;
+  detail::emplace_in_place(alloc, data(), this->size_, pos, std::forward<Args>(args)...);
+  return Iterator(data() + pos);
+}
+
+template <typename T, std::size_t N>
+constexpr void StaticVector<T, N>::swap(StaticVector& obj) noexcept(
+    std::is_nothrow_move_constructible_v<T> && std::is_nothrow_swappable_v<T>) {
+  using std::swap;
+  StaticVector& shorter = this->size_ <= obj.size_ ? *this : obj;
+  StaticVector& longer = this->size_ <= obj.size_ ? obj : *this;
+  for (std::size_t i = 0; i < shorter.size_; ++i) {
+    swap(shorter.data()[i], longer.data()[i]);
+  }
+  const std::size_t tail = longer.size_ - shorter.size_;
+  std::allocator<T> alloc;
+  detail::relocate(alloc, longer.data() + shorter.size_, tail,
+                   shorter.data() + shorter.size_);
+  shorter.size_ += tail;
+  longer.size_ -= tail;
+}
+
+}  // namespace utils
@@ -0,0 +1,70 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+// Executor accepted by Vector's parallel constructors, resize and assign
+// (for example utils::parallel::par): for_each_chunk(size, body) calls
+// body(begin, end) for disjoint chunks covering [0, size), possibly from
+// several threads at once, and rethrows an exception thrown by body after
+// every running chunk has returned.
+template <typename Executor>
+concept chunk_executor = requires(const Executor& executor, void (*body)(std::size_t, std::size_t)) {
+  executor.for_each_chunk(std::size_t{0}, body);
+};
+
+namespace detail {
+
+// Constructs first[i] with construct(first + i, i) for every i < count,
+// chunk by chunk on the executor, so each worker touches its own pages
+// first. If any construction throws, every element built so far is
+// destroyed before the exception propagates.
+template <typename Executor, typename Allocator, typename T, typename Construct>
+void construct_chunks(const Executor& executor, Allocator& alloc, T* first, std::size_t count,
+                      Construct construct) {
+  using alloc_traits = std::allocator_traits<Allocator>;
+  std::mutex mutex;
+  std::vector<std::pair<std::size_t, std::size_t>> built;
+  auto destroy = [&](std::size_t begin, std::size_t end) noexcept {
+    for (std::size_t i = begin; i < end; ++i) {
+      alloc_traits::destroy(alloc, first + i);
+    }
+  };
+  try {
+    executor.for_each_chunk(count, [&](std::size_t begin, std::size_t end) {
+      std::size_t i = begin;
+      try {
+        for (; i < end; ++i) {
+          construct(first + i, i);
+        }
+      } catch (...) {
+        destroy(begin, i);
+        throw;
+      }
+      try {
+        std::lock_guard<std::mutex> lock(mutex);
+        built.emplace_back(begin, end);
+      } catch (...) {
+        destroy(begin, end);
+        throw;
+      }
+    });
+  } catch (...) {
+    for (const auto& [begin, end] : built) {
+      destroy(begin, end);
+    }
+    throw;
+  }
+}
+
+}  // namespace detail
+
+}  // namespace utils
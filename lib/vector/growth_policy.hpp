@@ -0,0 +1,96 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+namespace utils {
+
+constexpr std::size_t kMinSize = 8;
+constexpr double kSizeMultiplyer = 2;
+// Past this many bytes a single growth step stops being geometric.
+constexpr std::size_t kMaxGrowthBytes = std::size_t{1} << 30;
+
+// Multiplies the capacity by Factor on every growth. The first allocation
+// holds at least MinSize elements and a single step never adds more than
+// MaxGrowthBytes worth of elements (0 disables the cap).
+template <double Factor = kSizeMultiplyer, std::size_t MinSize = kMinSize,
+          std::size_t MaxGrowthBytes = kMaxGrowthBytes>
+struct GeometricGrowth {
+  static_assert(Factor > 1.0, "Growth factor must be greater than 1");
+
+  template <typename T>
+  static constexpr std::size_t next_capacity(std::size_t capacity,
+                                             std::size_t required,
+                                             std::size_t max_size) noexcept {
+    std::size_t grown;
+    if (capacity == 0) {
+      grown = MinSize;
+    } else {
+      std::size_t step =
+          static_cast<std::size_t>(static_cast<double>(capacity) * (Factor - 1.0));
+      if constexpr (MaxGrowthBytes != 0) {
+        step = std::min(step, std::max<std::size_t>(MaxGrowthBytes / sizeof(T), 1));
+      }
+      step = std::max<std::size_t>(step, 1);
+      grown = capacity > max_size - step ? max_size : capacity + step;
+    }
+    return std::min(std::max(grown, required), max_size);
+  }
+};
+
+// Adds Step elements on every growth. Step = 1 is the historical behaviour
+// and is kept for comparison only: N appends cost O(N^2) moves.
+template <std::size_t Step = 1>
+struct LinearGrowth {
+  static_assert(Step > 0, "Growth step must be positive");
+
+  template <typename T>
+  static constexpr std::size_t next_capacity(std::size_t capacity,
+                                             std::size_t required,
+                                             std::size_t max_size) noexcept {
+    std::size_t grown = capacity > max_size - Step ? max_size : capacity + Step;
+    return std::min(std::max(grown, required), max_size);
+  }
+};
+
+using DefaultGrowth = GeometricGrowth<>;
+
+template <typename Policy, typename T>
+concept growth_policy_for = requires(std::size_t n) {
+  { Policy::template next_capacity<T>(n, n, n) } -> std::convertible_to<std::size_t>;
+};
+
+namespace detail {
+
+template <typename Pointer>
+struct allocation_result {
+  Pointer ptr;
+  std::size_t count;
+};
+
+// Uses allocate_at_least when the allocator provides it, so that the slack
+// the underlying allocator hands out anyway becomes usable capacity.
+template <typename Allocator>
+constexpr auto allocate_at_least(Allocator& alloc, std::size_t n)
+    -> allocation_result<typename std::allocator_traits<Allocator>::pointer> {
+  if constexpr (requires { alloc.allocate_at_least(n); }) {
+    auto result = alloc.allocate_at_least(n);
+    return {result.ptr, static_cast<std::size_t>(result.count)};
+  } else {
+#if defined(__cpp_lib_allocate_at_least)
+    auto result = std::allocator_traits<Allocator>::allocate_at_least(alloc, n);
+    return {result.ptr, static_cast<std::size_t>(result.count)};
+#else
+    return {std::allocator_traits<Allocator>::allocate(alloc, n), n};
+#endif
+  }
+}
+
+}  // namespace detail
+
+}  // namespace utils
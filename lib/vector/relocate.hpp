@@ -0,0 +1,452 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <type_traits>
+#include <utility>
+
+#include "growth_policy.hpp"
+
+namespace utils {
+
+// A type is trivially relocatable when moving it to a new address and
+// ending the lifetime of the source is equivalent to copying its bytes.
+// Specialize for types such as std::unique_ptr-like handles to opt in:
+//
+//   template <>
+//   struct utils::is_trivially_relocatable<Handle> : std::true_type {};
+template <typename T>
+struct is_trivially_relocatable : std::is_trivially_copyable<T> {};
+
+template <typename T>
+inline constexpr bool is_trivially_relocatable_v =
+    is_trivially_relocatable<T>::value;
+
+namespace detail {
+
+template <typename Allocator>
+inline constexpr bool is_polymorphic_allocator_v = false;
+
+template <typename U>
+inline constexpr bool is_polymorphic_allocator_v<std::pmr::polymorphic_allocator<U>> =
+    true;
+
+// polymorphic_allocator only hooks construct to pass itself on to types
+// that use allocators, and its destroy is a plain destructor call.
+template <typename Allocator, typename T>
+concept allocator_customizes_construct =
+    !(is_polymorphic_allocator_v<Allocator> && !std::uses_allocator_v<T, Allocator>) &&
+    requires(Allocator& alloc, T* p) { alloc.construct(p, std::declval<T&&>()); };
+
+template <typename Allocator, typename T>
+concept allocator_customizes_destroy =
+    !is_polymorphic_allocator_v<Allocator> &&
+    requires(Allocator& alloc, T* p) { alloc.destroy(p); };
+
+// Bytewise relocation is only valid when the allocator does not hook
+// construction or destruction of the elements.
+template <typename T, typename Allocator>
+inline constexpr bool is_memcpy_relocatable_v =
+    is_trivially_relocatable_v<T> &&
+    !allocator_customizes_construct<Allocator, T> &&
+    !allocator_customizes_destroy<Allocator, T>;
+
+// Allocators such as memory::PageAllocator can resize a block themselves
+// (with mremap), keeping its bytes. Vector only uses that when its elements
+// may be moved bytewise.
+template <typename T, typename Allocator>
+concept reallocates_in_place =
+    is_memcpy_relocatable_v<T, Allocator> &&
+    requires(Allocator& alloc, T* p, std::size_t n) {
+      { alloc.reallocate(p, n, n) } -> std::same_as<T*>;
+    };
+
+template <typename Allocator, typename T>
+constexpr void destroy_n(Allocator& alloc, T* first, std::size_t n) noexcept {
+  if constexpr (!std::is_trivially_destructible_v<T> ||
+                allocator_customizes_destroy<Allocator, T>) {
+    for (std::size_t i = 0; i < n; ++i) {
+      std::allocator_traits<Allocator>::destroy(alloc, first + i);
+    }
+  }
+}
+
+// Moves n elements from first to dest and destroys the sources, going back
+// to front when the ranges overlap with dest above first. Only used for
+// trivially relocatable types, whose moves do not throw.
+template <typename Allocator, typename T>
+constexpr void relocate_elements(Allocator& alloc, T* first, std::size_t n, T* dest,
+                                 bool backward = false) noexcept {
+  using alloc_traits = std::allocator_traits<Allocator>;
+  for (std::size_t k = 0; k < n; ++k) {
+    const std::size_t i = backward ? n - 1 - k : k;
+    alloc_traits::construct(alloc, dest + i, std::move(first[i]));
+    alloc_traits::destroy(alloc, first + i);
+  }
+}
+
+// Relocates [src, src + size) into uninitialized storage at dest, leaving a
+// hole of `gap` uninitialized slots at dest + pos. Either every element is
+// relocated and the source destroyed, or an exception propagates with the
+// source untouched (move_if_noexcept falls back to copying when the move
+// constructor may throw).
+//
+// memcpy and memmove are not available during constant evaluation, so there
+// the helpers below move trivially relocatable elements one at a time with
+// relocate_elements.
+template <typename Allocator, typename T>
+constexpr void relocate_with_gap(Allocator& alloc, T* src, std::size_t size,
+                                 std::size_t pos, std::size_t gap, T* dest) {
+  using alloc_traits = std::allocator_traits<Allocator>;
+  if constexpr (is_memcpy_relocatable_v<T, Allocator>) {
+    if consteval {
+      relocate_elements(alloc, src, pos, dest);
+      relocate_elements(alloc, src + pos, size - pos, dest + pos + gap);
+    } else {
+      if (pos != 0) {
+        std::memcpy(static_cast<void*>(dest), static_cast<const void*>(src),
+                    pos * sizeof(T));
+      }
+      if (size != pos) {
+        std::memcpy(static_cast<void*>(dest + pos + gap),
+                    static_cast<const void*>(src + pos), (size - pos) * sizeof(T));
+      }
+    }
+  } else {
+    std::size_t i = 0;
+    try {
+      for (; i < pos; ++i) {
+        alloc_traits::construct(alloc, dest + i, std::move_if_noexcept(src[i]));
+      }
+    } catch (...) {
+      destroy_n(alloc, dest, i);
+      throw;
+    }
+    try {
+      for (; i < size; ++i) {
+        alloc_traits::construct(alloc, dest + i + gap,
+                                std::move_if_noexcept(src[i]));
+      }
+    } catch (...) {
+      destroy_n(alloc, dest, pos);
+      destroy_n(alloc, dest + pos + gap, i - pos);
+      throw;
+    }
+    destroy_n(alloc, src, size);
+  }
+}
+
+template <typename Allocator, typename T>
+constexpr void relocate(Allocator& alloc, T* src, std::size_t size, T* dest) {
+  relocate_with_gap(alloc, src, size, size, 0, dest);
+}
+
+// Copy-constructs count elements from first into uninitialized dest. On
+// exception nothing is left constructed. Contiguous runs of trivially
+// copyable elements are copied with memcpy unless the allocator hooks
+// construction.
+template <typename Allocator, typename T, std::input_iterator InputIterator>
+constexpr void uninitialized_copy_n(Allocator& alloc, InputIterator first,
+                                    std::size_t count, T* dest) {
+  if constexpr (std::contiguous_iterator<InputIterator> &&
+                std::is_same_v<std::iter_value_t<InputIterator>, T> &&
+                std::is_trivially_copyable_v<T> && !allocator_customizes_construct<Allocator, T>) {
+    if !consteval {
+      if (count != 0) {
+        std::memcpy(static_cast<void*>(dest), static_cast<const void*>(std::to_address(first)),
+                    count * sizeof(T));
+      }
+      return;
+    }
+  }
+  std::size_t built = 0;
+  try {
+    for (; built < count; ++built, ++first) {
+      std::allocator_traits<Allocator>::construct(alloc, dest + built, *first);
+    }
+  } catch (...) {
+    destroy_n(alloc, dest, built);
+    throw;
+  }
+}
+
+// Default-initializes count elements at dest, as `new T` would: trivial
+// types are left indeterminate and cost nothing. An allocator that hooks
+// construction still gets construct(p), which value-initializes, and so
+// does constant evaluation. On exception nothing is left constructed.
+template <typename Allocator, typename T>
+constexpr void uninitialized_default_construct_n(Allocator& alloc, T* dest, std::size_t count) {
+  constexpr bool hooked =
+      !(is_polymorphic_allocator_v<Allocator> && !std::uses_allocator_v<T, Allocator>) &&
+      requires(Allocator& a, T* p) { a.construct(p); };
+  if !consteval {
+    if constexpr (!hooked) {
+      std::uninitialized_default_construct_n(dest, count);
+      return;
+    }
+  }
+  std::size_t built = 0;
+  try {
+    for (; built < count; ++built) {
+      std::allocator_traits<Allocator>::construct(alloc, dest + built);
+    }
+  } catch (...) {
+    destroy_n(alloc, dest, built);
+    throw;
+  }
+}
+
+// Fills new storage at dest: `count` elements are created at dest + pos by
+// build(dest + pos), which must be all-or-nothing, then the old elements
+// are relocated around them. On exception dest holds no live objects and
+// src is untouched.
+template <typename Allocator, typename T, typename Build>
+constexpr void relocate_around(Allocator& alloc, T* src, std::size_t size,
+                               std::size_t pos, std::size_t count, T* dest, Build&& build) {
+  build(dest + pos);
+  try {
+    relocate_with_gap(alloc, src, size, pos, count, dest);
+  } catch (...) {
+    destroy_n(alloc, dest + pos, count);
+    throw;
+  }
+}
+
+// Moves the size elements at data into a new block of at least new_cap
+// elements, creating count more at pos with build as relocate_around does,
+// then frees the old block when owns_old is set (SmallVector's inline
+// buffer is not) and points data and capacity at the new one. On exception
+// the new block is freed and data, capacity and the elements are
+// untouched.
+template <typename Allocator, typename T, typename Build>
+constexpr void grow_buffer(Allocator& alloc, T*& data, std::size_t& capacity, std::size_t size,
+                           bool owns_old, std::size_t new_cap, std::size_t pos,
+                           std::size_t count, Build&& build) {
+  using alloc_traits = std::allocator_traits<Allocator>;
+  auto [new_data, allocated] = allocate_at_least(alloc, new_cap);
+  try {
+    relocate_around(alloc, data, size, pos, count, new_data, std::forward<Build>(build));
+  } catch (...) {
+    alloc_traits::deallocate(alloc, new_data, allocated);
+    throw;
+  }
+  if (owns_old) {
+    alloc_traits::deallocate(alloc, data, capacity);
+  }
+  data = new_data;
+  capacity = allocated;
+}
+
+// grow_buffer without new elements.
+template <typename Allocator, typename T>
+constexpr void grow_buffer(Allocator& alloc, T*& data, std::size_t& capacity, std::size_t size,
+                           bool owns_old, std::size_t new_cap) {
+  grow_buffer(alloc, data, capacity, size, owns_old, new_cap, size, 0, [](T*) {});
+}
+
+// Constructs a new element at data + pos, shifting [pos, size) right by one
+// inside existing storage. Requires spare capacity. size is updated as
+// elements come to life so the container stays destructible on exception.
+template <typename Allocator, typename T, typename... Args>
+constexpr void emplace_in_place(Allocator& alloc, T* data, std::size_t& size,
+                                std::size_t pos, Args&&... args) {
+  using alloc_traits = std::allocator_traits<Allocator>;
+  if (pos == size) {
+    alloc_traits::construct(alloc, data + size, std::forward<Args>(args)...);
+    ++size;
+  } else if constexpr (is_memcpy_relocatable_v<T, Allocator>) {
+    // Built off to the side first: args may refer to elements of data.
+    if consteval {
+      T value(std::forward<Args>(args)...);
+      relocate_elements(alloc, data + pos, size - pos, data + pos + 1, true);
+      alloc_traits::construct(alloc, data + pos, std::move(value));
+    } else {
+      alignas(T) unsigned char buffer[sizeof(T)];
+      T* value = reinterpret_cast<T*>(buffer);
+      alloc_traits::construct(alloc, value, std::forward<Args>(args)...);
+      std::memmove(static_cast<void*>(data + pos + 1),
+                   static_cast<const void*>(data + pos), (size - pos) * sizeof(T));
+      std::memcpy(static_cast<void*>(data + pos), static_cast<const void*>(value),
+                  sizeof(T));
+    }
+    ++size;
+  } else {
+    T value(std::forward<Args>(args)...);
+    T* last = data + size;
+    alloc_traits::construct(alloc, last, std::move(*(last - 1)));
+    ++size;
+    std::move_backward(data + pos, last - 1, last);
+    data[pos] = std::move(value);
+  }
+}
+
+// Inserts count elements read from first at data + pos inside existing
+// storage. Requires size + count <= capacity; size is kept in step with the
+// live elements. Trivially relocatable types get the strong guarantee.
+template <typename Allocator, typename T, std::forward_iterator ForwardIterator>
+constexpr void insert_in_place(Allocator& alloc, T* data, std::size_t& size,
+                               std::size_t pos, ForwardIterator first, std::size_t count) {
+  using alloc_traits = std::allocator_traits<Allocator>;
+  T* position = data + pos;
+  T* old_end = data + size;
+  const std::size_t elems_after = size - pos;
+  if constexpr (is_memcpy_relocatable_v<T, Allocator>) {
+    if consteval {
+      relocate_elements(alloc, position, elems_after, position + count, true);
+    } else {
+      std::memmove(static_cast<void*>(position + count),
+                   static_cast<const void*>(position), elems_after * sizeof(T));
+    }
+    try {
+      uninitialized_copy_n(alloc, first, count, position);
+    } catch (...) {
+      if consteval {
+        relocate_elements(alloc, position + count, elems_after, position);
+      } else {
+        std::memmove(static_cast<void*>(position),
+                     static_cast<const void*>(position + count),
+                     elems_after * sizeof(T));
+      }
+      throw;
+    }
+    size += count;
+  } else if (elems_after > count) {
+    for (T* src = old_end - count; src != old_end; ++src) {
+      alloc_traits::construct(alloc, src + count, std::move(*src));
+      ++size;
+    }
+    std::move_backward(position, old_end - count, old_end);
+    for (std::size_t i = 0; i < count; ++i, ++first) {
+      position[i] = *first;
+    }
+  } else {
+    ForwardIterator mid = std::ranges::next(
+        first, static_cast<std::iter_difference_t<ForwardIterator>>(elems_after));
+    for (ForwardIterator it = mid; size < pos + count; ++it) {
+      alloc_traits::construct(alloc, data + size, *it);
+      ++size;
+    }
+    for (T* src = position; src != old_end; ++src) {
+      alloc_traits::construct(alloc, data + size, std::move(*src));
+      ++size;
+    }
+    std::ranges::copy(first, mid, position);
+  }
+}
+
+// Bytewise moves n trivially relocatable elements from first down to dest
+// (dest <= first); the ranges may overlap.
+template <typename Allocator, typename T>
+constexpr void slide_down(Allocator& alloc, T* first, std::size_t n, T* dest) noexcept {
+  if (n == 0 || dest == first) {
+    return;
+  }
+  if consteval {
+    relocate_elements(alloc, first, n, dest);
+  } else {
+    std::memmove(static_cast<void*>(dest), static_cast<const void*>(first), n * sizeof(T));
+  }
+}
+
+// Removes [pos, pos + count) from data and closes the gap.
+template <typename Allocator, typename T>
+constexpr void erase_in_place(Allocator& alloc, T* data, std::size_t& size,
+                              std::size_t pos, std::size_t count) {
+  if constexpr (is_memcpy_relocatable_v<T, Allocator>) {
+    destroy_n(alloc, data + pos, count);
+    slide_down(alloc, data + pos + count, size - pos - count, data + pos);
+  } else {
+    std::move(data + pos + count, data + size, data + pos);
+    destroy_n(alloc, data + size - count, count);
+  }
+  size -= count;
+}
+
+// Removes every element for which remove(element, index) is true in one
+// pass and returns how many went. Each removed element is destroyed once.
+// Survivors that are trivially relocatable but not trivially copyable move
+// bytewise as whole runs between removed elements; others are
+// move-assigned forward and the tail is destroyed.
+// If remove throws, the elements still present stay valid and size counts
+// them.
+template <typename Allocator, typename T, typename Remove>
+constexpr std::size_t remove_in_place(Allocator& alloc, T* data, std::size_t& size,
+                                      Remove&& remove) {
+  // Kept local: for integer elements, stores through data could alias size.
+  const std::size_t count = size;
+  std::size_t i = 0;
+  while (i < count && !remove(data[i], i)) {
+    ++i;
+  }
+  if (i == count) {
+    return 0;
+  }
+  // [0, out) is final and data[i] is the first element to remove.
+  std::size_t out = i;
+  if constexpr (is_memcpy_relocatable_v<T, Allocator> && !std::is_trivially_copyable_v<T>) {
+    // Survivors not yet moved start at run.
+    std::size_t run = i + 1;
+    std::allocator_traits<Allocator>::destroy(alloc, data + i);
+    try {
+      for (++i; i < count; ++i) {
+        if (remove(data[i], i)) {
+          slide_down(alloc, data + run, i - run, data + out);
+          out += i - run;
+          std::allocator_traits<Allocator>::destroy(alloc, data + i);
+          run = i + 1;
+        }
+      }
+    } catch (...) {
+      slide_down(alloc, data + run, count - run, data + out);
+      size = out + (count - run);
+      throw;
+    }
+    slide_down(alloc, data + run, count - run, data + out);
+    out += count - run;
+  } else {
+    for (++i; i < count; ++i) {
+      if (!remove(data[i], i)) {
+        data[out] = std::move(data[i]);
+        ++out;
+      }
+    }
+    destroy_n(alloc, data + out, count - out);
+  }
+  size = out;
+  return count - out;
+}
+
+// Replaces data[pos] with the last element and shrinks size by one.
+template <typename Allocator, typename T>
+constexpr void unordered_erase_in_place(Allocator& alloc, T* data, std::size_t& size,
+                                        std::size_t pos) {
+  const std::size_t last = size - 1;
+  if (pos != last) {
+    if constexpr (is_memcpy_relocatable_v<T, Allocator>) {
+      std::allocator_traits<Allocator>::destroy(alloc, data + pos);
+      if consteval {
+        relocate_elements(alloc, data + last, 1, data + pos);
+      } else {
+        std::memcpy(static_cast<void*>(data + pos), static_cast<const void*>(data + last),
+                    sizeof(T));
+      }
+      --size;
+      return;
+    } else {
+      data[pos] = std::move(data[last]);
+    }
+  }
+  std::allocator_traits<Allocator>::destroy(alloc, data + last);
+  --size;
+}
+
+}  // namespace detail
+
+}  // namespace utils
@@ -0,0 +1,111 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+namespace utils {
+
+// Counters gathered by VectorStats. bytes_moved counts elements relocated
+// into a new buffer on reallocation; slow_inserts counts insertions away
+// from the end that had to rebuild the buffer around the new elements.
+struct VectorCounters {
+  std::size_t allocations = 0;
+  std::size_t reallocations = 0;
+  std::size_t bytes_moved = 0;
+  std::size_t peak_capacity = 0;
+  std::size_t constructed = 0;
+  std::size_t destroyed = 0;
+  std::size_t slow_inserts = 0;
+};
+
+// Statistics policy that records nothing. Every hook is an empty constexpr
+// function and the member is [[no_unique_address]], so a Vector using it
+// has the same size and code as one without instrumentation and stays
+// usable in constant evaluation.
+template <typename T>
+struct NoStats {
+  static constexpr bool enabled = false;
+
+  constexpr void on_allocate(std::size_t) noexcept {}
+  constexpr void on_reallocate(std::size_t, std::size_t) noexcept {}
+  constexpr void on_construct(std::size_t) noexcept {}
+  constexpr void on_destroy(std::size_t) noexcept {}
+  constexpr void on_slow_insert() noexcept {}
+  constexpr void merge(const NoStats&) noexcept {}
+};
+
+// Process-wide totals per element type. Entries are created on first use
+// and live until exit; updates are relaxed atomics, so the registry can be
+// fed from any thread.
+class StatsRegistry {
+ public:
+  struct Entry {
+    std::atomic<std::size_t> allocations{0};
+    std::atomic<std::size_t> reallocations{0};
+    std::atomic<std::size_t> bytes_moved{0};
+    std::atomic<std::size_t> peak_capacity{0};
+    std::atomic<std::size_t> constructed{0};
+    std::atomic<std::size_t> destroyed{0};
+    std::atomic<std::size_t> slow_inserts{0};
+  };
+
+  static StatsRegistry& instance();
+
+  Entry& entry(const std::type_info& type);
+  // Totals per type, keyed by the demangled type name.
+  std::vector<std::pair<std::string, VectorCounters>> snapshot() const;
+  // Fixed-width text table of snapshot(), one row per type.
+  std::string dump() const;
+  void reset();
+
+ private:
+  StatsRegistry() = default;
+
+  mutable std::mutex mutex_;
+  std::map<std::type_index, std::unique_ptr<Entry>> entries_;
+};
+
+// Statistics policy that counts into the instance and into the per-type
+// StatsRegistry entry for T.
+template <typename T>
+class VectorStats {
+ public:
+  static constexpr bool enabled = true;
+
+  VectorStats() = default;
+  // Counters belong to the object, not its value: copies start from zero.
+  VectorStats(const VectorStats&) noexcept {}
+  VectorStats& operator=(const VectorStats&) noexcept { return *this; }
+
+  const VectorCounters& counters() const noexcept { return counters_; }
+  static VectorCounters totals() noexcept;
+
+  void on_allocate(std::size_t capacity) noexcept;
+  void on_reallocate(std::size_t capacity, std::size_t moved) noexcept;
+  void on_construct(std::size_t count) noexcept;
+  void on_destroy(std::size_t count) noexcept;
+  void on_slow_insert() noexcept;
+  // Folds in the counters of a temporary that is about to replace this
+  // vector's contents.
+  void merge(const VectorStats& other) noexcept;
+
+ private:
+  // Called from the noexcept hooks, so registration failures are absorbed.
+  static StatsRegistry::Entry& global() noexcept;
+
+  VectorCounters counters_;
+};
+
+}  // namespace utils
+
+#include "stats.tpp"
@@ -0,0 +1,200 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#if __has_include(<cxxabi.h>)
+#include <cxxabi.h>
+#endif
+
+#include "stats.hpp"
+
+namespace utils {
+
+namespace detail {
+
+inline std::string demangle(const char* name) {
+#if __has_include(<cxxabi.h>)
+  int status = 0;
+  std::unique_ptr<char, void (*)(void*)> demangled(
+      abi::__cxa_demangle(name, nullptr, nullptr, &status), std::free);
+  if (status == 0 && demangled != nullptr) {
+    return demangled.get();
+  }
+#endif
+  return name;
+}
+
+inline void atomic_max(std::atomic<std::size_t>& target, std::size_t value) noexcept {
+  std::size_t current = target.load(std::memory_order_relaxed);
+  while (current < value &&
+         !target.compare_exchange_weak(current, value, std::memory_order_relaxed)) {
+  }
+}
+
+}  // namespace detail
+
+// StatsRegistry
+
+// Never destroyed, so vectors with static storage duration can still
+// report from their destructors during shutdown.
+inline StatsRegistry& StatsRegistry::instance() {
+  static StatsRegistry* registry = new StatsRegistry();
+  return *registry;
+}
+
+inline StatsRegistry::Entry& StatsRegistry::entry(const std::type_info& type) {
+  std::lock_guard lock(this->mutex_);
+  auto& slot = this->entries_[std::type_index(type)];
+  if (slot == nullptr) {
+    slot = std::make_unique<Entry>();
+  }
+  return *slot;
+}
+
+inline std::vector<std::pair<std::string, VectorCounters>> StatsRegistry::snapshot() const {
+  std::vector<std::pair<std::string, VectorCounters>> result;
+  std::lock_guard lock(this->mutex_);
+  result.reserve(this->entries_.size());
+  for (const auto& [type, entry] : this->entries_) {
+    VectorCounters counters;
+    counters.allocations = entry->allocations.load(std::memory_order_relaxed);
+    counters.reallocations = entry->reallocations.load(std::memory_order_relaxed);
+    counters.bytes_moved = entry->bytes_moved.load(std::memory_order_relaxed);
+    counters.peak_capacity = entry->peak_capacity.load(std::memory_order_relaxed);
+    counters.constructed = entry->constructed.load(std::memory_order_relaxed);
+    counters.destroyed = entry->destroyed.load(std::memory_order_relaxed);
+    counters.slow_inserts = entry->slow_inserts.load(std::memory_order_relaxed);
+    result.emplace_back(detail::demangle(type.name()), counters);
+  }
+  std::sort(result.begin(), result.end(),
+            [](const auto& a, const auto& b) { return a.first < b.first; });
+  return result;
+}
+
+inline std::string StatsRegistry::dump() const {
+  // Type names are padded to 32 columns but never cut; only the counters,
+  // at most 7 * 21 characters, go through the fixed buffer.
+  auto pad = [](const std::string& name) {
+    return name.size() < 32 ? name + std::string(32 - name.size(), ' ') : name;
+  };
+  std::string report = pad("type");
+  char counters[256];
+  std::snprintf(counters, sizeof(counters), " %12s %12s %14s %12s %12s %12s %12s\n", "allocs",
+                "reallocs", "bytes_moved", "peak_cap", "constructed", "destroyed",
+                "slow_inserts");
+  report += counters;
+  for (const auto& [name, c] : snapshot()) {
+    std::snprintf(counters, sizeof(counters), " %12zu %12zu %14zu %12zu %12zu %12zu %12zu\n",
+                  c.allocations, c.reallocations, c.bytes_moved, c.peak_capacity,
+                  c.constructed, c.destroyed, c.slow_inserts);
+    report += pad(name);
+    report += counters;
+  }
+  return report;
+}
+
+inline void StatsRegistry::reset() {
+  std::lock_guard lock(this->mutex_);
+  for (auto& [type, entry] : this->entries_) {
+    entry->allocations.store(0, std::memory_order_relaxed);
+    entry->reallocations.store(0, std::memory_order_relaxed);
+    entry->bytes_moved.store(0, std::memory_order_relaxed);
+    entry->peak_capacity.store(0, std::memory_order_relaxed);
+    entry->constructed.store(0, std::memory_order_relaxed);
+    entry->destroyed.store(0, std::memory_order_relaxed);
+    entry->slow_inserts.store(0, std::memory_order_relaxed);
+  }
+}
+
+// VectorStats
+
+// Registering T allocates and locks, either of which may throw. Counts for
+// a type that could not be registered go to an entry of its own, which
+// totals() still reads but the registry does not list.
+template <typename T>
+StatsRegistry::Entry& VectorStats<T>::global() noexcept {
+  static StatsRegistry::Entry& entry = []() noexcept -> StatsRegistry::Entry& {
+    try {
+      return StatsRegistry::instance().entry(typeid(T));
+    } catch (...) {
+      static StatsRegistry::Entry unregistered;
+      return unregistered;
+    }
+  }();
+  return entry;
+}
+
+template <typename T>
+VectorCounters VectorStats<T>::totals() noexcept {
+  const StatsRegistry::Entry& entry = global();
+  VectorCounters counters;
+  counters.allocations = entry.allocations.load(std::memory_order_relaxed);
+  counters.reallocations = entry.reallocations.load(std::memory_order_relaxed);
+  counters.bytes_moved = entry.bytes_moved.load(std::memory_order_relaxed);
+  counters.peak_capacity = entry.peak_capacity.load(std::memory_order_relaxed);
+  counters.constructed = entry.constructed.load(std::memory_order_relaxed);
+  counters.destroyed = entry.destroyed.load(std::memory_order_relaxed);
+  counters.slow_inserts = entry.slow_inserts.load(std::memory_order_relaxed);
+  return counters;
+}
+
+template <typename T>
+void VectorStats<T>::on_allocate(std::size_t capacity) noexcept {
+  ++this->counters_.allocations;
+  this->counters_.peak_capacity = std::max(this->counters_.peak_capacity, capacity);
+  global().allocations.fetch_add(1, std::memory_order_relaxed);
+  detail::atomic_max(global().peak_capacity, capacity);
+}
+
+template <typename T>
+void VectorStats<T>::on_reallocate(std::size_t capacity, std::size_t moved) noexcept {
+  const std::size_t bytes = moved * sizeof(T);
+  ++this->counters_.reallocations;
+  this->counters_.bytes_moved += bytes;
+  global().reallocations.fetch_add(1, std::memory_order_relaxed);
+  global().bytes_moved.fetch_add(bytes, std::memory_order_relaxed);
+  on_allocate(capacity);
+}
+
+template <typename T>
+void VectorStats<T>::on_construct(std::size_t count) noexcept {
+  this->counters_.constructed += count;
+  global().constructed.fetch_add(count, std::memory_order_relaxed);
+}
+
+template <typename T>
+void VectorStats<T>::on_destroy(std::size_t count) noexcept {
+  this->counters_.destroyed += count;
+  global().destroyed.fetch_add(count, std::memory_order_relaxed);
+}
+
+template <typename T>
+void VectorStats<T>::on_slow_insert() noexcept {
+  ++this->counters_.slow_inserts;
+  global().slow_inserts.fetch_add(1, std::memory_order_relaxed);
+}
+
+template <typename T>
+void VectorStats<T>::merge(const VectorStats& other) noexcept {
+  this->counters_.allocations += other.counters_.allocations;
+  this->counters_.reallocations += other.counters_.reallocations;
+  this->counters_.bytes_moved += other.counters_.bytes_moved;
+  this->counters_.peak_capacity =
+      std::max(this->counters_.peak_capacity, other.counters_.peak_capacity);
+  this->counters_.constructed += other.counters_.constructed;
+  this->counters_.destroyed += other.counters_.destroyed;
+  this->counters_.slow_inserts += other.counters_.slow_inserts;
+}
+
+}  // namespace utils
@@ -2,134 +2,268 @@
 
 #pragma once
 
+#include <compare>
+#include <concepts>
 #include <cstddef>
 #include <initializer_list>
 #include <iterator>
 #include <memory>
+#include <ranges>
+#include <type_traits>
 #include <utility>
 
+#include "execution.hpp"
+#include "growth_policy.hpp"
+#include "relocate.hpp"
+#include "stats.hpp"
+
 namespace utils {
 
-template <typename T, typename Allocator = std::allocator<T>>
+// Constructor tag: new elements are default-initialized, so trivial types
+// such as char or float are left indeterminate instead of zeroed. For
+// buffers that are about to be overwritten, e.g. by read() or a decoder.
+struct default_init_t {
+  explicit default_init_t() = default;
+};
+inline constexpr default_init_t default_init{};
+
+// Stats receives allocation, relocation and construction events; the
+// default NoStats<T> discards them at compile time. Use VectorStats<T> to
+// count per instance and per element type.
+template <typename T, typename Allocator = std::allocator<T>,
+          typename GrowthPolicy = DefaultGrowth, typename Stats = NoStats<T>>
 class Vector {
+  static_assert(growth_policy_for<GrowthPolicy, T>,
+                "GrowthPolicy must provide next_capacity<T>(capacity, required, max_size)");
+
  public:
+  using value_type = T;
   using allocator_type = Allocator;
   using alloc_traits = std::allocator_traits<Allocator>;
-  
+  using growth_policy = GrowthPolicy;
+  using stats_type = Stats;
+
   // Constructors / Destructor
-  Vector(const Allocator& alloc = Allocator());
-  explicit Vector(std::size_t size, const T& val, 
-                 const Allocator& alloc = Allocator());
-  Vector(const std::initializer_list<T>& list, 
+  constexpr Vector(const Allocator& alloc = Allocator());
+  constexpr explicit Vector(std::size_t size, const T& val, 
+                           const Allocator& alloc = Allocator());
+  constexpr explicit Vector(std::size_t size, default_init_t,
+                            const Allocator& alloc = Allocator());
+  constexpr Vector(const std::initializer_list<T>& list, 
+                   const Allocator& alloc = Allocator());
+  constexpr Vector(const Vector& obj);
+  constexpr Vector(const Vector& obj, const Allocator& alloc);
+  constexpr Vector(Vector&& other) noexcept;
+  constexpr Vector(Vector&& other, const Allocator& alloc);
+  // Parallel versions: elements are built chunk by chunk on the executor,
+  // e.g. Vector<double> v(utils::parallel::par, n, 0.0). Allocator::construct
+  // must be safe to call concurrently.
+  template <chunk_executor Executor>
+  Vector(const Executor& executor, std::size_t size, const T& val,
          const Allocator& alloc = Allocator());
-  Vector(const Vector& obj);
-  Vector(const Vector& obj, const Allocator& alloc);
-  Vector(Vector&& other) noexcept;
-  Vector(Vector&& other, const Allocator& alloc);
-  Vector<T, Allocator>& operator=(const Vector<T, Allocator>& obj);
-  Vector<T, Allocator>& operator=(Vector<T, Allocator>&& other) 
+  template <chunk_executor Executor>
+  Vector(const Executor& executor, const Vector& obj);
+  template <chunk_executor Executor>
+  Vector(const Executor& executor, Vector&& other, const Allocator& alloc);
+  constexpr Vector& operator=(const Vector& obj);
+  constexpr Vector& operator=(Vector&& other) 
       noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
                alloc_traits::is_always_equal::value);
-  Vector<T, Allocator>& operator=(const std::initializer_list<T>& list);
-  ~Vector();
+  constexpr Vector& operator=(const std::initializer_list<T>& list);
+  constexpr ~Vector();
 
   // Allocator
-  const Allocator& get_allocator() const noexcept { return alloc_; }
+  constexpr const Allocator& get_allocator() const noexcept { return alloc_; }
+  // Statistics
+  constexpr const Stats& stats() const noexcept { return stats_; }
 
   // Iterators:
-  class Iterator {
+  // Contiguous iterator over T (Const = false) or const T. Iterator
+  // converts to ConstIterator, and the two compare with each other.
+  template <bool Const>
+  class BasicIterator {
    public:
+    using iterator_concept = std::contiguous_iterator_tag;
     using iterator_category = std::random_access_iterator_tag;
     using value_type = T;
+    using element_type = std::conditional_t<Const, const T, T>;
     using difference_type = std::ptrdiff_t;
-    using pointer = T*;
-    using reference = T&;
-    using creference = const T&;
-
-    Iterator(pointer obj);
-    Iterator& operator++();
-    Iterator operator+(const Iterator& other) const;
-    Iterator& operator+=(const Iterator& other);
-    Iterator operator+(difference_type size) const;
-    Iterator& operator+=(difference_type size);
-    Iterator& operator--();
-    difference_type operator-(const Iterator& other) const;
-    Iterator operator-(difference_type size) const;
-    Iterator& operator-=(const Iterator& other);
-    Iterator& operator-=(difference_type size);
-    reference operator*() const;
-    pointer operator->();
-    bool operator==(const Iterator& obj) const;
-    bool operator!=(const Iterator& obj) const;
-    bool operator<(const Iterator& other) const;
-    bool operator>(const Iterator& other) const;
-    bool operator<=(const Iterator& other) const;
-    bool operator>=(const Iterator& other) const;
-    reference operator[](difference_type n) const { return *(current_ + n); }
-    static std::size_t distance(const Iterator& begin, const Iterator& end);
+    using pointer = element_type*;
+    using reference = element_type&;
+
+    constexpr BasicIterator() noexcept = default;
+    constexpr BasicIterator(pointer obj) noexcept;
+    template <bool OtherConst>
+      requires(Const && !OtherConst)
+    constexpr BasicIterator(const BasicIterator<OtherConst>& other) noexcept;
+    constexpr BasicIterator& operator++() noexcept;
+    constexpr BasicIterator operator++(int) noexcept;
+    constexpr BasicIterator& operator--() noexcept;
+    constexpr BasicIterator operator--(int) noexcept;
+    constexpr BasicIterator& operator+=(difference_type size) noexcept;
+    constexpr BasicIterator& operator-=(difference_type size) noexcept;
+    constexpr BasicIterator operator+(difference_type size) const noexcept;
+    friend constexpr BasicIterator operator+(difference_type size,
+                                             const BasicIterator& it) noexcept {
+      return it + size;
+    }
+    constexpr BasicIterator operator-(difference_type size) const noexcept;
+    // A hidden friend, so an Iterator operand converts to ConstIterator on
+    // either side.
+    friend constexpr difference_type operator-(const BasicIterator& lhs,
+                                               const BasicIterator& rhs) noexcept {
+      return lhs.current_ - rhs.current_;
+    }
+    constexpr reference operator*() const noexcept;
+    constexpr pointer operator->() const noexcept;
+    constexpr reference operator[](difference_type n) const noexcept { return current_[n]; }
+    constexpr bool operator==(const BasicIterator& obj) const noexcept;
+    constexpr std::strong_ordering operator<=>(const BasicIterator& other) const noexcept;
+    static constexpr std::size_t distance(const BasicIterator& begin, const BasicIterator& end);
 
    private:
-    pointer current_;
+    template <bool>
+    friend class BasicIterator;
+
+    pointer current_ = nullptr;
   };
+  using Iterator = BasicIterator<false>;
+  using ConstIterator = BasicIterator<true>;
+  using ReverseIterator = std::reverse_iterator<Iterator>;
+  using ConstReverseIterator = std::reverse_iterator<ConstIterator>;
+  // Standard container names.
+  using iterator = Iterator;
+  using const_iterator = ConstIterator;
+  using reverse_iterator = ReverseIterator;
+  using const_reverse_iterator = ConstReverseIterator;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using reference = T&;
+  using const_reference = const T&;
+  using pointer = T*;
+  using const_pointer = const T*;
+
   template <class InputIterator>
-  Vector(InputIterator first, InputIterator last,
-         const Allocator& alloc = Allocator());
-  Iterator begin();
-  const Iterator begin() const;
-  Iterator end();
-  const Iterator end() const;
-  const Iterator cbegin() const;
-  const Iterator cend() const;
+    requires(!std::is_integral_v<InputIterator>)
+  constexpr Vector(InputIterator first, InputIterator last,
+                   const Allocator& alloc = Allocator());
+  constexpr Iterator begin() noexcept;
+  constexpr ConstIterator begin() const noexcept;
+  constexpr Iterator end() noexcept;
+  constexpr ConstIterator end() const noexcept;
+  constexpr ConstIterator cbegin() const noexcept;
+  constexpr ConstIterator cend() const noexcept;
+  constexpr ReverseIterator rbegin() noexcept { return ReverseIterator(end()); }
+  constexpr ConstReverseIterator rbegin() const noexcept { return ConstReverseIterator(end()); }
+  constexpr ReverseIterator rend() noexcept { return ReverseIterator(begin()); }
+  constexpr ConstReverseIterator rend() const noexcept { return ConstReverseIterator(begin()); }
+  constexpr ConstReverseIterator crbegin() const noexcept { return rbegin(); }
+  constexpr ConstReverseIterator crend() const noexcept { return rend(); }
   // Capacity:
-  std::size_t size() const;
-  std::size_t max_size() const;
-  void resize(std::size_t size, const T& val = T());
-  std::size_t capacity() const;
-  bool empty() const;
-  void reserve(std::size_t malloc);
-  void shrink_to_fit();
+  constexpr std::size_t size() const;
+  constexpr std::size_t max_size() const;
+  constexpr void resize(std::size_t size, const T& val = T());
+  template <chunk_executor Executor>
+  void resize(const Executor& executor, std::size_t size, const T& val = T());
+  // resize() that default-initializes new elements (see default_init).
+  constexpr void resize_for_overwrite(std::size_t size);
+  // As std::string::resize_and_overwrite: grows to size elements, the new
+  // ones default-initialized, calls n = op(data(), size) and keeps the
+  // first n elements. An n above size throws std::length_error with the
+  // first size elements kept. If op throws, the vector keeps its old size;
+  // elements op wrote below the old size stay as written.
+  template <typename Operation>
+  constexpr void resize_and_overwrite(std::size_t size, Operation op);
+  constexpr std::size_t capacity() const;
+  constexpr bool empty() const;
+  constexpr void reserve(std::size_t malloc);
+  constexpr void shrink_to_fit();
   // Element access:
-  T& operator[](std::size_t i);
-  const T& operator[](std::size_t i) const;
-  T& at(std::size_t n);
-  const T& at(std::size_t n) const;
-  T& front();
-  const T& front() const;
-  T& back();
-  const T& back() const;
-  T* data();
-  const T* data() const;
+  constexpr T& operator[](std::size_t i);
+  constexpr const T& operator[](std::size_t i) const;
+  constexpr T& at(std::size_t n);
+  constexpr const T& at(std::size_t n) const;
+  constexpr T& front();
+  constexpr const T& front() const;
+  constexpr T& back();
+  constexpr const T& back() const;
+  constexpr T* data();
+  constexpr const T* data() const;
   // Modifiers:
   template<std::input_iterator InputIterator>
-  void assign(InputIterator first, InputIterator last);
-  void assign(std::size_t size, const T& val);
-  void clear() noexcept;
-  void push_back(const T& obj);
-  void push_back(T&& obj);
+  constexpr void assign(InputIterator first, InputIterator last);
+  constexpr void assign(std::size_t size, const T& val);
+  template <chunk_executor Executor>
+  void assign(const Executor& executor, std::size_t size, const T& val);
+  constexpr void clear() noexcept;
+  constexpr void push_back(const T& obj);
+  constexpr void push_back(T&& obj);
   template<typename... Args>
-  T& emplace_back(Args&&... args);
-  void pop_back();
-  Iterator erase(const Iterator position);
-  Iterator erase(const Iterator begin, const Iterator end);
-  Iterator insert(const Iterator position, const T& val);
-  Iterator insert(const Iterator position, T&& val);
+  constexpr T& emplace_back(Args&&... args);
+  constexpr void pop_back();
+  constexpr Iterator erase(ConstIterator position);
+  constexpr Iterator erase(ConstIterator first, ConstIterator last);
+  // Moves the last element into position instead of shifting the tail:
+  // O(1), but the order of the remaining elements changes.
+  constexpr Iterator unordered_erase(ConstIterator position);
+  // Removes the elements at the given strictly increasing indices in one
+  // pass over the vector and returns how many were removed. Throws, with
+  // nothing removed, if the indices are unsorted, repeated or out of range.
+  template <std::ranges::forward_range Indices>
+    requires std::integral<std::ranges::range_value_t<Indices>>
+  constexpr std::size_t erase_indices(Indices&& indices);
+  constexpr Iterator insert(ConstIterator position, const T& val);
+  constexpr Iterator insert(ConstIterator position, T&& val);
+  constexpr Iterator insert(ConstIterator position, std::size_t count, const T& val);
+  template <std::input_iterator InputIterator>
+  constexpr Iterator insert(ConstIterator position, InputIterator first, InputIterator last);
+  constexpr Iterator insert(ConstIterator position, std::initializer_list<T> list);
+  template <std::ranges::input_range Range>
+  constexpr Iterator insert_range(ConstIterator position, Range&& range);
+  template <std::ranges::input_range Range>
+  constexpr void append_range(Range&& range);
   template<typename... Args>
-  Iterator emplace(const Iterator position, Args&&... args);
+  constexpr Iterator emplace(ConstIterator position, Args&&... args);
 
-  void swap(Vector& obj) noexcept(
+  constexpr void swap(Vector& obj) noexcept(
       alloc_traits::propagate_on_container_swap::value ||
       alloc_traits::is_always_equal::value);
 
  private:
-  void reallocate(std::size_t new_cap);
-  void destroy_range(T* first, T* last) noexcept;
+  template <typename U, typename A, typename G, typename S, typename Pred>
+  friend constexpr std::size_t erase_if(Vector<U, A, G, S>& vec, Pred pred);
+
+  // Single-pass compaction behind erase_if and erase_indices.
+  template <typename Remove>
+  constexpr std::size_t remove_where(Remove&& remove);
+
+  constexpr void reallocate(std::size_t new_cap);
+  // reserve() that returns where val lives afterwards, which differs when
+  // val is one of the elements.
+  constexpr const T& reserve_keeping(std::size_t malloc, const T& val);
+  constexpr std::size_t next_capacity(std::size_t required) const;
+  template <typename Build>
+  constexpr void realloc_insert(std::size_t pos, std::size_t count, Build&& build);
+  template <std::forward_iterator ForwardIterator>
+  constexpr Iterator insert_forward(std::size_t pos, ForwardIterator first, std::size_t count);
+  constexpr void destroy_range(T* first, T* last) noexcept;
+  // Destroys the elements from size on; never grows.
+  constexpr void truncate(std::size_t size) noexcept;
   
   std::size_t size_;
   T* data_;
   std::size_t capacity_;
   Allocator alloc_;
+  [[no_unique_address]] Stats stats_;
 };
 
+// Remove every element matching pred (or equal to value) in a single pass,
+// keeping the order of the rest, and return the number removed.
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats, typename Pred>
+constexpr std::size_t erase_if(Vector<T, Allocator, GrowthPolicy, Stats>& vec, Pred pred);
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats, typename U = T>
+constexpr std::size_t erase(Vector<T, Allocator, GrowthPolicy, Stats>& vec, const U& value);
+
 }  // namespace utils
 
 #include "vector.tpp"
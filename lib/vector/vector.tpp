@@ -1,9 +1,14 @@
 // Copyright 2024 Gregory Tolmachev
 
+#include <algorithm>
 #include <cmath>
+#include <compare>
 #include <cstddef>
+#include <cstring>
+#include <functional>
 #include <limits>
 #include <memory>
+#include <ranges>
 #include <stdexcept>
 #include <utility>
 
@@ -11,23 +16,22 @@
 
 namespace utils {
 
-constexpr std::size_t kMinSize = 8;
-constexpr double kSizeMultiplyer = 2;
-
 // Constructors / Destructor
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector(const Allocator& alloc)
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Vector(const Allocator& alloc)
     : size_(0), data_(nullptr), capacity_(0), alloc_(alloc) {}
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector(std::size_t size, const T& val, const Allocator& alloc)
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Vector(std::size_t size, const T& val, const Allocator& alloc)
     : size_(size), capacity_(size), alloc_(alloc) {
   this->data_ = alloc_traits::allocate(this->alloc_, size);
+  this->stats_.on_allocate(size);
   try {
     for (std::size_t i = 0; i < size; ++i) {
       alloc_traits::construct(this->alloc_, this->data_ + i, val);
     }
+    this->stats_.on_construct(size);
   } catch (...) {
     destroy_range(this->data_, this->data_ + this->size_);
     alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
@@ -35,16 +39,33 @@ Vector<T, Allocator>::Vector(std::size_t size, const T& val, const Allocator& al
   }
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector(const std::initializer_list<T>& list, const Allocator& alloc)
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Vector(std::size_t size, default_init_t,
+                                                            const Allocator& alloc)
+    : size_(size), capacity_(size), alloc_(alloc) {
+  this->data_ = alloc_traits::allocate(this->alloc_, size);
+  this->stats_.on_allocate(size);
+  try {
+    detail::uninitialized_default_construct_n(this->alloc_, this->data_, size);
+    this->stats_.on_construct(size);
+  } catch (...) {
+    alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
+    throw;
+  }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Vector(const std::initializer_list<T>& list, const Allocator& alloc)
     : size_(list.size()), capacity_(list.size()), alloc_(alloc) {
   this->data_ = alloc_traits::allocate(this->alloc_, list.size());
+  this->stats_.on_allocate(list.size());
   try {
     std::size_t i = 0;
     for (const auto& item : list) {
       alloc_traits::construct(this->alloc_, this->data_ + i, item);
       ++i;
     }
+    this->stats_.on_construct(list.size());
   } catch (...) {
     destroy_range(this->data_, this->data_ + this->size_);
     alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
@@ -52,16 +73,18 @@ Vector<T, Allocator>::Vector(const std::initializer_list<T>& list, const Allocat
   }
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector(const Vector& obj)
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Vector(const Vector& obj)
     : size_(obj.size_),
       capacity_(obj.size_),
       alloc_(alloc_traits::select_on_container_copy_construction(obj.alloc_)) {
   this->data_ = alloc_traits::allocate(this->alloc_, obj.size_);
+  this->stats_.on_allocate(obj.size_);
   try {
     for (std::size_t i = 0; i < obj.size_; ++i) {
       alloc_traits::construct(this->alloc_, this->data_ + i, obj.data_[i]);
     }
+    this->stats_.on_construct(obj.size_);
   } catch (...) {
     destroy_range(this->data_, this->data_ + this->size_);
     alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
@@ -69,14 +92,16 @@ Vector<T, Allocator>::Vector(const Vector& obj)
   }
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector(const Vector& obj, const Allocator& alloc)
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Vector(const Vector& obj, const Allocator& alloc)
     : size_(obj.size_), capacity_(obj.size_), alloc_(alloc) {
   this->data_ = alloc_traits::allocate(this->alloc_, obj.size_);
+  this->stats_.on_allocate(obj.size_);
   try {
     for (std::size_t i = 0; i < obj.size_; ++i) {
       alloc_traits::construct(this->alloc_, this->data_ + i, obj.data_[i]);
     }
+    this->stats_.on_construct(obj.size_);
   } catch (...) {
     destroy_range(this->data_, this->data_ + this->size_);
     alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
@@ -84,8 +109,8 @@ Vector<T, Allocator>::Vector(const Vector& obj, const Allocator& alloc)
   }
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector(Vector&& other) noexcept
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Vector(Vector&& other) noexcept
     : size_(other.size_),
       data_(other.data_),
       capacity_(other.capacity_),
@@ -95,25 +120,26 @@ Vector<T, Allocator>::Vector(Vector&& other) noexcept
   other.capacity_ = 0;
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Vector(Vector&& other, const Allocator& alloc) {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Vector(Vector&& other, const Allocator& alloc)
+    : size_(0), data_(nullptr), capacity_(0), alloc_(alloc) {
   if (alloc == other.alloc_) {
     this->size_ = other.size_;
     this->data_ = other.data_;
     this->capacity_ = other.capacity_;
-    this->alloc_ = alloc;
     other.size_ = 0;
     other.data_ = nullptr;
     other.capacity_ = 0;
   } else {
     this->size_ = other.size_;
     this->capacity_ = other.size_;
-    this->alloc_ = alloc;
     this->data_ = alloc_traits::allocate(this->alloc_, other.size_);
+    this->stats_.on_allocate(other.size_);
     try {
       for (std::size_t i = 0; i < other.size_; ++i) {
         alloc_traits::construct(this->alloc_, this->data_ + i, std::move(other.data_[i]));
       }
+      this->stats_.on_construct(other.size_);
       other.clear();
     } catch (...) {
       destroy_range(this->data_, this->data_ + this->size_);
@@ -123,16 +149,81 @@ Vector<T, Allocator>::Vector(Vector&& other, const Allocator& alloc) {
   }
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>& Vector<T, Allocator>::operator=(const Vector& obj) {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <chunk_executor Executor>
+Vector<T, Allocator, GrowthPolicy, Stats>::Vector(const Executor& executor, std::size_t size,
+                                                  const T& val, const Allocator& alloc)
+    : size_(size), capacity_(size), alloc_(alloc) {
+  this->data_ = alloc_traits::allocate(this->alloc_, size);
+  this->stats_.on_allocate(size);
+  try {
+    detail::construct_chunks(executor, this->alloc_, this->data_, size, [this, &val](T* p, std::size_t) {
+      alloc_traits::construct(this->alloc_, p, val);
+    });
+    this->stats_.on_construct(size);
+  } catch (...) {
+    alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
+    throw;
+  }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <chunk_executor Executor>
+Vector<T, Allocator, GrowthPolicy, Stats>::Vector(const Executor& executor, const Vector& obj)
+    : size_(obj.size_),
+      capacity_(obj.size_),
+      alloc_(alloc_traits::select_on_container_copy_construction(obj.alloc_)) {
+  this->data_ = alloc_traits::allocate(this->alloc_, obj.size_);
+  this->stats_.on_allocate(obj.size_);
+  try {
+    detail::construct_chunks(executor, this->alloc_, this->data_, obj.size_,
+                             [this, &obj](T* p, std::size_t i) {
+                               alloc_traits::construct(this->alloc_, p, obj.data_[i]);
+                             });
+    this->stats_.on_construct(obj.size_);
+  } catch (...) {
+    alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
+    throw;
+  }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <chunk_executor Executor>
+Vector<T, Allocator, GrowthPolicy, Stats>::Vector(const Executor& executor, Vector&& other,
+                                                  const Allocator& alloc)
+    : size_(0), data_(nullptr), capacity_(0), alloc_(alloc) {
+  if (alloc == other.alloc_) {
+    swap(other);
+    return;
+  }
+  this->data_ = alloc_traits::allocate(this->alloc_, other.size_);
+  this->capacity_ = other.size_;
+  this->stats_.on_allocate(other.size_);
+  try {
+    detail::construct_chunks(executor, this->alloc_, this->data_, other.size_,
+                             [this, &other](T* p, std::size_t i) {
+                               alloc_traits::construct(this->alloc_, p, std::move(other.data_[i]));
+                             });
+  } catch (...) {
+    alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
+    throw;
+  }
+  this->size_ = other.size_;
+  this->stats_.on_construct(other.size_);
+  other.clear();
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>& Vector<T, Allocator, GrowthPolicy, Stats>::operator=(const Vector& obj) {
   if (this != &obj) {
-    if (alloc_traits::propagate_on_container_copy_assignment::value &&
-        this->alloc_ != obj.alloc_) {
-      clear();
-      alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
-      this->alloc_ = obj.alloc_;
-      this->data_ = nullptr;
-      this->capacity_ = 0;
+    if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+      if (this->alloc_ != obj.alloc_) {
+        clear();
+        alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
+        this->alloc_ = obj.alloc_;
+        this->data_ = nullptr;
+        this->capacity_ = 0;
+      }
     }
     if (this->alloc_ != obj.alloc_) {
       Vector tmp(this->alloc_);
@@ -141,17 +232,19 @@ Vector<T, Allocator>& Vector<T, Allocator>::operator=(const Vector& obj) {
       for (std::size_t i = 0; i < obj.size_; ++i) {
         tmp.push_back(obj.data_[i]);
       }
+      this->stats_.merge(tmp.stats_);
       swap(tmp);
     } else {
       Vector tmp(obj, this->alloc_);
+      this->stats_.merge(tmp.stats_);
       swap(tmp);
     }
   }
   return *this;
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>& Vector<T, Allocator>::operator=(Vector&& other) 
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>& Vector<T, Allocator, GrowthPolicy, Stats>::operator=(Vector&& other) 
     noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
              alloc_traits::is_always_equal::value) {
   if (this != &other) {
@@ -159,7 +252,7 @@ Vector<T, Allocator>& Vector<T, Allocator>::operator=(Vector&& other)
         this->alloc_ == other.alloc_) {
       clear();
       alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
-      if (alloc_traits::propagate_on_container_move_assignment::value) {
+      if constexpr (alloc_traits::propagate_on_container_move_assignment::value) {
         this->alloc_ = std::move(other.alloc_);
       }
       this->data_ = other.data_;
@@ -169,15 +262,22 @@ Vector<T, Allocator>& Vector<T, Allocator>::operator=(Vector&& other)
       other.size_ = 0;
       other.capacity_ = 0;
     } else {
-      assign(std::make_move_iterator(other.begin()),
-             std::make_move_iterator(other.end()));
+      assign(std::make_move_iterator(other.data_),
+             std::make_move_iterator(other.data_ + other.size_));
     }
   }
   return *this;
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::~Vector() {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>& Vector<T, Allocator, GrowthPolicy, Stats>::operator=(
+    const std::initializer_list<T>& list) {
+  assign(list.begin(), list.end());
+  return *this;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::~Vector() {
   clear();
   if (this->data_) {
     alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
@@ -185,43 +285,77 @@ Vector<T, Allocator>::~Vector() {
 }
 
 // Private helper methods
-template <typename T, typename Allocator>
-void Vector<T, Allocator>::destroy_range(T* first, T* last) noexcept {
-  for (T* p = first; p != last; ++p) {
-    alloc_traits::destroy(this->alloc_, p);
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::destroy_range(T* first, T* last) noexcept {
+  detail::destroy_n(this->alloc_, first, static_cast<std::size_t>(last - first));
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::reallocate(std::size_t new_cap) {
+  if constexpr (detail::reallocates_in_place<T, Allocator>) {
+    if (this->data_) {
+      this->data_ = this->alloc_.reallocate(this->data_, this->capacity_, new_cap);
+      this->capacity_ = new_cap;
+      this->stats_.on_reallocate(new_cap, 0);
+      return;
+    }
+  }
+  const bool had_buffer = this->data_ != nullptr;
+  detail::grow_buffer(this->alloc_, this->data_, this->capacity_, this->size_, had_buffer,
+                      new_cap);
+  if (had_buffer) {
+    this->stats_.on_reallocate(this->capacity_, this->size_);
+  } else {
+    this->stats_.on_allocate(this->capacity_);
   }
 }
 
-template <typename T, typename Allocator>
-void Vector<T, Allocator>::reallocate(std::size_t new_cap) {
-  T* new_data = alloc_traits::allocate(this->alloc_, new_cap);
-  std::size_t old_size = this->size_;
-  
-  try {
-    for (std::size_t i = 0; i < this->size_; ++i) {
-      alloc_traits::construct(this->alloc_, new_data + i, std::move(this->data_[i]));
-    }
-  } catch (...) {
-    destroy_range(new_data, new_data + old_size);
-    alloc_traits::deallocate(this->alloc_, new_data, new_cap);
-    throw;
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr std::size_t Vector<T, Allocator, GrowthPolicy, Stats>::next_capacity(std::size_t required) const {
+  if (required > max_size()) {
+    throw std::length_error("Vector size exceeds max_size()");
   }
-  
-  destroy_range(this->data_, this->data_ + this->size_);
-  alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
-  
-  this->data_ = new_data;
-  this->capacity_ = new_cap;
+  return GrowthPolicy::template next_capacity<T>(this->capacity_, required,
+                                                 max_size());
 }
 
-template <typename T, typename Allocator>
-void Vector<T, Allocator>::reserve(std::size_t malloc) {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::reserve(std::size_t malloc) {
   if (malloc <= this->capacity_) return;
+  if (malloc > max_size()) {
+    throw std::length_error("Vector size exceeds max_size()");
+  }
   reallocate(malloc);
 }
 
-template <typename T, typename Allocator>
-void Vector<T, Allocator>::shrink_to_fit() {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr const T& Vector<T, Allocator, GrowthPolicy, Stats>::reserve_keeping(std::size_t malloc,
+                                                                    const T& val) {
+  const T* source = std::addressof(val);
+  if consteval {
+    // Pointers into different objects cannot be ordered during constant
+    // evaluation, but they can be compared for equality.
+    for (std::size_t i = 0; i < this->size_; ++i) {
+      if (source == this->data_ + i) {
+        reserve(malloc);
+        return this->data_[i];
+      }
+    }
+    reserve(malloc);
+    return val;
+  }
+  std::less<const T*> less;
+  if (less(source, this->data_) || !less(source, this->data_ + this->size_)) {
+    reserve(malloc);
+    return val;
+  }
+  const std::size_t index = static_cast<std::size_t>(source - this->data_);
+  reserve(malloc);
+  return this->data_[index];
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::shrink_to_fit() {
   if (this->size_ == this->capacity_) {
     return;
   }
@@ -232,172 +366,214 @@ void Vector<T, Allocator>::shrink_to_fit() {
     this->capacity_ = 0;
     return;
   }
+  if constexpr (detail::reallocates_in_place<T, Allocator>) {
+    reallocate(this->size_);
+    return;
+  }
 
   T* new_data = alloc_traits::allocate(this->alloc_, this->size_);
   try {
-    for (std::size_t i = 0; i < this->size_; ++i) {
-      alloc_traits::construct(this->alloc_, new_data + i, std::move(this->data_[i]));
-    }
+    detail::relocate(this->alloc_, this->data_, this->size_, new_data);
   } catch (...) {
     alloc_traits::deallocate(this->alloc_, new_data, this->size_);
     throw;
   }
 
-  destroy_range(this->data_, this->data_ + this->size_);
   alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
+  this->stats_.on_reallocate(this->size_, this->size_);
   
   this->data_ = new_data;
   this->capacity_ = this->size_;
 }
 
-template <typename T, typename Allocator>
-void Vector<T, Allocator>::clear() noexcept {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::clear() noexcept {
   destroy_range(this->data_, this->data_ + this->size_);
+  this->stats_.on_destroy(this->size_);
   this->size_ = 0;
 }
 
-template <typename T, typename Allocator>
-void Vector<T, Allocator>::push_back(const T& obj) {
-  if (this->size_ >= this->capacity_) {
-    reserve(this->capacity_ == 0 ? 1 : this->capacity_ + 1);
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <typename Build>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::realloc_insert(std::size_t pos, std::size_t count,
+                                                        Build&& build) {
+  const bool had_buffer = this->data_ != nullptr;
+  detail::grow_buffer(this->alloc_, this->data_, this->capacity_, this->size_, had_buffer,
+                      next_capacity(this->size_ + count), pos, count, std::forward<Build>(build));
+  if (had_buffer) {
+    this->stats_.on_reallocate(this->capacity_, this->size_);
+  } else {
+    this->stats_.on_allocate(this->capacity_);
   }
-  alloc_traits::construct(this->alloc_, this->data_ + this->size_, obj);
-  ++this->size_;
+  if (pos != this->size_) {
+    this->stats_.on_slow_insert();
+  }
+  this->stats_.on_construct(count);
+  this->size_ += count;
 }
 
-template <typename T, typename Allocator>
-void Vector<T, Allocator>::push_back(T&& obj) {
-  if (this->size_ >= this->capacity_) {
-    reserve(this->capacity_ == 0 ? 1 : this->capacity_ + 1);
-  }
-  alloc_traits::construct(this->alloc_, this->data_ + this->size_, std::move(obj));
-  ++this->size_;
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::push_back(const T& obj) {
+  emplace_back(obj);
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::push_back(T&& obj) {
+  emplace_back(std::move(obj));
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
 template<typename... Args>
-T& Vector<T, Allocator>::emplace_back(Args&&... args) {
+constexpr T& Vector<T, Allocator, GrowthPolicy, Stats>::emplace_back(Args&&... args) {
+  if constexpr (detail::reallocates_in_place<T, Allocator>) {
+    if (this->size_ >= this->capacity_ && this->data_) {
+      // args may refer to an element, so the value is built before the
+      // block moves and then relocated bytewise into place.
+      alignas(T) unsigned char buffer[sizeof(T)];
+      T* value = reinterpret_cast<T*>(buffer);
+      alloc_traits::construct(this->alloc_, value, std::forward<Args>(args)...);
+      try {
+        reallocate(next_capacity(this->size_ + 1));
+      } catch (...) {
+        alloc_traits::destroy(this->alloc_, value);
+        throw;
+      }
+      std::memcpy(static_cast<void*>(this->data_ + this->size_),
+                  static_cast<const void*>(value), sizeof(T));
+      this->stats_.on_construct(1);
+      return this->data_[this->size_++];
+    }
+  }
   if (this->size_ >= this->capacity_) {
-    reserve(this->capacity_ == 0 ? 1 : this->capacity_ + 1);
+    const std::size_t pos = this->size_;
+    realloc_insert(pos, 1, [&](T* dest) {
+      alloc_traits::construct(this->alloc_, dest, std::forward<Args>(args)...);
+    });
+    return this->data_[pos];
   }
   alloc_traits::construct(this->alloc_, this->data_ + this->size_, std::forward<Args>(args)...);
+  this->stats_.on_construct(1);
   return this->data_[this->size_++];
 }
 
-// Iterators:
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator::Iterator(pointer obj) : current_(obj) {}
-
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator& Vector<T, Allocator>::Iterator::operator++() {
-  ++this->current_;
-  return *this;
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <typename Remove>
+constexpr std::size_t Vector<T, Allocator, GrowthPolicy, Stats>::remove_where(Remove&& remove) {
+  const std::size_t old_size = this->size_;
+  try {
+    const std::size_t removed = detail::remove_in_place(this->alloc_, this->data_, this->size_,
+                                                        std::forward<Remove>(remove));
+    this->stats_.on_destroy(removed);
+    return removed;
+  } catch (...) {
+    this->stats_.on_destroy(old_size - this->size_);
+    throw;
+  }
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator& Vector<T, Allocator>::Iterator::operator+=(const Iterator& other) {
-  this->current_ += other.current_;
+// Iterators:
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <bool Const>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::BasicIterator(pointer obj) noexcept : current_(obj) {}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <bool Const>
+template <bool OtherConst>
+  requires(Const && !OtherConst)
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::BasicIterator(const BasicIterator<OtherConst>& other) noexcept
+    : current_(other.current_) {}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <bool Const>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>& Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::operator++() noexcept {
+  ++this->current_;
   return *this;
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator Vector<T, Allocator>::Iterator::operator+(
-    const Iterator& other) const {
-  return Iterator(this->current_ + other.current_);
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <bool Const>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const> Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::operator++(int) noexcept {
+  return BasicIterator(this->current_++);
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator& Vector<T, Allocator>::Iterator::operator+=(difference_type size) {
-  this->current_ += size;
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <bool Const>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>& Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::operator--() noexcept {
+  --this->current_;
   return *this;
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator Vector<T, Allocator>::Iterator::operator+(
-    difference_type size) const {
-  return Iterator(this->current_ + size);
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <bool Const>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const> Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::operator--(int) noexcept {
+  return BasicIterator(this->current_--);
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator& Vector<T, Allocator>::Iterator::operator--() {
-  --this->current_;
-  return *this;
-}
-
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator& Vector<T, Allocator>::Iterator::operator-=(const Iterator& other) {
-  this->current_ -= other.current_;
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <bool Const>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>& Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::operator+=(difference_type size) noexcept {
+  this->current_ += size;
   return *this;
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator::difference_type Vector<T, Allocator>::Iterator::operator-(
-    const Iterator& other) const {
-  return this->current_ - other.current_;
-}
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator Vector<T, Allocator>::Iterator::operator-(
-    difference_type size) const {
-  return Iterator(this->current_ - size);
-}
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator& Vector<T, Allocator>::Iterator::operator-=(difference_type size) {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <bool Const>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>& Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::operator-=(difference_type size) noexcept {
   this->current_ -= size;
   return *this;
 }
 
-template <typename T, typename Allocator>
-typename Vector<T, Allocator>::Iterator::pointer Vector<T, Allocator>::Iterator::operator->() {
-    return current_;
-}
-
-template <typename T, typename Allocator>
-typename Vector<T, Allocator>::Iterator::reference Vector<T, Allocator>::Iterator::operator*() const {
-    return *current_;
-}
-
-template <typename T, typename Allocator>
-bool Vector<T, Allocator>::Iterator::operator==(const Iterator& obj) const {
-  return this->current_ == obj.current_;
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <bool Const>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const> Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::operator+(difference_type size) const noexcept {
+  return BasicIterator(this->current_ + size);
 }
 
-template <typename T, typename Allocator>
-bool Vector<T, Allocator>::Iterator::operator!=(const Iterator& obj) const {
-  return this->current_ != obj.current_;
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <bool Const>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const> Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::operator-(difference_type size) const noexcept {
+  return BasicIterator(this->current_ - size);
 }
 
-template <typename T, typename Allocator>
-bool Vector<T, Allocator>::Iterator::operator<(const Iterator& other) const {
-  return this->current_ < other.current_;
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <bool Const>
+constexpr typename Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::reference Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::operator*() const noexcept {
+  return *this->current_;
 }
 
-template <typename T, typename Allocator>
-bool Vector<T, Allocator>::Iterator::operator>(const Iterator& other) const {
-  return this->current_ > other.current_;
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <bool Const>
+constexpr typename Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::pointer Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::operator->() const noexcept {
+  return this->current_;
 }
 
-template <typename T, typename Allocator>
-bool Vector<T, Allocator>::Iterator::operator<=(const Iterator& other) const {
-  return this->current_ <= other.current_;
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <bool Const>
+constexpr bool Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::operator==(const BasicIterator& obj) const noexcept {
+  return this->current_ == obj.current_;
 }
 
-template <typename T, typename Allocator>
-bool Vector<T, Allocator>::Iterator::operator>=(const Iterator& other) const {
-  return this->current_ >= other.current_;
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <bool Const>
+constexpr std::strong_ordering Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::operator<=>(
+    const BasicIterator& other) const noexcept {
+  return this->current_ <=> other.current_;
 }
 
-template <typename T, typename Allocator>
-std::size_t Vector<T, Allocator>::Iterator::distance(const Iterator& begin,
-                                          const Iterator& end) {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <bool Const>
+constexpr std::size_t Vector<T, Allocator, GrowthPolicy, Stats>::BasicIterator<Const>::distance(const BasicIterator& begin, const BasicIterator& end) {
   return end - begin;
 }
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
 template <class InputIterator>
-Vector<T, Allocator>::Vector(InputIterator first, InputIterator last,
+  requires(!std::is_integral_v<InputIterator>)
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Vector(InputIterator first, InputIterator last,
                             const Allocator& alloc) : alloc_(alloc) {
   const std::size_t count = std::distance(first, last);
   this->data_ = alloc_traits::allocate(this->alloc_, count);
+  this->stats_.on_allocate(count);
   this->size_ = 0;
   this->capacity_ = count;
   
@@ -406,6 +582,7 @@ Vector<T, Allocator>::Vector(InputIterator first, InputIterator last,
       alloc_traits::construct(this->alloc_, this->data_ + this->size_, *first);
       ++this->size_;
     }
+    this->stats_.on_construct(this->size_);
   } catch (...) {
     destroy_range(this->data_, this->data_ + this->size_);
     alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
@@ -413,252 +590,407 @@ Vector<T, Allocator>::Vector(InputIterator first, InputIterator last,
   }
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator Vector<T, Allocator>::begin() {
-  return Vector<T, Allocator>::Iterator(Iterator(this->data_));
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Iterator Vector<T, Allocator, GrowthPolicy, Stats>::begin() noexcept {
+  return Iterator(this->data_);
 }
 
-template <typename T, typename Allocator>
-const Vector<T, Allocator>::Iterator Vector<T, Allocator>::begin() const {
-  return Vector<T, Allocator>::Iterator(Iterator(this->data_));
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::ConstIterator Vector<T, Allocator, GrowthPolicy, Stats>::begin() const noexcept {
+  return ConstIterator(this->data_);
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator Vector<T, Allocator>::end() {
-  return Vector<T, Allocator>::Iterator(Iterator(this->data_ + this->size_));
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Iterator Vector<T, Allocator, GrowthPolicy, Stats>::end() noexcept {
+  return Iterator(this->data_ + this->size_);
 }
 
-template <typename T, typename Allocator>
-const Vector<T, Allocator>::Iterator Vector<T, Allocator>::end() const {
-  return Vector<T, Allocator>::Iterator(Iterator(this->data_ + this->size_));
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::ConstIterator Vector<T, Allocator, GrowthPolicy, Stats>::end() const noexcept {
+  return ConstIterator(this->data_ + this->size_);
 }
 
-template <typename T, typename Allocator>
-const Vector<T, Allocator>::Iterator Vector<T, Allocator>::cbegin() const {
-  return Vector<T, Allocator>::Iterator(Iterator(this->data_));
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::ConstIterator Vector<T, Allocator, GrowthPolicy, Stats>::cbegin() const noexcept {
+  return begin();
 }
 
-template <typename T, typename Allocator>
-const Vector<T, Allocator>::Iterator Vector<T, Allocator>::cend() const {
-  return Vector<T, Allocator>::Iterator(Iterator(this->data_ + this->size_));
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::ConstIterator Vector<T, Allocator, GrowthPolicy, Stats>::cend() const noexcept {
+  return end();
 }
 
 // Capacity:
 
-template <typename T, typename Allocator>
-std::size_t Vector<T, Allocator>::size() const {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr std::size_t Vector<T, Allocator, GrowthPolicy, Stats>::size() const {
   return this->size_;
 }
 
-template <typename T, typename Allocator>
-std::size_t Vector<T, Allocator>::max_size() const {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr std::size_t Vector<T, Allocator, GrowthPolicy, Stats>::max_size() const {
   return std::numeric_limits<std::size_t>::max() / sizeof(T);
 }
 
-template <typename T, typename Allocator>
-void Vector<T, Allocator>::resize(std::size_t size, const T& val) {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::resize(std::size_t size, const T& val) {
   if (size < this->size_) {
     destroy_range(this->data_ + size, this->data_ + this->size_);
+    this->stats_.on_destroy(this->size_ - size);
   } else if (size > this->size_) {
-    reserve(size);
-    for (std::size_t i = this->size_; i < size; ++i) {
-      alloc_traits::construct(this->alloc_, this->data_ + i, val);
+    const T& value = reserve_keeping(size, val);
+    std::size_t i = this->size_;
+    try {
+      for (; i < size; ++i) {
+        alloc_traits::construct(this->alloc_, this->data_ + i, value);
+      }
+    } catch (...) {
+      destroy_range(this->data_ + this->size_, this->data_ + i);
+      throw;
     }
+    this->stats_.on_construct(size - this->size_);
+  }
+  this->size_ = size;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <chunk_executor Executor>
+void Vector<T, Allocator, GrowthPolicy, Stats>::resize(const Executor& executor, std::size_t size,
+                                                       const T& val) {
+  if (size <= this->size_) {
+    resize(size, val);
+    return;
+  }
+  const T& value = reserve_keeping(size, val);
+  detail::construct_chunks(executor, this->alloc_, this->data_ + this->size_, size - this->size_,
+                           [this, &value](T* p, std::size_t) {
+                             alloc_traits::construct(this->alloc_, p, value);
+                           });
+  this->stats_.on_construct(size - this->size_);
+  this->size_ = size;
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::resize_for_overwrite(std::size_t size) {
+  if (size <= this->size_) {
+    truncate(size);
+    return;
   }
+  reserve(size);
+  detail::uninitialized_default_construct_n(this->alloc_, this->data_ + this->size_,
+                                            size - this->size_);
+  this->stats_.on_construct(size - this->size_);
   this->size_ = size;
 }
 
-template <typename T, typename Allocator>
-std::size_t Vector<T, Allocator>::capacity() const {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <typename Operation>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::resize_and_overwrite(std::size_t size,
+                                                                              Operation op) {
+  const std::size_t old_size = this->size_;
+  if (size > old_size) {
+    resize_for_overwrite(size);
+  }
+  std::size_t kept;
+  try {
+    kept = static_cast<std::size_t>(std::move(op)(this->data_, size));
+  } catch (...) {
+    truncate(old_size);
+    throw;
+  }
+  if (kept > size) {
+    truncate(size);
+    throw std::length_error("resize_and_overwrite kept more elements than it was given");
+  }
+  truncate(kept);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::truncate(std::size_t size) noexcept {
+  if (size < this->size_) {
+    destroy_range(this->data_ + size, this->data_ + this->size_);
+    this->stats_.on_destroy(this->size_ - size);
+    this->size_ = size;
+  }
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr std::size_t Vector<T, Allocator, GrowthPolicy, Stats>::capacity() const {
   return this->capacity_;
 }
 
-template <typename T, typename Allocator>
-bool Vector<T, Allocator>::empty() const {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr bool Vector<T, Allocator, GrowthPolicy, Stats>::empty() const {
   return (this->size_ == 0);
 }
 
-template <typename T, typename Allocator>
-T& Vector<T, Allocator>::operator[](std::size_t i) {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr T& Vector<T, Allocator, GrowthPolicy, Stats>::operator[](std::size_t i) {
   return this->data_[i];
 }
 
-template <typename T, typename Allocator>
-const T& Vector<T, Allocator>::operator[](std::size_t i) const {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr const T& Vector<T, Allocator, GrowthPolicy, Stats>::operator[](std::size_t i) const {
   return this->data_[i];
 }
 
-template <typename T, typename Allocator>
-T& Vector<T, Allocator>::at(std::size_t i) {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr T& Vector<T, Allocator, GrowthPolicy, Stats>::at(std::size_t i) {
   if (i >= this->size_) {
     throw std::out_of_range("");
   }
   return this->data_[i];
 }
 
-template <typename T, typename Allocator>
-const T& Vector<T, Allocator>::at(std::size_t i) const {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr const T& Vector<T, Allocator, GrowthPolicy, Stats>::at(std::size_t i) const {
   if (i >= this->size_) {
     throw std::out_of_range("");
   }
   return this->data_[i];
 }
 
-template <typename T, typename Allocator>
-T& Vector<T, Allocator>::front() {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr T& Vector<T, Allocator, GrowthPolicy, Stats>::front() {
   return this->data_[0];
 }
 
-template <typename T, typename Allocator>
-const T& Vector<T, Allocator>::front() const {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr const T& Vector<T, Allocator, GrowthPolicy, Stats>::front() const {
   return this->data_[0];
 }
 
-template <typename T, typename Allocator>
-T& Vector<T, Allocator>::back() {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr T& Vector<T, Allocator, GrowthPolicy, Stats>::back() {
   return this->data_[this->size_ - 1];
 }
 
-template <typename T, typename Allocator>
-const T& Vector<T, Allocator>::back() const {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr const T& Vector<T, Allocator, GrowthPolicy, Stats>::back() const {
   return this->data_[this->size_ - 1];
 }
 
-template <typename T, typename Allocator>
-T* Vector<T, Allocator>::data() {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr T* Vector<T, Allocator, GrowthPolicy, Stats>::data() {
   return this->data_;
 }
 
-template <typename T, typename Allocator>
-const T* Vector<T, Allocator>::data() const {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr const T* Vector<T, Allocator, GrowthPolicy, Stats>::data() const {
   return this->data_;
 }
 
 
-template <typename T, typename Allocator>
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
 template <std::input_iterator InputIterator>
-void Vector<T, Allocator>::assign(InputIterator first, InputIterator last) {
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::assign(InputIterator first, InputIterator last) {
   Vector tmp(first, last, alloc_);
+  this->stats_.merge(tmp.stats_);
   swap(tmp);
 }
 
-template <typename T, typename Allocator>
-void Vector<T, Allocator>::assign(std::size_t size, const T& val) {
-  clear();
-  if (size > 0) {
-    this->data_ = alloc_traits::allocate(this->alloc_, size);
-    try {
-      for (std::size_t i = 0; i < size; ++i) {
-        alloc_traits::construct(this->alloc_, this->data_ + i, val);
-      }
-      this->size_ = size;
-      this->capacity_ = size;
-    } catch (...) {
-      destroy_range(this->data_, this->data_ + this->size_);
-      alloc_traits::deallocate(this->alloc_, this->data_, this->capacity_);
-      throw;
-    }
-  }
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::assign(std::size_t size, const T& val) {
+  Vector tmp(size, val, alloc_);
+  this->stats_.merge(tmp.stats_);
+  swap(tmp);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <chunk_executor Executor>
+void Vector<T, Allocator, GrowthPolicy, Stats>::assign(const Executor& executor, std::size_t size,
+                                                       const T& val) {
+  Vector tmp(executor, size, val, alloc_);
+  this->stats_.merge(tmp.stats_);
+  swap(tmp);
 }
 
-template <typename T, typename Allocator>
-void Vector<T, Allocator>::pop_back() {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::pop_back() {
   if (this->size_ == 0) {
     throw std::out_of_range("Trying to pop from empty Vector.");
   }
-  this->data_[this->size_--].~T();
+  --this->size_;
+  alloc_traits::destroy(this->alloc_, this->data_ + this->size_);
+  this->stats_.on_destroy(1);
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator Vector<T, Allocator>::erase(const Iterator position) {
-  if (position < position->begin() || position >= position->end()) {
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Iterator Vector<T, Allocator, GrowthPolicy, Stats>::erase(ConstIterator position) {
+  const std::size_t index = position - cbegin();
+  if (index >= this->size_) {
     throw std::out_of_range("Iterator out of range");
   }
-  std::size_t index = position.current_ - this->data_;
-  data_[index].~T();
-  for (std::size_t i = index; i < this->size_ - 1; ++i) {
-    this->data_[i] = std::move(this->data_[i + 1]);
+  detail::erase_in_place(this->alloc_, this->data_, this->size_, index, 1);
+  this->stats_.on_destroy(1);
+
+  return Iterator(this->data_ + index);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Iterator Vector<T, Allocator, GrowthPolicy, Stats>::erase(ConstIterator first, ConstIterator last) {
+  const std::size_t from = first - cbegin();
+  const std::size_t to = last - cbegin();
+  if (from > to || to > this->size_) {
+    throw std::out_of_range("Iterator out of range");
+  }
+  if (from != to) {
+    detail::erase_in_place(this->alloc_, this->data_, this->size_, from, to - from);
+    this->stats_.on_destroy(to - from);
   }
-  --this->size_;
 
-  return (index < this->size_) ? Iterator(this->data_ + index)
-                               : position->end();
+  return Iterator(this->data_ + from);
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator Vector<T, Allocator>::insert(const Iterator position, T&& val) {
-  const std::size_t pos = position - begin();
-  if (pos == size_) {
-    push_back(std::move(val));
-    return Iterator(data_ + pos);
-  } else {
-    Vector tmp(alloc_);
-    tmp.reserve(size_ + 1);
-    for (std::size_t i = 0; i < pos; ++i) {
-      alloc_traits::construct(tmp.alloc_, tmp.data_ + i, std::move(data_[i]));
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Iterator Vector<T, Allocator, GrowthPolicy, Stats>::unordered_erase(ConstIterator position) {
+  const std::size_t index = position - cbegin();
+  if (index >= this->size_) {
+    throw std::out_of_range("Iterator out of range");
+  }
+  detail::unordered_erase_in_place(this->alloc_, this->data_, this->size_, index);
+  this->stats_.on_destroy(1);
+
+  return Iterator(this->data_ + index);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <std::ranges::forward_range Indices>
+  requires std::integral<std::ranges::range_value_t<Indices>>
+constexpr std::size_t Vector<T, Allocator, GrowthPolicy, Stats>::erase_indices(Indices&& indices) {
+  bool first = true;
+  std::size_t previous = 0;
+  for (const auto index : indices) {
+    if (std::cmp_less(index, 0) || std::cmp_greater_equal(index, this->size_)) {
+      throw std::out_of_range("Index out of range");
     }
-    alloc_traits::construct(tmp.alloc_, tmp.data_ + pos, std::move(val));
-    for (std::size_t i = pos; i < size_; ++i) {
-      alloc_traits::construct(tmp.alloc_, tmp.data_ + i + 1, std::move(data_[i]));
+    if (!first && static_cast<std::size_t>(index) <= previous) {
+      throw std::invalid_argument("Indices must be strictly increasing");
     }
-    tmp.size_ = size_ + 1;
-    swap(tmp);
-    return Iterator(data_ + pos);
+    previous = static_cast<std::size_t>(index);
+    first = false;
   }
+  auto next = std::ranges::begin(indices);
+  const auto stop = std::ranges::end(indices);
+  return remove_where([&](const T&, std::size_t i) {
+    if (next == stop || static_cast<std::size_t>(*next) != i) {
+      return false;
+    }
+    ++next;
+    return true;
+  });
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Iterator Vector<T, Allocator, GrowthPolicy, Stats>::insert(ConstIterator position, T&& val) {
+  return emplace(position, std::move(val));
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Iterator Vector<T, Allocator, GrowthPolicy, Stats>::insert(ConstIterator position, const T& val) {
+  return emplace(position, val);
 }
 
-template <typename T, typename Allocator>
-Vector<T, Allocator>::Iterator Vector<T, Allocator>::insert(const Iterator position, const T& val) {
-  const std::size_t pos = position - begin();
-  if (pos == size_) {
-    push_back(val);
-    return Iterator(data_ + pos);
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <typename... Args>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Iterator Vector<T, Allocator, GrowthPolicy, Stats>::emplace(ConstIterator position, Args&&... args) {
+  const std::size_t pos = position - cbegin();
+  if (this->size_ == this->capacity_) {
+    realloc_insert(pos, 1, [&](T* dest) {
+      alloc_traits::construct(this->alloc_, dest, std::forward<Args>(args)...);
+    });
   } else {
-    Vector tmp(alloc_);
-    tmp.reserve(size_ + 1);
-    for (std::size_t i = 0; i < pos; ++i) {
-      alloc_traits::construct(tmp.alloc_, tmp.data_ + i, std::move(data_[i]));
-    }
-    alloc_traits::construct(tmp.alloc_, tmp.data_ + pos, val);
-    for (std::size_t i = pos; i < size_; ++i) {
-      alloc_traits::construct(tmp.alloc_, tmp.data_ + i + 1, std::move(data_[i]));
+    detail::emplace_in_place(this->alloc_, this->data_, this->size_, pos,
+                             std::forward<Args>(args)...);
+    this->stats_.on_construct(1);
+  }
+  return Iterator(this->data_ + pos);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <std::forward_iterator ForwardIterator>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Iterator Vector<T, Allocator, GrowthPolicy, Stats>::insert_forward(
+    std::size_t pos, ForwardIterator first, std::size_t count) {
+  if (count > this->capacity_ - this->size_) {
+    realloc_insert(pos, count, [&](T* dest) {
+      detail::uninitialized_copy_n(this->alloc_, first, count, dest);
+    });
+  } else if (count != 0) {
+    detail::insert_in_place(this->alloc_, this->data_, this->size_, pos, first, count);
+    this->stats_.on_construct(count);
+  }
+  return Iterator(this->data_ + pos);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <std::input_iterator InputIterator>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Iterator Vector<T, Allocator, GrowthPolicy, Stats>::insert(
+    ConstIterator position, InputIterator first, InputIterator last) {
+  const std::size_t pos = position - cbegin();
+  if constexpr (std::forward_iterator<InputIterator>) {
+    return insert_forward(pos, first, static_cast<std::size_t>(std::distance(first, last)));
+  } else {
+    const std::size_t old_size = this->size_;
+    for (; first != last; ++first) {
+      emplace_back(*first);
     }
-    tmp.size_ = size_ + 1;
-    swap(tmp);
-    return Iterator(data_ + pos);
+    std::rotate(this->data_ + pos, this->data_ + old_size, this->data_ + this->size_);
+    return Iterator(this->data_ + pos);
   }
 }
 
-template <typename T, typename Allocator>
-template <typename... Args>
-Vector<T, Allocator>::Iterator Vector<T, Allocator>::emplace(const Iterator position, Args&&... args) {
-  const std::size_t pos = position - begin();
-  if (pos == size_) {
-    alloc_traits::construct(alloc_, data_ + size_, std::forward<Args>(args)...);
-    ++size_;
-    return Iterator(data_ + pos);
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Iterator Vector<T, Allocator, GrowthPolicy, Stats>::insert(
+    ConstIterator position, std::size_t count, const T& val) {
+  // val may refer to an element that is about to be shifted.
+  const T copy(val);
+  auto values = std::views::iota(std::size_t{0}, count) |
+                std::views::transform([&copy](std::size_t) -> const T& { return copy; });
+  return insert_forward(position - cbegin(), values.begin(), count);
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Iterator Vector<T, Allocator, GrowthPolicy, Stats>::insert(
+    ConstIterator position, std::initializer_list<T> list) {
+  return insert_forward(position - cbegin(), list.begin(), list.size());
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <std::ranges::input_range Range>
+constexpr Vector<T, Allocator, GrowthPolicy, Stats>::Iterator Vector<T, Allocator, GrowthPolicy, Stats>::insert_range(
+    ConstIterator position, Range&& range) {
+  if constexpr (std::ranges::forward_range<Range>) {
+    return insert_forward(position - cbegin(), std::ranges::begin(range),
+                          static_cast<std::size_t>(std::ranges::distance(range)));
   } else {
-    Vector tmp(alloc_);
-    tmp.reserve(size_ + 1);
-    for (std::size_t i = 0; i < pos; ++i) {
-      alloc_traits::construct(tmp.alloc_, tmp.data_ + i, std::move(data_[i]));
+    const std::size_t pos = position - cbegin();
+    const std::size_t old_size = this->size_;
+    if constexpr (std::ranges::sized_range<Range>) {
+      const std::size_t count = std::ranges::size(range);
+      if (count > this->capacity_ - this->size_) {
+        reallocate(next_capacity(this->size_ + count));
+      }
     }
-    alloc_traits::construct(tmp.alloc_, tmp.data_ + pos, std::forward<Args>(args)...);
-    for (std::size_t i = pos; i < size_; ++i) {
-      alloc_traits::construct(tmp.alloc_, tmp.data_ + i + 1, std::move(data_[i]));
+    for (auto it = std::ranges::begin(range); it != std::ranges::end(range); ++it) {
+      emplace_back(*it);
     }
-    tmp.size_ = size_ + 1;
-    swap(tmp);
-    return Iterator(data_ + pos);
+    std::rotate(this->data_ + pos, this->data_ + old_size, this->data_ + this->size_);
+    return Iterator(this->data_ + pos);
   }
 }
 
-template <typename T, typename Allocator>
-void Vector<T, Allocator>::swap(Vector& obj) 
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+template <std::ranges::input_range Range>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::append_range(Range&& range) {
+  insert_range(end(), std::forward<Range>(range));
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats>
+constexpr void Vector<T, Allocator, GrowthPolicy, Stats>::swap(Vector& obj) 
     noexcept(alloc_traits::propagate_on_container_swap::value ||
              alloc_traits::is_always_equal::value) {
   using std::swap;
-  if (alloc_traits::propagate_on_container_swap::value) {
+  if constexpr (alloc_traits::propagate_on_container_swap::value) {
     swap(alloc_, obj.alloc_);
   }
   swap(data_, obj.data_);
@@ -666,4 +998,16 @@ void Vector<T, Allocator>::swap(Vector& obj)
   swap(capacity_, obj.capacity_);
 }
 
+// Non-member functions
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats, typename Pred>
+constexpr std::size_t erase_if(Vector<T, Allocator, GrowthPolicy, Stats>& vec, Pred pred) {
+  return vec.remove_where([&pred](T& element, std::size_t) -> bool { return pred(element); });
+}
+
+template <typename T, typename Allocator, typename GrowthPolicy, typename Stats, typename U>
+constexpr std::size_t erase(Vector<T, Allocator, GrowthPolicy, Stats>& vec, const U& value) {
+  return erase_if(vec, [&value](const T& element) -> bool { return element == value; });
+}
+
 }  // namespace utils
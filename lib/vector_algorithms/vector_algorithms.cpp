@@ -0,0 +1,460 @@
+// Copyright 2024 Gregory Tolmachev
+//
+// Kernels are written once with GCC/Clang vector extensions and
+// instantiated per vector width (0 = scalar). Each instruction set gets
+// thin entry points carrying a target attribute and `flatten`, so the
+// kernel is inlined and compiled for that target only. This file is built
+// with -ffp-contract=off: a fused multiply-add in one variant and not in
+// another would break the bit-identical results the header promises.
+
+#include "vector_algorithms.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define UTILS_SIMD_X86 1
+#else
+#define UTILS_SIMD_X86 0
+#endif
+
+namespace utils {
+
+namespace algorithms {
+
+namespace {
+
+// Elements per block; also the number of partial sums in sum() and dot().
+constexpr std::size_t kBlock = 16;
+// count() flushes its per-lane counters this often so they cannot wrap.
+constexpr std::size_t kCountChunk = std::size_t{1} << 20;
+
+template <typename T, std::size_t Bytes>
+struct VectorOf {
+  typedef T type __attribute__((vector_size(Bytes)));
+};
+
+template <typename T>
+using wide_t = std::conditional_t<std::is_integral_v<T>, std::uint64_t, T>;
+
+// Helpers take and return vectors through references only. A vector
+// passed or returned by value has a different ABI with and without
+// AVX/AVX-512, and these helpers are shared by every target.
+
+template <typename V, typename T>
+[[gnu::always_inline]] inline void load(V& v, const T* p) {
+  std::memcpy(&v, p, sizeof(V));
+}
+
+template <typename V, typename T>
+[[gnu::always_inline]] inline void store(T* p, const V& v) {
+  std::memcpy(p, &v, sizeof(V));
+}
+
+template <typename M>
+[[gnu::always_inline]] inline bool any(const M& mask) {
+  using Words = typename VectorOf<std::uint64_t, sizeof(M)>::type;
+  const Words words = reinterpret_cast<Words>(mask);
+  std::uint64_t bits = 0;
+  for (std::size_t j = 0; j < sizeof(M) / 8; ++j) {
+    bits |= words[j];
+  }
+  return bits != 0;
+}
+
+// Converts lanes to the accumulator's element type (integers go through
+// int64_t so they sign-extend) and reinterprets the result as WV.
+template <typename SV, typename WV, typename V>
+[[gnu::always_inline]] inline void widen(WV& out, const V& v) {
+  out = reinterpret_cast<WV>(__builtin_convertvector(v, SV));
+}
+
+template <bool Max, typename T>
+[[gnu::always_inline]] inline T pick(T best, T x) {
+  if constexpr (Max) {
+    return best < x ? x : best;
+  } else {
+    return x < best ? x : best;
+  }
+}
+
+// Kernels. Bytes is the vector width, 0 for scalar code.
+
+template <typename T, std::size_t Bytes>
+[[gnu::always_inline]] inline std::size_t find_kernel(const T* p, std::size_t n, T value) {
+  std::size_t i = 0;
+  if constexpr (Bytes != 0) {
+    using V = typename VectorOf<T, Bytes>::type;
+    constexpr std::size_t kLanes = Bytes / sizeof(T);
+    const V needle = V{} + value;
+    for (; i + kBlock <= n; i += kBlock) {
+      V x;
+      load(x, p + i);
+      auto hit = x == needle;
+      for (std::size_t k = kLanes; k < kBlock; k += kLanes) {
+        load(x, p + i + k);
+        hit |= x == needle;
+      }
+      if (any(hit)) {
+        break;
+      }
+    }
+  }
+  for (; i < n; ++i) {
+    if (p[i] == value) {
+      return i;
+    }
+  }
+  return n;
+}
+
+template <typename T, std::size_t Bytes>
+[[gnu::always_inline]] inline std::size_t count_kernel(const T* p, std::size_t n, T value) {
+  std::size_t total = 0;
+  std::size_t i = 0;
+  if constexpr (Bytes != 0) {
+    using V = typename VectorOf<T, Bytes>::type;
+    using M = decltype(V{} == V{});
+    constexpr std::size_t kLanes = Bytes / sizeof(T);
+    const V needle = V{} + value;
+    const std::size_t blocks_end = n - n % kBlock;
+    while (i < blocks_end) {
+      const std::size_t chunk_end = std::min(blocks_end, i + kCountChunk);
+      M counts{};
+      for (; i < chunk_end; i += kBlock) {
+        for (std::size_t k = 0; k < kBlock; k += kLanes) {
+          V x;
+          load(x, p + i + k);
+          counts -= x == needle;
+        }
+      }
+      for (std::size_t j = 0; j < kLanes; ++j) {
+        total += static_cast<std::size_t>(counts[j]);
+      }
+    }
+  }
+  for (; i < n; ++i) {
+    total += p[i] == value ? 1 : 0;
+  }
+  return total;
+}
+
+template <bool Max, typename T, std::size_t Bytes>
+[[gnu::always_inline]] inline T extremum_kernel(const T* p, std::size_t n) {
+  T best = p[0];
+  bool nan = false;
+  std::size_t i = 0;
+  if constexpr (Bytes != 0) {
+    using V = typename VectorOf<T, Bytes>::type;
+    using M = decltype(V{} == V{});
+    constexpr std::size_t kLanes = Bytes / sizeof(T);
+    V lanes = V{} + p[0];
+    M nan_lanes{};
+    for (; i + kBlock <= n; i += kBlock) {
+      for (std::size_t k = 0; k < kBlock; k += kLanes) {
+        V x;
+        load(x, p + i + k);
+        if constexpr (std::is_floating_point_v<T>) {
+          nan_lanes |= x != x;
+        }
+        if constexpr (Max) {
+          lanes = lanes < x ? x : lanes;
+        } else {
+          lanes = x < lanes ? x : lanes;
+        }
+      }
+    }
+    for (std::size_t j = 0; j < kLanes; ++j) {
+      best = pick<Max>(best, lanes[j]);
+    }
+    nan = any(nan_lanes);
+  }
+  for (; i < n; ++i) {
+    if constexpr (std::is_floating_point_v<T>) {
+      if (p[i] != p[i]) {
+        nan = true;
+        continue;
+      }
+    }
+    best = pick<Max>(best, p[i]);
+  }
+  if constexpr (std::is_floating_point_v<T>) {
+    // best can only be NaN if p[0] is, which also sets nan.
+    if (nan || best != best) {
+      return std::numeric_limits<T>::quiet_NaN();
+    }
+  }
+  return best;
+}
+
+// sum (Dot == false) or dot product. Element i always goes to partial sum
+// i % kBlock until the last whole block; the partial sums are then folded
+// pairwise and the tail is added in order.
+template <bool Dot, typename T, std::size_t Bytes>
+[[gnu::always_inline]] inline wide_t<T> reduce_kernel(const T* a, const T* b, std::size_t n) {
+  using W = wide_t<T>;
+  W partial[kBlock] = {};
+  std::size_t i = 0;
+  if constexpr (Bytes != 0) {
+    // Accumulators fill a whole register; narrower elements are loaded
+    // half a register at a time, sign-extended and reinterpreted so that
+    // integer lanes wrap.
+    constexpr std::size_t kLanes = Bytes / sizeof(W);
+    using V = typename VectorOf<T, kLanes * sizeof(T)>::type;
+    using WV = typename VectorOf<W, Bytes>::type;
+    using SV = typename VectorOf<std::conditional_t<std::is_integral_v<T>, std::int64_t, T>,
+                                 Bytes>::type;
+    WV acc[kBlock / kLanes] = {};
+    for (; i + kBlock <= n; i += kBlock) {
+      for (std::size_t k = 0; k < kBlock / kLanes; ++k) {
+        V lanes;
+        WV x;
+        load(lanes, a + i + k * kLanes);
+        widen<SV>(x, lanes);
+        if constexpr (Dot) {
+          WV y;
+          load(lanes, b + i + k * kLanes);
+          widen<SV>(y, lanes);
+          x = x * y;
+        }
+        acc[k] += x;
+      }
+    }
+    for (std::size_t k = 0; k < kBlock / kLanes; ++k) {
+      for (std::size_t j = 0; j < kLanes; ++j) {
+        partial[k * kLanes + j] = acc[k][j];
+      }
+    }
+  } else {
+    for (; i + kBlock <= n; i += kBlock) {
+      for (std::size_t j = 0; j < kBlock; ++j) {
+        W x = static_cast<W>(a[i + j]);
+        if constexpr (Dot) {
+          x = x * static_cast<W>(b[i + j]);
+        }
+        partial[j] += x;
+      }
+    }
+  }
+  for (std::size_t width = kBlock / 2; width != 0; width /= 2) {
+    for (std::size_t j = 0; j < width; ++j) {
+      partial[j] += partial[j + width];
+    }
+  }
+  W result = partial[0];
+  for (; i < n; ++i) {
+    W x = static_cast<W>(a[i]);
+    if constexpr (Dot) {
+      x = x * static_cast<W>(b[i]);
+    }
+    result += x;
+  }
+  return result;
+}
+
+template <typename T, std::size_t Bytes>
+[[gnu::always_inline]] inline void clamp_kernel(T* p, std::size_t n, T lo, T hi) {
+  std::size_t i = 0;
+  if constexpr (Bytes != 0) {
+    using V = typename VectorOf<T, Bytes>::type;
+    constexpr std::size_t kLanes = Bytes / sizeof(T);
+    const V low = V{} + lo;
+    const V high = V{} + hi;
+    for (; i + kLanes <= n; i += kLanes) {
+      V x;
+      load(x, p + i);
+      x = x < low ? low : x;
+      x = high < x ? high : x;
+      store(p + i, x);
+    }
+  }
+  for (; i < n; ++i) {
+    p[i] = std::clamp(p[i], lo, hi);
+  }
+}
+
+}  // namespace
+
+// Entry points per instruction set.
+
+#define UTILS_SIMD_ENTRY_POINTS(ISA, BYTES, ATTRIBUTES)                                 \
+  namespace ISA {                                                                       \
+  template <typename T>                                                                 \
+  ATTRIBUTES std::size_t find(const T* p, std::size_t n, T value) {                     \
+    return find_kernel<T, BYTES>(p, n, value);                                          \
+  }                                                                                     \
+  template <typename T>                                                                 \
+  ATTRIBUTES std::size_t count(const T* p, std::size_t n, T value) {                    \
+    return count_kernel<T, BYTES>(p, n, value);                                         \
+  }                                                                                     \
+  template <typename T>                                                                 \
+  ATTRIBUTES T min(const T* p, std::size_t n) {                                         \
+    return extremum_kernel<false, T, BYTES>(p, n);                                      \
+  }                                                                                     \
+  template <typename T>                                                                 \
+  ATTRIBUTES T max(const T* p, std::size_t n) {                                         \
+    return extremum_kernel<true, T, BYTES>(p, n);                                       \
+  }                                                                                     \
+  template <typename T>                                                                 \
+  ATTRIBUTES wide_t<T> sum(const T* p, std::size_t n) {                                 \
+    return reduce_kernel<false, T, BYTES>(p, p, n);                                     \
+  }                                                                                     \
+  template <typename T>                                                                 \
+  ATTRIBUTES wide_t<T> dot(const T* a, const T* b, std::size_t n) {                     \
+    return reduce_kernel<true, T, BYTES>(a, b, n);                                      \
+  }                                                                                     \
+  template <typename T>                                                                 \
+  ATTRIBUTES void clamp(T* p, std::size_t n, T lo, T hi) {                              \
+    clamp_kernel<T, BYTES>(p, n, lo, hi);                                               \
+  }                                                                                     \
+  }
+
+namespace {
+
+UTILS_SIMD_ENTRY_POINTS(scalar, 0, )
+#if UTILS_SIMD_X86
+UTILS_SIMD_ENTRY_POINTS(sse2, 16, __attribute__((target("sse2"), flatten)))
+UTILS_SIMD_ENTRY_POINTS(avx2, 32, __attribute__((target("avx2"), flatten)))
+UTILS_SIMD_ENTRY_POINTS(avx512, 64,
+                        __attribute__((target("avx512f,avx512dq,avx512bw,avx512vl"), flatten)))
+#endif
+
+Isa detect() noexcept {
+#if UTILS_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq") &&
+      __builtin_cpu_supports("avx512bw") && __builtin_cpu_supports("avx512vl")) {
+    return Isa::kAvx512;
+  }
+  if (__builtin_cpu_supports("avx2")) {
+    return Isa::kAvx2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return Isa::kSse2;
+  }
+#endif
+  return Isa::kScalar;
+}
+
+std::atomic<Isa>& active() noexcept {
+  static std::atomic<Isa> isa(detected_isa());
+  return isa;
+}
+
+}  // namespace
+
+#undef UTILS_SIMD_ENTRY_POINTS
+
+#if UTILS_SIMD_X86
+#define UTILS_SIMD_DISPATCH(CALL)                 \
+  switch (active_isa()) {                         \
+    case Isa::kAvx512:                            \
+      return avx512::CALL;                        \
+    case Isa::kAvx2:                              \
+      return avx2::CALL;                          \
+    case Isa::kSse2:                              \
+      return sse2::CALL;                          \
+    case Isa::kScalar:                            \
+      break;                                      \
+  }                                               \
+  return scalar::CALL
+#else
+#define UTILS_SIMD_DISPATCH(CALL) return scalar::CALL
+#endif
+
+Isa detected_isa() noexcept {
+  static const Isa isa = detect();
+  return isa;
+}
+
+Isa active_isa() noexcept { return active().load(std::memory_order_relaxed); }
+
+void set_active_isa(Isa isa) {
+  if (static_cast<int>(isa) > static_cast<int>(detected_isa())) {
+    throw std::invalid_argument(std::string("instruction set not supported: ") +
+                                isa_name(isa));
+  }
+  active().store(isa, std::memory_order_relaxed);
+}
+
+const char* isa_name(Isa isa) noexcept {
+  switch (isa) {
+    case Isa::kScalar:
+      return "scalar";
+    case Isa::kSse2:
+      return "sse2";
+    case Isa::kAvx2:
+      return "avx2";
+    case Isa::kAvx512:
+      return "avx512";
+  }
+  return "unknown";
+}
+
+namespace detail {
+
+template <simd_element T>
+std::size_t find(const T* data, std::size_t size, T value) {
+  UTILS_SIMD_DISPATCH(find(data, size, value));
+}
+
+template <simd_element T>
+std::size_t count(const T* data, std::size_t size, T value) {
+  UTILS_SIMD_DISPATCH(count(data, size, value));
+}
+
+template <simd_element T>
+T min(const T* data, std::size_t size) {
+  UTILS_SIMD_DISPATCH(min(data, size));
+}
+
+template <simd_element T>
+T max(const T* data, std::size_t size) {
+  UTILS_SIMD_DISPATCH(max(data, size));
+}
+
+template <simd_element T>
+accumulator_t<T> sum(const T* data, std::size_t size) {
+  UTILS_SIMD_DISPATCH(sum(data, size));
+}
+
+template <simd_element T>
+accumulator_t<T> dot(const T* a, const T* b, std::size_t size) {
+  UTILS_SIMD_DISPATCH(dot(a, b, size));
+}
+
+template <simd_element T>
+void clamp(T* data, std::size_t size, T lo, T hi) {
+  UTILS_SIMD_DISPATCH(clamp(data, size, lo, hi));
+}
+
+#undef UTILS_SIMD_DISPATCH
+
+#define UTILS_SIMD_INSTANTIATE(T)                                         \
+  template std::size_t find<T>(const T*, std::size_t, T);                 \
+  template std::size_t count<T>(const T*, std::size_t, T);                \
+  template T min<T>(const T*, std::size_t);                               \
+  template T max<T>(const T*, std::size_t);                               \
+  template accumulator_t<T> sum<T>(const T*, std::size_t);                \
+  template accumulator_t<T> dot<T>(const T*, const T*, std::size_t);      \
+  template void clamp<T>(T*, std::size_t, T, T);
+
+UTILS_SIMD_INSTANTIATE(float)
+UTILS_SIMD_INSTANTIATE(double)
+UTILS_SIMD_INSTANTIATE(std::int32_t)
+UTILS_SIMD_INSTANTIATE(std::int64_t)
+
+#undef UTILS_SIMD_INSTANTIATE
+
+}  // namespace detail
+
+}  // namespace algorithms
+
+}  // namespace utils
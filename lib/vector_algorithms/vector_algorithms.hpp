@@ -0,0 +1,112 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace utils {
+
+namespace algorithms {
+
+// Vectorized kernels over contiguous float, double, int32_t and int64_t
+// data (utils::Vector, std::vector, std::span, ...). The implementation is
+// picked at run time from the CPU features and every variant returns the
+// same result as the scalar one, bit for bit:
+//
+//  * sum and dot add into 16 interleaved partial sums that are combined in
+//    a fixed order, whatever the vector width, so floating-point rounding
+//    does not depend on the instruction set. Integer sums and dot products
+//    are computed in int64_t with wrap-around.
+//  * min and max return a quiet NaN if any element is NaN. Which zero is
+//    returned for a mix of +0.0 and -0.0 is unspecified.
+//  * find and count compare with ==, so NaN never matches.
+//  * clamp follows std::clamp: NaN elements are left as they are.
+//
+// Loads are unaligned, so any subrange can be passed; the tail that does
+// not fill a whole vector is handled by scalar code.
+
+enum class Isa {
+  kScalar,
+  kSse2,
+  kAvx2,
+  kAvx512,
+};
+
+// Best instruction set supported by this CPU and build.
+Isa detected_isa() noexcept;
+// Instruction set the kernels currently use; detected_isa() by default.
+Isa active_isa() noexcept;
+// Selects a narrower instruction set, e.g. to compare implementations.
+// Throws std::invalid_argument if isa is not supported here.
+void set_active_isa(Isa isa);
+const char* isa_name(Isa isa) noexcept;
+
+template <typename T>
+concept simd_element = std::same_as<T, float> || std::same_as<T, double> ||
+                       std::same_as<T, std::int32_t> || std::same_as<T, std::int64_t>;
+
+template <typename T>
+using accumulator_t = std::conditional_t<std::is_integral_v<T>, std::int64_t, T>;
+
+template <typename Container>
+using element_t = std::remove_cvref_t<decltype(*std::declval<Container&>().data())>;
+
+template <typename Container>
+concept contiguous_elements = requires(Container& c) {
+  c.data();
+  { c.size() } -> std::convertible_to<std::size_t>;
+} && simd_element<element_t<Container>>;
+
+namespace detail {
+
+template <simd_element T>
+std::size_t find(const T* data, std::size_t size, T value);
+template <simd_element T>
+std::size_t count(const T* data, std::size_t size, T value);
+template <simd_element T>
+T min(const T* data, std::size_t size);
+template <simd_element T>
+T max(const T* data, std::size_t size);
+template <simd_element T>
+accumulator_t<T> sum(const T* data, std::size_t size);
+template <simd_element T>
+accumulator_t<T> dot(const T* a, const T* b, std::size_t size);
+template <simd_element T>
+void clamp(T* data, std::size_t size, T lo, T hi);
+
+}  // namespace detail
+
+// Index of the first element equal to value, or size() if there is none.
+template <contiguous_elements Container>
+std::size_t find(const Container& c, element_t<Container> value);
+
+template <contiguous_elements Container>
+std::size_t count(const Container& c, element_t<Container> value);
+
+// Throw std::out_of_range on an empty container.
+template <contiguous_elements Container>
+element_t<Container> min(const Container& c);
+template <contiguous_elements Container>
+element_t<Container> max(const Container& c);
+
+template <contiguous_elements Container>
+accumulator_t<element_t<Container>> sum(const Container& c);
+
+// Throws std::invalid_argument if the sizes differ.
+template <contiguous_elements Container>
+accumulator_t<element_t<Container>> dot(const Container& a, const Container& b);
+
+// Clamps every element to [lo, hi] in place. Throws std::invalid_argument
+// if hi < lo.
+template <contiguous_elements Container>
+void clamp(Container& c, element_t<Container> lo, element_t<Container> hi);
+
+}  // namespace algorithms
+
+}  // namespace utils
+
+#include "vector_algorithms.tpp"
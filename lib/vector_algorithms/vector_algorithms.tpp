@@ -0,0 +1,61 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <cstddef>
+#include <stdexcept>
+
+#include "vector_algorithms.hpp"
+
+namespace utils {
+
+namespace algorithms {
+
+template <contiguous_elements Container>
+std::size_t find(const Container& c, element_t<Container> value) {
+  return detail::find(c.data(), static_cast<std::size_t>(c.size()), value);
+}
+
+template <contiguous_elements Container>
+std::size_t count(const Container& c, element_t<Container> value) {
+  return detail::count(c.data(), static_cast<std::size_t>(c.size()), value);
+}
+
+template <contiguous_elements Container>
+element_t<Container> min(const Container& c) {
+  if (c.size() == 0) {
+    throw std::out_of_range("min of an empty range");
+  }
+  return detail::min(c.data(), static_cast<std::size_t>(c.size()));
+}
+
+template <contiguous_elements Container>
+element_t<Container> max(const Container& c) {
+  if (c.size() == 0) {
+    throw std::out_of_range("max of an empty range");
+  }
+  return detail::max(c.data(), static_cast<std::size_t>(c.size()));
+}
+
+template <contiguous_elements Container>
+accumulator_t<element_t<Container>> sum(const Container& c) {
+  return detail::sum(c.data(), static_cast<std::size_t>(c.size()));
+}
+
+template <contiguous_elements Container>
+accumulator_t<element_t<Container>> dot(const Container& a, const Container& b) {
+  if (a.size() != b.size()) {
+    throw std::invalid_argument("dot of ranges with different sizes");
+  }
+  return detail::dot(a.data(), b.data(), static_cast<std::size_t>(a.size()));
+}
+
+template <contiguous_elements Container>
+void clamp(Container& c, element_t<Container> lo, element_t<Container> hi) {
+  if (hi < lo) {
+    throw std::invalid_argument("clamp with hi < lo");
+  }
+  detail::clamp(c.data(), static_cast<std::size_t>(c.size()), lo, hi);
+}
+
+}  // namespace algorithms
+
+}  // namespace utils
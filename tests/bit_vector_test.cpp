@@ -0,0 +1,172 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <lib/bit_vector/bit_vector.hpp>
+
+#include <cstdint>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+#include <lib/vector_algorithms/vector_algorithms.hpp>
+
+#include "gtest/gtest.h"
+#include "isa_test.hpp"
+
+namespace algo = utils::algorithms;
+
+namespace {
+
+std::vector<bool> random_flags(std::size_t n, unsigned seed, unsigned percent = 30) {
+  std::mt19937 rng(seed);
+  std::vector<bool> flags(n);
+  for (std::size_t i = 0; i < n; ++i) flags[i] = rng() % 100 < percent;
+  return flags;
+}
+
+utils::BitVector from_bools(const std::vector<bool>& flags) {
+  utils::BitVector bits;
+  for (bool flag : flags) bits.push_back(flag);
+  return bits;
+}
+
+}  // namespace
+
+TEST(BitVector, PushBackAndAccess) {
+  utils::BitVector bits;
+  EXPECT_TRUE(bits.empty());
+  for (int i = 0; i < 200; ++i) bits.push_back(i % 3 == 0);
+  ASSERT_EQ(200, bits.size());
+  for (int i = 0; i < 200; ++i) EXPECT_EQ(i % 3 == 0, bits[i]);
+  EXPECT_EQ(4, bits.words().size());
+  EXPECT_GE(bits.capacity(), 200);
+
+  bits[1] = true;
+  bits[0] = bits[2];
+  bits.flip(3);
+  EXPECT_TRUE(bits.test(1));
+  EXPECT_FALSE(bits.test(0));
+  EXPECT_FALSE(bits.test(3));
+  EXPECT_THROW(bits.at(200), std::out_of_range);
+
+  bits.pop_back();
+  EXPECT_EQ(199, bits.size());
+  EXPECT_TRUE(bits.back());
+  bits.pop_back();
+  EXPECT_FALSE(bits.back());
+
+  utils::BitVector empty;
+  EXPECT_THROW(empty.pop_back(), std::out_of_range);
+  EXPECT_EQ(0, empty.size());
+}
+
+TEST(BitVector, ResizeKeepsUnusedBitsClear) {
+  utils::BitVector bits(70, true);
+  EXPECT_EQ(70, bits.count());
+  EXPECT_TRUE(bits.all());
+  bits.resize(65);
+  EXPECT_EQ(65, bits.count());
+  bits.resize(130, true);
+  EXPECT_EQ(130, bits.count());
+  bits.resize(100, false);
+  bits.resize(140, false);
+  EXPECT_EQ(100, bits.count());
+  bits.flip();
+  EXPECT_EQ(40, bits.count());
+  EXPECT_EQ(100, bits.find_first());
+  bits.set();
+  EXPECT_TRUE(bits.all());
+  bits.reset();
+  EXPECT_TRUE(bits.none());
+}
+
+TEST_F(IsaTest, WordOperationsMatchPerBit) {
+  for (algo::Isa isa : isas()) {
+    algo::set_active_isa(isa);
+    for (std::size_t n : {0, 1, 63, 64, 65, 255, 1000, 4099}) {
+      const auto fa = random_flags(n, 1);
+      const auto fb = random_flags(n, 2);
+      const auto a = from_bools(fa);
+      const auto b = from_bools(fb);
+
+      const auto both = a & b;
+      const auto either = a | b;
+      const auto one = a ^ b;
+      auto only_a = a;
+      only_a.and_not(b);
+      const auto inverse = ~a;
+      std::size_t expected_a = 0;
+      std::size_t expected_both = 0;
+      for (std::size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(fa[i] && fb[i], both[i]);
+        ASSERT_EQ(fa[i] || fb[i], either[i]);
+        ASSERT_EQ(fa[i] != fb[i], one[i]);
+        ASSERT_EQ(fa[i] && !fb[i], only_a[i]);
+        ASSERT_EQ(!fa[i], inverse[i]);
+        expected_a += fa[i];
+        expected_both += fa[i] && fb[i];
+      }
+      EXPECT_EQ(expected_a, a.count()) << algo::isa_name(isa) << n;
+      EXPECT_EQ(expected_both, a.count_and(b));
+      EXPECT_EQ(expected_both, both.count());
+      EXPECT_EQ(n - expected_a, inverse.count());
+    }
+  }
+}
+
+TEST(BitVector, SizeMismatchThrows) {
+  utils::BitVector a(10);
+  utils::BitVector b(11);
+  EXPECT_THROW(a &= b, std::invalid_argument);
+  EXPECT_THROW(a.count_and(b), std::invalid_argument);
+}
+
+TEST(BitVector, RankSelectAndFindNext) {
+  const auto flags = random_flags(3000, 3, 5);
+  const auto bits = from_bools(flags);
+  const utils::RankSelect index(bits);
+  EXPECT_EQ(bits.count(), index.count());
+
+  std::vector<std::size_t> positions;
+  std::size_t ones = 0;
+  for (std::size_t i = 0; i <= flags.size(); ++i) {
+    ASSERT_EQ(ones, bits.rank(i));
+    ASSERT_EQ(ones, index.rank(i));
+    if (i < flags.size() && flags[i]) {
+      positions.push_back(i);
+      ++ones;
+    }
+  }
+  for (std::size_t k = 0; k < positions.size(); ++k) {
+    ASSERT_EQ(positions[k], bits.select(k));
+    ASSERT_EQ(positions[k], index.select(k));
+  }
+  EXPECT_EQ(utils::BitVector::npos, bits.select(positions.size()));
+  EXPECT_THROW(index.select(positions.size()), std::out_of_range);
+  EXPECT_THROW(index.rank(3001), std::out_of_range);
+
+  std::vector<std::size_t> visited;
+  for (std::size_t i = bits.find_first(); i != utils::BitVector::npos; i = bits.find_next(i + 1)) {
+    visited.push_back(i);
+  }
+  EXPECT_EQ(positions, visited);
+}
+
+TEST(BitVector, IndexAndFlagConversion) {
+  const std::vector<std::uint32_t> indices = {0, 5, 64, 65, 127, 128, 999};
+  const auto bits = utils::BitVector::from_indices(indices, 1000);
+  EXPECT_EQ(indices.size(), bits.count());
+  const auto round_trip = bits.to_indices();
+  EXPECT_EQ(indices, std::vector<std::uint32_t>(round_trip.begin(), round_trip.end()));
+  EXPECT_THROW(utils::BitVector::from_indices(std::vector<int>{1000}, 1000), std::out_of_range);
+  EXPECT_THROW(utils::BitVector::from_indices(std::vector<int>{-1}, 1000), std::out_of_range);
+
+  utils::Vector<std::uint64_t> wide = {7};
+  bits.append_indices(wide);
+  EXPECT_EQ(8, wide.size());
+  EXPECT_EQ(999, wide[7]);
+
+  const std::vector<std::uint8_t> flags = {1, 0, 0, 2, 0};
+  const auto from_bytes = utils::BitVector::from_flags(flags);
+  EXPECT_EQ(5, from_bytes.size());
+  EXPECT_EQ(utils::BitVector::from_indices(std::vector<int>{0, 3}, 5), from_bytes);
+}
@@ -0,0 +1,233 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <lib/concurrent_vector/concurrent_vector.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test_types.hpp"
+
+namespace {
+
+constexpr std::size_t kThreads = 8;
+
+std::uint64_t tag(std::size_t thread, std::size_t seq) {
+  return (static_cast<std::uint64_t>(thread) << 32) | seq;
+}
+
+}  // namespace
+
+TEST(ConcurrentVector, IteratorConcepts) {
+  using V = utils::ConcurrentVector<int>;
+  static_assert(std::random_access_iterator<V::iterator>);
+  static_assert(std::random_access_iterator<V::const_iterator>);
+}
+
+TEST(ConcurrentVector, SerialAppendKeepsReferences) {
+  utils::ConcurrentVector<std::string> v;
+  std::vector<const std::string*> addresses;
+  for (int i = 0; i < 5000; ++i) {
+    addresses.push_back(&v.push_back(std::to_string(i)));
+  }
+  ASSERT_EQ(5000, v.size());
+  EXPECT_GE(v.capacity(), v.size());
+  for (int i = 0; i < 5000; ++i) {
+    ASSERT_EQ(addresses[i], &v[i]);
+    ASSERT_EQ(std::to_string(i), *addresses[i]);
+  }
+  EXPECT_TRUE(std::is_sorted(v.begin(), v.end(), [](const std::string& a, const std::string& b) {
+    return std::stoi(a) < std::stoi(b);
+  }));
+  EXPECT_EQ("4999", v.at(4999));
+  EXPECT_THROW(v.at(5000), std::out_of_range);
+  EXPECT_FALSE(v.is_published(5000));
+}
+
+TEST(ConcurrentVector, GrowByReturnsFirstIndex) {
+  utils::ConcurrentVector<int> v;
+  EXPECT_EQ(0, v.grow_by(3));
+  EXPECT_EQ(3, v.grow_by(1000, 7));
+  EXPECT_EQ(1003, v.size());
+  EXPECT_EQ(0, v[2]);
+  EXPECT_EQ(7, v[3]);
+  EXPECT_EQ(7, v[1002]);
+  EXPECT_EQ(1003, v.grow_by(0));
+
+  EXPECT_THROW(v.grow_by(v.max_size()), std::length_error);
+  EXPECT_THROW(v.grow_by(v.max_size() - 1000), std::length_error);
+  EXPECT_EQ(1003, v.size());
+  EXPECT_EQ(1003, v.grow_by(1));
+}
+
+TEST(ConcurrentVector, ToVectorCopiesPublishedElements) {
+  utils::ConcurrentVector<int> v;
+  for (int i = 0; i < 3000; ++i) v.push_back(i);
+  utils::Vector<int> flat = v.to_vector();
+  ASSERT_EQ(3000, flat.size());
+  for (int i = 0; i < 3000; ++i) ASSERT_EQ(i, flat[i]);
+}
+
+TEST(ConcurrentVector, FailedConstructionLeavesUnpublishedSlot) {
+  {
+    utils::ConcurrentVector<LiveCounted> v;
+    LiveCounted value(5);
+    v.push_back(value);
+    LiveCounted::copies_left = 0;
+    EXPECT_THROW(v.push_back(value), std::runtime_error);
+    LiveCounted::copies_left = 3;
+    EXPECT_THROW(v.grow_by(10, value), std::runtime_error);
+    LiveCounted::copies_left = -1;
+    v.push_back(value);
+
+    EXPECT_EQ(13, v.size());
+    EXPECT_TRUE(v.is_published(0));
+    EXPECT_FALSE(v.is_published(1));
+    EXPECT_TRUE(v.is_published(4));
+    EXPECT_FALSE(v.is_published(5));
+    EXPECT_TRUE(v.is_published(12));
+    EXPECT_THROW(v.at(1), std::out_of_range);
+    EXPECT_EQ(5, v.to_vector().size());
+    EXPECT_EQ(1 + 5, LiveCounted::live.load());
+  }
+  EXPECT_EQ(0, LiveCounted::live.load());
+}
+
+TEST(ConcurrentVector, IterationStopsAtFirstUnpublishedSlot) {
+  {
+    utils::ConcurrentVector<LiveCounted> v;
+    LiveCounted value(5);
+    v.push_back(value);
+    v.push_back(value);
+    LiveCounted::copies_left = 0;
+    EXPECT_THROW(v.push_back(value), std::runtime_error);
+    LiveCounted::copies_left = -1;
+    v.push_back(value);
+
+    EXPECT_EQ(4, v.size());
+    EXPECT_EQ(2, std::distance(v.begin(), v.end()));
+    for (const LiveCounted& element : v) {
+      EXPECT_EQ(5, element.value);
+    }
+    const utils::ConcurrentVector<LiveCounted> copy(v);
+    EXPECT_EQ(2, std::distance(copy.begin(), copy.end()));
+    v.clear();
+    v.push_back(value);
+    EXPECT_EQ(1, std::distance(v.begin(), v.end()));
+  }
+  EXPECT_EQ(0, LiveCounted::live.load());
+}
+
+TEST(ConcurrentVector, CopyMoveClearAndSwap) {
+  utils::ConcurrentVector<std::unique_ptr<int>> handles;
+  for (int i = 0; i < 300; ++i) handles.push_back(std::make_unique<int>(i));
+  utils::ConcurrentVector<std::unique_ptr<int>> moved(std::move(handles));
+  EXPECT_TRUE(handles.empty());
+  ASSERT_EQ(300, moved.size());
+  EXPECT_EQ(299, *moved[299]);
+  handles = std::move(moved);
+  EXPECT_EQ(299, *handles[299]);
+
+  utils::ConcurrentVector<std::string> a;
+  for (int i = 0; i < 200; ++i) a.push_back(std::to_string(i));
+  utils::ConcurrentVector<std::string> b(a);
+  ASSERT_EQ(200, b.size());
+  EXPECT_EQ("199", b[199]);
+  b.clear();
+  EXPECT_TRUE(b.empty());
+  b.push_back("x");
+  EXPECT_EQ("x", b[0]);
+  a.swap(b);
+  EXPECT_EQ(1, a.size());
+  EXPECT_EQ(200, b.size());
+  b = a;
+  EXPECT_EQ(1, b.size());
+  EXPECT_EQ("x", b[0]);
+}
+
+TEST(ConcurrentVector, ConcurrentPushBackStress) {
+  constexpr std::size_t kPerThread = 50000;
+  utils::ConcurrentVector<std::uint64_t> v;
+  std::vector<std::vector<const std::uint64_t*>> addresses(kThreads);
+  std::atomic<bool> done = false;
+  std::atomic<std::size_t> reads = 0;
+
+  // Any published slot must already hold a value that some writer pushed.
+  std::thread reader([&] {
+    while (!done.load()) {
+      const std::size_t size = v.size();
+      for (std::size_t i = 0; i < size; i += 97) {
+        if (v.is_published(i)) {
+          const std::uint64_t value = v[i];
+          ASSERT_LT(value >> 32, kThreads);
+          ASSERT_LT(value & 0xffffffff, kPerThread);
+          reads.fetch_add(1, std::memory_order_relaxed);
+        }
+      }
+    }
+  });
+  std::vector<std::thread> writers;
+  for (std::size_t t = 0; t < kThreads; ++t) {
+    writers.emplace_back([&, t] {
+      addresses[t].reserve(kPerThread);
+      for (std::size_t i = 0; i < kPerThread; ++i) {
+        addresses[t].push_back(&v.push_back(tag(t, i)));
+      }
+    });
+  }
+  for (std::thread& writer : writers) writer.join();
+  done = true;
+  reader.join();
+
+  ASSERT_EQ(kThreads * kPerThread, v.size());
+  for (std::size_t t = 0; t < kThreads; ++t) {
+    for (std::size_t i = 0; i < kPerThread; ++i) {
+      ASSERT_EQ(tag(t, i), *addresses[t][i]);
+    }
+  }
+  utils::Vector<std::uint64_t> flat = v.to_vector();
+  ASSERT_EQ(kThreads * kPerThread, flat.size());
+  std::sort(flat.data(), flat.data() + flat.size());
+  for (std::size_t t = 0; t < kThreads; ++t) {
+    for (std::size_t i = 0; i < kPerThread; ++i) {
+      ASSERT_EQ(tag(t, i), flat[t * kPerThread + i]);
+    }
+  }
+}
+
+TEST(ConcurrentVector, ConcurrentGrowByStress) {
+  constexpr std::size_t kRounds = 2000;
+  utils::ConcurrentVector<std::uint64_t> v;
+  std::vector<std::vector<std::pair<std::size_t, std::size_t>>> ranges(kThreads);
+  std::vector<std::thread> writers;
+  for (std::size_t t = 0; t < kThreads; ++t) {
+    writers.emplace_back([&, t] {
+      for (std::size_t r = 0; r < kRounds; ++r) {
+        const std::size_t n = (r * 7 + t) % 37;
+        const std::size_t first = n % 2 ? v.grow_by(n, t) : v.grow_by(n);
+        if (n % 2 == 0) {
+          for (std::size_t i = first; i < first + n; ++i) v[i] = t;
+        }
+        ranges[t].emplace_back(first, n);
+      }
+    });
+  }
+  for (std::thread& writer : writers) writer.join();
+
+  std::size_t total = 0;
+  for (std::size_t t = 0; t < kThreads; ++t) {
+    for (auto [first, n] : ranges[t]) {
+      total += n;
+      for (std::size_t i = first; i < first + n; ++i) ASSERT_EQ(t, v[i]);
+    }
+  }
+  EXPECT_EQ(total, v.size());
+}
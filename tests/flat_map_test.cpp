@@ -0,0 +1,171 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <lib/flat_map/flat_map.hpp>
+
+#include <functional>
+#include <map>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test_types.hpp"
+
+TEST(FlatSet, BuildsSortedAndUnique) {
+  const std::vector<int> input = {5, 3, 9, 3, 1, 5, 7};
+  const utils::FlatSet<int> set(input);
+  EXPECT_EQ((std::vector<int>{1, 3, 5, 7, 9}), std::vector<int>(set.begin(), set.end()));
+  EXPECT_EQ(5, set.size());
+
+  const utils::FlatSet<int, std::greater<int>> descending = {1, 4, 2, 4};
+  EXPECT_EQ((std::vector<int>{4, 2, 1}),
+            std::vector<int>(descending.begin(), descending.end()));
+}
+
+TEST(FlatSet, LookupMatchesStdSet) {
+  std::mt19937 rng(1);
+  for (std::size_t n : {0, 1, 2, 3, 7, 64, 1000}) {
+    std::vector<int> input;
+    for (std::size_t i = 0; i < n; ++i) input.push_back(static_cast<int>(rng() % (2 * n + 1)));
+    const utils::FlatSet<int> set(input);
+    const std::set<int> expected(input.begin(), input.end());
+    ASSERT_EQ(expected.size(), set.size());
+    for (int key = -1; key <= static_cast<int>(2 * n + 1); ++key) {
+      ASSERT_EQ(expected.contains(key), set.contains(key)) << n << " " << key;
+      const auto lower = std::distance(expected.begin(), expected.lower_bound(key));
+      const auto upper = std::distance(expected.begin(), expected.upper_bound(key));
+      ASSERT_EQ(lower, set.lower_bound(key) - set.begin());
+      ASSERT_EQ(upper, set.upper_bound(key) - set.begin());
+    }
+  }
+}
+
+TEST(FlatSet, InsertEraseAndMerge) {
+  utils::FlatSet<std::string> set;
+  EXPECT_TRUE(set.insert("m").second);
+  EXPECT_TRUE(set.emplace(1, 'a').second);
+  EXPECT_FALSE(set.insert("m").second);
+  EXPECT_EQ("a", *set.begin());
+
+  set.insert_range(std::vector<std::string>{"z", "b", "m", "b"});
+  EXPECT_EQ((std::vector<std::string>{"a", "b", "m", "z"}),
+            std::vector<std::string>(set.begin(), set.end()));
+  set.insert_range(std::vector<std::string>{"zz", "zy"});
+  EXPECT_EQ(6, set.size());
+  EXPECT_EQ("zz", set.keys().back());
+
+  EXPECT_EQ(1, set.erase("m"));
+  EXPECT_EQ(0, set.erase("m"));
+  EXPECT_EQ("z", *set.erase(set.find("b")));
+  EXPECT_EQ((utils::FlatSet<std::string>{"a", "z", "zy", "zz"}), set);
+
+  set.insert_range(utils::FlatSet<std::string>{"b", "z", "zzz"});
+  EXPECT_EQ((utils::FlatSet<std::string>{"a", "b", "z", "zy", "zz", "zzz"}), set);
+}
+
+TEST(FlatMap, BuildKeepsFirstOfRepeatedKeys) {
+  const std::vector<std::pair<int, std::string>> input = {
+      {3, "c"}, {1, "a"}, {3, "x"}, {2, "b"}, {1, "y"}};
+  const utils::FlatMap<int, std::string> map(input);
+  ASSERT_EQ(3, map.size());
+  EXPECT_EQ((std::vector<int>{1, 2, 3}), std::vector<int>(map.keys().begin(), map.keys().end()));
+  EXPECT_EQ("a", map.at(1));
+  EXPECT_EQ("c", map.at(3));
+  EXPECT_THROW(map.at(4), std::out_of_range);
+
+  std::vector<std::pair<int, std::string>> visited;
+  for (const auto& [key, value] : map) visited.emplace_back(key, value);
+  EXPECT_EQ((std::vector<std::pair<int, std::string>>{{1, "a"}, {2, "b"}, {3, "c"}}), visited);
+}
+
+TEST(FlatMap, ModifiersMatchStdMap) {
+  std::mt19937 rng(2);
+  utils::FlatMap<int, int> map;
+  std::map<int, int> expected;
+  for (int step = 0; step < 2000; ++step) {
+    const int key = static_cast<int>(rng() % 300);
+    switch (rng() % 5) {
+      case 0:
+        EXPECT_EQ(expected.try_emplace(key, step).second, map.try_emplace(key, step).second);
+        break;
+      case 1:
+        expected.insert_or_assign(key, step);
+        map.insert_or_assign(key, step);
+        break;
+      case 2:
+        EXPECT_EQ(expected.erase(key), map.erase(key));
+        break;
+      case 3:
+        ++expected[key];
+        ++map[key];
+        break;
+      default: {
+        std::vector<std::pair<int, int>> batch;
+        for (int i = 0; i < 20; ++i) batch.emplace_back(static_cast<int>(rng() % 300), step);
+        for (const auto& [k, v] : batch) expected.try_emplace(k, v);
+        map.insert_range(batch);
+      }
+    }
+  }
+  ASSERT_EQ(expected.size(), map.size());
+  auto it = map.begin();
+  for (const auto& [key, value] : expected) {
+    ASSERT_EQ(key, it->first);
+    ASSERT_EQ(value, it->second);
+    ++it;
+  }
+  EXPECT_EQ(map.end(), it);
+}
+
+TEST(FlatMap, InsertRangeKeepsKeysAndValuesPairedOnThrow) {
+  // LiveCounted moves do not throw, so a copy-only wrapper forces copies.
+  struct CopyOnly {
+    CopyOnly(int val) : counted(val) {}
+    CopyOnly(const CopyOnly&) = default;
+    CopyOnly& operator=(const CopyOnly&) = default;
+    LiveCounted counted;
+  };
+  const std::vector<std::pair<int, CopyOnly>> batch = {{5, 50}, {6, 60}, {7, 70}};
+  for (long copies = 0;; ++copies) {
+    utils::FlatMap<int, CopyOnly> map;
+    map.try_emplace(1, 10);
+    LiveCounted::copies_left = copies;
+    try {
+      map.insert_range(batch);
+    } catch (const std::runtime_error&) {
+      ASSERT_EQ(1, map.keys().size());
+      ASSERT_EQ(1, map.values().size());
+      EXPECT_EQ(10, map.at(1).counted.value);
+      continue;
+    }
+    LiveCounted::copies_left = -1;
+    ASSERT_EQ(4, map.size());
+    EXPECT_EQ(70, map.at(7).counted.value);
+    break;
+  }
+}
+
+TEST(FlatMap, IteratorsAndValueAccess) {
+  utils::FlatMap<int, double> map = {{2, 2.0}, {1, 1.0}, {4, 4.0}};
+  for (auto [key, value] : map) value *= 10;
+  for (auto& value : map.values()) value += 1;
+  EXPECT_EQ(11.0, map.at(1));
+  EXPECT_EQ(41.0, map.find(4)->second);
+  EXPECT_EQ(map.end(), map.find(3));
+  EXPECT_EQ(4, map.lower_bound(3)->first);
+  EXPECT_EQ(2, map.upper_bound(1)->first);
+
+  utils::FlatMap<int, double>::const_iterator first = map.begin();
+  EXPECT_EQ(3, map.cend() - first);
+  EXPECT_EQ(4, first[2].first);
+  EXPECT_EQ(4, map.erase(map.find(2))->first);
+  EXPECT_EQ(2, map.size());
+
+  EXPECT_THROW((utils::FlatMap<int, int>(utils::sorted_unique, {1, 2}, {1})),
+               std::invalid_argument);
+  const utils::FlatMap<int, int> adopted(utils::sorted_unique, {1, 2}, {10, 20});
+  EXPECT_EQ(20, adopted.at(2));
+}
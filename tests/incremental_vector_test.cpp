@@ -0,0 +1,161 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <lib/incremental_vector/incremental_vector.hpp>
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "test_types.hpp"
+
+namespace {
+
+template <typename Vector>
+void expect_sequence(const Vector& v, std::size_t count) {
+  ASSERT_EQ(count, v.size());
+  for (std::size_t i = 0; i < count; ++i) {
+    ASSERT_EQ(static_cast<int>(i), v[i]) << i;
+  }
+}
+
+}  // namespace
+
+TEST(IncrementalVector, IteratorConcepts) {
+  using V = utils::IncrementalVector<int>;
+  static_assert(std::random_access_iterator<V::iterator>);
+  static_assert(std::random_access_iterator<V::const_iterator>);
+  static_assert(std::convertible_to<V::iterator, V::const_iterator>);
+}
+
+TEST(IncrementalVector, GrowthMigratesAcrossAppends) {
+  utils::IncrementalVector<int> v;
+  bool saw_migration = false;
+  for (int i = 0; i < 10000; ++i) {
+    const std::size_t capacity = v.capacity();
+    v.push_back(i);
+    if (v.migrating()) {
+      saw_migration = true;
+      // Grown on this append: nothing has been moved past the step.
+      if (v.capacity() != capacity) {
+        EXPECT_GE(v.step(), 4);
+      }
+    }
+    ASSERT_EQ(i, v.back());
+    ASSERT_EQ(0, v.front());
+    ASSERT_EQ(i / 2, v[static_cast<std::size_t>(i / 2)]);
+  }
+  EXPECT_TRUE(saw_migration);
+  expect_sequence(v, 10000);
+  EXPECT_EQ(std::accumulate(v.begin(), v.end(), 0L), 9999L * 10000 / 2);
+}
+
+TEST(IncrementalVector, MigrationFinishesBeforeNextGrowth) {
+  utils::IncrementalVector<std::string> v;
+  for (int i = 0; i < 5000; ++i) {
+    const bool full = v.size() == v.capacity();
+    const bool was_migrating = v.migrating();
+    v.push_back(std::to_string(i));
+    if (full) {
+      EXPECT_FALSE(was_migrating) << i;
+    }
+  }
+  for (int i = 0; i < 5000; ++i) ASSERT_EQ(std::to_string(i), v[static_cast<std::size_t>(i)]);
+}
+
+TEST(IncrementalVector, DataFinishesMigration) {
+  utils::IncrementalVector<int> v;
+  for (int i = 0; i < 65; ++i) v.push_back(i);
+  ASSERT_TRUE(v.migrating());
+  int* p = v.data();
+  EXPECT_FALSE(v.migrating());
+  for (int i = 0; i < 65; ++i) EXPECT_EQ(i, p[i]);
+}
+
+TEST(IncrementalVector, IteratorsDuringMigration) {
+  utils::IncrementalVector<int> v;
+  for (int i = 0; i < 33; ++i) v.push_back(i);
+  ASSERT_TRUE(v.migrating());
+  auto it = v.begin() + 10;
+  v.push_back(33);
+  EXPECT_EQ(10, *it);
+  EXPECT_EQ(34, v.end() - v.begin());
+  EXPECT_TRUE(std::is_sorted(v.begin(), v.end()));
+  std::reverse(v.begin(), v.end());
+  EXPECT_EQ(33, v[0]);
+  EXPECT_EQ(0, v[33]);
+}
+
+TEST(IncrementalVector, AppendOwnElementWhileGrowing) {
+  utils::IncrementalVector<std::string> v;
+  for (int i = 0; i < 16; ++i) v.push_back(std::string(30, static_cast<char>('a' + i)));
+  ASSERT_EQ(v.size(), v.capacity());
+  v.push_back(v[0]);
+  v.emplace_back(v[1]);
+  EXPECT_EQ(std::string(30, 'a'), v[16]);
+  EXPECT_EQ(std::string(30, 'b'), v[17]);
+}
+
+TEST(IncrementalVector, PopAndClearDuringMigration) {
+  utils::IncrementalVector<int> v;
+  for (int i = 0; i < 33; ++i) v.push_back(i);
+  ASSERT_TRUE(v.migrating());
+  while (v.size() > 5) v.pop_back();
+  expect_sequence(v, 5);
+  // Popping past the moved prefix empties the old buffer.
+  while (v.size() > 2) v.pop_back();
+  EXPECT_FALSE(v.migrating());
+  expect_sequence(v, 2);
+  for (int i = 2; i < 200; ++i) v.push_back(i);
+  expect_sequence(v, 200);
+
+  v.clear();
+  EXPECT_TRUE(v.empty());
+  EXPECT_FALSE(v.migrating());
+  EXPECT_THROW(v.pop_back(), std::out_of_range);
+  EXPECT_THROW(v.at(0), std::out_of_range);
+}
+
+TEST(IncrementalVector, CopyMoveAndReserve) {
+  utils::IncrementalVector<int> v;
+  for (int i = 0; i < 70; ++i) v.push_back(i);
+  ASSERT_TRUE(v.migrating());
+
+  utils::IncrementalVector<int> copy(v);
+  expect_sequence(copy, 70);
+  utils::IncrementalVector<int> moved(std::move(v));
+  expect_sequence(moved, 70);
+  EXPECT_TRUE(v.empty());
+
+  v = copy;
+  expect_sequence(v, 70);
+  copy = std::move(moved);
+  expect_sequence(copy, 70);
+
+  copy.reserve(1000);
+  EXPECT_FALSE(copy.migrating());
+  EXPECT_EQ(1000, copy.capacity());
+  copy.shrink_to_fit();
+  EXPECT_EQ(70, copy.capacity());
+  expect_sequence(copy, 70);
+}
+
+TEST(IncrementalVector, ElementsAreNotLeaked) {
+  {
+    utils::IncrementalVector<LiveCounted> v;
+    for (int i = 0; i < 1000; ++i) v.emplace_back(i);
+    EXPECT_EQ(1000, LiveCounted::live.load());
+    for (int i = 0; i < 300; ++i) v.pop_back();
+    EXPECT_EQ(700, LiveCounted::live.load());
+    for (int i = 0; i < 100; ++i) v.emplace_back(i);
+  }
+  EXPECT_EQ(0, LiveCounted::live.load());
+
+  utils::IncrementalVector<std::unique_ptr<int>> handles;
+  for (int i = 0; i < 1000; ++i) handles.push_back(std::make_unique<int>(i));
+  for (int i = 0; i < 1000; ++i) ASSERT_EQ(i, *handles[static_cast<std::size_t>(i)]);
+}
@@ -0,0 +1,26 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <vector>
+
+#include <lib/vector_algorithms/vector_algorithms.hpp>
+
+#include "gtest/gtest.h"
+
+// Restores the detected instruction set when a test ends.
+class IsaTest : public ::testing::Test {
+ protected:
+  void TearDown() override {
+    utils::algorithms::set_active_isa(utils::algorithms::detected_isa());
+  }
+
+  // Every instruction set up to and including the detected one.
+  static std::vector<utils::algorithms::Isa> isas() {
+    std::vector<utils::algorithms::Isa> result;
+    for (int i = 0; i <= static_cast<int>(utils::algorithms::detected_isa()); ++i) {
+      result.push_back(static_cast<utils::algorithms::Isa>(i));
+    }
+    return result;
+  }
+};
@@ -0,0 +1,147 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <lib/mapped_vector/mapped_vector.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "test_types.hpp"
+
+namespace {
+
+struct Record {
+  std::uint64_t id;
+  double value;
+  char tag[8];
+};
+
+using Mode = utils::MappedVector<Record>::Mode;
+
+Record make_record(std::uint64_t i) {
+  Record r{i, static_cast<double>(i) * 0.5, {}};
+  r.tag[0] = static_cast<char>('a' + i % 26);
+  return r;
+}
+
+void expect_records(const utils::MappedVector<Record>& v, std::uint64_t count) {
+  ASSERT_EQ(count, v.size());
+  for (std::uint64_t i = 0; i < count; ++i) {
+    EXPECT_EQ(i, v[i].id);
+    EXPECT_EQ(static_cast<double>(i) * 0.5, v[i].value);
+    EXPECT_EQ(static_cast<char>('a' + i % 26), v[i].tag[0]);
+  }
+}
+
+}  // namespace
+
+TEST(MappedVector, CreateAndReopen) {
+  TempFile file("mapped_create");
+  {
+    utils::MappedVector<Record> v(file.path(), Mode::kCreate);
+    EXPECT_TRUE(v.writable());
+    for (std::uint64_t i = 0; i < 10000; ++i) v.push_back(make_record(i));
+    EXPECT_GE(v.capacity(), 10000);
+  }
+  EXPECT_EQ(10000 * sizeof(Record), file.size());
+
+  utils::MappedVector<Record> reopened(file.path());
+  EXPECT_FALSE(reopened.writable());
+  expect_records(reopened, 10000);
+}
+
+TEST(MappedVector, GrowExistingFile) {
+  TempFile file("mapped_grow");
+  {
+    utils::MappedVector<Record> v(file.path(), Mode::kCreate);
+    for (std::uint64_t i = 0; i < 100; ++i) v.push_back(make_record(i));
+  }
+  {
+    utils::MappedVector<Record> v(file.path(), Mode::kReadWrite);
+    expect_records(v, 100);
+    for (std::uint64_t i = 100; i < 5000; ++i) v.push_back(make_record(i));
+    v.flush();
+    v.flush(false);
+  }
+  utils::MappedVector<Record> reopened(file.path());
+  expect_records(reopened, 5000);
+}
+
+TEST(MappedVector, AppendFromItself) {
+  TempFile file("mapped_alias");
+  utils::MappedVector<Record> v(file.path(), Mode::kCreate);
+  for (std::uint64_t i = 0; i < 8; ++i) v.push_back(make_record(i));
+  v.shrink_to_fit();
+  v.append(v.data(), v.size());
+  ASSERT_EQ(16, v.size());
+  for (std::uint64_t i = 0; i < 16; ++i) EXPECT_EQ(i % 8, v[i].id);
+  v.push_back(v[0]);
+  EXPECT_EQ(0, v.back().id);
+}
+
+TEST(MappedVector, ResizeZeroFillsAndShrinkTrimsFile) {
+  TempFile file("mapped_resize");
+  utils::MappedVector<Record> v(file.path(), Mode::kCreate);
+  v.push_back(make_record(7));
+  v.pop_back();
+  v.resize(3);
+  ASSERT_EQ(3, v.size());
+  for (const Record& r : v) {
+    EXPECT_EQ(0, r.id);
+    EXPECT_EQ(0.0, r.value);
+  }
+  v.reserve(1000);
+  EXPECT_EQ(1000 * sizeof(Record), file.size());
+  v.shrink_to_fit();
+  EXPECT_EQ(3, v.capacity());
+  EXPECT_EQ(3 * sizeof(Record), file.size());
+  v.close();
+  EXPECT_FALSE(v.is_open());
+  EXPECT_EQ(3 * sizeof(Record), file.size());
+}
+
+TEST(MappedVector, ReadOnlyRejectsMutation) {
+  TempFile file("mapped_readonly");
+  {
+    utils::MappedVector<Record> v(file.path(), Mode::kCreate);
+    v.push_back(make_record(1));
+  }
+  utils::MappedVector<Record> v(file.path());
+  EXPECT_THROW(v.push_back(make_record(2)), std::logic_error);
+  EXPECT_THROW(v.resize(10), std::logic_error);
+  EXPECT_THROW(v.clear(), std::logic_error);
+  EXPECT_EQ(1, v.size());
+  EXPECT_THROW(v.at(1), std::out_of_range);
+}
+
+TEST(MappedVector, OpenErrors) {
+  EXPECT_THROW(utils::MappedVector<Record>("/nonexistent/dir/file.bin"), std::system_error);
+
+  TempFile file("mapped_misaligned");
+  {
+    utils::MappedVector<char> bytes(file.path(), utils::MappedVector<char>::Mode::kCreate);
+    bytes.resize(sizeof(Record) + 1);
+  }
+  EXPECT_THROW(utils::MappedVector<Record>{file.path()}, std::runtime_error);
+}
+
+TEST(MappedVector, EmptyFileAndMove) {
+  TempFile file("mapped_empty");
+  utils::MappedVector<Record> v(file.path(), Mode::kCreate);
+  EXPECT_TRUE(v.empty());
+  EXPECT_EQ(nullptr, v.data());
+  v.push_back(make_record(0));
+
+  utils::MappedVector<Record> moved(std::move(v));
+  EXPECT_FALSE(v.is_open());
+  EXPECT_EQ(1, moved.size());
+
+  utils::MappedVector<Record> other;
+  other = std::move(moved);
+  EXPECT_EQ(0, other[0].id);
+  other.close();
+  EXPECT_EQ(sizeof(Record), file.size());
+}
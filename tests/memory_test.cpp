@@ -0,0 +1,252 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <lib/memory/memory.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+namespace {
+
+class CountingResource : public std::pmr::memory_resource {
+ public:
+  int allocations = 0;
+  int deallocations = 0;
+
+ private:
+  void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+    ++allocations;
+    return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+  }
+  void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+    ++deallocations;
+    std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+  }
+  bool do_is_equal(const memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+};
+
+}  // namespace
+
+// MonotonicArena
+TEST(MonotonicArena, BumpAllocation) {
+  utils::memory::MonotonicArena arena(1024);
+  void* a = arena.allocate(10, 1);
+  void* b = arena.allocate(10, 1);
+  EXPECT_EQ(static_cast<char*>(a) + 10, static_cast<char*>(b));
+
+  void* aligned = arena.allocate(8, 64);
+  EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(aligned) % 64);
+  EXPECT_EQ(28, arena.bytes_used());
+}
+
+TEST(MonotonicArena, ReleaseFreesAllChunks) {
+  CountingResource upstream;
+  {
+    utils::memory::MonotonicArena arena(256, &upstream);
+    for (int i = 0; i < 100; ++i) arena.allocate(100);
+    arena.allocate(10000);
+    EXPECT_GT(upstream.allocations, 1);
+    arena.release();
+    EXPECT_EQ(upstream.allocations, upstream.deallocations);
+    EXPECT_EQ(0, arena.bytes_used());
+    arena.allocate(16);
+  }
+  EXPECT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+TEST(MonotonicArena, ResetKeepsLargestChunk) {
+  CountingResource upstream;
+  utils::memory::MonotonicArena arena(256, &upstream);
+  for (int round = 0; round < 100; ++round) {
+    for (int i = 0; i < 50; ++i) arena.allocate(64);
+    arena.reset();
+  }
+  EXPECT_LE(upstream.allocations, 10);
+  EXPECT_EQ(upstream.allocations - 1, upstream.deallocations);
+  EXPECT_EQ(0, arena.bytes_used());
+}
+
+TEST(MonotonicArena, InitialBuffer) {
+  CountingResource upstream;
+  alignas(std::max_align_t) char buffer[512];
+  utils::memory::MonotonicArena arena(buffer, sizeof(buffer), &upstream);
+  void* p = arena.allocate(100);
+  EXPECT_GE(static_cast<char*>(p), buffer);
+  EXPECT_LT(static_cast<char*>(p), buffer + sizeof(buffer));
+  EXPECT_EQ(0, upstream.allocations);
+  arena.allocate(1000);
+  EXPECT_EQ(1, upstream.allocations);
+}
+
+TEST(MonotonicArena, VectorInArena) {
+  CountingResource upstream;
+  utils::memory::MonotonicArena arena(4096, &upstream);
+  {
+    utils::Vector<int, utils::memory::ArenaAllocator<int>> v(arena);
+    for (int i = 0; i < 1000; ++i) v.push_back(i);
+    EXPECT_EQ(999, v.back());
+
+    utils::Vector<int, utils::memory::ArenaAllocator<int>> copy(v);
+    EXPECT_EQ(v.get_allocator(), copy.get_allocator());
+    EXPECT_EQ(500, copy[500]);
+  }
+  EXPECT_EQ(0, upstream.deallocations);
+  arena.release();
+  EXPECT_EQ(upstream.allocations, upstream.deallocations);
+}
+
+// PoolResource
+TEST(PoolResource, ReusesFreedBlocks) {
+  utils::memory::PoolResource pool;
+  void* a = pool.allocate(24);
+  pool.deallocate(a, 24, alignof(std::max_align_t));
+  void* b = pool.allocate(32);
+  EXPECT_EQ(a, b);
+  void* c = pool.allocate(33);
+  EXPECT_NE(b, c);
+  EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(c) % alignof(std::max_align_t));
+  pool.deallocate(b, 32, alignof(std::max_align_t));
+  pool.deallocate(c, 33, alignof(std::max_align_t));
+}
+
+TEST(PoolResource, SmallBlocksHonourAlignment) {
+  utils::memory::PoolResource pool;
+  constexpr std::size_t kAlign = alignof(std::max_align_t);
+  std::vector<void*> blocks;
+  for (int i = 0; i < 16; ++i) {
+    for (std::size_t bytes : {std::size_t{1}, std::size_t{8}, kAlign - 1}) {
+      void* p = pool.allocate(bytes, kAlign);
+      EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(p) % kAlign) << bytes;
+      blocks.push_back(p);
+    }
+  }
+  for (void* p : blocks) pool.deallocate(p, 1, kAlign);
+  void* reused = pool.allocate(kAlign, kAlign);
+  EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(reused) % kAlign);
+  pool.deallocate(reused, kAlign, kAlign);
+}
+
+TEST(PoolResource, LargeAllocationsGoUpstream) {
+  CountingResource upstream;
+  utils::memory::PoolResource pool(utils::memory::kDefaultChunkSize, &upstream);
+  void* big = pool.allocate(utils::memory::PoolResource::kMaxBlock + 1);
+  EXPECT_EQ(1, upstream.allocations);
+  pool.deallocate(big, utils::memory::PoolResource::kMaxBlock + 1,
+                  alignof(std::max_align_t));
+  EXPECT_EQ(1, upstream.deallocations);
+}
+
+TEST(PoolResource, VectorWithPoolAllocator) {
+  utils::memory::PoolResource pool;
+  utils::Vector<std::string, utils::memory::PoolAllocator<std::string>> v(pool);
+  for (int i = 0; i < 200; ++i) v.push_back(std::to_string(i));
+  EXPECT_EQ("199", v.back());
+  v.shrink_to_fit();
+  EXPECT_EQ(200, v.capacity());
+  EXPECT_EQ("42", v[42]);
+}
+
+// utils::pmr::Vector
+TEST(PmrVector, AdapterBacksPolymorphicAllocator) {
+  CountingResource upstream;
+  utils::memory::MonotonicArena arena(1024, &upstream);
+  utils::memory::MemoryResourceAdapter adapter(arena);
+
+  utils::pmr::Vector<int> v(&adapter);
+  for (int i = 0; i < 100; ++i) v.push_back(i);
+  EXPECT_EQ(&adapter, v.get_allocator().resource());
+  EXPECT_GT(arena.bytes_used(), 100 * sizeof(int));
+
+  utils::pmr::Vector<int> other(std::pmr::new_delete_resource());
+  other = v;
+  EXPECT_EQ(std::pmr::new_delete_resource(), other.get_allocator().resource());
+  EXPECT_EQ(99, other.back());
+
+  utils::pmr::Vector<int> moved(std::pmr::new_delete_resource());
+  moved = std::move(v);
+  EXPECT_EQ(100, moved.size());
+  EXPECT_EQ(std::pmr::new_delete_resource(), moved.get_allocator().resource());
+
+  other.swap(moved);
+  EXPECT_EQ(100, other.size());
+}
+
+TEST(PmrVector, AdapterEquality) {
+  utils::memory::PoolResource pool;
+  utils::memory::MemoryResourceAdapter a(pool);
+  utils::memory::MemoryResourceAdapter b(pool);
+  utils::memory::MonotonicArena arena;
+  utils::memory::MemoryResourceAdapter c(arena);
+  EXPECT_TRUE(a.is_equal(b));
+  EXPECT_FALSE(a.is_equal(c));
+}
+
+// PageAllocator
+TEST(PageAllocator, AlignmentAndReallocate) {
+  utils::memory::PageAllocator<int> alloc;
+  int* small = alloc.allocate(3);
+  EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(small) % 64);
+  small[0] = 1;
+  small[2] = 3;
+
+  // Small to mapped, mapped to larger mapped, mapped back to small.
+  int* p = alloc.reallocate(small, 3, 100000);
+  EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(p) % 4096);
+  EXPECT_EQ(3, p[2]);
+  for (int i = 0; i < 100000; ++i) p[i] = i;
+  p = alloc.reallocate(p, 100000, 4000000);
+  for (int i = 0; i < 100000; ++i) ASSERT_EQ(i, p[i]);
+  p = alloc.reallocate(p, 4000000, 10);
+  EXPECT_EQ(9, p[9]);
+  alloc.deallocate(p, 10);
+
+  utils::memory::PageAllocator<double, 4096> page_aligned;
+  double* d = page_aligned.allocate(1);
+  EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(d) % 4096);
+  page_aligned.deallocate(d, 1);
+}
+
+TEST(PageAllocator, HugeBlocksAreHugePageAligned) {
+  utils::memory::PageAllocator<char> alloc;
+  auto [p, count] = alloc.allocate_at_least(3 * utils::memory::kHugePageSize + 1);
+  EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(p) % utils::memory::kHugePageSize);
+  EXPECT_EQ(0, count % 4096);
+  EXPECT_GT(count, 3 * utils::memory::kHugePageSize);
+  p[count - 1] = 'x';
+  alloc.deallocate(p, count);
+}
+
+TEST(PageAllocator, VectorGrowsWithoutCopying) {
+  using Vector = utils::Vector<std::uint64_t, utils::memory::PageAllocator<std::uint64_t>,
+                               utils::DefaultGrowth, utils::VectorStats<std::uint64_t>>;
+  static_assert(utils::detail::reallocates_in_place<std::uint64_t,
+                                                    utils::memory::PageAllocator<std::uint64_t>>);
+  Vector v;
+  for (std::uint64_t i = 0; i < 1000000; ++i) {
+    v.push_back(i);
+    if (i == 0) {
+      EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(v.data()) % 64);
+    }
+  }
+  v.shrink_to_fit();
+  v.push_back(v[5]);
+  EXPECT_EQ(5, v.back());
+  for (std::uint64_t i = 0; i < 1000000; ++i) ASSERT_EQ(i, v[i]);
+  EXPECT_GT(v.stats().counters().reallocations, 5);
+  EXPECT_EQ(0, v.stats().counters().bytes_moved);
+
+  v.resize(10);
+  v.shrink_to_fit();
+  EXPECT_EQ(10, v.capacity());
+  EXPECT_EQ(9, v.back());
+
+  utils::Vector<std::string, utils::memory::PageAllocator<std::string>> strings;
+  for (int i = 0; i < 1000; ++i) strings.push_back(std::to_string(i));
+  EXPECT_EQ("999", strings.back());
+}
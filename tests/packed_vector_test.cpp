@@ -0,0 +1,203 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <lib/packed_vector/packed_vector.hpp>
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <random>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <lib/vector_algorithms/vector_algorithms.hpp>
+
+#include "gtest/gtest.h"
+#include "isa_test.hpp"
+
+namespace algo = utils::algorithms;
+
+namespace {
+
+// Set to make the next global operator new throw std::bad_alloc.
+bool fail_next_allocation = false;
+
+std::vector<std::uint64_t> random_values(std::size_t n, unsigned bits, unsigned seed) {
+  std::mt19937_64 rng(seed);
+  const std::uint64_t mask = bits == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << bits) - 1;
+  std::vector<std::uint64_t> values(n);
+  for (auto& value : values) value = rng() & mask;
+  return values;
+}
+
+}  // namespace
+
+void* operator new(std::size_t size) {
+  if (std::exchange(fail_next_allocation, false)) {
+    throw std::bad_alloc();
+  }
+  if (void* p = std::malloc(size == 0 ? 1 : size)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+TEST(PackedVector, PushBackAndRead) {
+  utils::PackedVector<20> v;
+  EXPECT_EQ(20, v.bits());
+  EXPECT_EQ((1u << 20) - 1, v.max_value());
+  for (std::uint64_t i = 0; i < 1000; ++i) v.push_back(i * 997 % (1 << 20));
+  ASSERT_EQ(1000, v.size());
+  for (std::uint64_t i = 0; i < 1000; ++i) EXPECT_EQ(i * 997 % (1 << 20), v[i]);
+  EXPECT_EQ(0, v.front());
+  EXPECT_LE(v.memory_bytes(), 2 * 1000 * 20 / 8 + 64);
+}
+
+TEST(PackedVector, ProxyReference) {
+  utils::PackedVector<> v(7, 10, 5);
+  v[3] = 127;
+  v[4] = v[3];
+  EXPECT_EQ(127, v[3]);
+  EXPECT_EQ(127, v[4]);
+  EXPECT_EQ(5, v[2]);
+  EXPECT_EQ(5, v[5]);
+  EXPECT_THROW(v[0] = 128, std::out_of_range);
+  EXPECT_EQ(5, v[0]);
+  EXPECT_THROW(v.at(10), std::out_of_range);
+}
+
+TEST(PackedVector, RejectsBadWidthAndValues) {
+  EXPECT_THROW(utils::PackedVector<>(0), std::invalid_argument);
+  EXPECT_THROW(utils::PackedVector<>(65), std::invalid_argument);
+  EXPECT_THROW(utils::PackedVector<8>(9), std::invalid_argument);
+  utils::PackedVector<3> v;
+  EXPECT_THROW(v.push_back(8), std::out_of_range);
+  EXPECT_TRUE(v.empty());
+}
+
+TEST(PackedVector, ResizeAndPop) {
+  utils::PackedVector<5> v(4, 31);
+  v.resize(2);
+  v.resize(6, 9);
+  EXPECT_EQ(31, v[1]);
+  EXPECT_EQ(9, v[2]);
+  EXPECT_EQ(9, v[5]);
+  v.pop_back();
+  v.push_back(1);
+  EXPECT_EQ(1, v.back());
+  EXPECT_EQ(6, v.size());
+  v.shrink_to_fit();
+  EXPECT_EQ(31, v[0]);
+  EXPECT_GE(v.capacity(), v.size());
+
+  v.clear();
+  EXPECT_THROW(v.pop_back(), std::out_of_range);
+  EXPECT_EQ(0, v.size());
+}
+
+TEST(PackedVector, EveryWidthRoundTrips) {
+  for (unsigned bits = 1; bits <= 64; ++bits) {
+    const auto values = random_values(301, bits, bits);
+    auto v = utils::PackedVector<>(bits);
+    v.append_range(values);
+    ASSERT_EQ(values.size(), v.size());
+    for (std::size_t i = 0; i < values.size(); ++i) ASSERT_EQ(values[i], v[i]) << bits;
+
+    utils::Vector<std::uint64_t> decoded;
+    v.decode(decoded);
+    ASSERT_EQ(values, std::vector<std::uint64_t>(decoded.begin(), decoded.end())) << bits;
+  }
+}
+
+TEST(PackedVector, EncodePicksNarrowestWidth) {
+  const std::vector<std::uint32_t> values = {3, 1000, 70000, 0};
+  const auto v = utils::PackedVector<>::encode(values);
+  EXPECT_EQ(17, v.bits());
+  EXPECT_EQ(70000, v[2]);
+  EXPECT_EQ(1, utils::PackedVector<>::encode(std::vector<std::uint8_t>{0, 0}).bits());
+}
+
+TEST_F(IsaTest, DecodeMatchesScalarOnEveryIsa) {
+  for (algo::Isa isa : isas()) {
+    algo::set_active_isa(isa);
+    for (unsigned bits : {1u, 7u, 13u, 20u, 32u, 33u, 57u, 58u, 64u}) {
+      const auto values = random_values(1000, bits, bits);
+      auto v = utils::PackedVector<>::encode(values);
+      v.resize(values.size());
+
+      std::vector<std::uint64_t> wide(990);
+      v.decode(5, wide.size(), wide.data());
+      for (std::size_t i = 0; i < wide.size(); ++i) {
+        ASSERT_EQ(values[i + 5], wide[i]) << algo::isa_name(isa) << bits;
+      }
+      if (bits <= 32) {
+        utils::Vector<std::uint32_t> narrow;
+        v.decode(narrow);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+          ASSERT_EQ(values[i], narrow[i]) << algo::isa_name(isa) << bits;
+        }
+      } else {
+        utils::Vector<std::uint32_t> narrow;
+        EXPECT_THROW(v.decode(narrow), std::invalid_argument);
+      }
+    }
+  }
+}
+
+TEST(PackedVector, DecodeRangeChecked) {
+  utils::PackedVector<9> v(10, 1);
+  std::uint64_t out[16];
+  EXPECT_THROW(v.decode(5, 6, out), std::out_of_range);
+  v.decode(10, 0, out);
+}
+
+TEST(DeltaPackedVector, RoundTripsSortedData) {
+  std::mt19937_64 rng(7);
+  std::vector<std::uint64_t> values;
+  std::uint64_t value = std::uint64_t{1} << 40;
+  for (int i = 0; i < 10000; ++i) {
+    value += rng() % 50;
+    values.push_back(value);
+  }
+  const auto v = utils::DeltaPackedVector::encode(values);
+  ASSERT_EQ(values.size(), v.size());
+  for (std::size_t i = 0; i < values.size(); ++i) ASSERT_EQ(values[i], v[i]);
+  EXPECT_EQ(values.back(), v.back());
+  // 6-bit gaps instead of 41-bit values.
+  EXPECT_LT(v.memory_bytes(), values.size() * sizeof(std::uint64_t) / 4);
+
+  utils::Vector<std::uint64_t> decoded;
+  v.decode(decoded);
+  EXPECT_EQ(values, std::vector<std::uint64_t>(decoded.begin(), decoded.end()));
+}
+
+TEST(DeltaPackedVector, RejectsDecreasingValues) {
+  utils::DeltaPackedVector v;
+  v.push_back(5);
+  v.push_back(5);
+  EXPECT_THROW(v.push_back(4), std::invalid_argument);
+  EXPECT_EQ(2, v.size());
+  EXPECT_THROW(v.at(2), std::out_of_range);
+  v.clear();
+  EXPECT_TRUE(v.empty());
+  v.push_back(1);
+  EXPECT_EQ(1, v[0]);
+}
+
+TEST(DeltaPackedVector, FailedFlushKeepsContents) {
+  using Delta = utils::DeltaPackedVector;
+  Delta v;
+  for (std::uint64_t i = 0; i < Delta::kBlock; ++i) v.push_back(3 * i);
+  // The tail is full; the next push flushes it and the flush cannot grow.
+  fail_next_allocation = true;
+  EXPECT_THROW(v.push_back(1000), std::bad_alloc);
+  fail_next_allocation = false;
+  ASSERT_EQ(Delta::kBlock, v.size());
+  EXPECT_EQ(3 * (Delta::kBlock - 1), v.back());
+
+  for (std::uint64_t i = Delta::kBlock; i < 3 * Delta::kBlock; ++i) v.push_back(3 * i);
+  ASSERT_EQ(3 * Delta::kBlock, v.size());
+  for (std::uint64_t i = 0; i < v.size(); ++i) ASSERT_EQ(3 * i, v[i]);
+}
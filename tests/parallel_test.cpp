@@ -0,0 +1,291 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <lib/parallel/parallel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <lib/vector/vector.hpp>
+
+#include "gtest/gtest.h"
+#include "test_types.hpp"
+
+namespace parallel = utils::parallel;
+
+namespace {
+
+// Small grains so that even short inputs are split across many chunks.
+parallel::Options options_for(parallel::ThreadPool& pool, std::size_t grain = 100) {
+  parallel::Options options;
+  options.pool = &pool;
+  options.grain = grain;
+  options.serial_threshold = 0;
+  return options;
+}
+
+utils::Vector<std::int64_t> random_vector(std::size_t n, unsigned seed) {
+  std::mt19937_64 rng(seed);
+  utils::Vector<std::int64_t> v;
+  for (std::size_t i = 0; i < n; ++i) {
+    v.push_back(static_cast<std::int64_t>(rng() % 1000));
+  }
+  return v;
+}
+
+std::vector<std::int64_t> to_std(const utils::Vector<std::int64_t>& v) {
+  return std::vector<std::int64_t>(v.begin(), v.end());
+}
+
+const std::size_t kSizes[] = {0, 1, 99, 100, 101, 1000, 12345};
+
+}  // namespace
+
+TEST(ThreadPool, RunsEverySubmittedTask) {
+  parallel::ThreadPool pool(4);
+  EXPECT_EQ(4, pool.size());
+  std::atomic<int> done = 0;
+  {
+    parallel::TaskGroup group(pool);
+    for (int i = 0; i < 1000; ++i) {
+      group.run([&] { done.fetch_add(1); });
+    }
+    group.wait();
+  }
+  EXPECT_EQ(1000, done.load());
+}
+
+TEST(ThreadPool, SingleThreadRunsOnCaller) {
+  parallel::ThreadPool pool(1);
+  utils::Vector<std::int64_t> v = random_vector(5000, 1);
+  EXPECT_EQ(std::accumulate(v.begin(), v.end(), std::int64_t{0}),
+            parallel::reduce(v, std::int64_t{0}, std::plus<>{}, options_for(pool)));
+}
+
+TEST(ThreadPool, NestedAndExceptions) {
+  parallel::ThreadPool pool(3);
+  parallel::Options options = options_for(pool, 10);
+  std::atomic<int> inner = 0;
+  utils::Vector<int> outer(20, 0);
+  parallel::for_each(
+      outer,
+      [&](int&) {
+        utils::Vector<int> nested(100, 1);
+        inner += static_cast<int>(parallel::reduce(nested, 0, std::plus<>{}, options));
+      },
+      options);
+  EXPECT_EQ(2000, inner.load());
+
+  utils::Vector<int> v(1000, 0);
+  EXPECT_THROW(
+      parallel::for_each(v, [](int&) { throw std::runtime_error("task failed"); }, options),
+      std::runtime_error);
+}
+
+TEST(Parallel, ForEachAndTransform) {
+  parallel::ThreadPool pool(4);
+  for (std::size_t n : kSizes) {
+    utils::Vector<std::int64_t> v = random_vector(n, 2);
+    std::vector<std::int64_t> expected = to_std(v);
+    for (std::int64_t& x : expected) x = x * 3 + 1;
+
+    parallel::for_each(v, [](std::int64_t& x) { x = x * 3 + 1; }, options_for(pool));
+    EXPECT_EQ(expected, to_std(v));
+
+    utils::Vector<std::int64_t> out(n, 0);
+    parallel::transform(v, out, [](std::int64_t x) { return -x; }, options_for(pool));
+    for (std::size_t i = 0; i < n; ++i) EXPECT_EQ(-expected[i], out[i]);
+
+    parallel::transform(v, v, [](std::int64_t x) { return x / 2; }, options_for(pool));
+    for (std::size_t i = 0; i < n; ++i) EXPECT_EQ(expected[i] / 2, v[i]);
+  }
+
+  utils::Vector<int> in(10, 0);
+  utils::Vector<int> short_out(9, 0);
+  EXPECT_THROW(parallel::transform(in, short_out, [](int x) { return x; }), std::invalid_argument);
+}
+
+TEST(Parallel, ReduceIsIndependentOfThreadCount) {
+  utils::Vector<double> v;
+  std::mt19937_64 rng(3);
+  for (int i = 0; i < 100000; ++i) {
+    v.push_back(std::uniform_real_distribution<double>(-1, 1)(rng));
+  }
+  parallel::ThreadPool one(1);
+  parallel::ThreadPool four(4);
+  parallel::Options options = options_for(one, 1000);
+  const double single = parallel::reduce(v, 0.0, std::plus<>{}, options);
+  options.pool = &four;
+  EXPECT_EQ(single, parallel::reduce(v, 0.0, std::plus<>{}, options));
+  options.threads = 2;
+  EXPECT_EQ(single, parallel::reduce(v, 0.0, std::plus<>{}, options));
+  EXPECT_NEAR(std::accumulate(v.begin(), v.end(), 0.0), single, 1e-9);
+}
+
+TEST(Parallel, ReduceAccumulatesInTheInitType) {
+  parallel::ThreadPool pool(4);
+  utils::Vector<std::int32_t> ints(100000, 1000000);
+  EXPECT_EQ(std::int64_t{100000000000}, parallel::reduce(ints, std::int64_t{0}, std::plus<>{},
+                                                         options_for(pool, 1000)));
+
+  utils::Vector<float> floats(100000, 0.1f);
+  const double serial = std::accumulate(floats.begin(), floats.end(), 0.0);
+  EXPECT_NEAR(serial, parallel::reduce(floats, 0.0, std::plus<>{}, options_for(pool, 1000)), 1e-6);
+}
+
+TEST(Parallel, Scans) {
+  parallel::ThreadPool pool(4);
+  for (std::size_t n : kSizes) {
+    utils::Vector<std::int64_t> v = random_vector(n, 4);
+    std::vector<std::int64_t> src = to_std(v);
+    std::vector<std::int64_t> inclusive(n);
+    std::vector<std::int64_t> exclusive(n);
+    std::inclusive_scan(src.begin(), src.end(), inclusive.begin());
+    std::exclusive_scan(src.begin(), src.end(), exclusive.begin(), std::int64_t{7});
+
+    utils::Vector<std::int64_t> out(n, 0);
+    parallel::inclusive_scan(v, out, std::plus<>{}, options_for(pool));
+    EXPECT_EQ(inclusive, to_std(out)) << n;
+    parallel::exclusive_scan(v, out, std::int64_t{7}, std::plus<>{}, options_for(pool));
+    EXPECT_EQ(exclusive, to_std(out)) << n;
+
+    parallel::inclusive_scan(v, v, std::plus<>{}, options_for(pool));
+    EXPECT_EQ(inclusive, to_std(v)) << n;
+  }
+
+  // Non-commutative operation: string concatenation keeps the order.
+  utils::Vector<std::string> words;
+  for (int i = 0; i < 500; ++i) words.push_back(std::string(1, static_cast<char>('a' + i % 26)));
+  utils::Vector<std::string> joined(500, std::string());
+  parallel::exclusive_scan(words, joined, std::string(">"), std::plus<>{}, options_for(pool, 7));
+  std::string expected = ">";
+  for (int i = 0; i < 500; ++i) {
+    ASSERT_EQ(expected, joined[i]);
+    expected += words[i];
+  }
+}
+
+TEST(Parallel, Sort) {
+  parallel::ThreadPool pool(4);
+  for (std::size_t n : kSizes) {
+    for (std::size_t grain : {7, 100, 1000}) {
+      utils::Vector<std::int64_t> v = random_vector(n, static_cast<unsigned>(n + grain));
+      std::vector<std::int64_t> expected = to_std(v);
+      std::sort(expected.begin(), expected.end());
+      parallel::sort(v, std::less<>{}, options_for(pool, grain));
+      EXPECT_EQ(expected, to_std(v)) << n << " " << grain;
+
+      parallel::sort(v, std::greater<>{}, options_for(pool, grain));
+      std::reverse(expected.begin(), expected.end());
+      EXPECT_EQ(expected, to_std(v)) << n << " " << grain;
+    }
+  }
+}
+
+TEST(Parallel, StableSortOfMoveOnlyValues) {
+  parallel::ThreadPool pool(4);
+  using Item = std::pair<int, std::unique_ptr<int>>;
+  utils::Vector<Item> v;
+  std::mt19937 rng(5);
+  for (int i = 0; i < 10000; ++i) {
+    v.push_back(Item(static_cast<int>(rng() % 50), std::make_unique<int>(i)));
+  }
+  parallel::stable_sort(
+      v, [](const Item& a, const Item& b) { return a.first < b.first; }, options_for(pool, 333));
+  for (std::size_t i = 1; i < v.size(); ++i) {
+    ASSERT_LE(v[i - 1].first, v[i].first);
+    if (v[i - 1].first == v[i].first) {
+      ASSERT_LT(*v[i - 1].second, *v[i].second);
+    }
+  }
+}
+
+TEST(Parallel, SerialBelowThreshold) {
+  parallel::ThreadPool pool(4);
+  parallel::Options options;
+  options.pool = &pool;
+  std::atomic<int> calls = 0;
+  parallel::for_each_chunk(
+      options.serial_threshold - 1, [&](std::size_t, std::size_t) { ++calls; }, options);
+  EXPECT_EQ(1, calls.load());
+
+  calls = 0;
+  parallel::for_each_chunk(
+      std::size_t{1} << 20, [&](std::size_t, std::size_t) { ++calls; }, options);
+  EXPECT_EQ(static_cast<int>(parallel::Options::kMaxChunks), calls.load());
+}
+
+TEST(Parallel, VectorConstructionPolicy) {
+  parallel::ThreadPool pool(4);
+  const parallel::Policy policy{options_for(pool, 1000)};
+
+  utils::Vector<std::int64_t> filled(policy, 12345, std::int64_t{7});
+  ASSERT_EQ(12345, filled.size());
+  EXPECT_EQ(12345 * 7, std::accumulate(filled.begin(), filled.end(), std::int64_t{0}));
+
+  utils::Vector<std::int64_t> copy(policy, filled);
+  EXPECT_EQ(to_std(filled), to_std(copy));
+
+  copy.resize(policy, 20000, 3);
+  ASSERT_EQ(20000, copy.size());
+  EXPECT_EQ(7, copy[12344]);
+  EXPECT_EQ(3, copy[12345]);
+  EXPECT_EQ(3, copy[19999]);
+  copy.resize(policy, 10, 0);
+  EXPECT_EQ(10, copy.size());
+
+  copy.assign(policy, 5000, 9);
+  EXPECT_EQ(std::vector<std::int64_t>(5000, 9), to_std(copy));
+
+  utils::Vector<std::int64_t> small(parallel::par, 3, std::int64_t{1});
+  EXPECT_EQ(3, small.size());
+}
+
+TEST(Parallel, VectorMoveConstructionAcrossAllocators) {
+  using Strings = utils::Vector<std::string, ThrowingAllocator<std::string>>;
+  parallel::ThreadPool pool(4);
+  const parallel::Policy policy{options_for(pool, 64)};
+  ThrowingAllocator<std::string> a;
+  ThrowingAllocator<std::string> b;
+
+  Strings source(policy, 1000, std::string(30, 'q'), a);
+  Strings moved(policy, std::move(source), b);
+  EXPECT_EQ(1000, moved.size());
+  EXPECT_EQ(std::string(30, 'q'), moved[999]);
+  EXPECT_TRUE(source.empty());
+
+  Strings stolen(policy, std::move(moved), b);
+  EXPECT_EQ(1000, stolen.size());
+  EXPECT_TRUE(moved.empty());
+}
+
+TEST(Parallel, VectorConstructionDestroysBuiltElementsOnThrow) {
+  parallel::ThreadPool pool(4);
+  const parallel::Policy policy{options_for(pool, 50)};
+  {
+    const LiveCounted value(5);
+    LiveCounted::copies_left = 777;
+    EXPECT_THROW((utils::Vector<LiveCounted>(policy, 5000, value)), std::runtime_error);
+    EXPECT_EQ(1, LiveCounted::live.load());
+
+    LiveCounted::copies_left = -1;
+    utils::Vector<LiveCounted> source(policy, 5000, value);
+    LiveCounted::copies_left = 3000;
+    EXPECT_THROW((utils::Vector<LiveCounted>(policy, source)), std::runtime_error);
+    EXPECT_EQ(5001, LiveCounted::live.load());
+
+    LiveCounted::copies_left = 100;
+    EXPECT_THROW(source.resize(policy, 9000, value), std::runtime_error);
+    EXPECT_EQ(5000, source.size());
+    EXPECT_EQ(5001, LiveCounted::live.load());
+    LiveCounted::copies_left = -1;
+  }
+  EXPECT_EQ(0, LiveCounted::live.load());
+}
@@ -0,0 +1,197 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <lib/serialization/serialization.hpp>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+#include <lib/vector/vector.hpp>
+
+#include "gtest/gtest.h"
+#include "test_types.hpp"
+
+namespace {
+
+struct Record {
+  std::uint64_t id;
+  double value;
+  char tag[8];
+};
+
+Record make_record(std::uint64_t i) {
+  Record r{i, static_cast<double>(i) * 0.5, {}};
+  r.tag[0] = static_cast<char>('a' + i % 26);
+  return r;
+}
+
+utils::Vector<Record> make_records(std::uint64_t count) {
+  utils::Vector<Record> v;
+  for (std::uint64_t i = 0; i < count; ++i) v.push_back(make_record(i));
+  return v;
+}
+
+void expect_records(const utils::Vector<Record>& v, std::uint64_t first, std::uint64_t count) {
+  ASSERT_EQ(count, v.size());
+  for (std::uint64_t i = 0; i < count; ++i) {
+    ASSERT_EQ(first + i, v[i].id);
+    ASSERT_EQ(static_cast<double>(first + i) * 0.5, v[i].value);
+    ASSERT_EQ(static_cast<char>('a' + (first + i) % 26), v[i].tag[0]);
+  }
+}
+
+}  // namespace
+
+TEST(Serialization, ChecksumIsXxh64) {
+  EXPECT_EQ(0xEF46DB3751D8E999ULL, utils::detail::checksum("", 0));
+  EXPECT_EQ(0x44BC2CF5AD770999ULL, utils::detail::checksum("abc", 3));
+
+  // Feeding the same bytes in uneven pieces gives the same digest.
+  unsigned char bytes[1000];
+  for (int i = 0; i < 1000; ++i) bytes[i] = static_cast<unsigned char>(i * 31 + 7);
+  utils::detail::Checksum pieces;
+  for (std::size_t offset = 0, step = 1; offset < 1000; offset += step, step = step * 3 % 61 + 1) {
+    pieces.update(bytes + offset, std::min<std::size_t>(step, 1000 - offset));
+  }
+  EXPECT_EQ(utils::detail::checksum(bytes, 1000), pieces.digest());
+}
+
+TEST(Serialization, SaveAndLoadFile) {
+  TempFile file("serialization_roundtrip");
+  const utils::Vector<Record> records = make_records(10000);
+  utils::save(file.path(), records);
+  EXPECT_EQ(sizeof(utils::SerializedHeader) + 10000 * sizeof(Record), file.size());
+
+  utils::Vector<Record> loaded;
+  loaded.reserve(20000);
+  const Record* buffer = loaded.data();
+  utils::load(file.path(), loaded);
+  expect_records(loaded, 0, 10000);
+  EXPECT_EQ(buffer, loaded.data());
+
+  utils::save(file.path(), utils::Vector<Record>());
+  utils::load(file.path(), loaded);
+  EXPECT_TRUE(loaded.empty());
+}
+
+TEST(Serialization, SeveralVectorsThroughPipe) {
+  int fds[2];
+  ASSERT_EQ(0, ::pipe(fds));
+  utils::Vector<std::int32_t> first;
+  utils::Vector<std::int32_t> second;
+  for (int i = 0; i < 1000; ++i) {
+    first.push_back(i);
+    second.push_back(-i);
+  }
+  utils::save(fds[1], first);
+  utils::save(fds[1], second);
+  ::close(fds[1]);
+
+  utils::Vector<std::int32_t> a;
+  utils::Vector<std::int32_t> b;
+  utils::load(fds[0], a);
+  utils::load(fds[0], b);
+  ::close(fds[0]);
+  ASSERT_EQ(1000, a.size());
+  ASSERT_EQ(1000, b.size());
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(i, a[i]);
+    ASSERT_EQ(-i, b[i]);
+  }
+}
+
+TEST(Serialization, RejectsBadInput) {
+  TempFile file("serialization_bad");
+  utils::Vector<Record> loaded;
+  EXPECT_THROW(utils::load(file.path(), loaded), std::system_error);
+
+  const utils::Vector<Record> records = make_records(100);
+  const std::size_t header = sizeof(utils::SerializedHeader);
+
+  utils::save(file.path(), records);
+  file.patch(header + 50, 'X');
+  EXPECT_THROW(utils::load(file.path(), loaded), std::runtime_error);
+  EXPECT_TRUE(loaded.empty());
+
+  utils::save(file.path(), records);
+  utils::Vector<std::uint32_t> wrong_type;
+  EXPECT_THROW(utils::load(file.path(), wrong_type), std::runtime_error);
+
+  utils::save(file.path(), records);
+  file.patch(offsetof(utils::SerializedHeader, big_endian), 2);
+  EXPECT_THROW(utils::load(file.path(), loaded), std::runtime_error);
+
+  utils::save(file.path(), records);
+  file.patch(0, 'X');
+  EXPECT_THROW(utils::load(file.path(), loaded), std::runtime_error);
+
+  utils::save(file.path(), records);
+  std::filesystem::resize_file(file.path(), header + 99 * sizeof(Record));
+  EXPECT_THROW(utils::load(file.path(), loaded), std::runtime_error);
+  std::filesystem::resize_file(file.path(), header - 1);
+  EXPECT_THROW(utils::load(file.path(), loaded), std::runtime_error);
+
+  // A count far beyond the file is rejected before anything is allocated.
+  utils::save(file.path(), records);
+  file.patch(offsetof(utils::SerializedHeader, count) + 5, 1);
+  EXPECT_THROW(utils::load(file.path(), loaded), std::runtime_error);
+  EXPECT_THROW(utils::VectorReader<Record>(file.path()), std::runtime_error);
+}
+
+TEST(Serialization, ReaderFillsReusableWindow) {
+  TempFile file("serialization_reader");
+  utils::save(file.path(), make_records(10000));
+
+  utils::VectorReader<Record> reader(file.path());
+  EXPECT_EQ(10000, reader.size());
+  utils::Vector<Record> window;
+  std::uint64_t seen = 0;
+  const Record* buffer = nullptr;
+  while (reader.next(window, 333)) {
+    expect_records(window, seen, std::min<std::uint64_t>(333, 10000 - seen));
+    if (buffer == nullptr) buffer = window.data();
+    EXPECT_EQ(buffer, window.data());
+    seen += window.size();
+    EXPECT_EQ(10000 - seen, reader.remaining());
+  }
+  EXPECT_EQ(10000, seen);
+  EXPECT_TRUE(window.empty());
+  EXPECT_FALSE(reader.next(window, 333));
+}
+
+TEST(Serialization, ReaderChecksLastWindow) {
+  TempFile file("serialization_reader_bad");
+  utils::save(file.path(), make_records(1000));
+  file.patch(sizeof(utils::SerializedHeader) + 10, 'X');
+
+  utils::VectorReader<Record> reader(file.path());
+  utils::Vector<Record> window;
+  EXPECT_TRUE(reader.next(window, 600));
+  EXPECT_THROW(reader.next(window, 600), std::runtime_error);
+  EXPECT_THROW(utils::VectorReader<std::uint32_t>{file.path()}, std::runtime_error);
+}
+
+TEST(Serialization, LoadCountsConstructedElements) {
+  using CountedRecords = utils::Vector<Record, std::allocator<Record>, utils::DefaultGrowth,
+                                       utils::VectorStats<Record>>;
+  TempFile file("serialization_stats");
+  utils::save(file.path(), make_records(1000));
+
+  CountedRecords loaded;
+  utils::load(file.path(), loaded);
+  EXPECT_EQ(1000, loaded.stats().counters().constructed);
+  utils::VectorReader<Record> reader(file.path());
+  while (reader.next(loaded, 300)) {
+  }
+  loaded.clear();
+  EXPECT_EQ(2000, loaded.stats().counters().constructed);
+  EXPECT_EQ(2000, loaded.stats().counters().destroyed);
+}
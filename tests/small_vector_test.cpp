@@ -0,0 +1,421 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <lib/small_vector/small_vector.hpp>
+
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test_types.hpp"
+
+template <typename T>
+class CountingAllocator {
+ public:
+  using value_type = T;
+
+  CountingAllocator() noexcept = default;
+  template <typename U>
+  CountingAllocator(const CountingAllocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    ++allocations;
+    return std::allocator<T>().allocate(n);
+  }
+  void deallocate(T* p, std::size_t n) noexcept {
+    ++deallocations;
+    std::allocator<T>().deallocate(p, n);
+  }
+  bool operator==(const CountingAllocator&) const { return true; }
+
+  static inline int allocations = 0;
+  static inline int deallocations = 0;
+};
+
+// Constructors
+TEST(SmallVector, DefaultConstructor) {
+  utils::SmallVector<int, 4> v;
+  EXPECT_EQ(0, v.size());
+  EXPECT_EQ(4, v.capacity());
+  EXPECT_TRUE(v.is_inline());
+}
+
+TEST(SmallVector, CopyConstructor) {
+  utils::SmallVector<char, 2> v = {'b', 'y', 'm', 'q', 'f'};
+  utils::SmallVector<char, 2> copy = v;
+
+  ASSERT_EQ(v.size(), copy.size());
+  for (size_t i = 0; i < v.size(); ++i) {
+    EXPECT_EQ(v.at(i), copy.at(i));
+  }
+}
+
+// Iterators
+TEST(SmallVector, IteratorBegin) {
+  utils::SmallVector<int, 4> v = {7, 13, 21};
+
+  EXPECT_EQ(7, *v.begin());
+  EXPECT_EQ(13, *(v.begin() + 1));
+
+  const utils::SmallVector<int, 4> cv = v;
+  EXPECT_EQ(7, *cv.begin());
+}
+
+TEST(SmallVector, IteratorEnd) {
+  utils::SmallVector<int, 4> v = {5, 15, 25};
+  EXPECT_EQ(25, *(v.end() - 1));
+
+  utils::SmallVector<int, 4> empty_vec;
+  EXPECT_EQ(empty_vec.begin(), empty_vec.end());
+}
+
+TEST(SmallVector, IteratorSequence) {
+  utils::SmallVector<int, 2> v = {100, 200, 300, 400};
+  int expected_values[] = {100, 200, 300, 400};
+  size_t index = 0;
+
+  for (auto it = v.begin(); it != v.end(); ++it) {
+    EXPECT_EQ(*it, expected_values[index++]);
+  }
+}
+
+TEST(SmallVector, ContainerTypeAliases) {
+  using V = utils::SmallVector<int, 4>;
+  static_assert(std::same_as<V::const_iterator, decltype(std::declval<const V&>().begin())>);
+  static_assert(std::same_as<V::iterator, decltype(std::declval<V&>().begin())>);
+  static_assert(std::same_as<V::const_reverse_iterator, V::ConstReverseIterator>);
+  static_assert(std::same_as<V::reverse_iterator, V::ReverseIterator>);
+  static_assert(std::same_as<V::size_type, std::size_t>);
+  static_assert(std::same_as<V::difference_type, std::ptrdiff_t>);
+  static_assert(std::same_as<V::reference, int&>);
+  static_assert(std::same_as<V::const_reference, const int&>);
+  static_assert(std::same_as<V::pointer, int*>);
+  static_assert(std::same_as<V::const_pointer, const int*>);
+
+  V v = {1, 2, 3};
+  EXPECT_EQ(3, v.end() - v.cbegin());
+}
+
+// Capacity
+TEST(SmallVector, Size) {
+  utils::SmallVector<double, 1> v;
+  EXPECT_EQ(0, v.size());
+
+  v.push_back(2.71);
+  EXPECT_EQ(1, v.size());
+
+  v.push_back(1.41);
+  EXPECT_EQ(2, v.size());
+}
+
+TEST(SmallVector, Capacity) {
+  utils::SmallVector<int, 16> v;
+  EXPECT_EQ(16, v.capacity());
+
+  for (int i = 0; i < 50; ++i) {
+    v.push_back(i + 100);
+  }
+  EXPECT_GE(v.capacity(), 50);
+  EXPECT_FALSE(v.is_inline());
+}
+
+TEST(SmallVector, StaysInline) {
+  using Alloc = CountingAllocator<int>;
+  Alloc::allocations = 0;
+  Alloc::deallocations = 0;
+  {
+    utils::SmallVector<int, 8, Alloc> v;
+    for (int i = 0; i < 8; ++i) v.push_back(i);
+    EXPECT_EQ(0, Alloc::allocations);
+    EXPECT_TRUE(v.is_inline());
+    v.insert(v.begin(), -1);
+    EXPECT_EQ(9, v.size());
+    EXPECT_FALSE(v.is_inline());
+  }
+  EXPECT_EQ(1, Alloc::allocations);
+  EXPECT_EQ(1, Alloc::deallocations);
+}
+
+TEST(SmallVector, ShrinkToFitReturnsInline) {
+  utils::SmallVector<std::string, 4> v = {"a", "b", "c", "d", "e", "f"};
+  EXPECT_FALSE(v.is_inline());
+  v.pop_back();
+  v.pop_back();
+  v.pop_back();
+  v.shrink_to_fit();
+  EXPECT_TRUE(v.is_inline());
+  EXPECT_EQ(4, v.capacity());
+  ASSERT_EQ(3, v.size());
+  EXPECT_EQ("c", v[2]);
+}
+
+// Modifiers
+TEST(SmallVector, PushBack) {
+  utils::SmallVector<int, 4> v;
+  for (int i = 0; i < 8; ++i) v.push_back(i * 5);
+
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(i * 5, v[i]);
+  }
+
+  v.push_back(500);
+  EXPECT_EQ(500, v.back());
+}
+
+TEST(SmallVector, PopBack) {
+  utils::SmallVector<int, 4> v = {14, 28, 42, 56};
+  v.pop_back();
+  EXPECT_EQ(3, v.size());
+  EXPECT_EQ(42, v.back());
+
+  v.pop_back();
+  v.pop_back();
+  EXPECT_EQ(1, v.size());
+  EXPECT_EQ(14, v.back());
+}
+
+TEST(SmallVector, InsertErase) {
+  utils::SmallVector<std::string, 4> v = {"a", "b", "d"};
+  v.insert(v.begin() + 2, std::string("c"));
+  v.insert(v.begin(), v[3]);
+  ASSERT_EQ(5, v.size());
+  EXPECT_EQ("d", v[0]);
+  EXPECT_EQ("c", v[3]);
+
+  auto it = v.erase(v.begin() + 1);
+  EXPECT_EQ("b", *it);
+  EXPECT_THROW(v.erase(v.end()), std::out_of_range);
+
+  std::vector<std::string> block = {"x", "y"};
+  v.insert(v.begin() + 1, block.begin(), block.end());
+  v.insert(v.end(), 2, "z");
+  v.append_range(std::vector<std::string>{"end"});
+  std::vector<std::string> expected = {"d", "x", "y", "b", "c", "d", "z", "z", "end"};
+  ASSERT_EQ(expected.size(), v.size());
+  for (std::size_t i = 0; i < expected.size(); ++i) {
+    EXPECT_EQ(expected[i], v[i]);
+  }
+}
+
+TEST(SmallVector, Resize) {
+  utils::SmallVector<int, 4> v;
+  v.resize(3, 7);
+  EXPECT_EQ(3, v.size());
+  EXPECT_EQ(7, v[2]);
+  v.resize(10, 1);
+  EXPECT_EQ(10, v.size());
+  EXPECT_EQ(1, v[9]);
+  v.resize(2);
+  EXPECT_EQ(2, v.size());
+  EXPECT_EQ(7, v[1]);
+}
+
+TEST(SmallVector, Assign) {
+  utils::SmallVector<int, 4> v = {1, 2, 3, 4, 5};
+  v.assign(2, 9);
+  ASSERT_EQ(2, v.size());
+  EXPECT_EQ(9, v[1]);
+  v = {3, 2, 1};
+  ASSERT_EQ(3, v.size());
+  EXPECT_EQ(1, v[2]);
+}
+
+// Accessors
+TEST(SmallVector, AccessAt) {
+  utils::SmallVector<int, 8> v = {15, 30, 45, -60, 75};
+  EXPECT_EQ(15, v.at(0));
+  EXPECT_EQ(30, v.at(1));
+
+  EXPECT_THROW(v.at(5), std::out_of_range);
+
+  const utils::SmallVector<int, 8> cv = v;
+  EXPECT_EQ(15, cv.at(0));
+  EXPECT_THROW(cv.at(5), std::out_of_range);
+}
+
+TEST(SmallVector, AccessBrackets) {
+  const int NUM_ELEMENTS = 25;
+  utils::SmallVector<double, 8> v;
+
+  for (int i = 0; i < NUM_ELEMENTS; ++i) v.push_back(i * 0.1);
+
+  for (int i = 0; i < NUM_ELEMENTS; ++i) {
+    EXPECT_EQ(i * 0.1, v[i]);
+  }
+
+  const utils::SmallVector<double, 8> cv = v;
+  for (int i = 0; i < NUM_ELEMENTS; ++i) {
+    EXPECT_EQ(i * 0.1, cv[i]);
+  }
+}
+
+TEST(SmallVector, AccessFrontBack) {
+  utils::SmallVector<int, 4> v = {13, 26, 39};
+  EXPECT_EQ(13, v.front());
+  EXPECT_EQ(39, v.back());
+}
+
+TEST(SmallVector, AccessData) {
+  utils::SmallVector<char, 8> v = {'w', 'x', 'y', 'z', 'a'};
+  char* ptrCh = v.data();
+
+  for (size_t i = 0; i < v.size(); ++i) {
+    EXPECT_EQ(v.at(i), *(ptrCh + i));
+  }
+}
+
+TEST(SmallVector, MoveConstructor) {
+  static_assert(std::is_nothrow_move_constructible_v<utils::SmallVector<MoveableType, 4>>);
+  for (int count : {3, 6}) {
+    utils::SmallVector<MoveableType, 4> v1;
+    for (int i = 1; i <= count; ++i) v1.push_back(MoveableType(i));
+
+    utils::SmallVector<MoveableType, 4> v2 = std::move(v1);
+
+    ASSERT_EQ(count, v2.size());
+    for (int i = 0; i < count; ++i) EXPECT_EQ(i + 1, v2[i].getValue());
+    EXPECT_EQ(0, v1.size());
+    EXPECT_TRUE(v1.is_inline());
+  }
+}
+
+TEST(SmallVector, MoveAssignment) {
+  for (int count : {2, 6}) {
+    utils::SmallVector<MoveableType, 4> v1;
+    for (int i = 1; i <= count; ++i) v1.push_back(MoveableType(i));
+
+    utils::SmallVector<MoveableType, 4> v2 = {MoveableType(7), MoveableType(8),
+                                              MoveableType(9), MoveableType(10),
+                                              MoveableType(11)};
+    v2 = std::move(v1);
+
+    ASSERT_EQ(count, v2.size());
+    for (int i = 0; i < count; ++i) EXPECT_EQ(i + 1, v2[i].getValue());
+    EXPECT_EQ(0, v1.size());
+  }
+}
+
+TEST(SmallVector, PushBackMove) {
+  MoveableType::resetCounters();
+  utils::SmallVector<MoveableType, 4> v;
+
+  MoveableType obj(42);
+  v.push_back(std::move(obj));
+
+  EXPECT_EQ(42, v[0].getValue());
+  EXPECT_EQ(0, obj.getValue());
+  EXPECT_EQ(0, MoveableType::getCopyCount());
+  EXPECT_GE(MoveableType::getMoveCount(), 1);
+}
+
+TEST(SmallVector, EmplaceBack) {
+  utils::SmallVector<ComplexType, 2> v;
+
+  auto& ref = v.emplace_back(42, "test", 3.14);
+
+  EXPECT_EQ(1, v.size());
+  EXPECT_EQ(42, v[0].getInt());
+  EXPECT_EQ("test", v[0].getString());
+  EXPECT_EQ(3.14, v[0].getDouble());
+
+  EXPECT_EQ(&ref, &v[0]);
+}
+
+TEST(SmallVector, Emplace) {
+  utils::SmallVector<ComplexType, 2> v;
+  v.emplace_back(1, "one", 1.0);
+  v.emplace_back(3, "three", 3.0);
+
+  auto it = v.emplace(v.begin() + 1, 2, "two", 2.0);
+
+  EXPECT_EQ(3, v.size());
+  EXPECT_EQ(2, it->getInt());
+  EXPECT_EQ("two", it->getString());
+
+  EXPECT_EQ(1, v[0].getInt());
+  EXPECT_EQ(2, v[1].getInt());
+  EXPECT_EQ(3, v[2].getInt());
+}
+
+TEST(SmallVector, Swap) {
+  utils::SmallVector<std::string, 2> small = {"a"};
+  utils::SmallVector<std::string, 2> large = {"x", "y", "z"};
+  small.swap(large);
+  ASSERT_EQ(3, small.size());
+  ASSERT_EQ(1, large.size());
+  EXPECT_EQ("z", small[2]);
+  EXPECT_EQ("a", large[0]);
+  EXPECT_TRUE(large.is_inline());
+
+  utils::SmallVector<std::string, 2> other = {"b"};
+  large.swap(other);
+  EXPECT_EQ("b", large[0]);
+  EXPECT_EQ("a", other[0]);
+}
+
+TEST(SmallVector, AllocatorPropagation) {
+  using AllocVector = utils::SmallVector<int, 1, ThrowingAllocator<int>>;
+
+  ThrowingAllocator<int> alloc1(0);
+  ThrowingAllocator<int> alloc2(0);
+
+  AllocVector v1(alloc1);
+  v1.push_back(1);
+  v1.push_back(2);
+
+  AllocVector v2(v1);
+  EXPECT_EQ(v1.get_allocator(), v2.get_allocator());
+
+  AllocVector v3(v1, alloc2);
+  EXPECT_EQ(alloc2, v3.get_allocator());
+  EXPECT_NE(v1.get_allocator(), v3.get_allocator());
+  EXPECT_EQ(2, v3[1]);
+}
+
+TEST(SmallVector, StrongExceptionGuaranteeReallocation) {
+  ThrowingAllocator<MoveableType>::reset();
+  ThrowingAllocator<MoveableType> throwing_alloc(1);
+
+  utils::SmallVector<MoveableType, 2, ThrowingAllocator<MoveableType>> v(throwing_alloc);
+  while (v.size() <= v.inline_capacity) {
+    v.push_back(MoveableType(1));
+  }
+  while (v.size() < v.capacity()) {
+    v.push_back(MoveableType(2));
+  }
+  const std::size_t original_size = v.size();
+
+  try {
+    v.push_back(MoveableType(3));
+    FAIL() << "Expected std::bad_alloc";
+  } catch (const std::bad_alloc&) {
+    EXPECT_EQ(original_size, v.size());
+    EXPECT_EQ(1, v[0].getValue());
+    EXPECT_EQ(2, v.back().getValue());
+  }
+}
+
+TEST(SmallVector, EmplaceExceptionSafety) {
+  ThrowingAllocator<ComplexType>::reset();
+  ThrowingAllocator<ComplexType> throwing_alloc(1);
+
+  utils::SmallVector<ComplexType, 1, ThrowingAllocator<ComplexType>> v(throwing_alloc);
+  v.emplace_back(1, "one", 1.0);
+  v.emplace_back(1, "one", 1.0);
+  while (v.size() < v.capacity()) {
+    v.emplace_back(1, "one", 1.0);
+  }
+  const std::size_t full_size = v.size();
+
+  try {
+    v.emplace(v.begin(), 2, "two", 2.0);
+    FAIL() << "Expected std::bad_alloc";
+  } catch (const std::bad_alloc&) {
+    EXPECT_EQ(full_size, v.size());
+    EXPECT_EQ(1, v[0].getInt());
+    EXPECT_EQ("one", v[0].getString());
+  }
+}
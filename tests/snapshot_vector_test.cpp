@@ -0,0 +1,232 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <lib/snapshot_vector/snapshot_vector.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "test_types.hpp"
+
+namespace {
+
+using Table = utils::SnapshotVector<std::uint64_t>;
+constexpr std::size_t kChunk = Table::kChunkSize;
+
+utils::Vector<std::uint64_t> iota(std::size_t n) {
+  utils::Vector<std::uint64_t> v;
+  v.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) v.push_back(i);
+  return v;
+}
+
+}  // namespace
+
+TEST(SnapshotVector, IteratorConcepts) {
+  static_assert(std::random_access_iterator<Table::Snapshot::Iterator>);
+  static_assert(std::is_same_v<std::iter_reference_t<Table::Snapshot::Iterator>,
+                               const std::uint64_t&>);
+}
+
+TEST(SnapshotVector, ConvertsFromAndToVector) {
+  const std::size_t n = 3 * kChunk + 5;
+  Table table(iota(n));
+  Table::Snapshot snap = table.snapshot();
+  ASSERT_EQ(n, snap.size());
+  EXPECT_EQ(4, snap.chunk_count());
+  EXPECT_EQ(5, snap.chunk(3).size());
+  EXPECT_EQ(kChunk + 1, snap[kChunk + 1]);
+  EXPECT_EQ(n - 1, snap.back());
+  EXPECT_THROW(snap.at(n), std::out_of_range);
+  EXPECT_TRUE(std::equal(snap.begin(), snap.end(), iota(n).data()));
+
+  utils::Vector<std::uint64_t> back = table.to_vector();
+  ASSERT_EQ(n, back.size());
+  EXPECT_EQ(n - 1, back[n - 1]);
+
+  Table empty;
+  EXPECT_EQ(0, empty.size());
+  EXPECT_EQ(0, empty.to_vector().size());
+  EXPECT_EQ(0, empty.version());
+}
+
+TEST(SnapshotVector, SnapshotsAreImmutable) {
+  utils::SnapshotVector<std::string> table = {"a", "b", "c"};
+  auto before = table.snapshot();
+  table.update([](auto& e) {
+    e[1] = "B";
+    e.push_back("d");
+  });
+  auto after = table.snapshot();
+
+  EXPECT_EQ(1, table.version());
+  ASSERT_EQ(3, before.size());
+  EXPECT_EQ("b", before[1]);
+  ASSERT_EQ(4, after.size());
+  EXPECT_EQ("B", after[1]);
+  EXPECT_EQ("d", after[3]);
+}
+
+TEST(SnapshotVector, EditCopiesOnlyTouchedChunks) {
+  Table table(iota(4 * kChunk));
+  auto before = table.snapshot();
+  {
+    auto editor = table.edit();
+    const auto& read_only = editor;
+    EXPECT_EQ(5, read_only[5]);
+    editor[kChunk + 3] = 1000;
+    editor[kChunk + 4] = 1001;
+    editor.commit();
+  }
+  auto after = table.snapshot();
+  for (std::size_t c = 0; c < 4; ++c) {
+    const bool shared = before.chunk(c).data() == after.chunk(c).data();
+    EXPECT_EQ(c != 1, shared) << "chunk " << c;
+  }
+  EXPECT_EQ(kChunk + 3, before[kChunk + 3]);
+  EXPECT_EQ(1000, after[kChunk + 3]);
+}
+
+TEST(SnapshotVector, UncommittedEditIsDiscarded) {
+  Table table(iota(10));
+  {
+    auto editor = table.edit();
+    editor[0] = 99;
+    editor.push_back(10);
+  }
+  EXPECT_EQ(0, table.snapshot()[0]);
+  EXPECT_EQ(10, table.size());
+  EXPECT_EQ(0, table.version());
+}
+
+TEST(SnapshotVector, EditorGrowsAndShrinks) {
+  Table table;
+  auto editor = table.edit();
+  for (std::size_t i = 0; i < 2 * kChunk + 1; ++i) editor.push_back(i);
+  editor.commit();
+  auto first = table.snapshot();
+
+  editor.push_back(editor[0]);
+  editor.pop_back();
+  editor.pop_back();
+  EXPECT_EQ(2 * kChunk, editor.size());
+  editor.resize(kChunk + 2);
+  editor.resize(kChunk + 4, 7);
+  EXPECT_EQ(7, editor.at(kChunk + 3));
+  EXPECT_THROW(editor.at(kChunk + 4), std::out_of_range);
+  editor.commit();
+
+  auto second = table.snapshot();
+  EXPECT_EQ(2 * kChunk + 1, first.size());
+  EXPECT_EQ(2 * kChunk, first.back());
+  ASSERT_EQ(kChunk + 4, second.size());
+  EXPECT_EQ(kChunk + 1, second[kChunk + 1]);
+  EXPECT_EQ(7, second.back());
+
+  editor.clear();
+  EXPECT_THROW(editor.pop_back(), std::out_of_range);
+  editor.commit();
+  EXPECT_TRUE(table.snapshot().empty());
+  EXPECT_EQ(kChunk + 4, second.size());
+}
+
+TEST(SnapshotVector, FailedAppendLeavesNoEmptyChunk) {
+  {
+    utils::SnapshotVector<LiveCounted> table(
+        utils::Vector<LiveCounted>(utils::SnapshotVector<LiveCounted>::kChunkSize, LiveCounted(1)));
+    auto editor = table.edit();
+    const LiveCounted value(2);
+    LiveCounted::copies_left = 0;
+    EXPECT_THROW(editor.push_back(value), std::runtime_error);
+    LiveCounted::copies_left = -1;
+    editor.pop_back();
+    editor.push_back(value);
+    editor.commit();
+    EXPECT_EQ(1, table.snapshot().chunk_count());
+    EXPECT_EQ(2, table.snapshot().back().value);
+  }
+  EXPECT_EQ(0, LiveCounted::live.load());
+}
+
+TEST(SnapshotVector, IteratorsKeepTheirVersionAlive) {
+  const std::size_t n = 2 * kChunk + 3;
+  Table table(iota(n));
+  const auto first = table.snapshot().begin();
+  const auto last = table.snapshot().end();
+  table.assign(iota(1));
+  ASSERT_EQ(static_cast<std::ptrdiff_t>(n), last - first);
+  EXPECT_TRUE(std::equal(first, last, iota(n).data()));
+}
+
+TEST(SnapshotVector, ReclaimsOldVersions) {
+  LiveCounted::live = 0;
+  {
+    utils::Vector<LiveCounted> initial(10, LiveCounted(1));
+    utils::SnapshotVector<LiveCounted> table(std::move(initial));
+    initial.clear();
+    EXPECT_EQ(10, LiveCounted::live.load());
+    auto old = table.snapshot();
+    table.update([](auto& e) { e[0].value = 2; });
+    // The old chunk stays alive while a snapshot of the old version does.
+    EXPECT_EQ(20, LiveCounted::live.load());
+    old = {};
+    EXPECT_EQ(10, LiveCounted::live.load());
+    table.assign(utils::Vector<LiveCounted>(3, LiveCounted(3)));
+    EXPECT_EQ(3, LiveCounted::live.load());
+  }
+  EXPECT_EQ(0, LiveCounted::live.load());
+}
+
+TEST(SnapshotVector, ReaderRefreshesOnCommit) {
+  Table table(iota(10));
+  Table::Reader reader(table);
+  const Table::Snapshot* cached = &reader.current();
+  EXPECT_EQ(10, cached->size());
+  table.update([](auto& e) { e.push_back(10); });
+  EXPECT_EQ(11, reader.current().size());
+  EXPECT_EQ(cached, &reader.current());
+}
+
+TEST(SnapshotVector, ConcurrentReadersSeeConsistentVersions) {
+  // Every version holds n copies of one value, so a reader that sees two
+  // different values in one snapshot has seen a torn update.
+  constexpr std::size_t kReaders = 4;
+  constexpr std::uint64_t kUpdates = 200;
+  const std::size_t n = 3 * kChunk;
+  Table table(utils::Vector<std::uint64_t>(n, 0));
+  std::atomic<bool> done{false};
+  std::atomic<std::size_t> torn{0};
+  std::vector<std::thread> readers;
+  for (std::size_t r = 0; r < kReaders; ++r) {
+    readers.emplace_back([&, r] {
+      Table::Reader reader(table);
+      std::uint64_t last = 0;
+      while (!done.load(std::memory_order_acquire)) {
+        const Table::Snapshot& snap = r % 2 ? reader.current() : table.snapshot();
+        const std::uint64_t first = snap[0];
+        if (first < last || snap[n / 2] != first || snap[n - 1] != first) {
+          torn.fetch_add(1);
+        }
+        last = first;
+      }
+    });
+  }
+  for (std::uint64_t value = 1; value <= kUpdates; ++value) {
+    table.update([&](auto& e) {
+      for (std::size_t i = 0; i < n; ++i) e[i] = value;
+    });
+  }
+  done.store(true, std::memory_order_release);
+  for (auto& reader : readers) reader.join();
+  EXPECT_EQ(0, torn.load());
+  EXPECT_EQ(kUpdates, table.version());
+  EXPECT_EQ(kUpdates, table.snapshot()[n - 1]);
+}
@@ -0,0 +1,195 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <lib/soa_vector/soa_vector.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <numeric>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <version>
+
+#include "gtest/gtest.h"
+#include "test_types.hpp"
+
+namespace {
+
+struct Trade {
+  std::uint64_t id;
+  double price;
+  std::int32_t quantity;
+  std::string venue;
+};
+
+using Trades = utils::SoAVector<std::uint64_t, double, std::int32_t, std::string>;
+
+Trade make_trade(std::uint64_t i) {
+  return {i, static_cast<double>(i) * 0.25, static_cast<std::int32_t>(i % 100),
+          "venue-" + std::to_string(i % 7)};
+}
+
+void expect_trades(const Trades& trades, std::uint64_t count) {
+  ASSERT_EQ(count, trades.size());
+  for (std::uint64_t i = 0; i < count; ++i) {
+    const auto [id, price, quantity, venue] = trades[i];
+    const Trade expected = make_trade(i);
+    ASSERT_EQ(expected.id, id);
+    ASSERT_EQ(expected.price, price);
+    ASSERT_EQ(expected.quantity, quantity);
+    ASSERT_EQ(expected.venue, venue);
+  }
+}
+
+}  // namespace
+
+TEST(SoAVector, IteratorConcepts) {
+  static_assert(std::random_access_iterator<Trades::iterator>);
+  // Tuples of const references need the C++23 tuple common_reference.
+#if defined(__cpp_lib_ranges_zip)
+  static_assert(std::random_access_iterator<Trades::const_iterator>);
+#endif
+  static_assert(std::convertible_to<Trades::iterator, Trades::const_iterator>);
+  static_assert(std::same_as<std::span<double>, decltype(std::declval<Trades&>().get<1>())>);
+}
+
+TEST(SoAVector, PushStructTupleAndFields) {
+  Trades trades;
+  for (std::uint64_t i = 0; i < 1000; ++i) {
+    if (i % 3 == 0) {
+      trades.push_back(make_trade(i));
+    } else if (i % 3 == 1) {
+      const Trade t = make_trade(i);
+      trades.push_back(std::make_tuple(t.id, t.price, t.quantity, t.venue));
+    } else {
+      Trade t = make_trade(i);
+      auto [id, price, quantity, venue] = trades.emplace_back(t.id, t.price, t.quantity,
+                                                             std::move(t.venue));
+      ASSERT_EQ(i, id);
+      ASSERT_EQ(make_trade(i).venue, venue);
+    }
+  }
+  expect_trades(trades, 1000);
+  EXPECT_GE(trades.capacity(), 1000);
+  EXPECT_THROW(trades.at(1000), std::out_of_range);
+}
+
+TEST(SoAVector, FieldSpansAreContiguous) {
+  Trades trades;
+  for (std::uint64_t i = 0; i < 500; ++i) trades.push_back(make_trade(i));
+  std::span<double> prices = trades.get<1>();
+  ASSERT_EQ(500, prices.size());
+  EXPECT_EQ(trades.data<1>(), prices.data());
+  EXPECT_DOUBLE_EQ(0.25 * 499 * 500 / 2, std::accumulate(prices.begin(), prices.end(), 0.0));
+  for (double& price : prices) price *= 2;
+  EXPECT_EQ(2 * 0.25 * 10, std::get<1>(trades[10]));
+  const Trades& view = trades;
+  EXPECT_EQ(499, view.get<0>().back());
+}
+
+TEST(SoAVector, ProxyReferencesWriteThrough) {
+  Trades trades;
+  for (std::uint64_t i = 0; i < 10; ++i) trades.push_back(make_trade(i));
+  std::get<3>(trades[2]) = "changed";
+  EXPECT_EQ("changed", trades.get<3>()[2]);
+
+  for (auto [id, price, quantity, venue] : trades) {
+    quantity = static_cast<std::int32_t>(id * 10);
+  }
+  EXPECT_EQ(90, trades.get<2>()[9]);
+
+  auto it = trades.begin() + 5;
+  EXPECT_EQ(5, std::get<0>(*it));
+  EXPECT_EQ(7, std::get<0>(it[2]));
+  EXPECT_EQ(10, trades.end() - trades.begin());
+  EXPECT_EQ(9, std::get<0>(*std::prev(trades.cend())));
+}
+
+TEST(SoAVector, AppendOwnElementWhileGrowing) {
+  utils::SoAVector<std::string, int> v;
+  v.push_back(std::make_tuple(std::string(40, 'a'), 1));
+  while (v.size() != v.capacity()) v.push_back(std::make_tuple(std::string(40, 'b'), 2));
+  v.push_back(v[0]);
+  EXPECT_EQ(std::string(40, 'a'), std::get<0>(v.back()));
+  EXPECT_EQ(1, std::get<1>(v.back()));
+  EXPECT_EQ(std::string(40, 'a'), std::get<0>(v.front()));
+}
+
+TEST(SoAVector, ResizePopClearAndShrink) {
+  Trades trades;
+  trades.resize(100);
+  EXPECT_EQ(100, trades.size());
+  EXPECT_EQ("", trades.get<3>()[99]);
+  EXPECT_EQ(0.0, trades.get<1>()[50]);
+  trades.pop_back();
+  trades.resize(10);
+  EXPECT_EQ(10, trades.size());
+  trades.shrink_to_fit();
+  EXPECT_EQ(10, trades.capacity());
+  trades.clear();
+  EXPECT_TRUE(trades.empty());
+  EXPECT_THROW(trades.pop_back(), std::out_of_range);
+  trades.shrink_to_fit();
+  EXPECT_EQ(0, trades.capacity());
+}
+
+TEST(SoAVector, CopyMoveAndSwap) {
+  Trades trades;
+  for (std::uint64_t i = 0; i < 300; ++i) trades.push_back(make_trade(i));
+  Trades copy(trades);
+  expect_trades(copy, 300);
+  Trades moved(std::move(copy));
+  expect_trades(moved, 300);
+  EXPECT_TRUE(copy.empty());
+  copy = moved;
+  expect_trades(copy, 300);
+  Trades other;
+  other.push_back(make_trade(0));
+  other.swap(copy);
+  expect_trades(other, 300);
+  expect_trades(copy, 1);
+  copy = std::move(other);
+  expect_trades(copy, 300);
+}
+
+TEST(SoAVector, ElementsAreNotLeaked) {
+  {
+    utils::SoAVector<LiveCounted, std::unique_ptr<int>> v;
+    for (int i = 0; i < 1000; ++i) v.emplace_back(i, std::make_unique<int>(i));
+    EXPECT_EQ(1000, LiveCounted::live.load());
+    EXPECT_EQ(999, *std::get<1>(v.back()));
+    for (int i = 0; i < 400; ++i) v.pop_back();
+    EXPECT_EQ(600, LiveCounted::live.load());
+  }
+  EXPECT_EQ(0, LiveCounted::live.load());
+}
+
+TEST(SoAVector, FailedFieldConstructionRollsBackTheRow) {
+  {
+    utils::SoAVector<std::string, LiveCounted> v;
+    LiveCounted value(1);
+    v.emplace_back("first", value);
+    LiveCounted::copies_left = 0;
+    EXPECT_THROW(v.emplace_back("second", value), std::runtime_error);
+    LiveCounted::copies_left = -1;
+    EXPECT_EQ(1, v.size());
+    EXPECT_EQ("first", v.get<0>()[0]);
+    EXPECT_EQ(2, LiveCounted::live.load());
+  }
+  EXPECT_EQ(0, LiveCounted::live.load());
+}
+
+TEST(SoAVector, UsesRebindableAllocator) {
+  std::pmr::monotonic_buffer_resource resource;
+  using PmrTrades = utils::BasicSoAVector<std::pmr::polymorphic_allocator<std::byte>,
+                                          utils::DefaultGrowth, int, double>;
+  PmrTrades v{std::pmr::polymorphic_allocator<std::byte>(&resource)};
+  for (int i = 0; i < 100; ++i) v.emplace_back(i, i * 0.5);
+  EXPECT_EQ(&resource, v.get_allocator().resource());
+  EXPECT_EQ(99, v.get<0>().back());
+}
@@ -0,0 +1,188 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <lib/static_vector/static_vector.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <ranges>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "gtest/gtest.h"
+#include "test_types.hpp"
+
+namespace {
+
+constexpr utils::StaticVector<int, 32> Primes() {
+  utils::StaticVector<int, 32> primes;
+  for (int n = 2; !primes.full(); ++n) {
+    bool prime = true;
+    for (int p : primes) prime = prime && n % p != 0;
+    if (prime) primes.push_back(n);
+  }
+  return primes;
+}
+
+struct Entry {
+  char key;
+  int value;
+};
+
+constexpr auto kPrimes = Primes();
+
+}  // namespace
+
+// Tables built at compile time
+TEST(StaticVector, ConstexprTable) {
+  static_assert(kPrimes.size() == 32);
+  static_assert(kPrimes.front() == 2 && kPrimes[10] == 31 && kPrimes.back() == 131);
+  static_assert(std::is_trivially_destructible_v<utils::StaticVector<int, 32>>);
+
+  int expected[] = {2, 3, 5, 7, 11, 13};
+  EXPECT_TRUE(std::equal(std::begin(expected), std::end(expected), kPrimes.begin()));
+}
+
+TEST(StaticVector, ConstexprModifiers) {
+  constexpr auto table = [] {
+    utils::StaticVector<Entry, 8> v = {{'b', 2}, {'d', 4}};
+    v.insert(v.begin(), Entry{'a', 1});
+    v.emplace(v.begin() + 2, Entry{'c', 3});
+    v.push_back({'x', 0});
+    v.erase(v.end() - 1);
+    v.resize(6, Entry{'z', 26});
+    v.pop_back();
+    return v;
+  }();
+  static_assert(table.size() == 5);
+  static_assert(table[0].key == 'a' && table[2].key == 'c' && table[3].value == 4);
+  static_assert(table.back().key == 'z');
+  EXPECT_EQ(8, table.capacity());
+}
+
+TEST(StaticVector, ConstexprNonTrivialElements) {
+  // Elements with a destructor cannot outlive constant evaluation, but may
+  // be used within it.
+  constexpr std::size_t total = [] {
+    utils::StaticVector<std::string, 4> v;
+    v.push_back("ab");
+    v.emplace_back(3, 'c');
+    v.insert(v.begin(), std::string("longer than the small buffer"));
+    v.erase(v.begin() + 1);
+    std::size_t n = 0;
+    for (const std::string& s : v) n += s.size();
+    return n;
+  }();
+  static_assert(total == 31);
+}
+
+// Constructors
+TEST(StaticVector, Constructors) {
+  utils::StaticVector<int, 8> empty;
+  EXPECT_TRUE(empty.empty());
+  EXPECT_EQ(8, empty.capacity());
+
+  utils::StaticVector<int, 8> filled(5, 7);
+  EXPECT_EQ(5, filled.size());
+  EXPECT_EQ(7, filled.at(4));
+
+  std::istringstream in("1 2 3");
+  utils::StaticVector<int, 8> read{std::istream_iterator<int>(in),
+                                   std::istream_iterator<int>()};
+  ASSERT_EQ(3, read.size());
+  EXPECT_EQ(3, read[2]);
+
+  utils::StaticVector<std::string, 4> strings = {"a", "b"};
+  utils::StaticVector<std::string, 4> copy = strings;
+  utils::StaticVector<std::string, 4> moved = std::move(strings);
+  EXPECT_EQ(2, copy.size());
+  EXPECT_EQ("b", moved[1]);
+  EXPECT_TRUE(strings.empty());
+}
+
+// Capacity
+TEST(StaticVector, ContainerTypeAliases) {
+  using V = utils::StaticVector<int, 4>;
+  static_assert(std::is_same_v<V::const_iterator, decltype(std::declval<const V&>().begin())>);
+  static_assert(std::is_same_v<V::iterator, decltype(std::declval<V&>().begin())>);
+  static_assert(std::is_same_v<V::const_reverse_iterator, V::ConstReverseIterator>);
+  static_assert(std::is_same_v<V::reverse_iterator, V::ReverseIterator>);
+  static_assert(std::is_same_v<V::size_type, std::size_t>);
+  static_assert(std::is_same_v<V::difference_type, std::ptrdiff_t>);
+  static_assert(std::is_same_v<V::reference, int&>);
+  static_assert(std::is_same_v<V::const_reference, const int&>);
+  static_assert(std::is_same_v<V::pointer, int*>);
+  static_assert(std::is_same_v<V::const_pointer, const int*>);
+
+  V v = {1, 2, 3};
+  EXPECT_EQ(-3, v.cbegin() - v.end());
+}
+
+TEST(StaticVector, OverflowThrowsAndKeepsContents) {
+  utils::StaticVector<int, 4> v = {1, 2, 3, 4};
+  EXPECT_THROW(v.push_back(5), std::length_error);
+  EXPECT_THROW(v.insert(v.begin(), 0), std::length_error);
+  EXPECT_THROW(v.insert(v.end(), 2, 0), std::length_error);
+  EXPECT_THROW(v.resize(5), std::length_error);
+  EXPECT_THROW(v.reserve(5), std::length_error);
+  EXPECT_THROW((utils::StaticVector<int, 2>{1, 2, 3}), std::length_error);
+
+  std::istringstream in("7 8 9");
+  v.pop_back();
+  v.pop_back();
+  EXPECT_THROW(v.insert(v.begin(), std::istream_iterator<int>(in),
+                        std::istream_iterator<int>()),
+               std::length_error);
+  ASSERT_EQ(2, v.size());
+  EXPECT_EQ(1, v[0]);
+  EXPECT_EQ(2, v[1]);
+}
+
+// Modifiers
+TEST(StaticVector, InsertEraseMiddle) {
+  utils::StaticVector<MoveableType, 8> v;
+  for (int i = 0; i < 5; ++i) v.emplace_back(i);
+  v.insert(v.begin() + 2, MoveableType(10));
+  v.erase(v.begin());
+  int expected[] = {1, 10, 2, 3, 4};
+  ASSERT_EQ(5, v.size());
+  for (std::size_t i = 0; i < v.size(); ++i) {
+    EXPECT_EQ(expected[i], v[i].getValue());
+  }
+  v.insert(v.begin() + 1, v[3]);
+  EXPECT_EQ(3, v[1].getValue());
+}
+
+TEST(StaticVector, AssignAndSwap) {
+  utils::StaticVector<std::string, 6> a = {"x", "y", "z"};
+  utils::StaticVector<std::string, 6> b = {"1"};
+  a.swap(b);
+  ASSERT_EQ(1, a.size());
+  ASSERT_EQ(3, b.size());
+  EXPECT_EQ("1", a[0]);
+  EXPECT_EQ("z", b[2]);
+
+  a.assign(4, "q");
+  EXPECT_EQ(4, a.size());
+  a = {"m", "n"};
+  EXPECT_EQ("n", a.back());
+  b = a;
+  EXPECT_EQ(2, b.size());
+  a.append_range(std::array<std::string, 2>{"o", "p"});
+  EXPECT_EQ("p", a[3]);
+}
+
+TEST(StaticVector, DestroysElements) {
+  LiveCounted::live = 0;
+  {
+    utils::StaticVector<LiveCounted, 8> v(3, LiveCounted(1));
+    EXPECT_EQ(3, LiveCounted::live.load());
+    v.pop_back();
+    utils::StaticVector<LiveCounted, 8> other = std::move(v);
+    EXPECT_EQ(2, LiveCounted::live.load());
+  }
+  EXPECT_EQ(0, LiveCounted::live.load());
+}
@@ -0,0 +1,170 @@
+// Copyright 2024 Gregory Tolmachev
+
+#pragma once
+
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <new>
+#include <stdexcept>
+#include <string>
+
+class MoveableType {
+ public:
+  MoveableType(int val = 0) : value(val) {}
+  MoveableType(const MoveableType& other) : value(other.value) { ++copy_count; }
+  MoveableType(MoveableType&& other) noexcept : value(other.value) {
+    other.value = 0;
+    ++move_count;
+  }
+  MoveableType& operator=(const MoveableType& other) {
+    if (this != &other) {
+      value = other.value;
+      ++copy_count;
+    }
+    return *this;
+  }
+  MoveableType& operator=(MoveableType&& other) noexcept {
+    if (this != &other) {
+      value = other.value;
+      other.value = 0;
+      ++move_count;
+    }
+    return *this;
+  }
+  ~MoveableType() = default;
+
+  int getValue() const { return value; }
+  static void resetCounters() {
+    copy_count = 0;
+    move_count = 0;
+  }
+  static int getCopyCount() { return copy_count; }
+  static int getMoveCount() { return move_count; }
+
+ private:
+  int value;
+  static inline int copy_count = 0;
+  static inline int move_count = 0;
+};
+
+class ComplexType {
+ public:
+  ComplexType(int x, std::string s, double d) 
+      : int_val(x), str_val(s), double_val(d) {}
+  
+  int getInt() const { return int_val; }
+  const std::string& getString() const { return str_val; }
+  double getDouble() const { return double_val; }
+
+ private:
+  int int_val;
+  std::string str_val;
+  double double_val;
+};
+
+// Counts live instances; copying throws once `copies_left` reaches zero.
+class LiveCounted {
+ public:
+  LiveCounted(int val = 0) : value(val) { ++live; }
+  LiveCounted(const LiveCounted& other) : value(other.value) {
+    if (copies_left.fetch_sub(1) == 0) {
+      throw std::runtime_error("copy failed");
+    }
+    ++live;
+  }
+  LiveCounted(LiveCounted&& other) noexcept : value(other.value) { ++live; }
+  LiveCounted& operator=(const LiveCounted&) = default;
+  ~LiveCounted() { --live; }
+
+  int value;
+  static inline std::atomic<int> live = 0;
+  static inline std::atomic<long> copies_left = -1;  // < 0: never throw
+};
+
+template<typename T>
+class ThrowingAllocator {
+ public:
+  using value_type = T;
+  using pointer = T*;
+  using const_pointer = const T*;
+  using reference = T&;
+  using const_reference = const T&;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  
+  template<typename U>
+  struct rebind {
+    using other = ThrowingAllocator<U>;
+  };
+
+  ThrowingAllocator() noexcept : throw_on_(0), id_(next_id++) {}
+  ThrowingAllocator(size_t throw_on) noexcept : throw_on_(throw_on), id_(next_id++) {}
+  
+  template<typename U>
+  ThrowingAllocator(const ThrowingAllocator<U>& other) noexcept
+      : throw_on_(other.throw_on_), id_(other.id_) {}
+  
+  pointer allocate(size_t n) {
+    if (throw_on_ > 0 && allocation_count_++ == throw_on_) {
+      throw std::bad_alloc();
+    }
+    return static_cast<pointer>(::operator new(n * sizeof(T)));
+  }
+  
+  void deallocate(pointer p, size_t) noexcept {
+    ::operator delete(p);
+  }
+  
+  bool operator==(const ThrowingAllocator& other) const {
+    return throw_on_ == other.throw_on_ && id_ == other.id_;
+  }
+  
+  bool operator!=(const ThrowingAllocator& other) const {
+    return !(*this == other);
+  }
+
+  static void reset() { allocation_count_ = 0; }
+  
+  ThrowingAllocator select_on_container_copy_construction() const {
+    return *this;
+  }
+  
+ private:
+  size_t throw_on_;
+  int id_;
+  static inline int next_id = 0;
+  static inline size_t allocation_count_ = 0;
+  
+  template<typename U>
+  friend class ThrowingAllocator;
+};
+
+// A file in the temp directory, named after the test and the pid, that is
+// removed on construction and destruction.
+class TempFile {
+ public:
+  explicit TempFile(const std::string& name)
+      : path_(std::filesystem::temp_directory_path() /
+              (name + "_" + std::to_string(::getpid()) + ".bin")) {
+    std::filesystem::remove(path_);
+  }
+  ~TempFile() { std::filesystem::remove(path_); }
+
+  std::string path() const { return path_.string(); }
+  std::uintmax_t size() const { return std::filesystem::file_size(path_); }
+
+  // Overwrites one byte of the file.
+  void patch(std::size_t offset, char value) const {
+    std::fstream file(path_, std::ios::in | std::ios::out | std::ios::binary);
+    file.seekp(static_cast<std::streamoff>(offset));
+    file.put(value);
+  }
+
+ private:
+  std::filesystem::path path_;
+};
@@ -0,0 +1,190 @@
+// Copyright 2024 Gregory Tolmachev
+
+#include <lib/vector_algorithms/vector_algorithms.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <lib/vector/vector.hpp>
+
+#include "gtest/gtest.h"
+#include "isa_test.hpp"
+
+namespace algo = utils::algorithms;
+
+namespace {
+
+const std::size_t kSizes[] = {0, 1, 2, 3, 7, 8, 15, 16, 17, 31, 32, 33, 63, 64, 65, 100, 1000, 4097};
+
+template <typename T>
+bool same_bits(T a, T b) {
+  if constexpr (std::is_floating_point_v<T>) {
+    if (std::isnan(a) && std::isnan(b)) {
+      return true;
+    }
+  }
+  return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+template <typename T>
+utils::Vector<T> random_values(std::size_t n, unsigned seed) {
+  std::mt19937_64 rng(seed);
+  utils::Vector<T> v;
+  for (std::size_t i = 0; i < n; ++i) {
+    if constexpr (std::is_floating_point_v<T>) {
+      v.push_back(std::uniform_real_distribution<T>(-1000, 1000)(rng));
+    } else {
+      v.push_back(static_cast<T>(std::uniform_int_distribution<int>(-50, 50)(rng)));
+    }
+  }
+  return v;
+}
+
+template <typename T>
+void check_against_scalar(const std::vector<algo::Isa>& isas) {
+  for (std::size_t n : kSizes) {
+    utils::Vector<T> a = random_values<T>(n + 3, static_cast<unsigned>(n));
+    utils::Vector<T> b = random_values<T>(n + 3, static_cast<unsigned>(n) + 1);
+    for (std::size_t offset = 0; offset < 4; ++offset) {
+      std::span<const T> x(a.data() + offset, n);
+      std::span<const T> y(b.data() + 3 - offset, n);
+      const T needle = n == 0 ? T{} : x[n / 2];
+
+      algo::set_active_isa(algo::Isa::kScalar);
+      const std::size_t found = algo::find(x, needle);
+      const std::size_t counted = algo::count(x, needle);
+      const auto sum = algo::sum(x);
+      const auto dot = algo::dot(x, y);
+      const T min = n == 0 ? T{} : algo::min(x);
+      const T max = n == 0 ? T{} : algo::max(x);
+
+      EXPECT_EQ(static_cast<std::size_t>(std::find(x.begin(), x.end(), needle) - x.begin()),
+                found);
+      EXPECT_EQ(static_cast<std::size_t>(std::count(x.begin(), x.end(), needle)), counted);
+      if (n != 0) {
+        EXPECT_EQ(*std::min_element(x.begin(), x.end()), min);
+        EXPECT_EQ(*std::max_element(x.begin(), x.end()), max);
+      }
+      if constexpr (std::is_integral_v<T>) {
+        EXPECT_EQ(std::accumulate(x.begin(), x.end(), std::int64_t{0}), sum);
+        EXPECT_EQ(std::inner_product(x.begin(), x.end(), y.begin(), std::int64_t{0}), dot);
+      }
+
+      for (algo::Isa isa : isas) {
+        SCOPED_TRACE(algo::isa_name(isa));
+        algo::set_active_isa(isa);
+        EXPECT_EQ(found, algo::find(x, needle)) << n;
+        EXPECT_EQ(counted, algo::count(x, needle)) << n;
+        EXPECT_TRUE(same_bits(sum, algo::sum(x))) << n;
+        EXPECT_TRUE(same_bits(dot, algo::dot(x, y))) << n;
+        if (n != 0) {
+          EXPECT_TRUE(same_bits(min, algo::min(x))) << n;
+          EXPECT_TRUE(same_bits(max, algo::max(x))) << n;
+        }
+
+        std::vector<T> clamped(x.begin(), x.end());
+        std::vector<T> expected = clamped;
+        for (T& value : expected) value = std::clamp(value, T{-10}, T{20});
+        algo::clamp(clamped, T{-10}, T{20});
+        EXPECT_EQ(expected, clamped) << n;
+      }
+    }
+  }
+}
+
+}  // namespace
+
+TEST_F(IsaTest, Selection) {
+  EXPECT_EQ(algo::detected_isa(), algo::active_isa());
+  algo::set_active_isa(algo::Isa::kScalar);
+  EXPECT_EQ(algo::Isa::kScalar, algo::active_isa());
+  if (algo::detected_isa() != algo::Isa::kAvx512) {
+    EXPECT_THROW(algo::set_active_isa(algo::Isa::kAvx512), std::invalid_argument);
+  }
+  EXPECT_STREQ("scalar", algo::isa_name(algo::Isa::kScalar));
+}
+
+TEST_F(IsaTest, MatchesScalarFloat) { check_against_scalar<float>(isas()); }
+TEST_F(IsaTest, MatchesScalarDouble) { check_against_scalar<double>(isas()); }
+TEST_F(IsaTest, MatchesScalarInt32) { check_against_scalar<std::int32_t>(isas()); }
+TEST_F(IsaTest, MatchesScalarInt64) { check_against_scalar<std::int64_t>(isas()); }
+
+TEST_F(IsaTest, NaNPropagation) {
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  for (algo::Isa isa : isas()) {
+    SCOPED_TRACE(algo::isa_name(isa));
+    algo::set_active_isa(isa);
+    for (std::size_t n : {1, 5, 16, 40, 1000}) {
+      for (std::size_t at : {std::size_t{0}, n / 2, n - 1}) {
+        utils::Vector<double> v(n, 1.0);
+        v[at] = nan;
+        EXPECT_TRUE(std::isnan(algo::min(v)));
+        EXPECT_TRUE(std::isnan(algo::max(v)));
+        EXPECT_TRUE(std::isnan(algo::sum(v)));
+        EXPECT_EQ(n, algo::find(v, nan));
+        EXPECT_EQ(0, algo::count(v, nan));
+
+        algo::clamp(v, 2.0, 3.0);
+        EXPECT_TRUE(std::isnan(v[at]));
+        if (n > 1) {
+          EXPECT_EQ(2.0, v[at == 0 ? n - 1 : 0]);
+        }
+      }
+    }
+  }
+}
+
+TEST_F(IsaTest, SpecialValues) {
+  const float inf = std::numeric_limits<float>::infinity();
+  for (algo::Isa isa : isas()) {
+    SCOPED_TRACE(algo::isa_name(isa));
+    algo::set_active_isa(isa);
+    utils::Vector<float> v(37, 0.0f);
+    v[5] = -0.0f;
+    v[20] = inf;
+    v[30] = -inf;
+    EXPECT_EQ(-inf, algo::min(v));
+    EXPECT_EQ(inf, algo::max(v));
+    EXPECT_TRUE(std::isnan(algo::sum(v)));
+    EXPECT_EQ(0, algo::find(v, -0.0f));
+    EXPECT_EQ(35, algo::count(v, 0.0f));
+
+    utils::Vector<float> zeros(37, -0.0f);
+    zeros[36] = 0.0f;
+    EXPECT_EQ(0.0f, algo::min(zeros));
+    EXPECT_EQ(0.0f, algo::max(zeros));
+  }
+}
+
+TEST_F(IsaTest, IntegerWrapAround) {
+  const std::int32_t big = std::numeric_limits<std::int32_t>::max();
+  utils::Vector<std::int32_t> v(100, big);
+  const std::int64_t expected = std::int64_t{big} * 100;
+  for (algo::Isa isa : isas()) {
+    SCOPED_TRACE(algo::isa_name(isa));
+    algo::set_active_isa(isa);
+    EXPECT_EQ(expected, algo::sum(v));
+    EXPECT_EQ(static_cast<std::int64_t>(std::uint64_t{big} * big * 100), algo::dot(v, v));
+  }
+}
+
+TEST_F(IsaTest, Errors) {
+  utils::Vector<int> empty;
+  EXPECT_THROW(algo::min(empty), std::out_of_range);
+  EXPECT_THROW(algo::max(empty), std::out_of_range);
+  EXPECT_EQ(0, algo::sum(empty));
+  EXPECT_EQ(0, algo::find(empty, 1));
+
+  utils::Vector<int> a(3, 1);
+  utils::Vector<int> b(4, 1);
+  EXPECT_THROW(algo::dot(a, b), std::invalid_argument);
+  EXPECT_THROW(algo::clamp(a, 2, 1), std::invalid_argument);
+}
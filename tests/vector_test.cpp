@@ -2,7 +2,24 @@
 
 #include <lib/vector/vector.hpp>
 
+#include <algorithm>
+#include <concepts>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <memory_resource>
+#include <ranges>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
 #include "gtest/gtest.h"
+#include "test_types.hpp"
 
 // Constructors
 TEST(Vector, DefaultConstructor) {
@@ -49,6 +66,46 @@ TEST(Vector, IteratorSequence) {
   }
 }
 
+TEST(Vector, IteratorConcepts) {
+  using V = utils::Vector<int>;
+  static_assert(std::contiguous_iterator<V::Iterator>);
+  static_assert(std::contiguous_iterator<V::ConstIterator>);
+  static_assert(std::ranges::contiguous_range<V>);
+  static_assert(std::ranges::contiguous_range<const V>);
+  static_assert(std::ranges::sized_range<V>);
+  static_assert(std::same_as<std::ranges::iterator_t<const V>, V::ConstIterator>);
+  static_assert(std::same_as<decltype(*std::declval<V::ConstIterator>()), const int&>);
+  static_assert(std::convertible_to<V::Iterator, V::ConstIterator>);
+  static_assert(!std::convertible_to<V::ConstIterator, V::Iterator>);
+
+  V v = {30, 10, 20};
+  std::ranges::sort(v);
+  std::span<const int> view(v);
+  EXPECT_EQ(v.data(), view.data());
+  EXPECT_EQ(3, view.size());
+  EXPECT_EQ(10, view[0]);
+
+  V::ConstIterator it = v.begin();
+  EXPECT_TRUE(it == v.begin());
+  EXPECT_TRUE(v.cbegin() < v.end());
+  EXPECT_EQ(10, *it++);
+  EXPECT_EQ(20, *it);
+  EXPECT_EQ(20, *it--);
+  EXPECT_EQ(v.data(), std::to_address(it));
+  EXPECT_EQ(30, *(2 + v.cbegin()));
+  EXPECT_EQ(3, v.end() - v.cbegin());
+  EXPECT_EQ(-3, v.cbegin() - v.end());
+  EXPECT_EQ(2, v.end() - (v.begin() + 1));
+
+  std::vector<int> reversed(v.rbegin(), v.rend());
+  EXPECT_EQ((std::vector<int>{30, 20, 10}), reversed);
+  EXPECT_EQ(30, *v.crbegin());
+
+  v.erase(v.cbegin() + 1);
+  v.insert(v.cend(), 40);
+  EXPECT_EQ((std::vector<int>{10, 30, 40}), std::vector<int>(v.begin(), v.end()));
+}
+
 // Capacity
 TEST(Vector, Size) {
   utils::Vector<double> v;
@@ -147,48 +204,6 @@ TEST(Vector, AccessData) {
   }
 }
 
-class MoveableType {
- public:
-  MoveableType(int val = 0) : value(val) {}
-  MoveableType(const MoveableType& other) : value(other.value) { ++copy_count; }
-  MoveableType(MoveableType&& other) noexcept : value(other.value) {
-    other.value = 0;
-    ++move_count;
-  }
-  MoveableType& operator=(const MoveableType& other) {
-    if (this != &other) {
-      value = other.value;
-      ++copy_count;
-    }
-    return *this;
-  }
-  MoveableType& operator=(MoveableType&& other) noexcept {
-    if (this != &other) {
-      value = other.value;
-      other.value = 0;
-      ++move_count;
-    }
-    return *this;
-  }
-  ~MoveableType() = default;
-
-  int getValue() const { return value; }
-  static void resetCounters() {
-    copy_count = 0;
-    move_count = 0;
-  }
-  static int getCopyCount() { return copy_count; }
-  static int getMoveCount() { return move_count; }
-
- private:
-  int value;
-  static int copy_count;
-  static int move_count;
-};
-
-int MoveableType::copy_count = 0;
-int MoveableType::move_count = 0;
-
 TEST(Vector, MoveConstructor) {
   MoveableType::resetCounters();
   utils::Vector<MoveableType> v1;
@@ -237,21 +252,6 @@ TEST(Vector, PushBackMove) {
   EXPECT_GE(MoveableType::getMoveCount(), 1);
 }
 
-class ComplexType {
- public:
-  ComplexType(int x, std::string s, double d) 
-      : int_val(x), str_val(s), double_val(d) {}
-  
-  int getInt() const { return int_val; }
-  const std::string& getString() const { return str_val; }
-  double getDouble() const { return double_val; }
-
- private:
-  int int_val;
-  std::string str_val;
-  double double_val;
-};
-
 TEST(Vector, EmplaceBack) {
   utils::Vector<ComplexType> v;
   
@@ -293,70 +293,6 @@ TEST(Vector, EmplaceEfficiency) {
   EXPECT_EQ(42, v[0].getValue());
 }
 
-template<typename T>
-class ThrowingAllocator {
- public:
-  using value_type = T;
-  using pointer = T*;
-  using const_pointer = const T*;
-  using reference = T&;
-  using const_reference = const T&;
-  using size_type = std::size_t;
-  using difference_type = std::ptrdiff_t;
-  
-  template<typename U>
-  struct rebind {
-    using other = ThrowingAllocator<U>;
-  };
-
-  ThrowingAllocator() noexcept : throw_on_(0), id_(next_id++) {}
-  ThrowingAllocator(size_t throw_on) noexcept : throw_on_(throw_on), id_(next_id++) {}
-  
-  template<typename U>
-  ThrowingAllocator(const ThrowingAllocator<U>& other) noexcept
-      : throw_on_(other.throw_on_), id_(other.id_) {}
-  
-  pointer allocate(size_t n) {
-    if (throw_on_ > 0 && allocation_count_++ == throw_on_) {
-      throw std::bad_alloc();
-    }
-    return static_cast<pointer>(::operator new(n * sizeof(T)));
-  }
-  
-  void deallocate(pointer p, size_t) noexcept {
-    ::operator delete(p);
-  }
-  
-  bool operator==(const ThrowingAllocator& other) const {
-    return throw_on_ == other.throw_on_ && id_ == other.id_;
-  }
-  
-  bool operator!=(const ThrowingAllocator& other) const {
-    return !(*this == other);
-  }
-
-  static void reset() { allocation_count_ = 0; }
-  
-  ThrowingAllocator select_on_container_copy_construction() const {
-    return *this;
-  }
-  
- private:
-  size_t throw_on_;
-  int id_;
-  static int next_id;
-  static size_t allocation_count_;
-  
-  template<typename U>
-  friend class ThrowingAllocator;
-};
-
-template<typename T>
-int ThrowingAllocator<T>::next_id = 0;
-
-template<typename T>
-size_t ThrowingAllocator<T>::allocation_count_ = 0;
-
 TEST(Vector, AllocatorPropagation) {
   using AllocVector = utils::Vector<int, ThrowingAllocator<int>>;
   
@@ -384,7 +320,7 @@ TEST(Vector, ExceptionSafetyConstruction) {
     utils::Vector<MoveableType, ThrowingAllocator<MoveableType>> v(throwing_alloc);
     v.reserve(5);
     
-    for (int i = 0; i < 10; ++i) {
+    for (int i = 0; i < 100; ++i) {
       v.push_back(MoveableType(i));
     }
     FAIL() << "Expected std::bad_alloc";
@@ -435,6 +371,9 @@ TEST(Vector, StrongExceptionGuaranteeReallocation) {
   
   utils::Vector<MoveableType, ThrowingAllocator<MoveableType>> v(throwing_alloc);
   v.push_back(MoveableType(1));
+  while (v.size() < v.capacity()) {
+    v.push_back(MoveableType(1));
+  }
   
   MoveableType::resetCounters();
   std::size_t original_size = v.size();
@@ -457,14 +396,660 @@ TEST(Vector, EmplaceExceptionSafety) {
   
   v.emplace_back(1, "one", 1.0);
   EXPECT_EQ(1, v[0].getInt());
+  while (v.size() < v.capacity()) {
+    v.emplace_back(1, "one", 1.0);
+  }
+  const std::size_t full_size = v.size();
   
   try {
     v.emplace_back(2, "two", 2.0);
     FAIL() << "Expected std::bad_alloc";
   } catch (const std::bad_alloc&) {
-    EXPECT_EQ(1, v.size());
+    EXPECT_EQ(full_size, v.size());
     EXPECT_EQ(1, v[0].getInt());
     EXPECT_EQ("one", v[0].getString());
     EXPECT_EQ(1.0, v[0].getDouble());
   }
-}
\ No newline at end of file
+}
+// Growth
+TEST(Vector, GeometricGrowth) {
+  utils::Vector<int> v;
+  v.push_back(1);
+  EXPECT_EQ(utils::kMinSize, v.capacity());
+
+  std::size_t reallocations = 0;
+  std::size_t last_capacity = v.capacity();
+  for (int i = 0; i < 100000; ++i) {
+    v.push_back(i);
+    if (v.capacity() != last_capacity) {
+      EXPECT_GE(v.capacity(), last_capacity * 2);
+      last_capacity = v.capacity();
+      ++reallocations;
+    }
+  }
+  EXPECT_LE(reallocations, 15);
+}
+
+TEST(Vector, GrowthPolicies) {
+  utils::Vector<int, std::allocator<int>, utils::LinearGrowth<4>> linear;
+  for (int i = 0; i < 9; ++i) linear.push_back(i);
+  EXPECT_EQ(12, linear.capacity());
+
+  utils::Vector<int, std::allocator<int>, utils::GeometricGrowth<1.5, 2>> slow;
+  slow.push_back(0);
+  EXPECT_EQ(2, slow.capacity());
+  for (int i = 0; i < 3; ++i) slow.push_back(i);
+  EXPECT_EQ(4, slow.capacity());
+  slow.push_back(4);
+  EXPECT_EQ(6, slow.capacity());
+}
+
+TEST(Vector, GrowthCap) {
+  using Capped = utils::GeometricGrowth<2.0, 8, 64 * sizeof(int)>;
+  EXPECT_EQ(64, Capped::next_capacity<int>(32, 33, 1 << 20));
+  EXPECT_EQ(128, Capped::next_capacity<int>(64, 65, 1 << 20));
+  EXPECT_EQ(192, Capped::next_capacity<int>(128, 129, 1 << 20));
+  EXPECT_EQ(500, Capped::next_capacity<int>(128, 500, 1 << 20));
+  EXPECT_EQ(100, Capped::next_capacity<int>(90, 91, 100));
+}
+
+template <typename T>
+class GenerousAllocator : public std::allocator<T> {
+ public:
+  using value_type = T;
+  GenerousAllocator() = default;
+  template <typename U>
+  GenerousAllocator(const GenerousAllocator<U>&) noexcept {}
+
+  struct Result {
+    T* ptr;
+    std::size_t count;
+  };
+  Result allocate_at_least(std::size_t n) {
+    return {std::allocator<T>::allocate(n + 3), n + 3};
+  }
+};
+
+TEST(Vector, AllocateAtLeast) {
+  utils::Vector<int, GenerousAllocator<int>> v;
+  v.push_back(1);
+  EXPECT_EQ(utils::kMinSize + 3, v.capacity());
+  for (int i = 0; i < 100; ++i) v.push_back(i);
+  EXPECT_EQ(101, v.size());
+  EXPECT_EQ(99, v.back());
+}
+
+// Relocation
+struct OptInRelocatable {
+  OptInRelocatable(int v = 0) : value(std::make_unique<int>(v)) {}
+  OptInRelocatable(OptInRelocatable&& other) noexcept
+      : value(std::move(other.value)) {
+    ++moves;
+  }
+  std::unique_ptr<int> value;
+  static inline int moves = 0;
+};
+
+template <>
+struct utils::is_trivially_relocatable<OptInRelocatable> : std::true_type {};
+
+struct ThrowingMove {
+  ThrowingMove(int v = 0) : value(v) {}
+  ThrowingMove(const ThrowingMove& other) : value(other.value) { ++copies; }
+  ThrowingMove(ThrowingMove&& other) : value(other.value) { ++moves; }
+  int value;
+  static inline int copies = 0;
+  static inline int moves = 0;
+};
+
+TEST(Vector, TriviallyRelocatableTrait) {
+  static_assert(utils::is_trivially_relocatable_v<int>);
+  static_assert(utils::is_trivially_relocatable_v<double>);
+  static_assert(!utils::is_trivially_relocatable_v<std::string>);
+  static_assert(utils::is_trivially_relocatable_v<OptInRelocatable>);
+}
+
+TEST(Vector, RelocateOptInWithoutMoving) {
+  utils::Vector<OptInRelocatable> v;
+  v.reserve(1);
+  for (int i = 0; i < 100; ++i) v.emplace_back(i);
+  OptInRelocatable::moves = 0;
+  v.insert(v.begin() + 50, OptInRelocatable(-1));
+  v.shrink_to_fit();
+  v.erase(v.begin());
+  EXPECT_EQ(1, OptInRelocatable::moves);
+  ASSERT_EQ(100, v.size());
+  EXPECT_EQ(1, *v[0].value);
+  EXPECT_EQ(-1, *v[49].value);
+  EXPECT_EQ(99, *v[99].value);
+}
+
+TEST(Vector, RelocateThrowingMoveCopies) {
+  utils::Vector<ThrowingMove> v;
+  for (int i = 0; i < 100; ++i) v.emplace_back(i);
+  ThrowingMove::moves = 0;
+  ThrowingMove::copies = 0;
+  v.reserve(1000);
+  EXPECT_EQ(0, ThrowingMove::moves);
+  EXPECT_EQ(100, ThrowingMove::copies);
+  EXPECT_EQ(42, v[42].value);
+}
+
+TEST(Vector, InsertEraseMiddle) {
+  utils::Vector<std::string> v = {"a", "b", "d"};
+  v.insert(v.begin() + 2, std::string("c"));
+  v.insert(v.begin(), v[3]);
+  ASSERT_EQ(5, v.size());
+  EXPECT_EQ("d", v[0]);
+  EXPECT_EQ("c", v[3]);
+
+  auto it = v.erase(v.begin() + 1);
+  EXPECT_EQ("b", *it);
+  it = v.erase(v.end() - 1);
+  EXPECT_EQ(v.end(), it);
+  ASSERT_EQ(3, v.size());
+  EXPECT_EQ("d", v[0]);
+  EXPECT_EQ("b", v[1]);
+  EXPECT_EQ("c", v[2]);
+  EXPECT_THROW(v.erase(v.end()), std::out_of_range);
+
+  utils::Vector<int> ints = {1, 2, 3, 4};
+  ints.erase(ints.begin() + 1);
+  EXPECT_EQ(3, ints.size());
+  EXPECT_EQ(3, ints[1]);
+  EXPECT_EQ(4, ints[2]);
+}
+
+TEST(Vector, InsertInPlace) {
+  utils::Vector<std::string> v = {"a", "d"};
+  v.reserve(16);
+  const std::string* storage = v.data();
+  v.emplace(v.begin() + 1, "c");
+  v.emplace(v.begin() + 1, 1, 'b');
+  v.insert(v.begin(), v[3]);
+  EXPECT_EQ(storage, v.data());
+  ASSERT_EQ(5, v.size());
+  EXPECT_EQ("d", v[0]);
+  EXPECT_EQ("a", v[1]);
+  EXPECT_EQ("b", v[2]);
+  EXPECT_EQ("c", v[3]);
+  EXPECT_EQ("d", v[4]);
+}
+
+TEST(Vector, EraseRange) {
+  utils::Vector<std::string> v = {"a", "b", "c", "d", "e"};
+  auto it = v.erase(v.begin() + 1, v.begin() + 3);
+  EXPECT_EQ("d", *it);
+  ASSERT_EQ(3, v.size());
+  EXPECT_EQ("a", v[0]);
+  EXPECT_EQ("e", v[2]);
+
+  it = v.erase(v.begin() + 1, v.begin() + 1);
+  EXPECT_EQ("d", *it);
+  EXPECT_EQ(3, v.size());
+  EXPECT_THROW(v.erase(v.begin() + 2, v.begin() + 1), std::out_of_range);
+  EXPECT_THROW(v.erase(v.begin(), v.end() + 1), std::out_of_range);
+
+  it = v.erase(v.begin(), v.end());
+  EXPECT_EQ(v.end(), it);
+  EXPECT_TRUE(v.empty());
+}
+
+TEST(Vector, EraseIfAndErase) {
+  utils::Vector<int> ints;
+  for (int i = 0; i < 100; ++i) ints.push_back(i);
+  EXPECT_EQ(50, utils::erase_if(ints, [](int x) { return x % 2 == 1; }));
+  ASSERT_EQ(50, ints.size());
+  for (int i = 0; i < 50; ++i) EXPECT_EQ(2 * i, ints[i]);
+
+  utils::Vector<std::string> words = {"x", "a", "x", "b", "x"};
+  EXPECT_EQ(3, utils::erase(words, "x"));
+  ASSERT_EQ(2, words.size());
+  EXPECT_EQ("a", words[0]);
+  EXPECT_EQ("b", words[1]);
+  EXPECT_EQ(0, utils::erase(words, "x"));
+}
+
+TEST(Vector, EraseIfDestroysEachElementOnce) {
+  LiveCounted::live = 0;
+  {
+    utils::Vector<LiveCounted> v;
+    for (int i = 0; i < 64; ++i) v.emplace_back(i);
+    EXPECT_EQ(16, utils::erase_if(v, [](const LiveCounted& x) { return x.value % 4 == 0; }));
+    EXPECT_EQ(48, LiveCounted::live);
+    EXPECT_EQ(1, v[0].value);
+    EXPECT_EQ(63, v.back().value);
+  }
+  EXPECT_EQ(0, LiveCounted::live);
+}
+
+TEST(Vector, EraseIfRelocatesWithoutMoving) {
+  utils::Vector<OptInRelocatable> v;
+  for (int i = 0; i < 100; ++i) v.emplace_back(i);
+  OptInRelocatable::moves = 0;
+  EXPECT_EQ(34, utils::erase_if(v, [](const OptInRelocatable& x) { return *x.value % 3 == 0; }));
+  EXPECT_EQ(0, OptInRelocatable::moves);
+  ASSERT_EQ(66, v.size());
+  EXPECT_EQ(1, *v[0].value);
+  EXPECT_EQ(2, *v[1].value);
+  EXPECT_EQ(98, *v[65].value);
+
+  // A throwing predicate leaves every element that was not yet removed.
+  int calls = 0;
+  EXPECT_THROW(utils::erase_if(v,
+                               [&calls](const OptInRelocatable& x) {
+                                 if (++calls == 10) throw std::runtime_error("stop");
+                                 return *x.value % 2 == 0;
+                               }),
+               std::runtime_error);
+  ASSERT_EQ(62, v.size());
+  EXPECT_EQ(1, *v[0].value);
+  EXPECT_EQ(7, *v[2].value);
+  EXPECT_EQ(14, *v[5].value);
+  EXPECT_EQ(98, *v[61].value);
+}
+
+TEST(Vector, UnorderedErase) {
+  utils::Vector<std::string> v = {"a", "b", "c", "d"};
+  auto it = v.unordered_erase(v.begin() + 1);
+  EXPECT_EQ("d", *it);
+  ASSERT_EQ(3, v.size());
+  EXPECT_EQ("a", v[0]);
+  EXPECT_EQ("c", v[2]);
+  it = v.unordered_erase(v.end() - 1);
+  EXPECT_EQ(v.end(), it);
+  EXPECT_THROW(v.unordered_erase(v.end()), std::out_of_range);
+
+  utils::Vector<OptInRelocatable> handles;
+  for (int i = 0; i < 4; ++i) handles.emplace_back(i);
+  OptInRelocatable::moves = 0;
+  handles.unordered_erase(handles.begin());
+  EXPECT_EQ(0, OptInRelocatable::moves);
+  ASSERT_EQ(3, handles.size());
+  EXPECT_EQ(3, *handles[0].value);
+}
+
+TEST(Vector, EraseIndices) {
+  utils::Vector<std::string> v;
+  for (int i = 0; i < 10; ++i) v.push_back(std::to_string(i));
+  EXPECT_EQ(4, v.erase_indices(std::vector<std::size_t>{0, 3, 4, 9}));
+  ASSERT_EQ(6, v.size());
+  EXPECT_EQ("1", v[0]);
+  EXPECT_EQ("2", v[1]);
+  EXPECT_EQ("5", v[2]);
+  EXPECT_EQ("8", v[5]);
+  EXPECT_EQ(0, v.erase_indices(std::vector<int>{}));
+
+  EXPECT_THROW(v.erase_indices(std::vector<int>{2, 1}), std::invalid_argument);
+  EXPECT_THROW(v.erase_indices(std::vector<int>{1, 1}), std::invalid_argument);
+  EXPECT_THROW(v.erase_indices(std::vector<int>{1, 6}), std::out_of_range);
+  EXPECT_THROW(v.erase_indices(std::vector<int>{-1}), std::out_of_range);
+  EXPECT_EQ(6, v.size());
+
+  utils::Vector<int> ints = {0, 1, 2, 3, 4, 5, 6, 7};
+  EXPECT_EQ(4, ints.erase_indices(std::views::iota(2, 6)));
+  EXPECT_EQ((std::vector<int>{0, 1, 6, 7}), std::vector<int>(ints.data(), ints.data() + 4));
+}
+
+TEST(Vector, PushBackAliasingOnGrowth) {
+  utils::Vector<std::string> v = {"first"};
+  while (v.size() < v.capacity()) v.push_back("x");
+  v.push_back(v[0]);
+  EXPECT_EQ("first", v.back());
+}
+
+TEST(Vector, InsertRange) {
+  utils::Vector<int> v = {1, 2, 7, 8};
+  int values[] = {3, 4, 5, 6};
+  auto it = v.insert(v.begin() + 2, std::begin(values), std::end(values));
+  EXPECT_EQ(3, *it);
+  EXPECT_EQ((utils::Vector<int>{1, 2, 3, 4, 5, 6, 7, 8}.size()), v.size());
+  for (int i = 0; i < 8; ++i) EXPECT_EQ(i + 1, v[i]);
+
+  v.insert(v.begin(), 3, 0);
+  EXPECT_EQ(11, v.size());
+  EXPECT_EQ(0, v[2]);
+  EXPECT_EQ(1, v[3]);
+
+  v.insert(v.end(), {9, 10});
+  EXPECT_EQ(10, v.back());
+}
+
+TEST(Vector, InsertRangeNonTrivial) {
+  for (std::size_t extra : {0, 1, 2, 5}) {
+    for (std::size_t pos = 0; pos <= 4; ++pos) {
+      utils::Vector<std::string> v = {"0", "1", "2", "3"};
+      v.reserve(v.size() + extra);
+      std::vector<std::string> block = {"a", "b"};
+      v.insert(v.begin() + pos, block.begin(), block.end());
+
+      std::vector<std::string> expected = {"0", "1", "2", "3"};
+      expected.insert(expected.begin() + pos, {"a", "b"});
+      ASSERT_EQ(expected.size(), v.size());
+      for (std::size_t i = 0; i < expected.size(); ++i) {
+        EXPECT_EQ(expected[i], v[i]);
+      }
+    }
+  }
+}
+
+TEST(Vector, InsertRangeAndAppendRange) {
+  utils::Vector<int> v = {1, 5};
+  std::vector<int> middle = {2, 3, 4};
+  v.insert_range(v.begin() + 1, middle);
+  v.append_range(std::views::iota(6, 9));
+
+  std::istringstream input("9 10");
+  v.append_range(std::ranges::subrange(std::istream_iterator<int>(input),
+                                       std::istream_iterator<int>()));
+  ASSERT_EQ(10, v.size());
+  for (int i = 0; i < 10; ++i) EXPECT_EQ(i + 1, v[i]);
+
+  std::istringstream front("-1 0");
+  v.insert(v.begin(), std::istream_iterator<int>(front), std::istream_iterator<int>());
+  EXPECT_EQ(-1, v[0]);
+  EXPECT_EQ(0, v[1]);
+  EXPECT_EQ(1, v[2]);
+}
+
+TEST(Vector, InsertRangeExceptionSafety) {
+  ThrowingAllocator<int>::reset();
+  ThrowingAllocator<int> throwing_alloc(1);
+  utils::Vector<int, ThrowingAllocator<int>> v(throwing_alloc);
+  v.push_back(1);
+  v.push_back(2);
+  std::vector<int> many(100, 7);
+  EXPECT_THROW(v.insert(v.begin() + 1, many.begin(), many.end()), std::bad_alloc);
+  ASSERT_EQ(2, v.size());
+  EXPECT_EQ(1, v[0]);
+  EXPECT_EQ(2, v[1]);
+}
+
+template <typename T>
+using CountedVector = utils::Vector<T, std::allocator<T>, utils::DefaultGrowth,
+                                    utils::VectorStats<T>>;
+
+struct StatsOnlyType {
+  int value;
+};
+
+TEST(Vector, NoStatsHasNoOverhead) {
+  struct Layout {
+    std::size_t size;
+    int* data;
+    std::size_t capacity;
+    std::allocator<int> alloc;
+  };
+  static_assert(sizeof(utils::Vector<int>) == sizeof(Layout));
+  static_assert(!utils::Vector<int>::stats_type::enabled);
+}
+
+TEST(Vector, StatsCountGrowth) {
+  CountedVector<int> v;
+  for (int i = 0; i < 100; ++i) v.push_back(i);
+  const utils::VectorCounters& c = v.stats().counters();
+  // Capacities 8, 16, 32, 64, 128.
+  EXPECT_EQ(5, c.allocations);
+  EXPECT_EQ(4, c.reallocations);
+  EXPECT_EQ((8 + 16 + 32 + 64) * sizeof(int), c.bytes_moved);
+  EXPECT_EQ(128, c.peak_capacity);
+  EXPECT_EQ(100, c.constructed);
+  EXPECT_EQ(0, c.slow_inserts);
+
+  v.shrink_to_fit();
+  v.insert(v.begin(), -1);
+  EXPECT_EQ(1, v.stats().counters().slow_inserts);
+  v.erase(v.begin());
+  v.pop_back();
+  v.clear();
+  EXPECT_EQ(101, v.stats().counters().constructed);
+  EXPECT_EQ(101, v.stats().counters().destroyed);
+
+  CountedVector<int> erased = {1, 2, 3, 4, 5, 6, 7};
+  utils::erase_if(erased, [](int x) { return x > 4; });
+  erased.erase_indices(std::vector<int>{0, 2});
+  erased.unordered_erase(erased.begin());
+  EXPECT_EQ(6, erased.stats().counters().destroyed);
+}
+
+TEST(Vector, StatsAreNotCopied) {
+  CountedVector<int> v(10, 1);
+  CountedVector<int> copy = v;
+  EXPECT_EQ(1, copy.stats().counters().allocations);
+  EXPECT_EQ(10, copy.stats().counters().constructed);
+  copy.assign(3, 2);
+  EXPECT_EQ(2, copy.stats().counters().allocations);
+  EXPECT_EQ(13, copy.stats().counters().constructed);
+}
+
+TEST(Vector, StatsRegistryAggregatesPerType) {
+  constexpr int kThreads = 4;
+  constexpr int kPushes = 1000;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreads; ++t) {
+    threads.emplace_back([] {
+      CountedVector<StatsOnlyType> v;
+      for (int i = 0; i < kPushes; ++i) v.push_back({i});
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  utils::VectorCounters totals = utils::VectorStats<StatsOnlyType>::totals();
+  EXPECT_EQ(kThreads * kPushes, totals.constructed);
+  EXPECT_EQ(kThreads * kPushes, totals.destroyed);
+  EXPECT_EQ(1024, totals.peak_capacity);
+
+  const std::string report = utils::StatsRegistry::instance().dump();
+  EXPECT_NE(std::string::npos, report.find("reallocs"));
+  EXPECT_NE(std::string::npos, report.find("StatsOnlyType"));
+}
+
+TEST(Vector, StatsRegistryDumpKeepsLongTypeNames) {
+  using LongName = std::map<std::string, std::vector<std::pair<std::string, std::wstring>>>;
+  CountedVector<LongName> v;
+  v.emplace_back();
+  const std::string report = utils::StatsRegistry::instance().dump();
+  const auto rows = utils::StatsRegistry::instance().snapshot();
+  EXPECT_EQ(rows.size() + 1,
+            static_cast<std::size_t>(std::count(report.begin(), report.end(), '\n')));
+  bool found = false;
+  for (const auto& [name, counters] : rows) {
+    if (name.size() > 200) {
+      found = true;
+      EXPECT_NE(std::string::npos, report.find(name + " "));
+    }
+  }
+  EXPECT_TRUE(found);
+}
+
+TEST(Vector, ResizeFromOwnElement) {
+  utils::Vector<std::string> v;
+  v.push_back(std::string(40, 'x'));
+  v.shrink_to_fit();
+  v.resize(100, v[0]);
+  ASSERT_EQ(100, v.size());
+  for (const std::string& s : v) EXPECT_EQ(std::string(40, 'x'), s);
+}
+
+TEST(Vector, ResizeDestroysPartialGrowth) {
+  {
+    utils::Vector<LiveCounted> v(3, LiveCounted(1));
+    LiveCounted::copies_left = 5;
+    EXPECT_THROW(v.resize(20, LiveCounted(2)), std::runtime_error);
+    LiveCounted::copies_left = -1;
+    EXPECT_EQ(3, v.size());
+    EXPECT_EQ(3, LiveCounted::live.load());
+  }
+  EXPECT_EQ(0, LiveCounted::live.load());
+}
+
+TEST(Vector, DefaultInitConstructorAndResizeForOverwrite) {
+  utils::Vector<int> ints(1000, utils::default_init);
+  EXPECT_EQ(1000, ints.size());
+  for (int i = 0; i < 1000; ++i) ints[i] = i;
+  ints.resize_for_overwrite(3000);
+  ASSERT_EQ(3000, ints.size());
+  for (int i = 0; i < 1000; ++i) ASSERT_EQ(i, ints[i]);
+  ints.resize_for_overwrite(10);
+  EXPECT_EQ(10, ints.size());
+  EXPECT_EQ(9, ints.back());
+
+  // Non-trivial types are still default-constructed and destroyed.
+  utils::Vector<std::string> strings(3, utils::default_init);
+  strings.resize_for_overwrite(5);
+  for (const std::string& s : strings) EXPECT_TRUE(s.empty());
+  {
+    utils::Vector<LiveCounted> counted(4, utils::default_init);
+    EXPECT_EQ(4, LiveCounted::live.load());
+    counted.resize_for_overwrite(10);
+    EXPECT_EQ(10, LiveCounted::live.load());
+    counted.resize_for_overwrite(1);
+    EXPECT_EQ(1, LiveCounted::live.load());
+  }
+  EXPECT_EQ(0, LiveCounted::live.load());
+
+  // An allocator that hooks construction still constructs through it.
+  std::pmr::monotonic_buffer_resource resource;
+  utils::Vector<std::pmr::string, std::pmr::polymorphic_allocator<std::pmr::string>> pmr(
+      2, utils::default_init, &resource);
+  EXPECT_EQ(&resource, pmr[1].get_allocator().resource());
+}
+
+TEST(Vector, ResizeAndOverwrite) {
+  utils::Vector<char> buffer = {'a', 'b'};
+  buffer.resize_and_overwrite(10, [](char* data, std::size_t size) {
+    EXPECT_EQ(10, size);
+    EXPECT_EQ('b', data[1]);
+    std::memcpy(data + 2, "cdef", 4);
+    return 6;
+  });
+  EXPECT_EQ("abcdef", std::string(buffer.begin(), buffer.end()));
+  buffer.resize_and_overwrite(3, [](char* data, std::size_t) {
+    data[0] = 'z';
+    return 1;
+  });
+  EXPECT_EQ("z", std::string(buffer.begin(), buffer.end()));
+
+  EXPECT_THROW(buffer.resize_and_overwrite(4, [](char*, std::size_t size) { return size + 1; }),
+               std::length_error);
+  EXPECT_EQ(4, buffer.size());
+
+  utils::Vector<int> shrinking = {1, 2, 3, 4, 5};
+  EXPECT_THROW(shrinking.resize_and_overwrite(2, [](int*, std::size_t) { return 3; }),
+               std::length_error);
+  EXPECT_EQ(2, shrinking.size());
+  EXPECT_EQ(2, shrinking.back());
+
+  {
+    utils::Vector<LiveCounted> counted(2, LiveCounted(1));
+    EXPECT_THROW(counted.resize_and_overwrite(8,
+                                              [](LiveCounted* data, std::size_t) -> std::size_t {
+                                                data[0].value = 5;
+                                                throw std::runtime_error("op failed");
+                                              }),
+                 std::runtime_error);
+    EXPECT_EQ(2, counted.size());
+    EXPECT_EQ(5, counted[0].value);
+    EXPECT_EQ(2, LiveCounted::live.load());
+    counted.resize_and_overwrite(6, [](LiveCounted* data, std::size_t size) {
+      for (std::size_t i = 0; i < size; ++i) data[i].value = static_cast<int>(i);
+      return std::size_t{4};
+    });
+    EXPECT_EQ(4, LiveCounted::live.load());
+    EXPECT_EQ(3, counted.back().value);
+  }
+  EXPECT_EQ(0, LiveCounted::live.load());
+}
+
+TEST(Vector, ResizeAndOverwriteMoveOnly) {
+  utils::Vector<std::unique_ptr<int>> owners;
+  owners.push_back(std::make_unique<int>(7));
+  owners.resize_and_overwrite(4, [](std::unique_ptr<int>* data, std::size_t size) {
+    EXPECT_EQ(nullptr, data[1]);
+    for (std::size_t i = 1; i < size; ++i) data[i] = std::make_unique<int>(static_cast<int>(i));
+    return std::size_t{3};
+  });
+  ASSERT_EQ(3, owners.size());
+  EXPECT_EQ(7, *owners[0]);
+  EXPECT_EQ(2, *owners[2]);
+  EXPECT_THROW(owners.resize_and_overwrite(6,
+                                           [](std::unique_ptr<int>*, std::size_t) -> std::size_t {
+                                             throw std::runtime_error("op failed");
+                                           }),
+               std::runtime_error);
+  EXPECT_EQ(3, owners.size());
+  owners.resize_for_overwrite(1);
+  EXPECT_EQ(7, *owners.back());
+}
+
+constexpr int ConstantEvaluatedOverwrite() {
+  utils::Vector<int> v(4, utils::default_init);
+  for (int i = 0; i < 4; ++i) v[i] = i;
+  v.resize_for_overwrite(8);
+  v.resize_and_overwrite(16, [](int* data, std::size_t size) {
+    for (std::size_t i = 4; i < size; ++i) data[i] = static_cast<int>(i);
+    return size - 1;
+  });
+  int sum = 0;
+  for (int x : v) sum += x;
+  return sum;
+}
+
+static_assert(ConstantEvaluatedOverwrite() == 105);
+
+// Builds a table in a transient Vector and returns a digest of it, so that
+// every call below is evaluated entirely at compile time.
+constexpr int ConstantEvaluatedDigest() {
+  utils::Vector<int> v;
+  for (int i = 0; i < 100; ++i) v.push_back(i * i);
+  v.insert(v.begin() + 3, -7);
+  v.insert(v.begin(), {1, 2, 3});
+  v.erase(v.begin());
+  v.resize(150, v[5]);
+  v.insert(v.begin() + 1, 3, v[0]);
+  v.shrink_to_fit();
+  utils::erase_if(v, [](int x) { return x % 7 == 0; });
+  v.erase(v.begin() + 10, v.begin() + 20);
+  v.unordered_erase(v.begin() + 2);
+  utils::Vector<int> copy(v);
+  copy.append_range(std::views::iota(0, 10));
+  unsigned digest = static_cast<unsigned>(copy.size());
+  for (int x : copy) digest = digest * 31 + static_cast<unsigned>(x);
+  return static_cast<int>(digest);
+}
+
+int RuntimeDigest() {
+  std::vector<int> v;
+  for (int i = 0; i < 100; ++i) v.push_back(i * i);
+  v.insert(v.begin() + 3, -7);
+  v.insert(v.begin(), {1, 2, 3});
+  v.erase(v.begin());
+  v.resize(150, v[5]);
+  v.insert(v.begin() + 1, 3, v[0]);
+  std::erase_if(v, [](int x) { return x % 7 == 0; });
+  v.erase(v.begin() + 10, v.begin() + 20);
+  v[2] = v.back();
+  v.pop_back();
+  for (int i = 0; i < 10; ++i) v.push_back(i);
+  unsigned digest = static_cast<unsigned>(v.size());
+  for (int x : v) digest = digest * 31 + static_cast<unsigned>(x);
+  return static_cast<int>(digest);
+}
+
+constexpr std::size_t ConstantEvaluatedStrings() {
+  utils::Vector<std::string> v = {"a", "bb"};
+  v.emplace_back(5, 'x');
+  v.insert(v.begin(), std::string("ccc"));
+  v.erase(v.begin() + 1);
+  v.insert(v.begin() + 1, 2, std::string("dd"));
+  utils::erase(v, std::string("bb"));
+  std::size_t total = 0;
+  for (const std::string& s : v) total += s.size();
+  return total * 10 + v.size();
+}
+
+TEST(Vector, ConstantEvaluation) {
+  constexpr int kDigest = ConstantEvaluatedDigest();
+  EXPECT_EQ(RuntimeDigest(), kDigest);
+  static_assert(ConstantEvaluatedStrings() == 124);
+}